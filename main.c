@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <sys/mman.h>
 #include "thesquid.h"
 
 void UnitTestSquad() {
@@ -124,6 +125,24 @@ void UnitTestSquidlet() {
   printf("\n");
   float temperature = SquidletGetTemperature(squidlet);
   printf("squidlet temperature: %f\n", temperature);
+  float stubTemperature = 42.5;
+  unsigned int periodMs = 10;
+  if (SquidletSetThermalSource(squidlet, TheSquidThermalSourceStub, 
+    &stubTemperature, periodMs) == false ||
+    fabs(SquidletGetTemperature(squidlet) - 42.5) > 0.001) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquidletSetThermalSource failed");
+    PBErrCatch(TheSquidErr);
+  }
+  // The sampler thread reads the temperature meanwhile
+  float newTemperature = 50.0;
+  __atomic_store(&stubTemperature, &newTemperature, __ATOMIC_RELAXED);
+  usleep(100000);
+  if (fabs(SquidletGetTemperature(squidlet) - 50.0) > 0.001) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "TheSquidThermal failed");
+    PBErrCatch(TheSquidErr);
+  }
   SquidletFree(&squidlet);
   if (squidlet != NULL) {
     TheSquidErr->_type = PBErrTypeUnitTestFailed;
@@ -240,6 +259,34 @@ void UnitTestDummy() {
       
     } while (SquadGetNbTaskToComplete(squad) > 0L && 
       time(NULL) - startTime <= 60 && !flagStop);
+    // Export the trace of the tasks and check it's valid JSON
+    fp = fopen("unitTestDummyTrace.json", "w");
+    bool retTrace = SquadExportTrace(squad, fp);
+    fclose(fp);
+    JSONNode* trace = JSONCreate();
+    fp = fopen("unitTestDummyTrace.json", "r");
+    if (!retTrace || !JSONLoad(trace, fp) || 
+      JSONProperty(trace, "traceEvents") == NULL) {
+      TheSquidErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(TheSquidErr->_msg, "SquadExportTrace failed");
+      PBErrCatch(TheSquidErr);
+    }
+    fclose(fp);
+    JSONFree(&trace);
+    // Run a short benchmark of the protocol on 1 and 2 squidlets
+    SquadBenchmarkConfig config = SquadBenchmarkConfigCreateStatic();
+    config._warmUpMs = 100.0;
+    config._sampleMs = 100.0;
+    config._minLengthMs = 500.0;
+    config._maxLengthMs = 1000.0;
+    config._format = SquadBenchmarkFormat_CSV;
+    SquadBenchmarkProtocol(squad, &config, stdout);
+    SquadBenchmarkConfigFreeStatic(&config);
+    if (SquadGetNbSquidlets(squad) != (unsigned long)nbSquidlet) {
+      TheSquidErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(TheSquidErr->_msg, "SquadBenchmarkProtocol failed");
+      PBErrCatch(TheSquidErr);
+    }
     // Kill the child process
     for (int iSquidlet = 0; iSquidlet < nbSquidlet; ++iSquidlet) {
       if (kill(pidSquidlet[iSquidlet], SIGINT) < 0) {
@@ -485,9 +532,41 @@ void UnitTestEvalNeuranet() {
       VecSet(ids, 0, id);
       VecSet(ids, 1, id + 1);
       SquadAddTask_EvalNeuraNet(squad, id, maxWait,
-        "./dataset.json", "./", ids, best, cat);
+        "./dataset.json", "./", ids, best, cat, false, 1);
+    }
+    // Add the evaluation of the first pair of NeuraNets sharded on 
+    // the squidlets, its result must be the same as the non sharded 
+    // one
+    unsigned long idSharded = 100;
+    VecSet(ids, 0, 0);
+    VecSet(ids, 1, 1);
+    SquadAddTask_EvalNeuraNet(squad, idSharded, maxWait,
+      "./dataset.json", "./", ids, best, cat, false, nbSquidlet);
+    // Add twice the evaluation of the first pair of NeuraNets sent 
+    // inline with the task, the second time they may be already in 
+    // the cache of the squidlet, the results must be the same as the
+    // one loaded from the working directory
+    unsigned long idInline = 200;
+    NeuraNet* nns[2] = {NULL, NULL};
+    for (int iNN = 0; iNN < 2; ++iNN) {
+      sprintf(buffer, "./nn%d.json", iNN);
+      FILE* fpnn = fopen(buffer, "r");
+      if (fpnn == NULL || !NNLoad(nns + iNN, fpnn)) {
+        TheSquidErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(TheSquidErr->_msg, "NNLoad failed");
+        PBErrCatch(TheSquidErr);
+      }
+      fclose(fpnn);
     }
+    for (int iTask = 0; iTask < 2; ++iTask) {
+      SquadAddTask_EvalNeuraNetInline(squad, idInline + iTask, maxWait,
+        "./dataset.json", nns, ids, best, cat, false, 1);
+    }
+    NeuraNetFree(nns);
+    NeuraNetFree(nns + 1);
     VecFree(&ids);
+    VecFloat* values[4] = {NULL, NULL, NULL, NULL};
+    int nbShardedResult = 0;
 
     // Loop until all the tasks are completed or give up after 60s
     time_t startTime = time(NULL);
@@ -507,12 +586,65 @@ void UnitTestEvalNeuranet() {
           flagStop = true;
         } else {
           printf(" succeeded\n");
+          if (task->_id == 0 || task->_id == idSharded || 
+            task->_id == idInline || task->_id == idInline + 1) {
+            int iValues = 0;
+            if (task->_id == idSharded)
+              iValues = 1;
+            else if (task->_id >= idInline)
+              iValues = 2 + task->_id - idInline;
+            JSONNode* json = JSONCreate();
+            JSONLoadFromStr(json, task->_bufferResult);
+            VecDecodeAsJSON(values + iValues, JSONProperty(json, "v"));
+            JSONFree(&json);
+            if (task->_id == idSharded)
+              ++nbShardedResult;
+          }
         }
+        SquidletTaskRequestFree(&(completedTask->_request));
         SquadRunningTaskFree(&completedTask);
       }
       
     } while (SquadGetNbTaskToComplete(squad) > 0L && 
       time(NULL) - startTime <= 60 && !flagStop);
+    // Check the result of the sharded evaluation
+    if (nbShardedResult != 1 || values[0] == NULL || 
+      values[1] == NULL || VecGetDim(values[0]) != VecGetDim(values[1])) {
+      TheSquidErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(TheSquidErr->_msg, "sharded evaluation failed");
+      PBErrCatch(TheSquidErr);
+    }
+    for (long iNN = VecGetDim(values[0]); iNN--;) {
+      if (fabs(VecGet(values[0], iNN) - VecGet(values[1], iNN)) > 
+        0.0001 * (1.0 + fabs(VecGet(values[0], iNN)))) {
+        TheSquidErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(TheSquidErr->_msg, 
+          "sharded evaluation failed (nn%ld: %f!=%f)", iNN, 
+          VecGet(values[1], iNN), VecGet(values[0], iNN));
+        PBErrCatch(TheSquidErr);
+      }
+    }
+    // Check the result of the evaluations with inlined NeuraNets
+    for (int iValues = 2; iValues < 4; ++iValues) {
+      if (values[iValues] == NULL || 
+        VecGetDim(values[0]) != VecGetDim(values[iValues])) {
+        TheSquidErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(TheSquidErr->_msg, "inline evaluation failed");
+        PBErrCatch(TheSquidErr);
+      }
+      for (long iNN = VecGetDim(values[0]); iNN--;) {
+        if (fabs(VecGet(values[0], iNN) - VecGet(values[iValues], iNN)) >
+          0.0001 * (1.0 + fabs(VecGet(values[0], iNN)))) {
+          TheSquidErr->_type = PBErrTypeUnitTestFailed;
+          sprintf(TheSquidErr->_msg, 
+            "inline evaluation failed (nn%ld: %f!=%f)", iNN, 
+            VecGet(values[iValues], iNN), VecGet(values[0], iNN));
+          PBErrCatch(TheSquidErr);
+        }
+      }
+    }
+    for (int iValues = 4; iValues--;)
+      VecFree(values + iValues);
     // Kill the child process
     for (int iSquidlet = 0; iSquidlet < nbSquidlet; ++iSquidlet) {
       if (kill(pidSquidlet[iSquidlet], SIGINT) < 0) {
@@ -529,6 +661,1182 @@ void UnitTestEvalNeuranet() {
   }
 }
 
+void UnitTestEvalNeuranetBatch() {
+  Squidlet* squidlet = SquidletCreate();
+  if (squidlet == NULL) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquidletCreate failed");
+    PBErrCatch(TheSquidErr);
+  }
+  // Evaluate the NeuraNets with the squidlet, in one single pass 
+  // on the dataset, with one thread and several threads
+  const int nbNN = 4;
+  long cat = 0;
+  float best = -1000.0;
+  char buffer[THESQUID_MAXPAYLOADSIZE];
+  sprintf(buffer, 
+    "{\"id\":\"0\",\"subid\":\"0\",\"dataset\":\"./dataset.json\","
+    "\"workingDir\":\"./\",\"nnids\":{\"_dim\":\"%d\",\"_val\":"
+    "[\"0\",\"1\",\"2\",\"3\"]},\"best\":\"%f\",\"cat\":\"%ld\"}",
+    nbNN, best, cat);
+  int nbThreads[2] = {1, 4};
+  VecFloat* values[2] = {NULL, NULL};
+  for (int iRun = 0; iRun < 2; ++iRun) {
+    SquidletSetNbThread(squidlet, nbThreads[iRun]);
+    char* result = NULL;
+    SquidletProcessRequest_EvalNeuranet(squidlet, buffer, &result);
+    JSONNode* json = JSONCreate();
+    if (strstr(result, "\"success\":\"1\"") == NULL ||
+      JSONLoadFromStr(json, result) == false ||
+      VecDecodeAsJSON(values + iRun, JSONProperty(json, "v")) == false ||
+      VecGetDim(values[iRun]) != nbNN) {
+      TheSquidErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(TheSquidErr->_msg, 
+        "SquidletProcessRequest_EvalNeuranet failed (%s)", result);
+      PBErrCatch(TheSquidErr);
+    }
+    JSONFree(&json);
+    free(result);
+  }
+  // Check the values against the evaluation of the NeuraNets one 
+  // by one
+  GDataSetVecFloat dataset = 
+    GDataSetVecFloatCreateStaticFromFile("./dataset.json");
+  for (int iNN = 0; iNN < nbNN; ++iNN) {
+    sprintf(buffer, "./nn%d.json", iNN);
+    FILE* fp = fopen(buffer, "r");
+    NeuraNet* nn = NULL;
+    NNLoad(&nn, fp);
+    fclose(fp);
+    VecShort* inputs = VecShortCreate(NNGetNbInput(nn));
+    for (long i = VecGetDim(inputs); i--;)
+      VecSet(inputs, i, i);
+    VecShort* outputs = VecShortCreate(NNGetNbOutput(nn));
+    for (long i = VecGetDim(outputs); i--;)
+      VecSet(outputs, i, VecGetDim(inputs) + i);
+    float check = 
+      GDSEvaluateNN(&dataset, nn, cat, inputs, outputs, best);
+    for (int iRun = 0; iRun < 2; ++iRun) {
+      if (fabs(check - VecGet(values[iRun], iNN)) > 
+        0.0001 * (1.0 + fabs(check))) {
+        TheSquidErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(TheSquidErr->_msg, 
+          "TheSquidEvalNeuraNets failed (nn%d, %d threads: %f!=%f)", 
+          iNN, nbThreads[iRun], VecGet(values[iRun], iNN), check);
+        PBErrCatch(TheSquidErr);
+      }
+    }
+    VecFree(&inputs);
+    VecFree(&outputs);
+    NeuraNetFree(&nn);
+  }
+  GDataSetVecFloatFreeStatic(&dataset);
+  // Evaluate in fast reject mode with a threshold which can't be 
+  // beaten, each NeuraNet must stop after the first sample and report
+  // an upper bound of its value
+  sprintf(buffer, 
+    "{\"id\":\"0\",\"subid\":\"0\",\"dataset\":\"./dataset.json\","
+    "\"workingDir\":\"./\",\"nnids\":{\"_dim\":\"%d\",\"_val\":"
+    "[\"0\",\"1\",\"2\",\"3\"]},\"best\":\"0.0\",\"cat\":\"%ld\","
+    "\"reject\":\"1\"}", nbNN, cat);
+  char* result = NULL;
+  SquidletProcessRequest_EvalNeuranet(squidlet, buffer, &result);
+  JSONNode* json = JSONCreate();
+  VecFloat* bounds = NULL;
+  VecLong* nbEvals = NULL;
+  if (strstr(result, "\"success\":\"1\"") == NULL ||
+    JSONLoadFromStr(json, result) == false ||
+    VecDecodeAsJSON(&bounds, JSONProperty(json, "v")) == false ||
+    VecDecodeAsJSON(&nbEvals, JSONProperty(json, "nbSample")) == false) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, 
+      "SquidletProcessRequest_EvalNeuranet failed (%s)", result);
+    PBErrCatch(TheSquidErr);
+  }
+  for (int iNN = 0; iNN < nbNN; ++iNN) {
+    if (VecGet(nbEvals, iNN) != 1 ||
+      VecGet(bounds, iNN) < VecGet(values[0], iNN)) {
+      TheSquidErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(TheSquidErr->_msg, 
+        "TheSquidEvalNeuraNets failed (nn%d, bound %f<%f, nb %ld)", 
+        iNN, VecGet(bounds, iNN), VecGet(values[0], iNN),
+        VecGet(nbEvals, iNN));
+      PBErrCatch(TheSquidErr);
+    }
+  }
+  VecFree(&bounds);
+  VecFree(&nbEvals);
+  JSONFree(&json);
+  free(result);
+  VecFree(values);
+  VecFree(values + 1);
+  SquidletFree(&squidlet);
+  printf("UnitTestEvalNeuranetBatch OK\n");
+}
+
+void UnitTestEvalNeuranetShards() {
+  Squidlet* squidlet = SquidletCreate();
+  Squad* squad = SquadCreate();
+  const int nbNN = 4;
+  const unsigned int nbShard = 3;
+  long cat = 0;
+  VecLong* ids = VecLongCreate(nbNN);
+  for (int iNN = nbNN; iNN--;)
+    VecSet(ids, iNN, iNN);
+  // Create a dataset with less samples than ranges
+  FILE* fp = fopen("unitTestEvalNeuranetShards.json", "w");
+  fprintf(fp, "{\"dataSet\":\"./unitTestEvalNeuranetShards.json\","
+    "\"dataSetType\":\"0\",\"desc\":\"\",\"nbSample\":\"2\","
+    "\"dim\":{\"_dim\":\"1\",\"_val\":\"11\"},\"samples\":["
+    "{\"_dim\":\"11\",\"_val\":[\"1.0\",\"0.0\",\"0.0\",\"0.455\","
+    "\"0.365\",\"0.095\",\"0.514\",\"0.2245\",\"0.101\",\"0.15\","
+    "\"15.0\"]},"
+    "{\"_dim\":\"11\",\"_val\":[\"1.0\",\"0.0\",\"0.0\",\"0.35\","
+    "\"0.265\",\"0.09\",\"0.2255\",\"0.0995\",\"0.0485\",\"0.07\","
+    "\"7.0\"]}]}");
+  fclose(fp);
+  // Evaluate the NeuraNets on one single range, and split in ranges 
+  // with the same id, the first time with a best value which can't be 
+  // missed, the second time with one which can't be beaten, the third 
+  // time with more ranges than samples. The ranges are completed by 
+  // the squidlet and merged by the squad
+  const char* datasets[3] = {"./dataset.json", "./dataset.json", 
+    "./unitTestEvalNeuranetShards.json"};
+  float best[3] = {-1000.0, 0.0, -1000.0};
+  unsigned int nbShards[3] = {nbShard, nbShard, 5};
+  VecFloat* values[3][2] = {{NULL, NULL}, {NULL, NULL}, {NULL, NULL}};
+  VecLong* nbEvals = NULL;
+  for (int iRun = 0; iRun < 3; ++iRun) {
+    SquadAddTask_EvalNeuraNet(squad, 1, 60, datasets[iRun], "./", 
+      ids, best[iRun], cat, false, 1);
+    SquadAddTask_EvalNeuraNet(squad, 1, 60, datasets[iRun], "./", 
+      ids, best[iRun], cat, false, nbShards[iRun]);
+    int nbReturned = 0;
+    while (SquadGetNbRemainingTasks(squad) > 0L) {
+      SquidletTaskRequest* task = GSetPop((GSet*)SquadTasks(squad));
+      SquidletProcessRequest_EvalNeuranet(squidlet, task->_data, 
+        &(task->_bufferResult));
+      if (SquadProcessCompletedTask_EvalNeuranet(squad, task) == true) {
+        JSONNode* json = JSONCreate();
+        if (nbReturned > 1 || 
+          JSONLoadFromStr(json, task->_bufferResult) == false ||
+          VecDecodeAsJSON(values[iRun] + nbReturned, 
+            JSONProperty(json, "v")) == false) {
+          TheSquidErr->_type = PBErrTypeUnitTestFailed;
+          sprintf(TheSquidErr->_msg, 
+            "SquadProcessCompletedTask_EvalNeuranet failed (%s)", 
+            task->_bufferResult);
+          PBErrCatch(TheSquidErr);
+        }
+        if (iRun == 1 && nbReturned == 1)
+          VecDecodeAsJSON(&nbEvals, JSONProperty(json, "nbSample"));
+        JSONFree(&json);
+        ++nbReturned;
+      }
+      SquidletTaskRequestFree(&task);
+    }
+    if (nbReturned != 2 || GSetNbElem(&(squad->_evalNNShards)) != 0) {
+      TheSquidErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(TheSquidErr->_msg, 
+        "SquadProcessCompletedTask_EvalNeuranet failed (%d)", nbReturned);
+      PBErrCatch(TheSquidErr);
+    }
+  }
+  // The merged values must be the ones of the single range, and the 
+  // upper bounds of the values if the evaluations have been stopped in 
+  // each range after their first sample
+  for (int iNN = 0; iNN < nbNN; ++iNN) {
+    float check = VecGet(values[0][0], iNN);
+    float checkEmpty = VecGet(values[2][0], iNN);
+    if (fabs(check - VecGet(values[0][1], iNN)) > 
+      0.0001 * (1.0 + fabs(check)) ||
+      nbEvals == NULL || VecGet(nbEvals, iNN) != (long)nbShard ||
+      VecGet(values[1][1], iNN) < check ||
+      fabs(checkEmpty - VecGet(values[2][1], iNN)) > 
+      0.0001 * (1.0 + fabs(checkEmpty))) {
+      TheSquidErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(TheSquidErr->_msg, 
+        "SquadProcessCompletedTask_EvalNeuranet failed (nn%d: %f!=%f)", 
+        iNN, VecGet(values[0][1], iNN), check);
+      PBErrCatch(TheSquidErr);
+    }
+  }
+  unlink("unitTestEvalNeuranetShards.json");
+  for (int iRun = 3; iRun--;) {
+    VecFree(values[iRun]);
+    VecFree(values[iRun] + 1);
+  }
+  VecFree(&nbEvals);
+  // If a failed range is dropped by the user the evaluation is 
+  // abandoned and the other ranges are ignored
+  SquadAddTask_EvalNeuraNet(squad, 2, 0, "./dataset.json", "./", 
+    ids, best[0], cat, false, nbShard);
+  SquidletTaskRequest* task = GSetPop((GSet*)SquadTasks(squad));
+  task->_bufferResult = strdup("{\"success\":\"0\"}");
+  if (SquadProcessCompletedTask_EvalNeuranet(squad, task) == false) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, 
+      "SquadProcessCompletedTask_EvalNeuranet failed");
+    PBErrCatch(TheSquidErr);
+  }
+  SquidletTaskRequestFree(&task);
+  SquadPurgeEvalNNShards(squad);
+  if (GSetNbElem(&(squad->_evalNNShards)) != 0) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadPurgeEvalNNShards failed");
+    PBErrCatch(TheSquidErr);
+  }
+  while (SquadGetNbRemainingTasks(squad) > 0L) {
+    task = GSetPop((GSet*)SquadTasks(squad));
+    SquidletProcessRequest_EvalNeuranet(squidlet, task->_data, 
+      &(task->_bufferResult));
+    if (SquadProcessCompletedTask_EvalNeuranet(squad, task) == true) {
+      TheSquidErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(TheSquidErr->_msg, 
+        "SquadProcessCompletedTask_EvalNeuranet failed");
+      PBErrCatch(TheSquidErr);
+    }
+    SquidletTaskRequestFree(&task);
+  }
+  VecFree(&ids);
+  SquadFree(&squad);
+  SquidletFree(&squidlet);
+  printf("UnitTestEvalNeuranetShards OK\n");
+}
+
+void UnitTestNeuraNetCache() {
+  Squad* squad = SquadCreate();
+  SquidletInfo* squidlet = SquidletInfoCreate("cache", "0.0.0.0", 9000);
+  NeuraNet* nns[2] = {NULL, NULL};
+  for (int iNN = 0; iNN < 2; ++iNN) {
+    char path[20];
+    sprintf(path, "./nn%d.json", iNN);
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL || !NNLoad(nns + iNN, fp)) {
+      TheSquidErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(TheSquidErr->_msg, "NNLoad failed");
+      PBErrCatch(TheSquidErr);
+    }
+    fclose(fp);
+  }
+  VecLong* ids = VecLongCreate(2);
+  VecSet(ids, 0, 0);
+  VecSet(ids, 1, 1);
+  SquadAddTask_EvalNeuraNetInline(squad, 1, 60, "./dataset.json", nns, 
+    ids, -1000.0, 0, false, 1);
+  SquidletTaskRequest* task = GSetPop((GSet*)SquadTasks(squad));
+  // The first time the definitions are sent, and memorized as known by 
+  // the squidlet
+  GSet sentHashes = GSetCreateStatic();
+  GSet taskHashes = GSetCreateStatic();
+  char* data = 
+    SquadGetTaskDataForSquidlet(task, squidlet, &sentHashes, &taskHashes);
+  if (data == NULL || strstr(data, "\"nns\":{") == NULL ||
+    GSetNbElem(&sentHashes) != 2 || GSetNbElem(&taskHashes) != 2) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadGetTaskDataForSquidlet failed");
+    PBErrCatch(TheSquidErr);
+  }
+  free(data);
+  while (GSetNbElem(&sentHashes) > 0) {
+    char* hash = GSetPop(&sentHashes);
+    SquidletInfoAddNeuraNet(squidlet, hash, &taskHashes);
+    free(hash);
+  }
+  // Fill the cache with other NeuraNets, then add one more while the 
+  // task is sent, the NeuraNets of the task are the oldest ones but 
+  // must not be replaced
+  GSet noHash = GSetCreateStatic();
+  for (int iNN = 2; iNN < THESQUID_NBNNCACHE; ++iNN) {
+    char hash[THESQUID_NNHASHLENGTH + 1];
+    sprintf(hash, "%d", iNN);
+    SquidletInfoAddNeuraNet(squidlet, hash, &noHash);
+  }
+  SquidletInfoAddNeuraNet(squidlet, "new", &taskHashes);
+  while (GSetNbElem(&taskHashes) > 0) {
+    char* hash = GSetPop(&taskHashes);
+    free(hash);
+  }
+  // The NeuraNets are known, their definitions are stripped from the 
+  // data
+  data = 
+    SquadGetTaskDataForSquidlet(task, squidlet, &sentHashes, &taskHashes);
+  if (data == NULL || strstr(data, "\"nns\":{") != NULL ||
+    strstr(data, "\"nnhashes\":") == NULL ||
+    strlen(data) >= strlen(task->_data) ||
+    GSetNbElem(&sentHashes) != 0 || GSetNbElem(&taskHashes) != 2) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadGetTaskDataForSquidlet failed");
+    PBErrCatch(TheSquidErr);
+  }
+  free(data);
+  while (GSetNbElem(&taskHashes) > 0) {
+    char* hash = GSetPop(&taskHashes);
+    free(hash);
+  }
+  SquidletTaskRequestFree(&task);
+  VecFree(&ids);
+  NeuraNetFree(nns);
+  NeuraNetFree(nns + 1);
+  SquidletInfoFree(&squidlet);
+  SquadFree(&squad);
+  printf("UnitTestNeuraNetCache OK\n");
+}
+
+void UnitTestHisto() {
+  TheSquidHisto histo = TheSquidHistoCreateStatic();
+  for (int i = 1; i <= 1000; ++i)
+    TheSquidHistoAdd(&histo, (float)i);
+  float p50 = TheSquidHistoGetQuantile(&histo, 0.5);
+  float p99 = TheSquidHistoGetQuantile(&histo, 0.99);
+  if (histo._nb != 1000 || 
+    fabs(TheSquidHistoGetMean(&histo) - 500.5) > 0.0001 ||
+    fabs(p50 - 500.0) > 500.0 * 0.2 || fabs(p99 - 990.0) > 990.0 * 0.2 ||
+    TheSquidHistoGetQuantile(&histo, 1.0) > 1000.0 ||
+    TheSquidHistoGetQuantile(&histo, 0.0) < 1.0) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "TheSquidHisto failed");
+    PBErrCatch(TheSquidErr);
+  }
+  TheSquidHisto histoB = TheSquidHistoCreateStatic();
+  for (int i = 1001; i <= 2000; ++i)
+    TheSquidHistoAdd(&histoB, (float)i);
+  TheSquidHistoMerge(&histo, &histoB);
+  float p999 = TheSquidHistoGetQuantile(&histo, 0.999);
+  if (histo._nb != 2000 || histo._min > 1.0 || histo._max < 2000.0 ||
+    fabs(TheSquidHistoGetQuantile(&histo, 0.5) - 1000.0) > 1000.0 * 0.1 ||
+    fabs(p999 - 1998.0) > 1998.0 * 0.1) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "TheSquidHistoMerge failed");
+    PBErrCatch(TheSquidErr);
+  }
+  TheSquidHistoPrint(&histo, stdout);
+  printf("\n");
+  char* str = TheSquidHistoToStr(&histo);
+  TheSquidHistoReset(&histoB);
+  if (TheSquidHistoFromStr(&histoB, str) == false ||
+    histoB._nb != histo._nb || histoB._max != histo._max ||
+    memcmp(histoB._counts, histo._counts, sizeof(histo._counts)) != 0 ||
+    TheSquidHistoFromStr(&histoB, "2 3.0 1.0 2.0;0:1") == true ||
+    histoB._nb != 0) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "TheSquidHistoToStr/FromStr failed");
+    PBErrCatch(TheSquidErr);
+  }
+  free(str);
+  TheSquidHistoReset(&histo);
+  if (histo._nb != 0 || TheSquidHistoGetQuantile(&histo, 0.5) != 0.0) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "TheSquidHistoReset failed");
+    PBErrCatch(TheSquidErr);
+  }
+  printf("UnitTestHisto OK\n");
+}
+
+void UnitTestBenchmarkConfig() {
+  // Create a benchmark config file with a short grid of parameters
+  FILE* fp = fopen("unitTestBenchmarkConfig.json", "w");
+  fprintf(fp, "{\"payloadSizes\":[\"9\"],\"nbLoops\":[\"1\",\"2\"],"
+    "\"warmUpMs\":\"100\",\"sampleMs\":\"100\","
+    "\"minLengthMs\":\"500\",\"maxLengthMs\":\"1000\","
+    "\"targetCI\":\"0.05\",\"format\":\"csv\"}");
+  fclose(fp);
+  SquadBenchmarkConfig config = SquadBenchmarkConfigCreateStatic();
+  fp = fopen("unitTestBenchmarkConfig.json", "r");
+  if (SquadBenchmarkConfigLoad(&config, fp) == false ||
+    VecGetDim(config._payloadSizes) != 1 ||
+    VecGet(config._payloadSizes, 0) != 9 ||
+    VecGetDim(config._nbLoops) != 2 ||
+    VecGet(config._nbLoops, 1) != 2 ||
+    fabs(config._minLengthMs - 500.0) > 0.0001 ||
+    fabs(config._targetCI - 0.05) > 0.0001 ||
+    config._format != SquadBenchmarkFormat_CSV) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadBenchmarkConfigLoad failed");
+    PBErrCatch(TheSquidErr);
+  }
+  fclose(fp);
+  // Run the benchmark on the local device
+  Squad* squad = SquadCreate();
+  SquadBenchmarkWithConfig(squad, &config, stdout);
+  SquadFree(&squad);
+  SquadBenchmarkConfigFreeStatic(&config);
+  unlink("unitTestBenchmarkConfig.json");
+  printf("UnitTestBenchmarkConfig OK\n");
+}
+
+void UnitTestMetrics() {
+  Squad* squad = SquadCreate();
+  int port = 9100;
+  if (SquadSetMetricsPort(squad, port) == false) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadSetMetricsPort failed");
+    PBErrCatch(TheSquidErr);
+  }
+  // Scrape the metrics, the connection is pending until the next step
+  int sock = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  if (connect(sock, (struct sockaddr*)&addr, sizeof(addr)) == -1) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "connect to the metrics endpoint failed");
+    PBErrCatch(TheSquidErr);
+  }
+  char* request = "GET /metrics HTTP/1.0\r\n\r\n";
+  (void)send(sock, request, strlen(request), 0);
+  GSetSquadRunningTask completedTasks = SquadStep(squad);
+  (void)completedTasks;
+  char reply[10000] = {0};
+  size_t len = 0;
+  ssize_t nb = 0;
+  do {
+    nb = recv(sock, reply + len, sizeof(reply) - 1 - len, 0);
+    if (nb > 0)
+      len += nb;
+  } while (nb > 0 && len < sizeof(reply) - 1);
+  close(sock);
+  printf("%s\n", reply);
+  if (strstr(reply, "HTTP/1.0 200 OK") == NULL ||
+    strstr(reply, "thesquid_squad_tasks_queued 0") == NULL) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadPrintMetrics failed");
+    PBErrCatch(TheSquidErr);
+  }
+  SquadFree(&squad);
+  printf("UnitTestMetrics OK\n");
+}
+
+void UnitTestThermal() {
+  Squad* squad = SquadCreate();
+  SquidletInfo* squidlet = SquidletInfoCreate("thermal", "0.0.0.0", 9000);
+  SquadSetThermalThresholds(squad, 60.0, 70.0);
+  SquadSetThermalHorizon(squad, 0);
+  char* results[6] = {
+    "{\"success\":\"1\",\"temperature\":\"50.00\"}", 
+    "{\"success\":\"1\",\"temperature\":\"65.00\"}", 
+    "{\"success\":\"1\",\"temperature\":\"75.00\"}", 
+    "{\"success\":\"1\",\"temperature\":\"65.00\"}", 
+    "{\"success\":\"1\",\"temperature\":\"55.00\"}", 
+    "{\"success\":\"1\",\"temperature\":\"40.00\",\"throttled\":\"1\"}"};
+  SquidletThermalState check[6] = {
+    SquidletThermalState_Cool, SquidletThermalState_Warm, 
+    SquidletThermalState_Hot, SquidletThermalState_Hot, 
+    SquidletThermalState_Cool, SquidletThermalState_Hot};
+  for (int iResult = 0; iResult < 6; ++iResult) {
+    SquadUpdateSquidletThermal(squad, squidlet, results[iResult]);
+    if (SquadGetSquidletThermalState(squad, squidlet) != check[iResult]) {
+      TheSquidErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(TheSquidErr->_msg, 
+        "SquadGetSquidletThermalState failed (%d)", iResult);
+      PBErrCatch(TheSquidErr);
+    }
+  }
+  SquidletInfoFree(&squidlet);
+  SquadFree(&squad);
+  printf("UnitTestThermal OK\n");
+}
+
+void UnitTestThermalCoolDown() {
+  // The temperature of the squidlet, shared with its process
+  float* temperature = mmap(NULL, sizeof(float), PROT_READ | PROT_WRITE, 
+    MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  float hot = 90.0;
+  __atomic_store(temperature, &hot, __ATOMIC_RELAXED);
+  int port = 9220;
+  pid_t pid = fork();
+  if (pid == 0) {
+    Squidlet* squidlet = SquidletCreateOnPort(0, port);
+    SquidletSetThermalSource(squidlet, TheSquidThermalSourceStub, 
+      temperature, 100);
+    do {
+      SquidletTaskRequest request = SquidletWaitRequest(squidlet);
+      SquidletProcessRequest(squidlet, &request);
+    } while (!Squidlet_CtrlC);
+    SquidletFree(&squidlet);
+    exit(0);
+  }
+  // The stats are requested only on demand, the squidlet goes hot at 
+  // its first stats and must get the task once it has cooled down
+  Squad* squad = SquadCreate();
+  SquadSetStatsPeriod(squad, 0);
+  SquadSetThermalHorizon(squad, 0);
+  SquidletInfo* squidlet = SquidletInfoCreate("hot", "127.0.0.1", port);
+  GSetAppend((GSet*)SquadSquidlets(squad), squidlet);
+  sleep(1);
+  SquadAddTask_Dummy(squad, 1, 5);
+  unsigned long nbCompleted = 0;
+  bool wasHot = false;
+  time_t startTime = time(NULL);
+  do {
+    usleep(10000);
+    GSetSquadRunningTask completedTasks = SquadStep(squad);
+    while (GSetNbElem(&completedTasks) > 0L) {
+      SquadRunningTask* completedTask = GSetPop(&completedTasks);
+      if (wasHot == false) {
+        TheSquidErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(TheSquidErr->_msg, "task sent to a hot squidlet");
+        PBErrCatch(TheSquidErr);
+      }
+      ++nbCompleted;
+      SquidletTaskRequestFree(&(completedTask->_request));
+      SquadRunningTaskFree(&completedTask);
+    }
+    if (wasHot == false && 
+      SquadGetSquidletThermalState(squad, squidlet) == 
+        SquidletThermalState_Hot) {
+      wasHot = true;
+      float cool = 40.0;
+      __atomic_store(temperature, &cool, __ATOMIC_RELAXED);
+    }
+  } while (nbCompleted == 0 && time(NULL) - startTime <= 15);
+  if (wasHot == false || nbCompleted != 1 ||
+    SquadGetSquidletThermalState(squad, squidlet) != 
+      SquidletThermalState_Cool) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadSendStatsHeartbeat failed");
+    PBErrCatch(TheSquidErr);
+  }
+  kill(pid, SIGINT);
+  waitpid(pid, NULL, 0);
+  SquadFree(&squad);
+  munmap(temperature, sizeof(float));
+  printf("UnitTestThermalCoolDown OK\n");
+}
+
+void UnitTestEventLog() {
+  char* path = "./unitTestEventLog.bin";
+  TheSquidEventLog* log = TheSquidEventLogCreate(path, "unitTest");
+  if (log == NULL) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "TheSquidEventLogCreate failed");
+    PBErrCatch(TheSquidErr);
+  }
+  TheSquidEventLogPush(log, TheSquidEventType_SendTask, 
+    SquidletTaskType_Dummy, 1, 2, 9000, 123);
+  TheSquidEventLogPush(log, TheSquidEventType_TaskCompleted, 
+    SquidletTaskType_Dummy, 1, 2, 9000, 45);
+  TheSquidEventLogFree(&log);
+  FILE* stream = fopen(path, "rb");
+  char* text = NULL;
+  size_t len = 0;
+  FILE* out = open_memstream(&text, &len);
+  bool ret = TheSquidEventLogDecode(stream, out, false);
+  fclose(out);
+  fclose(stream);
+  if (ret == false || strstr(text, "unitTest") == NULL ||
+    strstr(text, "SendTask Dummy 1/2 9000 123") == NULL ||
+    strstr(text, "TaskCompleted Dummy 1/2 9000 45") == NULL) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "TheSquidEventLogDecode failed");
+    PBErrCatch(TheSquidErr);
+  }
+  free(text);
+  printf("UnitTestEventLog OK\n");
+}
+
+void UnitTestDiscovery() {
+  Squad* squad = SquadCreate();
+  SquadSetStatsPeriod(squad, 0);
+  int port = 9150;
+  if (SquadSetDiscoveryPort(squad, port) == false) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadSetDiscoveryPort failed");
+    PBErrCatch(TheSquidErr);
+  }
+  Squidlet* squidlet = SquidletCreate();
+  if (SquidletSetAnnounce(squidlet, "127.0.0.1", port) == false) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquidletSetAnnounce failed");
+    PBErrCatch(TheSquidErr);
+  }
+  usleep(100000);
+  GSetSquadRunningTask completedTasks = SquadStep(squad);
+  (void)completedTasks;
+  if (SquadGetNbSquidlets(squad) != 1) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadDiscoverSquidlets failed (hello)");
+    PBErrCatch(TheSquidErr);
+  }
+  SquidletFree(&squidlet);
+  usleep(100000);
+  completedTasks = SquadStep(squad);
+  if (SquadGetNbSquidlets(squad) != 0) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadDiscoverSquidlets failed (bye)");
+    PBErrCatch(TheSquidErr);
+  }
+  SquadFree(&squad);
+  printf("UnitTestDiscovery OK\n");
+}
+
+void UnitTestQuarantine() {
+  SquidletInfo* squidlet = SquidletInfoCreate("lost", "0.0.0.0", 9000);
+  if (SquidletInfoIsQuarantined(squidlet) == true) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquidletInfoIsQuarantined failed");
+    PBErrCatch(TheSquidErr);
+  }
+  time_t check[8] = {5, 10, 20, 40, 80, 160, 300, 300};
+  for (int iLost = 0; iLost < 8; ++iLost) {
+    SquidletInfoQuarantine(squidlet);
+    if (SquidletInfoIsQuarantined(squidlet) == false ||
+      squidlet->_quarantineDelay != check[iLost]) {
+      TheSquidErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(TheSquidErr->_msg, 
+        "SquidletInfoQuarantine failed (%d)", iLost);
+      PBErrCatch(TheSquidErr);
+    }
+  }
+  SquidletInfoFree(&squidlet);
+  printf("UnitTestQuarantine OK\n");
+}
+
+void UnitTestCircuitBreaker() {
+  SquidletInfo* squidlet = SquidletInfoCreate("down", "0.0.0.0", 9000);
+  SquidletHealth check[4] = {
+    SquidletHealth_Closed, SquidletHealth_Closed, 
+    SquidletHealth_Open, SquidletHealth_Open};
+  for (int iFailure = 0; iFailure < 3; ++iFailure) {
+    SquidletInfoReportFailure(squidlet);
+    if (SquidletInfoGetHealth(squidlet) != check[iFailure]) {
+      TheSquidErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(TheSquidErr->_msg, 
+        "SquidletInfoReportFailure failed (%d)", iFailure);
+      PBErrCatch(TheSquidErr);
+    }
+  }
+  // End the quarantine, the probe fails
+  squidlet->_timeQuarantineEnd = 0;
+  if (SquidletInfoGetHealth(squidlet) != SquidletHealth_HalfOpen) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquidletInfoGetHealth failed");
+    PBErrCatch(TheSquidErr);
+  }
+  SquidletInfoReportFailure(squidlet);
+  if (SquidletInfoGetHealth(squidlet) != check[3] ||
+    squidlet->_quarantineDelay != 2 * SQUAD_QUARANTINEMIN) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquidletInfoReportFailure failed");
+    PBErrCatch(TheSquidErr);
+  }
+  // End the quarantine, the probe succeeds
+  squidlet->_timeQuarantineEnd = 0;
+  SquidletInfoReportSuccess(squidlet);
+  if (SquidletInfoGetHealth(squidlet) != SquidletHealth_Closed ||
+    squidlet->_nbFailure != 0) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquidletInfoReportSuccess failed");
+    PBErrCatch(TheSquidErr);
+  }
+  SquidletInfoFree(&squidlet);
+  printf("UnitTestCircuitBreaker OK\n");
+}
+
+void UnitTestDispatch() {
+  Squad* squad = SquadCreate();
+  char* squidlets = "{\"_squidlets\":["
+    "{\"_name\":\"a\",\"_ip\":\"127.0.0.1\",\"_port\":\"9160\"},"
+    "{\"_name\":\"b\",\"_ip\":\"127.0.0.1\",\"_port\":\"9161\"},"
+    "{\"_name\":\"c\",\"_ip\":\"127.0.0.1\",\"_port\":\"9162\"}]}";
+  if (SquadLoadSquidletsFromStr(squad, squidlets) == false) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadLoadSquidletsFromStr failed");
+    PBErrCatch(TheSquidErr);
+  }
+  for (unsigned long id = 0; id < 3; ++id)
+    SquadAddTask_Dummy(squad, id, 5);
+  // No squidlet is listening, all the requests must fail at once
+  time_t start = time(NULL);
+  GSetSquadRunningTask completedTasks = SquadStep(squad);
+  if (time(NULL) - start >= SQUAD_REQUESTTIMEOUT ||
+    GSetNbElem(&completedTasks) != 0 ||
+    SquadGetNbRunningTasks(squad) != 0 ||
+    SquadGetNbRemainingTasks(squad) != 3 ||
+    SquadGetNbSquidlets(squad) != 3) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadStep failed");
+    PBErrCatch(TheSquidErr);
+  }
+  GSetIterForward iter = 
+    GSetIterForwardCreateStatic((GSet*)SquadSquidlets(squad));
+  do {
+    SquidletInfo* squidlet = GSetIterGet(&iter);
+    if (squidlet->_nbFailure == 0 || squidlet->_sock != -1) {
+      TheSquidErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(TheSquidErr->_msg, "SquadStepDispatch failed");
+      PBErrCatch(TheSquidErr);
+    }
+  } while (GSetIterStep(&iter));
+  SquadFree(&squad);
+  printf("UnitTestDispatch OK\n");
+}
+
+void UnitTestBatch() {
+  int pid = fork();
+  if (pid == 0) {
+    // In the squidlet process, behind the relay
+    Squidlet* squidlet = SquidletCreateOnPort(0, 9170);
+    if (squidlet == NULL) {
+      printf("Failed to create the squidlet\n");
+      printf("errno: %s\n", strerror(errno));
+      exit(0);
+    }
+    do {
+      SquidletTaskRequest request = SquidletWaitRequest(squidlet);
+      SquidletProcessRequest(squidlet, &request);
+    } while (!Squidlet_CtrlC);
+    SquidletFree(&squidlet);
+    exit(0);
+  }
+  // Create the relay
+  Squidlet* relay = SquidletCreateOnPort(0, 9171);
+  Squad* squad = SquadCreate();
+  char* squidlets = "{\"_squidlets\":["
+    "{\"_name\":\"a\",\"_ip\":\"127.0.0.1\",\"_port\":\"9170\"}]}";
+  if (relay == NULL || 
+    SquadLoadSquidletsFromStr(squad, squidlets) == false) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquidletSetRelay failed");
+    PBErrCatch(TheSquidErr);
+  }
+  SquidletSetRelay(relay, squad);
+  // Wait to be sure the squidlet is up and running
+  sleep(2);
+  // Process a batch of two dummy tasks
+  char* batch = "{\"types\":[\"0\",\"0\"],\"ids\":[\"0\",\"1\"],"
+    "\"subIds\":[\"0\",\"0\"],\"maxWaits\":[\"5\",\"5\"],"
+    "\"lens\":[\"9\",\"9\"],\"data\":[{\"v\":\"0\"},{\"v\":\"1\"}]}";
+  char* result = NULL;
+  SquidletProcessRequest_Batch(relay, batch, &result);
+  printf("%s\n", result);
+  JSONNode* json = JSONCreate();
+  char* resultsStart = strstr(result, ",\"results\":[");
+  if (resultsStart == NULL) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquidletProcessRequest_Batch failed");
+    PBErrCatch(TheSquidErr);
+  }
+  *resultsStart = '}';
+  resultsStart[1] = '\0';
+  JSONNode* lens = NULL;
+  if (JSONLoadFromStr(json, result) == true)
+    lens = JSONProperty(json, "lens");
+  if (lens == NULL || JSONGetNbValue(lens) != 2 ||
+    atol(JSONLblVal(JSONValue(lens, 0))) <= 0 ||
+    atol(JSONLblVal(JSONValue(lens, 1))) <= 0 ||
+    relay->_nbTaskComplete != 2) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquidletProcessRequest_Batch failed");
+    PBErrCatch(TheSquidErr);
+  }
+  JSONFree(&json);
+  free(result);
+  // Kill the child process
+  if (kill(pid, SIGINT) < 0) {
+    printf("Couldn't kill squidlet %d\n", pid);
+  }
+  // Wait for the child to be killed
+  sleep(2);
+  SquidletFree(&relay);
+  printf("UnitTestBatch OK\n");
+}
+
+void UnitTestSquadThread() {
+  int port[2] = {9180, 9181};
+  pid_t pidSquidlet[2];
+  for (int iSquidlet = 0; iSquidlet < 2; ++iSquidlet) {
+    pidSquidlet[iSquidlet] = fork();
+    if (pidSquidlet[iSquidlet] == 0) {
+      // In a squidlet process
+      Squidlet* squidlet = SquidletCreateOnPort(0, port[iSquidlet]);
+      if (squidlet == NULL) {
+        printf("Failed to create the squidlet\n");
+        printf("errno: %s\n", strerror(errno));
+        exit(0);
+      }
+      do {
+        SquidletTaskRequest request = SquidletWaitRequest(squidlet);
+        SquidletProcessRequest(squidlet, &request);
+      } while (!Squidlet_CtrlC);
+      SquidletFree(&squidlet);
+      exit(0);
+    }
+  }
+  Squad* squad = SquadCreate();
+  char* squidlets = "{\"_squidlets\":["
+    "{\"_name\":\"a\",\"_ip\":\"127.0.0.1\",\"_port\":\"9180\"},"
+    "{\"_name\":\"b\",\"_ip\":\"127.0.0.1\",\"_port\":\"9181\"}]}";
+  if (SquadLoadSquidletsFromStr(squad, squidlets) == false ||
+    SquadSetNbThread(squad, 4) == false ||
+    SquadGetNbThread(squad) != 2 ||
+    SquadGetNbSquidlets(squad) != 0) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadSetNbThread failed");
+    PBErrCatch(TheSquidErr);
+  }
+  // The event log would miss the tasks of the shards
+  if (SquadSetEventLog(squad, "unitTestSquadThread.log") == true) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadSetEventLog failed");
+    PBErrCatch(TheSquidErr);
+  }
+  // Wait to be sure the squidlets are up and running
+  sleep(2);
+  int nbTask = 6;
+  for (unsigned long id = 0; id < (unsigned long)nbTask; ++id)
+    SquadAddTask_Dummy(squad, 0, 5);
+  // The squidlets can't be moved while the shards execute the tasks
+  (void)SquadStep(squad);
+  if (SquadGetNbTaskToComplete(squad) == 0 ||
+    SquadSetNbThread(squad, 0) == true) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadSetNbThread failed");
+    PBErrCatch(TheSquidErr);
+  }
+  int nbCompleted = 0;
+  time_t startTime = time(NULL);
+  do {
+    usleep(10000);
+    GSetSquadRunningTask completedTasks = SquadStep(squad);
+    while (GSetNbElem(&completedTasks) > 0L) {
+      SquadRunningTask* completedTask = GSetPop(&completedTasks);
+      if (SquidletTaskHasSucceeded(completedTask->_request) == false || 
+        completedTask->_squidlet != NULL) {
+        TheSquidErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(TheSquidErr->_msg, "SquadStepShards failed");
+        PBErrCatch(TheSquidErr);
+      }
+      ++nbCompleted;
+      SquidletTaskRequestFree(&(completedTask->_request));
+      SquadRunningTaskFree(&completedTask);
+    }
+  } while (SquadGetNbTaskToComplete(squad) > 0L && 
+    time(NULL) - startTime <= 30);
+  // Stop the threads, the squidlets are given back
+  if (nbCompleted != nbTask ||
+    SquadSetNbThread(squad, 0) == false ||
+    SquadGetNbThread(squad) != 0 ||
+    SquadGetNbSquidlets(squad) != 2) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadSetNbThread failed");
+    PBErrCatch(TheSquidErr);
+  }
+  // Kill the child processes
+  for (int iSquidlet = 0; iSquidlet < 2; ++iSquidlet) {
+    if (kill(pidSquidlet[iSquidlet], SIGINT) < 0) {
+      printf("Couldn't kill squidlet %d\n", pidSquidlet[iSquidlet]);
+    }
+  }
+  // Wait for the children to be killed
+  sleep(2);
+  SquadFree(&squad);
+  printf("UnitTestSquadThread OK\n");
+}
+
+void UnitTestPostProcessThread() {
+  Squad* squad = SquadCreate();
+  if (SquadSetNbPostProcessThread(squad, 2) == false ||
+    SquadGetNbPostProcessThread(squad) != 2) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadSetNbPostProcessThread failed");
+    PBErrCatch(TheSquidErr);
+  }
+  // Complete a POV-Ray task without fragment, it's handed to a thread 
+  // and returned by SquadStep once post processed
+  SquidletInfo* squidlet = SquidletInfoCreate("pov", "0.0.0.0", 9000);
+  SquidletTaskRequest* request = SquidletTaskRequestCreate(
+    SquidletTaskType_PovRay, 1, 0, "{}", 5);
+  request->_bufferResult = strdup("{\"success\":\"1\"}");
+  SquadRunningTask* runningTask = SquadRunningTaskCreate(request, 
+    squidlet);
+  if (SquadProcessCompletedTask(squad, runningTask) == true ||
+    runningTask->_request != NULL ||
+    SquadGetNbTaskToComplete(squad) != 1) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadPostProcessTask failed");
+    PBErrCatch(TheSquidErr);
+  }
+  SquadRunningTaskFree(&runningTask);
+  unsigned long nbCompleted = 0;
+  time_t startTime = time(NULL);
+  do {
+    usleep(10000);
+    GSetSquadRunningTask completedTasks = SquadStep(squad);
+    while (GSetNbElem(&completedTasks) > 0L) {
+      SquadRunningTask* completedTask = GSetPop(&completedTasks);
+      // The trace is recorded once the task is post processed
+      const SquadTaskTrace* trace = squad->_traces;
+      if (completedTask->_request != request || squad->_nbTrace != 1 ||
+        completedTask->_squidlet != NULL ||
+        completedTask->_timePostProcessed.tv_sec == 0 ||
+        trace->_timePostProcessed.tv_sec != 
+          completedTask->_timePostProcessed.tv_sec ||
+        trace->_timePostProcessed.tv_usec != 
+          completedTask->_timePostProcessed.tv_usec ||
+        strcmp(trace->_squidlet, "0.0.0.0:9000") != 0) {
+        TheSquidErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(TheSquidErr->_msg, "SquadStepShards failed");
+        PBErrCatch(TheSquidErr);
+      }
+      ++nbCompleted;
+      SquidletTaskRequestFree(&(completedTask->_request));
+      SquadRunningTaskFree(&completedTask);
+    }
+  } while (SquadGetNbTaskToComplete(squad) > 0L && 
+    time(NULL) - startTime <= 5);
+  if (nbCompleted != 1 ||
+    SquadSetNbPostProcessThread(squad, 0) == false ||
+    SquadGetNbPostProcessThread(squad) != 0) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadSetNbPostProcessThread failed");
+    PBErrCatch(TheSquidErr);
+  }
+  SquidletInfoFree(&squidlet);
+  SquadFree(&squad);
+  printf("UnitTestPostProcessThread OK\n");
+}
+
+bool UnitTestPluginExecute(
+  const char* data, 
+        char* result, 
+       size_t size) {
+  (void)data;
+  snprintf(result, size, "{\"v\":\"2\"}");
+  return true;
+}
+
+bool UnitTestPluginPostProcess(
+  const char* data, 
+  const char* result) {
+  (void)data;
+  return (strstr(result, "\"v\":\"2\"") != NULL);
+}
+
+void UnitTestPlugin() {
+  TheSquidTaskPlugin plugin;
+  memset(&plugin, 0, sizeof(TheSquidTaskPlugin));
+  strcpy(plugin._name, "UnitTest");
+  plugin._type = THESQUID_PLUGIN_FIRSTTYPE;
+  plugin._cost._timeMs = 1500;
+  plugin._cost._heavy = true;
+  plugin._cost._batchable = false;
+  plugin._execute = UnitTestPluginExecute;
+  plugin._postProcess = UnitTestPluginPostProcess;
+  if (TheSquidRegisterTaskPlugin(&plugin) == false ||
+    TheSquidRegisterTaskPlugin(&plugin) == true ||
+    TheSquidGetTaskPlugin(THESQUID_PLUGIN_FIRSTTYPE) == NULL ||
+    SquidletTaskTypeIsValid(THESQUID_PLUGIN_FIRSTTYPE) == false ||
+    SquidletTaskTypeIsValid(THESQUID_PLUGIN_FIRSTTYPE + 1) == true ||
+    strcmp(SquidletTaskTypeName(THESQUID_PLUGIN_FIRSTTYPE), 
+      "UnitTest") != 0 ||
+    strcmp(SquidletTaskTypeName(THESQUID_PLUGIN_FIRSTTYPE + 1), 
+      "Plugin") != 0) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "TheSquidRegisterTaskPlugin failed");
+    PBErrCatch(TheSquidErr);
+  }
+  plugin._type = SquidletTaskType_Nb;
+  if (TheSquidRegisterTaskPlugin(&plugin) == true) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "TheSquidRegisterTaskPlugin failed");
+    PBErrCatch(TheSquidErr);
+  }
+  // The time limit defaults to twice the expected time
+  Squad* squad = SquadCreate();
+  SquadAddTask_Plugin(squad, THESQUID_PLUGIN_FIRSTTYPE, 1, 0, "{}");
+  SquidletTaskRequest* request = GSetPop((GSet*)SquadTasks(squad));
+  if (SquidletTaskGetMaxWaitTime(request) != 4) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadAddTask_Plugin failed");
+    PBErrCatch(TheSquidErr);
+  }
+  // Execute the task and post process its result
+  Squidlet* squidlet = SquidletCreate();
+  char* bufferResult = NULL;
+  SquidletProcessRequest_Plugin(squidlet, 
+    TheSquidGetTaskPlugin(THESQUID_PLUGIN_FIRSTTYPE), "{}", 
+    &bufferResult);
+  request->_bufferResult = bufferResult;
+  SquidletInfo* squidletInfo = SquidletInfoCreate("plugin", "0.0.0.0", 
+    9000);
+  SquadRunningTask* runningTask = SquadRunningTaskCreate(request, 
+    squidletInfo);
+  if (SquidletTaskHasSucceeded(request) == false ||
+    SquadProcessCompletedTask(squad, runningTask) == false) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquidletProcessRequest_Plugin failed");
+    PBErrCatch(TheSquidErr);
+  }
+  SquidletTaskRequestFree(&request);
+  SquadRunningTaskFree(&runningTask);
+  SquidletInfoFree(&squidletInfo);
+  SquidletFree(&squidlet);
+  // The heavy task doesn't block the following ones for a warm 
+  // squidlet, and is the next one for a cool squidlet
+  SquadAddTask_Plugin(squad, THESQUID_PLUGIN_FIRSTTYPE, 2, 0, "{}");
+  SquadAddTask_Dummy(squad, 3, 5);
+  request = 
+    SquadPopTaskForThermalState(squad, SquidletThermalState_Warm);
+  if (request == NULL || request->_id != 3 ||
+    SquadPopTaskForThermalState(squad, SquidletThermalState_Warm) != 
+      NULL) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadPopTaskForThermalState failed");
+    PBErrCatch(TheSquidErr);
+  }
+  SquidletTaskRequestFree(&request);
+  request = 
+    SquadPopTaskForThermalState(squad, SquidletThermalState_Cool);
+  if (request == NULL || request->_id != 2 ||
+    SquadGetNbRemainingTasks(squad) != 0L) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadPopTaskForThermalState failed");
+    PBErrCatch(TheSquidErr);
+  }
+  SquidletTaskRequestFree(&request);
+  SquadFree(&squad);
+  printf("UnitTestPlugin OK\n");
+}
+
+void UnitTestExec() {
+  char* argv[] = {"cat", NULL};
+  char* output = NULL;
+  size_t lenOutput = 0;
+  int timeout = 5;
+  if (TheSquidSpawn("cat", argv, "hello", 5, &output, &lenOutput, 
+    timeout) != 0 || lenOutput != 5 || strcmp(output, "hello") != 0) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "TheSquidSpawn failed");
+    PBErrCatch(TheSquidErr);
+  }
+  free(output);
+  Squad* squad = SquadCreate();
+  Squidlet* squidlet = SquidletCreate();
+  const char* args[] = {"-"};
+  if (SquidletAddExecCommand(squidlet, "/bin/cat") == false ||
+    SquadAddTask_Exec(squad, 1, 5, "/bin/cat", 0, NULL, NULL) == true ||
+    SquadAddTask_Exec(squad, 1, 5, "cat", 1, args, "hello") == false ||
+    SquadAddTask_Exec(squad, 2, 5, "ls", 0, NULL, NULL) == false) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadAddTask_Exec failed");
+    PBErrCatch(TheSquidErr);
+  }
+  // The allowed command returns its output, the other one is refused
+  for (int iTask = 0; iTask < 2; ++iTask) {
+    SquidletTaskRequest* request = GSetPop((GSet*)SquadTasks(squad));
+    char* bufferResult = NULL;
+    SquidletProcessRequest_Exec(squidlet, SquidletTaskData(request), 
+      &bufferResult);
+    request->_bufferResult = bufferResult;
+    bool expected = (iTask == 0);
+    if (SquidletTaskHasSucceeded(request) != expected || 
+      (expected == true && strstr(bufferResult, "}\nhello") == NULL)) {
+      TheSquidErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(TheSquidErr->_msg, "SquidletProcessRequest_Exec failed");
+      PBErrCatch(TheSquidErr);
+    }
+    SquidletTaskRequestFree(&request);
+  }
+  // A number of arguments greater than the number of lines is refused
+  char* bufferResult = NULL;
+  SquidletProcessRequest_Exec(squidlet, 
+    "{\"cmd\":\"cat\",\"nbArg\":\"2000000000\"}\n-\nhello", 
+    &bufferResult);
+  if (strstr(bufferResult, "\"success\":\"0\"") == NULL ||
+    strstr(bufferResult, "Invalid arguments") == NULL) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquidletProcessRequest_Exec failed");
+    PBErrCatch(TheSquidErr);
+  }
+  free(bufferResult);
+  SquidletFree(&squidlet);
+  SquadFree(&squad);
+  printf("UnitTestExec OK\n");
+}
+
+void UnitTestSendFile() {
+  Squad* squad = SquadCreate();
+  SquadSetFlagSendFile(squad, true);
+  if (SquadGetFlagSendFile(squad) == false) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadSetFlagSendFile failed");
+    PBErrCatch(TheSquidErr);
+  }
+  // The fragments sent over the socket are never batched for a relay, 
+  // including by the shards of a multithreaded Squad
+  char* squidlets = "{\"_squidlets\":["
+    "{\"_name\":\"a\",\"_ip\":\"127.0.0.1\",\"_port\":\"9190\"},"
+    "{\"_name\":\"b\",\"_ip\":\"127.0.0.1\",\"_port\":\"9191\"}]}";
+  if (SquadLoadSquidletsFromStr(squad, squidlets) == false ||
+    SquadSetNbThread(squad, 2) == false) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadSetNbThread failed");
+    PBErrCatch(TheSquidErr);
+  }
+  SquadAddTask_PovRay(squad, 1, 10, "./testPov.ini", 100, 1000);
+  SquidletTaskRequest* task = GSetPop((GSet*)SquadTasks(squad));
+  if (strstr(task->_data, "\"sendFile\":") == NULL || 
+    SquadIsBatchable(task) == true) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadIsBatchable failed");
+    PBErrCatch(TheSquidErr);
+  }
+  SquidletTaskRequestFree(&task);
+  SquadSetFlagSendFile(squad, false);
+  SquadAddTask_PovRay(squad, 2, 10, "./testPov.ini", 100, 1000);
+  task = GSetPop((GSet*)SquadTasks(squad));
+  if (SquadIsBatchable(task) == false) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "SquadIsBatchable failed");
+    PBErrCatch(TheSquidErr);
+  }
+  SquidletTaskRequestFree(&task);
+  SquadFree(&squad);
+  // Send a file from one end of a pair of sockets and splice it into 
+  // another file at the other end
+  const char* content = "TheSquid sendfile and splice";
+  size_t len = strlen(content);
+  FILE* fp = fopen("unitTestSendFileIn.txt", "w");
+  fwrite(content, 1, len, fp);
+  fclose(fp);
+  int socks[2];
+  int fd = open("unitTestSendFileIn.txt", O_RDONLY);
+  off_t offset = 0;
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, socks) != 0 || 
+    sendfile(socks[0], fd, &offset, len) != (ssize_t)len ||
+    TheSquidSpliceToFile(socks[1], "unitTestSendFileOut.txt", len, 
+      1) == false) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "TheSquidSpliceToFile failed");
+    PBErrCatch(TheSquidErr);
+  }
+  close(fd);
+  char buffer[100] = {'\0'};
+  fp = fopen("unitTestSendFileOut.txt", "r");
+  if (fp == NULL || fread(buffer, 1, 100, fp) != len || 
+    strcmp(buffer, content) != 0) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "TheSquidSpliceToFile failed");
+    PBErrCatch(TheSquidErr);
+  }
+  fclose(fp);
+  // Nothing more is sent, the reception times out and the file is 
+  // deleted
+  if (TheSquidSpliceToFile(socks[1], "unitTestSendFileOut.txt", len, 
+    1) == true || access("unitTestSendFileOut.txt", F_OK) == 0) {
+    TheSquidErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(TheSquidErr->_msg, "TheSquidSpliceToFile failed");
+    PBErrCatch(TheSquidErr);
+  }
+  close(socks[0]);
+  close(socks[1]);
+  unlink("unitTestSendFileIn.txt");
+  printf("UnitTestSendFile OK\n");
+}
+
 void UnitTestAll() {
   UnitTestSquad();
   UnitTestLoadTasks();
@@ -537,6 +1845,25 @@ void UnitTestAll() {
   UnitTestDummy();
   UnitTestPovRay();
   UnitTestEvalNeuranet();
+  UnitTestEvalNeuranetBatch();
+  UnitTestEvalNeuranetShards();
+  UnitTestNeuraNetCache();
+  UnitTestBenchmarkConfig();
+  UnitTestHisto();
+  UnitTestMetrics();
+  UnitTestThermal();
+  UnitTestThermalCoolDown();
+  UnitTestEventLog();
+  UnitTestDiscovery();
+  UnitTestQuarantine();
+  UnitTestCircuitBreaker();
+  UnitTestDispatch();
+  UnitTestBatch();
+  UnitTestSquadThread();
+  UnitTestPostProcessThread();
+  UnitTestPlugin();
+  UnitTestExec();
+  UnitTestSendFile();
   printf("UnitTestAll OK\n");
 }
 
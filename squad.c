@@ -17,7 +17,21 @@ int main(int argc, char** argv) {
   // Declare and initialise variables to process arguments
   char* tasksFilePath = NULL;
   char* squidletsFilePath = NULL;
+  char* benchmarkFilePath = NULL;
+  char* traceFilePath = NULL;
+  int metricsPort = -1;
+  char* eventLogFilePath = NULL;
+  int discoveryPort = -1;
+  int statsPeriod = -1;
+  float thermalSoft = -1.0;
+  float thermalHard = -1.0;
+  int thermalHorizon = -1;
+  int nbThread = 0;
+  int nbPostProcessThread = 0;
+  char* pluginFilePaths[THESQUID_PLUGIN_MAXNB];
+  int nbPlugin = 0;
   bool flagTextOMeter = false;
+  bool flagSendFile = false;
   unsigned int freq = 1;
 
   // Loop on the arguments to process the prior arguments
@@ -50,6 +64,122 @@ int main(int argc, char** argv) {
 
     }
 
+    // -benchmarkConfig <path to benchmark config file>
+    if (strcmp(argv[iArg], "-benchmarkConfig") == 0 && iArg < argc - 1) {
+
+      // Memorize a pointer to the path to the benchmark config file
+      ++iArg;
+      benchmarkFilePath = argv[iArg];
+
+    }
+
+    // -trace <path to trace file>
+    if (strcmp(argv[iArg], "-trace") == 0 && iArg < argc - 1) {
+
+      // Memorize a pointer to the path to the trace file
+      ++iArg;
+      traceFilePath = argv[iArg];
+
+    }
+
+    // -metrics <port>
+    if (strcmp(argv[iArg], "-metrics") == 0 && iArg < argc - 1) {
+
+      // Decode the port of the metrics endpoint
+      ++iArg;
+      metricsPort = atoi(argv[iArg]);
+
+    }
+
+    // -eventLog <path to event log file>
+    if (strcmp(argv[iArg], "-eventLog") == 0 && iArg < argc - 1) {
+
+      // Memorize a pointer to the path to the event log file
+      ++iArg;
+      eventLogFilePath = argv[iArg];
+
+    }
+
+    // -discovery <UDP port>
+    if (strcmp(argv[iArg], "-discovery") == 0 && iArg < argc - 1) {
+
+      // Decode the port on which the announces of squidlets are 
+      // received
+      ++iArg;
+      discoveryPort = atoi(argv[iArg]);
+
+    }
+
+    // -statsPeriod <delay in second between stats of squidlets>
+    if (strcmp(argv[iArg], "-statsPeriod") == 0 && iArg < argc - 1) {
+
+      // Decode the period of the stats heartbeat
+      ++iArg;
+      statsPeriod = atoi(argv[iArg]);
+
+    }
+
+    // -thermal <soft threshold> <hard threshold>
+    if (strcmp(argv[iArg], "-thermal") == 0 && iArg < argc - 2) {
+
+      // Decode the thresholds of temperature of the squidlets
+      ++iArg;
+      thermalSoft = atof(argv[iArg]);
+      ++iArg;
+      thermalHard = atof(argv[iArg]);
+
+    }
+
+    // -thermalHorizon <delay in second to predict the temperature>
+    if (strcmp(argv[iArg], "-thermalHorizon") == 0 && iArg < argc - 1) {
+
+      // Decode the delay to predict the temperature of the squidlets
+      ++iArg;
+      thermalHorizon = atoi(argv[iArg]);
+
+    }
+
+    // -thread <nb>
+    if (strcmp(argv[iArg], "-thread") == 0 && iArg < argc - 1) {
+
+      // Decode the number of threads stepping the squidlets
+      ++iArg;
+      nbThread = atoi(argv[iArg]);
+
+    }
+
+    // -postProcessThread <nb>
+    if (strcmp(argv[iArg], "-postProcessThread") == 0 && 
+      iArg < argc - 1) {
+
+      // Decode the number of threads post processing the tasks
+      ++iArg;
+      nbPostProcessThread = atoi(argv[iArg]);
+
+    }
+
+    // -plugin <path to shared object>
+    if (strcmp(argv[iArg], "-plugin") == 0 && iArg < argc - 1) {
+
+      // Memorize a pointer to the path to the shared object of task 
+      // type plugins
+      ++iArg;
+      if (nbPlugin < THESQUID_PLUGIN_MAXNB) {
+        pluginFilePaths[nbPlugin] = argv[iArg];
+        ++nbPlugin;
+      }
+
+    }
+
+    // -sendFile
+    if (strcmp(argv[iArg], "-sendFile") == 0) {
+
+      // Set the flag to receive the output files of the tasks over the 
+      // socket
+      flagSendFile = true;
+
+    }
+
     // -verbose
     if (strcmp(argv[iArg], "-verbose") == 0) {
 
@@ -67,12 +197,61 @@ int main(int argc, char** argv) {
       printf("\"_ip\":\"a.b.c.d\",\"_port\":\"port\"}]}'> ");
       printf("[-verbose] [-tasks <path to tasks file>] ");
       printf("[-freq <delay in second between step, default: 1>] ");
-      printf("[-check] [-benchmark] [-help]\n");
+      printf("[-check] [-benchmark] [-benchmarkProtocol] ");
+      printf("[-benchmarkConfig <path to benchmark config file>] ");
+      printf("[-trace <path to trace file>] [-metrics <port>] ");
+      printf("[-eventLog <path to event log file>] ");
+      printf("[-discovery <UDP port of the announces of squidlets, ");
+      printf("default: %d>] ", THESQUID_DISCOVERY_PORT);
+      printf("[-statsPeriod <delay in second between stats of ");
+      printf("squidlets, 0 for on demand only, default: %d>] ", 
+        SQUAD_STATSPERIOD);
+      printf("[-thermal <soft> <hard temperature threshold in Celsius, ");
+      printf("default: %.1f %.1f>] ", SQUAD_THERMALSOFT, SQUAD_THERMALHARD);
+      printf("[-thermalHorizon <delay in second to predict the ");
+      printf("temperature, default: %d>] ", SQUAD_THERMALHORIZON);
+      printf("[-thread <nb of threads stepping the squidlets>] ");
+      printf("[-postProcessThread <nb of threads post processing ");
+      printf("the tasks>] ");
+      printf("[-plugin <path to shared object>] [-sendFile] ");
+      printf("[-help]\n");
       return 0;
 
     }
   }
 
+  // Register the task types of the plugins before loading the tasks
+  for (int iPlugin = 0; iPlugin < nbPlugin; ++iPlugin) {
+
+    // If we couldn't load the plugin
+    if (TheSquidLoadTaskPlugin(pluginFilePaths[iPlugin]) == false) {
+
+      // Print an error message
+      fprintf(stderr, "Squad: Couldn't load the plugin %s\n", 
+        pluginFilePaths[iPlugin]);
+      fprintf(stderr, "TheSquidErr: %s\n", TheSquidErr->_msg);
+
+      // Stop here
+      return 13;
+
+    }
+
+  }
+
+  // The metrics, trace and event log only cover the squidlets and tasks 
+  // of the squad, not the ones of its threads
+  if (nbThread > 1 && (metricsPort != -1 || traceFilePath != NULL || 
+    eventLogFilePath != NULL)) {
+
+    // Print an error message
+    fprintf(stderr, "Squad: -thread can't be used with -metrics, "
+      "-trace or -eventLog\n");
+
+    // Stop here
+    return 14;
+
+  }
+
   // Create the squad
   Squad* squad = SquadCreate();
 
@@ -89,6 +268,83 @@ int main(int argc, char** argv) {
 
   }
 
+  // Set the period of the stats heartbeat
+  if (statsPeriod >= 0)
+    SquadSetStatsPeriod(squad, statsPeriod);
+
+  // Set the flag to receive the output files of the tasks over the 
+  // socket
+  SquadSetFlagSendFile(squad, flagSendFile);
+
+  // Set the thresholds of temperature of the squidlets
+  if (thermalSoft >= 0.0 && thermalHard >= thermalSoft)
+    SquadSetThermalThresholds(squad, thermalSoft, thermalHard);
+  if (thermalHorizon >= 0)
+    SquadSetThermalHorizon(squad, thermalHorizon);
+
+  // If the user has requested the metrics endpoint
+  if (metricsPort != -1) {
+
+    // If we couldn't open the metrics endpoint
+    if (SquadSetMetricsPort(squad, metricsPort) == false) {
+
+      // Print an error message
+      fprintf(stderr, "Squad: Couldn't open the metrics endpoint\n");
+      fprintf(stderr, "TheSquidErr: %s\n", TheSquidErr->_msg);
+      fprintf(stderr, "errno: %s\n", strerror(errno));
+
+      // Free memory
+      SquadFree(&squad);
+
+      // Stop here
+      return 8;
+
+    }
+
+  }
+
+  // If the user has requested the event log
+  if (eventLogFilePath != NULL) {
+
+    // If we couldn't open the event log
+    if (SquadSetEventLog(squad, eventLogFilePath) == false) {
+
+      // Print an error message
+      fprintf(stderr, "Squad: Couldn't open the event log\n");
+      fprintf(stderr, "TheSquidErr: %s\n", TheSquidErr->_msg);
+      fprintf(stderr, "errno: %s\n", strerror(errno));
+
+      // Free memory
+      SquadFree(&squad);
+
+      // Stop here
+      return 9;
+
+    }
+
+  }
+
+  // If the user has requested the discovery of squidlets
+  if (discoveryPort != -1) {
+
+    // If we couldn't open the discovery port
+    if (SquadSetDiscoveryPort(squad, discoveryPort) == false) {
+
+      // Print an error message
+      fprintf(stderr, "Squad: Couldn't open the discovery port\n");
+      fprintf(stderr, "TheSquidErr: %s\n", TheSquidErr->_msg);
+      fprintf(stderr, "errno: %s\n", strerror(errno));
+
+      // Free memory
+      SquadFree(&squad);
+
+      // Stop here
+      return 10;
+
+    }
+
+  }
+
   // If the user has provided a squidlet configuration file
   if (squidletsFilePath != NULL) {
 
@@ -156,6 +412,40 @@ int main(int argc, char** argv) {
   // Set the TextOMeter accordingly to the -verbose argument
   SquadSetFlagTextOMeter(squad, flagTextOMeter);
 
+  // Declare the benchmark configuration with default values
+  SquadBenchmarkConfig benchmarkConfig = 
+    SquadBenchmarkConfigCreateStatic();
+
+  // If the user has provided a benchmark configuration file
+  if (benchmarkFilePath != NULL) {
+
+    // Load the benchmark configuration
+    FILE* benchmarkFile = fopen(benchmarkFilePath, "r");
+    bool retLoadConfig = (benchmarkFile != NULL && 
+      SquadBenchmarkConfigLoad(&benchmarkConfig, benchmarkFile));
+    if (benchmarkFile != NULL)
+      fclose(benchmarkFile);
+
+    // If we couldn't load the benchmark configuration
+    if (retLoadConfig == false) {
+
+      // Print an error message
+      fprintf(stderr, 
+        "Squad: Couldn't load the benchmark config file %s\n",
+        benchmarkFilePath);
+      fprintf(stderr, "TheSquidErr: %s\n", TheSquidErr->_msg);
+
+      // Free memory
+      SquadBenchmarkConfigFreeStatic(&benchmarkConfig);
+      SquadFree(&squad);
+
+      // Stop here
+      return 7;
+
+    }
+
+  }
+
   // Loop on the arguments to process the posterior arguments
   for (int iArg = 0; iArg < argc; ++iArg) {
 
@@ -170,6 +460,7 @@ int main(int argc, char** argv) {
       if (resCheckSquidlets == false) {
 
         // Free memory
+        SquadBenchmarkConfigFreeStatic(&benchmarkConfig);
         SquadFree(&squad);
 
         // Stop here
@@ -182,13 +473,24 @@ int main(int argc, char** argv) {
     // -benchmark
     if (strcmp(argv[iArg], "-benchmark") == 0) {
       
-      // Run the standard benchmark on the loaded squidlets
-      SquadBenchmark(squad, stdout);
+      // Run the benchmark on the loaded squidlets
+      SquadBenchmarkWithConfig(squad, &benchmarkConfig, stdout);
+
+    }
+
+    // -benchmarkProtocol
+    if (strcmp(argv[iArg], "-benchmarkProtocol") == 0) {
+      
+      // Run the benchmark of the protocol on the loaded squidlets
+      SquadBenchmarkProtocol(squad, &benchmarkConfig, stdout);
 
     }
 
   }
 
+  // Free memory
+  SquadBenchmarkConfigFreeStatic(&benchmarkConfig);
+
   // If the user has provided a tasks file
   if (tasksFilePath != NULL) {
 
@@ -236,6 +538,38 @@ int main(int argc, char** argv) {
       // Close the tasks file
       fclose(tasksFile);
 
+      // If the user requested several threads, shard the squidlets
+      if (nbThread > 1 && SquadSetNbThread(squad, nbThread) == false) {
+
+        // Print an error message
+        fprintf(stderr, "Squad: Couldn't start the threads\n");
+        fprintf(stderr, "TheSquidErr: %s\n", TheSquidErr->_msg);
+
+        // Free memory
+        SquadBenchmarkConfigFreeStatic(&benchmarkConfig);
+        SquadFree(&squad);
+
+        // Stop here
+        return 11;
+      }
+
+      // If the user requested threads to post process the tasks, 
+      // start them
+      if (nbPostProcessThread > 0 && 
+        SquadSetNbPostProcessThread(squad, nbPostProcessThread) == false) {
+
+        // Print an error message
+        fprintf(stderr, "Squad: Couldn't start the post process threads\n");
+        fprintf(stderr, "TheSquidErr: %s\n", TheSquidErr->_msg);
+
+        // Free memory
+        SquadBenchmarkConfigFreeStatic(&benchmarkConfig);
+        SquadFree(&squad);
+
+        // Stop here
+        return 12;
+      }
+
       // Loop as long as there are task to complete
       while (SquadGetNbTaskToComplete(squad) > 0) {
 
@@ -282,6 +616,29 @@ int main(int argc, char** argv) {
     }
 
   }
+
+  // If the user has requested the trace of the tasks
+  if (traceFilePath != NULL) {
+
+    // Open the trace file
+    FILE* traceFile = fopen(traceFilePath, "w");
+    
+    // If we couldn't open the trace file or export the trace
+    if (traceFile == NULL || 
+      SquadExportTrace(squad, traceFile) == false) {
+
+        // Print an error message
+        fprintf(stderr, "Squad: Couldn't export the trace file: %s\n", 
+          traceFilePath);
+        fprintf(stderr, "errno: %s\n", strerror(errno));
+
+    }
+
+    // Close the trace file
+    if (traceFile != NULL)
+      fclose(traceFile);
+
+  }
   
   // Free memory
   SquadFree(&squad);
@@ -15,6 +15,16 @@ int main(int argc, char** argv) {
   int port = -1;
   uint32_t ip = 0;
   char* outputFilePath = NULL;
+  int nbThread = 0;
+  int metricsPort = -1;
+  char* eventLogFilePath = NULL;
+  char* announceIp = NULL;
+  int announcePort = THESQUID_DISCOVERY_PORT;
+  char* relayFilePath = NULL;
+  char* pluginFilePaths[THESQUID_PLUGIN_MAXNB];
+  int nbPlugin = 0;
+  char* execFilePaths[THESQUID_EXEC_MAXCOMMAND];
+  int nbExec = 0;
 
   // Loop on the arguments to process the prior arguments
   for (int iArg = 0; iArg < argc; ++iArg) {
@@ -59,17 +69,106 @@ int main(int argc, char** argv) {
 
     }
     
+    // -thread <nb>
+    if (strcmp(argv[iArg], "-thread") == 0 && iArg < argc - 1) {
+
+      // Decode the number of threads used to process the tasks
+      ++iArg;
+      nbThread = atoi(argv[iArg]);
+
+    }
+    
+    // -metrics <port>
+    if (strcmp(argv[iArg], "-metrics") == 0 && iArg < argc - 1) {
+
+      // Decode the port of the metrics endpoint
+      ++iArg;
+      metricsPort = atoi(argv[iArg]);
+
+    }
+    
+    // -eventLog <path to event log file>
+    if (strcmp(argv[iArg], "-eventLog") == 0 && iArg < argc - 1) {
+
+      // Decode the path of the event log file
+      ++iArg;
+      eventLogFilePath = argv[iArg];
+
+    }
+    
+    // -announce <a.b.c.d> <UDP port>
+    if (strcmp(argv[iArg], "-announce") == 0 && iArg < argc - 2) {
+
+      // Decode the address to which the Squidlet announces itself
+      ++iArg;
+      announceIp = argv[iArg];
+      ++iArg;
+      announcePort = atoi(argv[iArg]);
+
+    }
+    
+    // -relay <path to squidlets config file>
+    if (strcmp(argv[iArg], "-relay") == 0 && iArg < argc - 1) {
+
+      // Decode the path of the config file of the squidlets to which 
+      // the Squidlet relays the batches of tasks
+      ++iArg;
+      relayFilePath = argv[iArg];
+
+    }
+    
+    // -plugin <path to shared object>
+    if (strcmp(argv[iArg], "-plugin") == 0 && iArg < argc - 1) {
+
+      // Decode the path of the shared object of task type plugins
+      ++iArg;
+      if (nbPlugin < THESQUID_PLUGIN_MAXNB) {
+        pluginFilePaths[nbPlugin] = argv[iArg];
+        ++nbPlugin;
+      }
+
+    }
+    
+    // -exec <path to binary>
+    if (strcmp(argv[iArg], "-exec") == 0 && iArg < argc - 1) {
+
+      // Decode the path of a binary allowed for the Exec tasks
+      ++iArg;
+      if (nbExec < THESQUID_EXEC_MAXCOMMAND) {
+        execFilePaths[nbExec] = argv[iArg];
+        ++nbExec;
+      }
+
+    }
+    
     // -help
     if (strcmp(argv[iArg], "-help") == 0) {
 
       // Display the help message and quit
       printf("squidlet [-ip <a.b.c.d>] [-port <port>] ");
-      printf("[-stream <stdout | file path>] [-temp] [-help]\n");
+      printf("[-stream <stdout | file path>] [-thread <nb>] ");
+      printf("[-metrics <port>] [-eventLog <path to event log file>] ");
+      printf("[-announce <a.b.c.d (broadcast or squad)> <UDP port>] ");
+      printf("[-relay <path to squidlets config file>] ");
+      printf("[-plugin <path to shared object>] ");
+      printf("[-exec <path to binary>] ");
+      printf("[-temp] [-help]\n");
       return 0;
 
     }
   }
   
+  // Register the task types of the plugins before starting the 
+  // squidlet
+  for (int iPlugin = 0; iPlugin < nbPlugin; ++iPlugin) {
+    if (TheSquidLoadTaskPlugin(pluginFilePaths[iPlugin]) == false) {
+      fprintf(stderr, "Failed to load the plugin %s\n", 
+        pluginFilePaths[iPlugin]);
+      fprintf(stderr, "TheSquidErr: %s\n", TheSquidErr->_msg);
+      return 8;
+    }
+  }
+
   // Create the squidlet
   Squidlet* squidlet = SquidletCreateOnPort(ip, port);
 
@@ -81,6 +180,71 @@ int main(int argc, char** argv) {
     return 2;
   }
 
+  // If the user provided a number of threads, set it, else keep the
+  // default one (the number of available cores)
+  if (nbThread > 0)
+    SquidletSetNbThread(squidlet, nbThread);
+
+  // If the user requested the metrics endpoint, open it
+  if (metricsPort != -1 && 
+    SquidletSetMetricsPort(squidlet, metricsPort) == false) {
+    fprintf(stderr, "Failed to open the metrics endpoint\n");
+    fprintf(stderr, "TheSquidErr: %s\n", TheSquidErr->_msg);
+    fprintf(stderr, "errno: %s\n", strerror(errno));
+    SquidletFree(&squidlet);
+    return 4;
+  }
+
+  // If the user requested the event log, open it
+  if (eventLogFilePath != NULL && 
+    SquidletSetEventLog(squidlet, eventLogFilePath) == false) {
+    fprintf(stderr, "Failed to open the event log\n");
+    fprintf(stderr, "TheSquidErr: %s\n", TheSquidErr->_msg);
+    fprintf(stderr, "errno: %s\n", strerror(errno));
+    SquidletFree(&squidlet);
+    return 5;
+  }
+
+  // If the user requested the announces, start them
+  if (announceIp != NULL && 
+    SquidletSetAnnounce(squidlet, announceIp, announcePort) == false) {
+    fprintf(stderr, "Failed to announce the squidlet\n");
+    fprintf(stderr, "TheSquidErr: %s\n", TheSquidErr->_msg);
+    fprintf(stderr, "errno: %s\n", strerror(errno));
+    SquidletFree(&squidlet);
+    return 6;
+  }
+
+  // If the user requested the squidlet to be a relay, create the Squad 
+  // of its squidlets
+  if (relayFilePath != NULL) {
+    Squad* relay = SquadCreate();
+    FILE* relayFile = fopen(relayFilePath, "r");
+    bool ret = (relayFile != NULL && SquadLoadSquidlets(relay, relayFile));
+    if (relayFile != NULL)
+      fclose(relayFile);
+    if (ret == false) {
+      fprintf(stderr, "Failed to load the squidlets of the relay\n");
+      fprintf(stderr, "TheSquidErr: %s\n", TheSquidErr->_msg);
+      fprintf(stderr, "errno: %s\n", strerror(errno));
+      SquadFree(&relay);
+      SquidletFree(&squidlet);
+      return 7;
+    }
+    SquidletSetRelay(squidlet, relay);
+  }
+
+  // Allow the binaries requested by the user for the Exec tasks
+  for (int iExec = 0; iExec < nbExec; ++iExec) {
+    if (SquidletAddExecCommand(squidlet, execFilePaths[iExec]) == false) {
+      fprintf(stderr, "Failed to allow the binary %s\n", 
+        execFilePaths[iExec]);
+      fprintf(stderr, "TheSquidErr: %s\n", TheSquidErr->_msg);
+      SquidletFree(&squidlet);
+      return 9;
+    }
+  }
+
   // Display info about the Squidlet:
   // <pid> <hostname> <ip>:<port>
   printf("Squidlet : ");
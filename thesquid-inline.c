@@ -205,7 +205,8 @@ unsigned long SquadGetNbTaskToComplete(
   }
 #endif
   return GSetNbElem(SquadTasks(that)) + 
-    GSetNbElem(SquadRunningTasks(that));  
+    GSetNbElem(SquadRunningTasks(that)) + that->_nbShardedTask + 
+    that->_nbPostProcessTask;  
 }
 
 // Return the number of running tasks
@@ -273,6 +274,211 @@ bool SquadGetFlagTextOMeter(
   return that->_flagTextOMeter;
 }
 
+// Return the delay in seconds between two requests of the statistics 
+// of a squidlet by the Squad 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+time_t SquadGetStatsPeriod(
+  const Squad* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  return that->_statsPeriod;
+}
+
+// Set the delay in seconds between two requests of the statistics 
+// of a squidlet by the Squad 'that' to 'period'
+// If 'period' is 0 the statistics are requested only on demand, 
+// except for the squidlets cooling down which are requested every 
+// SQUAD_THERMALCOOLPERIOD seconds
+#if BUILDMODE != 0
+static inline
+#endif
+void SquadSetStatsPeriod(
+   Squad* const that, 
+  const time_t period) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  that->_statsPeriod = period;
+}
+
+// Return the flag memorizing if the squidlets of the Squad 'that' send 
+// the output files of the tasks after their result
+#if BUILDMODE != 0
+static inline
+#endif
+bool SquadGetFlagSendFile(
+  const Squad* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  return that->_flagSendFile;
+}
+
+// Set the flag memorizing if the squidlets of the Squad 'that' send 
+// the output files of the tasks after their result to 'flag' 
+// It applies to the tasks added after the call
+#if BUILDMODE != 0
+static inline
+#endif
+void SquadSetFlagSendFile(
+  Squad* const that, 
+  const bool flag) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  that->_flagSendFile = flag;
+}
+
+// Return the number of threads stepping the shards of the squidlets of 
+// the Squad 'that', 0 if it's not multithreaded
+#if BUILDMODE != 0
+static inline
+#endif
+unsigned int SquadGetNbThread(
+  const Squad* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  return that->_nbThread;
+}
+
+// Return the number of threads post processing the completed tasks of 
+// the Squad 'that', 0 if they are post processed by SquadStep
+#if BUILDMODE != 0
+static inline
+#endif
+unsigned int SquadGetNbPostProcessThread(
+  const Squad* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  return that->_nbPostProcessThread;
+}
+
+// Return the soft threshold (in Celsius) of the predicted temperature 
+// above which the squidlets of the Squad 'that' are warm
+#if BUILDMODE != 0
+static inline
+#endif
+float SquadGetThermalSoft(
+  const Squad* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  return that->_thermalSoft;
+}
+
+// Return the hard threshold (in Celsius) of the predicted temperature 
+// above which the squidlets of the Squad 'that' are hot
+#if BUILDMODE != 0
+static inline
+#endif
+float SquadGetThermalHard(
+  const Squad* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  return that->_thermalHard;
+}
+
+// Return the delay (in seconds) used by the Squad 'that' to predict 
+// the temperature of its squidlets from their trend
+#if BUILDMODE != 0
+static inline
+#endif
+time_t SquadGetThermalHorizon(
+  const Squad* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  return that->_thermalHorizon;
+}
+
+// Set the soft and hard thresholds (in Celsius) of the predicted 
+// temperature of the squidlets of the Squad 'that' to 'soft' and 
+// 'hard'. 'soft' must be lower or equal to 'hard'
+#if BUILDMODE != 0
+static inline
+#endif
+void SquadSetThermalThresholds(
+  Squad* const that, 
+   const float soft, 
+   const float hard) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (soft > hard) {
+    TheSquidErr->_type = PBErrTypeInvalidArg;
+    sprintf(TheSquidErr->_msg, "'soft' is greater than 'hard' (%f>%f)", 
+      soft, hard);
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  that->_thermalSoft = soft;
+  that->_thermalHard = hard;
+}
+
+// Set the delay (in seconds) used by the Squad 'that' to predict the 
+// temperature of its squidlets from their trend to 'horizon' 
+// If 'horizon' is 0 the current temperature is used
+#if BUILDMODE != 0
+static inline
+#endif
+void SquadSetThermalHorizon(
+   Squad* const that, 
+  const time_t horizon) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  that->_thermalHorizon = horizon;
+}
+
 
 // -------------- Squidlet
 
@@ -376,5 +582,41 @@ void SquidletSetStreamInfo(
   that->_streamInfo = stream;  
 }
 
+// Get the number of threads used by the Squidlet 'that' to process 
+// the tasks
+#if BUILDMODE != 0 
+static inline 
+#endif 
+int SquidletGetNbThread(
+  const Squidlet* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  return that->_nbThread; 
+}
+
+// Set the number of threads used by the Squidlet 'that' to process 
+// the tasks to 'nbThread'
+// If 'nbThread' is less than 1, it is set to 1
+#if BUILDMODE != 0 
+static inline 
+#endif 
+void SquidletSetNbThread(
+  Squidlet* const that, 
+  const int nbThread) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  that->_nbThread = MAX(1, nbThread); 
+}
+
 
 
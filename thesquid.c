@@ -11,9 +11,183 @@
 
 // Name of the tasks types
 const char* squidletTaskTypeStr[] = {
-  "Null", "Dummy", "Benchmark", "PovRay", "ResetStats", "EvalNeuranet"
+  "Null", "Dummy", "Benchmark", "PovRay", "ResetStats", "EvalNeuranet", 
+  "Stats", "Batch", "Exec"
 };
 
+// Environment of the process, passed to the processes run by 
+// TheSquidSpawn
+extern char** environ;
+
+// Plugins registered for the user defined task types, indexed by their 
+// type minus THESQUID_PLUGIN_FIRSTTYPE, and flags telling which ones 
+// are registered
+TheSquidTaskPlugin theSquidTaskPlugins[THESQUID_PLUGIN_MAXNB];
+bool theSquidTaskPluginRegistered[THESQUID_PLUGIN_MAXNB] = {false};
+
+// Name of the latencies measured by the protocol benchmark, the first
+// one is the whole protocol, the following ones are the phases ending 
+// at the corresponding SquidletTaskPhase
+const char* squadBenchmarkLatencyStr[SquidletTaskPhase_Nb] = {
+  "total", "connect", "request", "data", "process", "result"
+};
+
+// Name of the states of health of the squidlets
+const char* squidletHealthStr[SquidletHealth_Nb] = {
+  "closed", "open", "half-open"
+};
+
+// Name of the types of events of TheSquidEventLog
+const char* theSquidEventTypeStr[TheSquidEventType_Nb] = {
+  "AcceptConnection", "SetSockOptFailed", "RecvTaskType", 
+  "RecvTaskTypeFailed", "SendReply", "SendReplyFailed", "ProcessTask", 
+  "RecvDataSize", "RecvDataSizeFailed", "RecvData", "RecvDataFailed", 
+  "SendResultSize", "SendResultSizeFailed", "RecvAck", "RecvAckFailed", 
+  "SendResult", "SendResultFailed", "Ready", "SendTask", "TaskRefused", 
+  "SendDataFailed", "TaskCompleted", "TaskGaveUp", "TaskLost", "Dropped"
+};
+
+// ================ Module data structure ====================
+
+// Arguments and results of a thread evaluating NeuraNets on a range
+// of samples in TheSquidEvalNeuraNets
+typedef struct TheSquidEvalNeuraNetsThread {
+  // The thread
+  pthread_t _thread;
+  // The samples, their number and dimension
+  const float* _samples;
+  long _nbSample;
+  long _dimSample;
+  // Range of samples evaluated by the thread: [_first, _last[
+  long _first;
+  long _last;
+  // The NeuraNets, their number, and their number of inputs/outputs
+  NeuraNet** _nns;
+  long _nbNN;
+  long _nbInput;
+  long _nbOutput;
+  // Threshold to stop the evaluation of a NeuraNet
+  float _threshold;
+  // Norm of the error on outputs per NeuraNet and sample, stored as
+  // _errs[iNN * _nbSample + iSample], shared by all the threads
+  float* _errs;
+} TheSquidEvalNeuraNetsThread;
+
+// Partial results of a neuranet evaluation task sharded by 
+// SquadAddTask_EvalNeuraNet
+typedef struct SquadEvalNNShards {
+  // Id of the task
+  unsigned long _id;
+  // Key of the evaluation, unique in the Squad and given to its ranges 
+  // in their data ("shardKey")
+  unsigned long _key;
+  // Number of ranges of samples, and number of completed ranges
+  unsigned int _nbShard;
+  unsigned int _nbDone;
+  // Flags memorizing the completed ranges, and the failed ranges 
+  // returned to the user and not tried again yet
+  bool* _done;
+  bool* _failed;
+  // Time after which the evaluation is abandoned if one of its failed 
+  // ranges hasn't been tried again
+  time_t _expiry;
+  // Ids of the NeuraNets
+  VecLong* _nnids;
+  // Sum of errors and number of evaluated samples per NeuraNet
+  VecFloat* _sumErrs;
+  VecLong* _nbEvals;
+  // Number of samples in the category
+  long _sizeCat;
+  // Flag for the fast reject mode, and flag memorizing if the 
+  // evaluation of a NeuraNet has been stopped in one of the ranges
+  bool _fastReject;
+  bool _stopped;
+} SquadEvalNNShards;
+
+// Tasks sent together to a relay squidlet in one batch task by 
+// SquadBatchTasks
+typedef struct SquadBatch {
+  // Id of the batch task
+  unsigned long _id;
+  // The tasks, in the order of the batch, and their number
+  SquidletTaskRequest** _tasks;
+  unsigned long _nbTask;
+} SquadBatch;
+
+// Shard of the squidlets of a multithreaded Squad, stepped by its own 
+// thread, created by SquadSetNbThread
+typedef struct SquadShard {
+  // Squad executing the tasks on the squidlets of the shard, used only 
+  // by the thread of the shard
+  Squad* _squad;
+  // Squad to which the completed tasks are returned
+  Squad* _parent;
+  // Thread stepping the Squad of the shard
+  pthread_t _thread;
+  // Mutex and condition protecting the new tasks and the stop flag, 
+  // and used to wake up the thread
+  pthread_mutex_t _mutex;
+  pthread_cond_t _cond;
+  // Flag to stop the thread
+  bool _stop;
+  // Tasks handed by the parent Squad and not yet taken by the thread
+  GSetSquidletTaskRequest _inbox;
+  // Number of tasks the shard can execute at once
+  unsigned long _capacity;
+  // Number of tasks handed by the parent Squad and not yet completed, 
+  // updated by both threads
+  unsigned long _nbPending;
+} SquadShard;
+
+// Node of the queue of the tasks completed by the shards of a Squad
+typedef struct SquadCompletedNode {
+  // Next node, null until the producer pushing it has linked it
+  struct SquadCompletedNode* _next;
+  // The completed task
+  SquadRunningTask* _task;
+  // Flag to memorize if the task has already been post processed
+  bool _processed;
+} SquadCompletedNode;
+
+// Thread of a Squad post processing its completed tasks in background, 
+// created by SquadSetNbPostProcessThread
+typedef struct SquadPostProcessWorker {
+  // Squad whose tasks are post processed
+  Squad* _squad;
+  // The thread
+  pthread_t _thread;
+  // Mutex and condition protecting the tasks to post process and the 
+  // stop flag, and used to wake up the thread
+  pthread_mutex_t _mutex;
+  pthread_cond_t _cond;
+  // Flag to stop the thread
+  bool _stop;
+  // Tasks to post process, in the order of their completion
+  GSetSquadRunningTask _jobs;
+} SquadPostProcessWorker;
+
+// Samples of the task throughput measured by the benchmark for one
+// pair of payload size and number of sorts, and the result
+typedef struct SquadBenchmarkPoint {
+  // Payload size and number of sorts per task
+  long _sizePayload;
+  long _nbLoop;
+  // Number of tasks completed during the measurement
+  unsigned long _nbTask;
+  // Sum and sum of squares of the samples of throughput (tasks/s)
+  double _sum;
+  double _sumSq;
+  // Number of samples
+  long _nbSample;
+  // Duration of the measurement in ms
+  float _lengthMs;
+  // Flag to measure the protocol only with tasks without processing
+  bool _protocol;
+  // Latencies in microseconds of the protocol of the completed tasks, 
+  // in the order of squadBenchmarkLatencyStr
+  TheSquidHisto _latencies[SquidletTaskPhase_Nb];
+} SquadBenchmarkPoint;
+
 // ================ Module functions declaration ====================
 
 // Function to receive in blocking mode 'nb' bytes of data from
@@ -26,6 +200,28 @@ bool SocketRecv(
   char* buffer, 
   const time_t timeout);
 
+// Function to send in blocking mode 'nb' bytes of data from 'buffer'
+// through the socket 'sock'. Give up after 'maxWait' seconds.
+// Return true if we could send all the bytes, false else
+bool SocketSend(
+         const short sock, 
+  const unsigned long nb, 
+    const char* const buffer, 
+         const time_t maxWait);
+
+// Create a pipe in 'fds' whose ends are closed on exec 
+// Return true if it could be created, else false
+bool TheSquidPipe(
+  int* const fds);
+
+// Function to check without blocking if the connection through the 
+// socket 'sock' has been lost, i.e. it has been closed by the peer or 
+// the keepalive probes have failed 
+// Return true if the connection is lost, false if it's still alive 
+// (with or without pending data)
+bool SocketIsLost(
+  const short sock);
+
 // Append the statistical data about the squidlet 'that' to the JSON 
 // node 'json'
 void SquidletAddStatsToJSON(
@@ -33,58 +229,385 @@ void SquidletAddStatsToJSON(
         JSONNode* const json);
 
 // Update the statitics of the SquidletInfo 'that' with the result of 
-// the 'task'
+// the Stats 'task'
 void SquidletInfoUpdateStats(
          SquidletInfo* const that, 
   SquidletTaskRequest* const task);
 
+// Create a non blocking socket for the request 'request' from the 
+// Squad 'that' to the squidlet 'squidlet' and start the connection 
+// Return true if the connection is in progress or established, false 
+// else
+bool SquadConnectSquidlet(
+                Squad* const that, 
+  SquidletTaskRequest* const request, 
+         SquidletInfo* const squidlet);
+
+// Check the connection started by SquadConnectSquidlet() from the 
+// Squad 'that' to the squidlet 'squidlet', configure the socket and 
+// send the type of the task of the request 'request' 
+// Return true if the request could be sent, false else
+bool SquadSendTaskType(
+                Squad* const that, 
+  SquidletTaskRequest* const request, 
+         SquidletInfo* const squidlet);
+
+// Receive the reply of the squidlet 'squidlet' to the request 
+// 'request' from the Squad 'that'. Give up after 'maxWait' seconds. 
+// Return true if the squidlet accepted the task, false else
+bool SquadRecvTaskReply(
+                Squad* const that, 
+  SquidletTaskRequest* const request, 
+         SquidletInfo* const squidlet, 
+                const time_t maxWait);
+
+// Send the data of the task accepted by the squidlet of the 
+// 'runningTask' of the Squad 'that', and put it in the running state 
+// Return true if the data could be sent, false else
+bool SquadStartRunningTask(
+             Squad* const that, 
+  SquadRunningTask* const runningTask);
+
+// Update the history, the event log and the circuit breaker of the 
+// Squad 'that' when the squidlet 'squidlet' has refused the task 
+// 'task' or couldn't be reached
+void SquadRefusedTask(
+                      Squad* const that, 
+               SquidletInfo* const squidlet, 
+  const SquidletTaskRequest* const task);
+
+// Start the request of the task 'task' on the squidlet 'squidlet' for 
+// the Squad 'that' without waiting for the reply of the squidlet 
+// The request is added to the running tasks and completed by 
+// SquadStepDispatch() 
+// Return true if the request has been started, in which case the 
+// squidlet must be removed from the available squidlets, false else
+bool SquadDispatchTask(
+                Squad* const that, 
+         SquidletInfo* const squidlet, 
+  SquidletTaskRequest* const task);
+
+// Advance the requests of the Squad 'that' started by 
+// SquadDispatchTask(), waiting up to 'maxWait' milliseconds for the 
+// connections to the squidlets and their replies 
+// The refused requests are removed from the running tasks, their 
+// squidlet is put back in the available squidlets and their task in 
+// the set of tasks
+void SquadStepDispatch(
+     Squad* const that, 
+  const int maxWait);
+
+// Advance the request 'runningTask' of the Squad 'that', 'ready' is 
+// true if its socket has an event, false if it has timed out 
+// Return true if the request is still in progress or has been 
+// accepted, false if it has failed
+bool SquadAdvanceTaskRequest(
+             Squad* const that, 
+  SquadRunningTask* const runningTask, 
+         const bool ready);
+
+// Receive the file attached to the result of the task 'task' from the 
+// squidlet 'squidlet' of the Squad 'that', if any 
+// The file is written at the path given by the property "sendFile" of 
+// the data of the task, its size is given by the property "fileSize" 
+// of the result 
+// Return true if there was no file or it could be received, else false
+bool SquadReceiveResultFile(
+                Squad* const that, 
+         SquidletInfo* const squidlet, 
+  SquidletTaskRequest* const task);
+
+// If the squidlet 'squidlet' of the Squad 'that' is a relay, pop the 
+// tasks following 'task' in the set of tasks of 'that', up to the 
+// capacity of the squidlet, and return a batch task grouping them 
+// with 'task', else return 'task'
+SquidletTaskRequest* SquadBatchTasks(
+                Squad* const that, 
+  SquidletTaskRequest* const task, 
+   const SquidletInfo* const squidlet);
+
+// Remove from the Squad 'that' the batch whose id is 'id' and return 
+// it, or return null if there is none
+SquadBatch* SquadPopBatch(
+               Squad* const that, 
+  const unsigned long id);
+
+// Free the memory used by the SquadBatch 'that', but not its tasks
+void SquadBatchFree(
+  SquadBatch** that);
+
+// Put back in the set of tasks of the Squad 'that' the tasks of the 
+// batch task 'batch' which couldn't be executed 
+// 'batch' itself is not freed
+void SquadUnbatchTask(
+                      Squad* const that, 
+  const SquidletTaskRequest* const batch);
+
+// Post process the tasks of the completed batch task 'runningTask' of 
+// the Squad 'that' with their results, the ones to be returned are 
+// added to 'completedTasks' and the ones without result are put back 
+// in the set of tasks
+void SquadProcessCompletedBatch(
+                Squad* const that, 
+     SquadRunningTask* const runningTask, 
+  GSetSquadRunningTask* const completedTasks);
+
+// Return the number of tasks the Squad 'that' can execute at once, 
+// i.e. its number of squidlets, available or not
+unsigned long SquadGetCapacity(
+  const Squad* const that);
+
+// Main function of the thread of the SquadShard 'arg', step its Squad 
+// with the tasks handed by the parent Squad and push the completed 
+// ones in the queue of the parent, until it is stopped
+void* SquadShardRun(
+  void* arg);
+
+// Stop the threads of the shards of the Squad 'that', give back their 
+// squidlets to 'that' and their tasks not yet completed to the set of 
+// tasks of 'that'
+void SquadStopShards(
+  Squad* const that);
+
+// Push the task 'task' completed by a shard, or post processed by a 
+// background thread if 'processed' is true, in the queue of the Squad 
+// 'that', can be called by several threads at the same time
+void SquadPushCompletedTask(
+             Squad* const that, 
+  SquadRunningTask* const task, 
+             const bool processed);
+
+// Pop the next task completed by a shard, or post processed by a 
+// background thread, from the queue of the Squad 'that', and set 
+// 'processed' accordingly, or return null if the queue is empty. Must 
+// be called by one single thread
+SquadRunningTask* SquadPopCompletedTask(
+  Squad* const that, 
+   bool* const processed);
+
+// Post process the tasks completed by the shards of the Squad 'that' 
+// and add the ones to be returned to 'completedTasks', with the ones 
+// post processed by the background threads, then hand the tasks to 
+// execute to the shards which can execute more
+void SquadStepShards(
+                 Squad* const that, 
+  GSetSquadRunningTask* const completedTasks);
+
+// Hand the completed task 'task' of the Squad 'that' to the thread 
+// post processing the tasks with its id, its request is moved to the 
+// thread and will be returned by SquadStep once post processed
+void SquadPostProcessTask(
+             Squad* const that, 
+  SquadRunningTask* const task);
+
+// Return true if the completed task 'task' of the Squad 'that' is 
+// post processed by a background thread, else false
+bool SquadIsPostProcessedInBackground(
+                const Squad* const that, 
+  const SquidletTaskRequest* const task);
+
+// Main function of the SquadPostProcessWorker 'arg', post process the 
+// tasks handed by its Squad and push them in the queue of the Squad, 
+// until it is stopped and has no more task
+void* SquadPostProcessWorkerRun(
+  void* arg);
+
+// Stop the threads post processing the tasks of the Squad 'that', 
+// after they have post processed their pending tasks
+void SquadStopPostProcessWorkers(
+  Squad* const that);
+
+// Send a stats task to each available squidlet of the Squad 'that' 
+// whose last stats are older than the stats period, or than 
+// SQUAD_THERMALCOOLPERIOD if it's cooling down, or which have been 
+// requested with SquadRequestStats()
+// Squidlets to which the request has been sent are moved to the 
+// running tasks
+void SquadSendStatsHeartbeat(
+  Squad* const that);
+
 // Send the result 'bufferResult' of the processing of a task
 // by the Squidlet 'that' 
 void SquidletSendResultData(
              Squidlet* const that, 
            const char* const bufferResult);
+
+// Send the file attached to the result of the task currently processed 
+// by the Squidlet 'that' with sendfile(), without copying it in user 
+// space 
+// Return true if the whole file could be sent, else false
+bool SquidletSendResultFile(
+  Squidlet* const that);
+
+// Push the event of type 'type' with the value 'value' for the task 
+// currently processed by the Squidlet 'that' in its event log, if any
+void SquidletLogEvent(
+          Squidlet* const that, 
+  const TheSquidEventType type, 
+      const unsigned long value);
+
+// Memorize in the Squidlet 'that' the id and sub id of the task 
+// currently processed, decoded from its data 'buffer', for the event log 
+// They are left to 0 if the data doesn't start with them
+void SquidletSetTaskId(
+   Squidlet* const that, 
+  const char* const buffer);
+
+// Push the event of type 'type' for the task 'task' on the squidlet 
+// 'squidlet' with the value 'value' in the event log of the Squad 
+// 'that', if any
+void SquadLogEvent(
+                      Squad* const that, 
+          const TheSquidEventType type, 
+  const SquidletTaskRequest* const task, 
+         const SquidletInfo* const squidlet, 
+             const unsigned long value);
+
+// Send the announce 'cmd' (hello or bye) of the Squidlet 'that'
+void SquidletAnnounce(
+     Squidlet* const that, 
+  const char* const cmd);
+
+// Receive the pending announces of the squidlets on the discovery 
+// socket of the Squad 'that', add the new squidlets, and remove the 
+// available ones which said goodbye or haven't announced themselves 
+// for more than SQUAD_DISCOVERY_TIMEOUT seconds
+void SquadDiscoverSquidlets(
+  Squad* const that);
+
+// Return the squidlet of the Squad 'that' at the address 'ip':'port', 
+// available or running a task, or null if there is none
+SquidletInfo* SquadGetSquidletInfo(
+        Squad* const that, 
+  const char* const ip, 
+          const int port);
+
+// Copy the samples of the category 'cat' of the GDataSet of the 
+// Squidlet 'that' into one contiguous buffer, if they are not already
+// Return true if the samples are available, false else
+bool SquidletCacheSamples(
+  Squidlet* const that, 
+   const long cat);
+
+// Return the NeuraNet whose hash is 'hash' from the cache of the 
+// Squidlet 'that'. If 'nns' is not null and contains the definition 
+// of the NeuraNet, it is decoded and added to the cache first, in 
+// place of the oldest NeuraNet whose hash is not in 'keep' (the 
+// hashes of the NeuraNets of the current task, may be null) 
+// Return null if the NeuraNet is not available
+NeuraNet* SquidletGetNeuraNet(
+        Squidlet* const that, 
+      const char* const hash, 
+  const JSONNode* const nns, 
+  const JSONNode* const keep);
+
+// Evaluate the NeuraNets on the range of samples described by 'arg',
+// a TheSquidEvalNeuraNetsThread, and store the norm of errors in it
+void* TheSquidEvalNeuraNetsRange(
+  void* arg);
+
+// Print the HELP and TYPE lines of the Prometheus metric 'name' of 
+// type 'type' described by 'help' on the 'stream'
+void TheSquidPrintMetricHeader(
+         FILE* const stream, 
+  const char* const name, 
+  const char* const type, 
+  const char* const help);
+
+// Print the metrics of the Squad 'that' on the 'stream', 
+// TheSquidMetricsPrinter wrapper of SquadPrintMetrics
+void SquadPrintMetricsCallback(
+  const void* const that, 
+        FILE* const stream);
+
+// Print the metrics of the Squidlet 'that' on the 'stream', 
+// TheSquidMetricsPrinter wrapper of SquidletPrintMetrics
+void SquidletPrintMetricsCallback(
+  const void* const that, 
+        FILE* const stream);
+
+// Main function of the thread of the TheSquidThermal 'arg', sample 
+// its source every period until it is stopped
+void* TheSquidThermalRun(
+  void* arg);
+
+// Main function of the thread of the TheSquidEventLog 'arg', write 
+// the pushed records every period until it is stopped
+void* TheSquidEventLogRun(
+  void* arg);
+
+// Write the records pushed in the ring buffer of the TheSquidEventLog 
+// 'that' to its stream, called only by its writer thread
+void TheSquidEventLogFlush(
+  TheSquidEventLog* const that);
              
-// -------------- SquidletInfo
+// -------------- TheSquidHisto
 
 // ================ Functions implementation ====================
 
-// Return a new SquidletInfo describing a Squidlet whose name is 
-// 'name', and whose attached to the address 'ip':'port'
-SquidletInfo* SquidletInfoCreate(
-  const char* const name, 
-  const char* const ip, 
-          const int port) {
+// Return a new empty TheSquidHisto
+TheSquidHisto TheSquidHistoCreateStatic(void) {
+  // Declare the new histogram
+  TheSquidHisto that;
+
+  // Empty it
+  TheSquidHistoReset(&that);
+
+  // Return the histogram
+  return that;
+}
+
+// Empty the TheSquidHisto 'that'
+void TheSquidHistoReset(
+  TheSquidHisto* const that) {
 #if BUILDMODE == 0
-  if (name == NULL) {
+  if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'name' is null");
+    sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (ip == NULL) {
+#endif
+  memset(that->_counts, 0, sizeof(that->_counts));
+  that->_nb = 0;
+  that->_sum = 0.0;
+  that->_min = 0.0;
+  that->_max = 0.0;
+}
+
+// Add the value 'val' (positive or null) to the TheSquidHisto 'that'
+void TheSquidHistoAdd(
+  TheSquidHisto* const that, 
+             const float val) {
+#if BUILDMODE == 0
+  if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'ip' is null");
+    sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
-  // Allocate memory for the squidletInfo
-  SquidletInfo* that = PBErrMalloc(TheSquidErr, sizeof(SquidletInfo));
-  
-  // Init properties
-  that->_name = strdup(name);
-  that->_ip = strdup(ip);
-  that->_port = port;
-  that->_sock = -1;
-  
-  // Init the stats
-  SquidletInfoStatsInit(&(that->_stats));
-
-  // Return the new squidletInfo
-  return that;
+  // Get the bucket of the value, the negative values are counted as 
+  // null and the values out of range in the last bucket
+  float v = MAX(0.0, val);
+  int iBucket = 
+    (int)floor((float)THESQUID_HISTO_NBBUCKETPEROCTAVE * log2(1.0 + v));
+  iBucket = MIN(iBucket, THESQUID_HISTO_NBBUCKET - 1);
+
+  // Update the histogram
+  ++(that->_counts[iBucket]);
+  if (that->_nb == 0 || v < that->_min)
+    that->_min = v;
+  if (that->_nb == 0 || v > that->_max)
+    that->_max = v;
+  ++(that->_nb);
+  that->_sum += v;
 }
 
-// Init the stats of the SquidletInfoStats 'that' 
-void SquidletInfoStatsInit(
-  SquidletInfoStats* const that) {
+// Return the quantile 'q' (in [0.0, 1.0]) of the values of the 
+// TheSquidHisto 'that', estimated from the bounds of its bucket
+// Return 0.0 if the TheSquidHisto is empty
+float TheSquidHistoGetQuantile(
+  const TheSquidHisto* const that, 
+                 const float q) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
@@ -92,692 +615,6913 @@ void SquidletInfoStatsInit(
     PBErrCatch(TheSquidErr);
   }
 #endif
-  that->_nbAcceptedConnection = 0;
-  that->_nbAcceptedTask = 0;
-  that->_nbRefusedTask = 0;
-  that->_nbFailedReceptTaskData = 0;
-  that->_nbFailedReceptTaskSize = 0;
-  that->_nbSentResult = 0;
-  that->_nbFailedSendResult = 0;
-  that->_nbFailedSendResultSize = 0;
-  that->_nbFailedReceptAck = 0;
-  that->_nbTaskComplete = 0;
-  for (int i = 3; i--;) {
-    that->_timeToProcessMs[i] = 0.0;
-    that->_timeWaitedTaskMs[i] = 0.0;
-    that->_timeWaitedAckMs[i] = 0.0;
-    that->_timeTransferSquadSquidMs[i] = 0.0;
-    that->_timeTransferSquidSquadMs[i] = 0.0;
-  }
-}
-
-// Free the memory used by the SquidletInfo 'that'
-void SquidletInfoFree(
-  SquidletInfo** that) {
-  // If the pointer is null there is nothing to do
-  if (that == NULL || *that == NULL)
-    return;
+  if (that->_nb == 0)
+    return 0.0;
 
-  // Close the socket if it's opened
-  if ((*that)->_sock != -1)
-    close((*that)->_sock);
-    
-  // Free memory
-  if ((*that)->_name != NULL)
-    free((*that)->_name);
-  if ((*that)->_ip != NULL)
-    free((*that)->_ip);
-  free(*that);
-  *that = NULL;
+  // Get the rank of the quantile
+  unsigned long rank = 
+    (unsigned long)ceil(MAX(0.0, MIN(1.0, q)) * (float)(that->_nb));
+  rank = MAX(1, rank);
+
+  // Search the bucket containing the value at this rank
+  int iBucket = 0;
+  unsigned long nb = that->_counts[0];
+  while (nb < rank && iBucket < THESQUID_HISTO_NBBUCKET - 1) {
+    ++iBucket;
+    nb += that->_counts[iBucket];
+  }
+
+  // Return the middle of the bucket, bounded by the min and max values
+  float low = 
+    pow(2.0, (float)iBucket / THESQUID_HISTO_NBBUCKETPEROCTAVE) - 1.0;
+  float high = 
+    pow(2.0, (float)(iBucket + 1) / THESQUID_HISTO_NBBUCKETPEROCTAVE) - 
+    1.0;
+  float val = 0.5 * (low + high);
+  return MAX(that->_min, MIN(that->_max, val));
 }
 
-// Print the SquidletInfo 'that' on the file 'stream'
-void SquidletInfoPrint(
-  const SquidletInfo* const that, 
-                FILE* const stream) {
+// Return the average of the values of the TheSquidHisto 'that'
+// Return 0.0 if the TheSquidHisto is empty
+float TheSquidHistoGetMean(
+  const TheSquidHisto* const that) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (stream == NULL) {
-    TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'stream' is null");
-    PBErrCatch(TheSquidErr);
-  }
 #endif
-  // Print the info on the stream 
-  fprintf(stream, "%s(%s:%d)", that->_name, that->_ip, that->_port);
+  if (that->_nb == 0)
+    return 0.0;
+  return that->_sum / (double)(that->_nb);
 }
 
-// Print the SquidletInfoStats 'that' on the file 'stream'
-void SquidletInfoStatsPrintln(
-  const SquidletInfoStats* const that, 
-                     FILE* const stream) {
+// Add the values of the TheSquidHisto 'histo' to the TheSquidHisto 
+// 'that'
+void TheSquidHistoMerge(
+        TheSquidHisto* const that, 
+  const TheSquidHisto* const histo) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (stream == NULL) {
+  if (histo == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'stream' is null");
+    sprintf(TheSquidErr->_msg, "'histo' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
-  // Print the stats on the stream 
-  fprintf(stream, "    nbAcceptedConnection: %lu\n", 
-    that->_nbAcceptedConnection);
-  fprintf(stream, "          nbAcceptedTask: %lu\n", 
-    that->_nbAcceptedTask);
-  fprintf(stream, "           nbRefusedTask: %lu\n", 
-    that->_nbRefusedTask);
-  fprintf(stream, "  nbFailedReceptTaskData: %lu\n", 
-    that->_nbFailedReceptTaskData);
-  fprintf(stream, "  nbFailedReceptTaskSize: %lu\n", 
-    that->_nbFailedReceptTaskSize);
-  fprintf(stream, "            nbSentResult: %lu\n", 
-    that->_nbSentResult);
-  fprintf(stream, "      nbFailedSendResult: %lu\n", 
-    that->_nbFailedSendResult);
-  fprintf(stream, "  nbFailedSendResultSize: %lu\n", 
-    that->_nbFailedSendResultSize);
-  fprintf(stream, "       nbFailedReceptAck: %lu\n", 
-    that->_nbFailedReceptAck);
-  fprintf(stream, "          nbTaskComplete: %lu\n", 
-    that->_nbTaskComplete);
-  fprintf(stream, "         timeToProcessMs: %07.0f/%07.0f/%07.0f\n", 
-    that->_timeToProcessMs[0], that->_timeToProcessMs[1],
-    that->_timeToProcessMs[2]);
-  fprintf(stream, "        timeWaitedTaskMs: %07.0f/%07.0f/%07.0f\n", 
-    that->_timeWaitedTaskMs[0], that->_timeWaitedTaskMs[1],
-    that->_timeWaitedTaskMs[2]);
-  fprintf(stream, "         timeWaitedAckMs: %07.0f/%07.0f/%07.0f\n", 
-    that->_timeWaitedAckMs[0], that->_timeWaitedAckMs[1],
-    that->_timeWaitedAckMs[2]);
-  fprintf(stream, "             temperature: %03.1f/%03.1f/%03.1f\n", 
-    that->_temperature[0], that->_temperature[1],
-    that->_temperature[2]);
-  fprintf(stream, "timeTransferSquadSquidMs: %04.3f/%04.3f/%04.3f\n", 
-    that->_timeTransferSquadSquidMs[0], that->_timeTransferSquadSquidMs[1],
-    that->_timeTransferSquadSquidMs[2]);
-  fprintf(stream, "timeTransferSquidSquadMs: %04.3f/%04.3f/%04.3f\n", 
-    that->_timeTransferSquidSquadMs[0], that->_timeTransferSquidSquadMs[1],
-    that->_timeTransferSquidSquadMs[2]);
-}
-
-// -------------- SquidletTaskRequest
+  // If the histogram to add is empty, there is nothing to do
+  if (histo->_nb == 0)
+    return;
 
-// ================ Functions implementation ====================
+  // Update the min and max
+  if (that->_nb == 0 || histo->_min < that->_min)
+    that->_min = histo->_min;
+  if (that->_nb == 0 || histo->_max > that->_max)
+    that->_max = histo->_max;
+
+  // Add the buckets
+  for (int iBucket = THESQUID_HISTO_NBBUCKET; iBucket--;)
+    that->_counts[iBucket] += histo->_counts[iBucket];
+  that->_nb += histo->_nb;
+  that->_sum += histo->_sum;
+}
 
-// Return a new SquidletTaskRequest for a task of type 'type'
-// The task is identified by its 'id'/'subId', it will have at
-// maximum 'maxWait' seconds to complete. It holds a copy of 'data', a 
-// string in JSON format
-SquidletTaskRequest* SquidletTaskRequestCreate(
-   SquidletTaskType type, 
-      unsigned long id, 
-      unsigned long subId, 
-  const char* const data, 
-       const time_t maxWait) {
+// Print the number of values, the average, the 50th, 90th, 99th, 
+// 99.9th percentiles and the max of the TheSquidHisto 'that' on the 
+// file 'stream'
+void TheSquidHistoPrint(
+  const TheSquidHisto* const that, 
+                FILE* const stream) {
 #if BUILDMODE == 0
-  if (data == NULL) {
+  if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'data' is null");
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (stream == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'stream' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
-  // Allocate memory for the new SquidletTaskRequest
-  SquidletTaskRequest* that = PBErrMalloc(TheSquidErr, 
-    sizeof(SquidletTaskRequest));
-  
-  // Init properties
-  that->_id = id;
-  that->_subId = subId;
-  that->_type = type;
-  that->_data = strdup(data);
-  that->_bufferResult = NULL;
-  that->_maxWaitTime = maxWait;
-  
-  // Return the new SquidletTaskRequest
-  return that;
-}
-
-// Free the memory used by the SquidletTaskRequest 'that'
-void SquidletTaskRequestFree(
-  SquidletTaskRequest** that) {
-  // If the pointer is null there is nothing to do
-  if (that == NULL || *that == NULL)
-    return;
-  
-  // Free memory
-  if ((*that)->_bufferResult != NULL)
-    free((*that)->_bufferResult);
-  if ((*that)->_data != NULL)
-    free((*that)->_data);
-  free(*that);
-  *that = NULL;  
+  fprintf(stream, 
+    "n:%lu avg:%.3f p50:%.3f p90:%.3f p99:%.3f p999:%.3f max:%.3f",
+    that->_nb, TheSquidHistoGetMean(that), 
+    TheSquidHistoGetQuantile(that, 0.5), 
+    TheSquidHistoGetQuantile(that, 0.9), 
+    TheSquidHistoGetQuantile(that, 0.99), 
+    TheSquidHistoGetQuantile(that, 0.999), 
+    that->_max);
 }
 
-// Print the SquidletTaskRequest 'that' on the file 'stream'
-// Only a maximum of 100 first characters of the data are printed
-void SquidletTaskRequestPrint(
-  const SquidletTaskRequest* const that, 
-                       FILE* const stream) {
+// Return a new string encoding the TheSquidHisto 'that' as 
+// '<nb> <sum> <min> <max>;<bucket>:<count>,...' where only the non 
+// empty buckets are listed
+char* TheSquidHistoToStr(
+  const TheSquidHisto* const that) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
+#endif
+  // Declare a stream to write the string
+  char* str = NULL;
+  size_t len = 0;
+  FILE* stream = open_memstream(&str, &len);
   if (stream == NULL) {
-    TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'stream' is null");
+    TheSquidErr->_type = PBErrTypeIOError;
+    sprintf(TheSquidErr->_msg, "open_memstream failed (%s)", 
+      strerror(errno));
     PBErrCatch(TheSquidErr);
   }
-#endif
-
-  // Declare a buffer to truncate the data
-  #define SquidletTaskRequestPrint_lengthTrunc 100
-  char truncData[SquidletTaskRequestPrint_lengthTrunc];
-  truncData[SquidletTaskRequestPrint_lengthTrunc - 1] = '\0';
-
-  // Copy the data
-  strncpy(truncData, SquidletTaskData(that), 
-    SquidletTaskRequestPrint_lengthTrunc - 1);
 
-  // Add a mark if the data were too long
-  if (strlen(SquidletTaskData(that)) >= 
-    SquidletTaskRequestPrint_lengthTrunc) {
-    strcpy(truncData + SquidletTaskRequestPrint_lengthTrunc - 7, 
-      " (...)");
+  // Write the summary and the non empty buckets
+  fprintf(stream, "%lu %.17g %.9g %.9g;", 
+    that->_nb, that->_sum, that->_min, that->_max);
+  bool first = true;
+  for (int iBucket = 0; iBucket < THESQUID_HISTO_NBBUCKET; ++iBucket) {
+    if (that->_counts[iBucket] > 0) {
+      fprintf(stream, "%s%d:%lu", (first ? "" : ","), iBucket, 
+        that->_counts[iBucket]);
+      first = false;
+    }
   }
+  fclose(stream);
 
-  // Print the info on the stream 
-  fprintf(stream, "%s(#%lu-%lu) %s", 
-    SquidletTaskTypeAsStr(that), 
-    SquidletTaskGetId(that), 
-    SquidletTaskGetSubId(that), 
-    truncData);
+  // Return the string
+  return str;
 }
 
-// Return the type of the task 'that' as a string
-const char* SquidletTaskTypeAsStr(
-  const SquidletTaskRequest* const that) {
+// Decode the string 'str' created by TheSquidHistoToStr into the 
+// TheSquidHisto 'that'
+// Return true if the string could be decoded, else false and 'that' 
+// is empty
+bool TheSquidHistoFromStr(
+  TheSquidHisto* const that, 
+     const char* const str) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-#endif
-
-  // If the type is valid
-  if (that->_type >= 0 && that->_type < sizeof(squidletTaskTypeStr)) {
-
-    // Return the name of the type
-    return squidletTaskTypeStr[that->_type];
-
-  // Else, the name is not valid
-  } else {
-
-    // Return the name of the default type
-    return squidletTaskTypeStr[0];
-
+  if (str == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'str' is null");
+    PBErrCatch(TheSquidErr);
   }
-}
-
+#endif
+  TheSquidHistoReset(that);
 
-// -------------- SquadRunningTask
+  // Decode the summary
+  if (sscanf(str, "%lu %lf %f %f", 
+    &(that->_nb), &(that->_sum), &(that->_min), &(that->_max)) != 4) {
+    TheSquidHistoReset(that);
+    return false;
+  }
+  const char* ptr = strchr(str, ';');
+  if (ptr == NULL) {
+    TheSquidHistoReset(that);
+    return false;
+  }
+  ++ptr;
+
+  // Decode the buckets and check their total against the number 
+  // of values
+  unsigned long nb = 0;
+  while (*ptr != '\0') {
+    char* end = NULL;
+    long iBucket = strtol(ptr, &end, 10);
+    if (end == ptr || *end != ':' || 
+      iBucket < 0 || iBucket >= THESQUID_HISTO_NBBUCKET) {
+      TheSquidHistoReset(that);
+      return false;
+    }
+    ptr = end + 1;
+    unsigned long count = strtoul(ptr, &end, 10);
+    if (end == ptr || (*end != ',' && *end != '\0')) {
+      TheSquidHistoReset(that);
+      return false;
+    }
+    that->_counts[iBucket] += count;
+    nb += count;
+    ptr = (*end == ',' ? end + 1 : end);
+  }
+  if (nb != that->_nb) {
+    TheSquidHistoReset(that);
+    return false;
+  }
 
-// ================ Functions implementation ====================
+  // Return the success code
+  return true;
+}
 
-// Return a new SquadRunningTask for the SquidletTaskRequest 'request' 
-// running on the SquidletInfo 'squidlet'
-SquadRunningTask* SquadRunningTaskCreate(
-  SquidletTaskRequest* const request, 
-         SquidletInfo* const squidlet) {
+// Print the TheSquidHisto 'that' on the file 'stream' as the samples 
+// of the Prometheus histogram 'name' with the labels 'labels' (as 
+// 'a="x",b="y"', may be empty). Only the non empty buckets are printed
+void TheSquidHistoPrintPrometheus(
+  const TheSquidHisto* const that, 
+           const char* const name, 
+           const char* const labels, 
+                 FILE* const stream) {
 #if BUILDMODE == 0
-  if (request == NULL) {
+  if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'request' is null");
+    sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (squidlet == NULL) {
+  if (name == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'squidlet' is null");
+    sprintf(TheSquidErr->_msg, "'name' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (labels == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'labels' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (stream == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'stream' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
-  // Allocate memory for the new SquadRunningTask
-  SquadRunningTask* that = PBErrMalloc(TheSquidErr, 
-    sizeof(SquadRunningTask));
-  
-  // Init properties
-  that->_request = request;
-  that->_squidlet = squidlet;
-  that->_startTime = time(NULL);
-  
-  // Return the new SquadRunningTask
+  // Separator between the labels and the bucket bound
+  const char* sep = (labels[0] == '\0' ? "" : ",");
+
+  // Loop on the buckets, the Prometheus buckets are cumulative and 
+  // identified by their upper bound
+  unsigned long nb = 0;
+  for (int iBucket = 0; iBucket < THESQUID_HISTO_NBBUCKET; ++iBucket) {
+    if (that->_counts[iBucket] > 0) {
+      nb += that->_counts[iBucket];
+      float high = pow(2.0, 
+        (float)(iBucket + 1) / THESQUID_HISTO_NBBUCKETPEROCTAVE) - 1.0;
+      fprintf(stream, "%s_bucket{%s%sle=\"%g\"} %lu\n", 
+        name, labels, sep, high, nb);
+    }
+  }
+  fprintf(stream, "%s_bucket{%s%sle=\"+Inf\"} %lu\n", 
+    name, labels, sep, that->_nb);
+  fprintf(stream, "%s_sum{%s} %f\n", name, labels, that->_sum);
+  fprintf(stream, "%s_count{%s} %lu\n", name, labels, that->_nb);
+}
+
+// -------------- TheSquidMetrics
+
+// ================ Functions implementation ====================
+
+// Return a new TheSquidMetrics listening on the port 'port' of all
+// the interfaces of the device
+// Return null if the socket couldn't be opened
+TheSquidMetrics* TheSquidMetricsCreate(
+  const int port) {
+  // Allocate memory
+  TheSquidMetrics* that = PBErrMalloc(TheSquidErr, 
+    sizeof(TheSquidMetrics));
+  that->_port = port;
+  that->_nbScrape = 0;
+
+  // Open the socket
+  that->_fd = socket(AF_INET, SOCK_STREAM, 0);
+
+  // If we couldn't open the socket
+  if (that->_fd == -1) {
+
+    // Free memory and return null
+    free(that);
+    sprintf(TheSquidErr->_msg, "socket() failed");
+    return NULL;
+  }
+
+  // Make the socket non blocking, so that accept() returns immediately
+  // when there is no pending scrape
+  int reuse = 1;
+  int flags = fcntl(that->_fd, F_GETFL, 0);
+  bool ret = (flags != -1 && 
+    fcntl(that->_fd, F_SETFL, flags | O_NONBLOCK) != -1);
+  ret &= (setsockopt(that->_fd, SOL_SOCKET, SO_REUSEADDR,
+    &reuse, sizeof(int)) != -1);
+
+  // Bind the socket on the requested port and listen through it
+  struct sockaddr_in sock;
+  memset(&sock, 0, sizeof(struct sockaddr_in));
+  sock.sin_family = AF_INET;
+  sock.sin_addr.s_addr = htonl(INADDR_ANY);
+  sock.sin_port = htons(port);
+  ret = ret && (bind(that->_fd, (struct sockaddr *)&sock, 
+    sizeof(struct sockaddr_in)) != -1);
+  ret = ret && (listen(that->_fd, THESQUID_METRICS_NBMAXSCRAPE) != -1);
+
+  // If we couldn't setup the socket
+  if (ret == false) {
+
+    // Free memory and return null
+    close(that->_fd);
+    free(that);
+    sprintf(TheSquidErr->_msg, "couldn't listen on port %d", port);
+    return NULL;
+  }
+
+  // Return the new TheSquidMetrics
   return that;
 }
 
-// Free the memory used by the SquadRunningTask 'that'
-void SquadRunningTaskFree(
-  SquadRunningTask** that) {
+// Free the memory used by the TheSquidMetrics 'that'
+void TheSquidMetricsFree(
+  TheSquidMetrics** that) {
   // If the pointer is null there is nothing to do
   if (that == NULL || *that == NULL)
     return;
-  
+
+  // Close the socket
+  close((*that)->_fd);
+
   // Free memory
   free(*that);
   *that = NULL;
 }
 
-// Print the SquadRunningTask 'that' on the file 'stream'
-void SquadRunningTaskPrint(
-  const SquadRunningTask* const that, 
-                    FILE* const stream) {
+// Reply to the pending scrapes of the TheSquidMetrics 'that' with the 
+// metrics printed by 'printer' for 'data', whatever the requested 
+// path. Return immediately if there is no pending scrape, serve at 
+// most THESQUID_METRICS_NBMAXSCRAPE scrapes
+// Return the number of served scrapes
+int TheSquidMetricsServe(
+         TheSquidMetrics* const that, 
+  const TheSquidMetricsPrinter printer, 
+              const void* const data) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (stream == NULL) {
+  if (printer == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'stream' is null");
+    sprintf(TheSquidErr->_msg, "'printer' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
-  // Print the info on the stream 
-  fprintf(stream, "[");
-  if (that->_request != NULL) {
-    SquidletTaskRequestPrint(that->_request, stream);
-  } else {
-    fprintf(stream, "<null>");
-  }
-  fprintf(stream, "]/[");
-  if (that->_squidlet != NULL) {
-    SquidletInfoPrint(that->_squidlet, stream);
-  } else {
-    fprintf(stream, "<null>");
-  }
-  fprintf(stream, "]");
-}
+  // Declare a variable to count the served scrapes
+  int nbServed = 0;
 
-// -------------- Squad
+  // Loop on the pending scrapes
+  while (nbServed < THESQUID_METRICS_NBMAXSCRAPE) {
 
-// ================ Functions declaration ====================
+    // Extract the next pending connection, if there is none stop here
+    int sock = accept(that->_fd, NULL, NULL);
+    if (sock < 0)
+      break;
 
-// Decode the JSON info of a Squad from the JSON node 'json'
-bool SquadDecodeAsJSON(
-     Squad* that, 
-  JSONNode* json);
+    // The accepted socket is blocking, limit the time to receive the 
+    // request and send the reply
+    struct timeval tv;
+    tv.tv_sec = THESQUID_METRICS_TIMEOUTMS / 1000;
+    tv.tv_usec = (THESQUID_METRICS_TIMEOUTMS % 1000) * 1000;
+    (void)setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, 
+      (char*)&tv, sizeof(tv));
+    (void)setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, 
+      (char*)&tv, sizeof(tv));
+
+    // Receive the HTTP request, its content is ignored
+    char request[1024];
+    (void)recv(sock, request, sizeof(request), 0);
+
+    // Print the metrics into memory
+    char* body = NULL;
+    size_t len = 0;
+    FILE* stream = open_memstream(&body, &len);
+    if (stream != NULL) {
+      (*printer)(data, stream);
+      fclose(stream);
+    }
 
-// Refresh the content of the TextOMeter attached to the 
-// Squad 'that'
-void SquadUpdateTextOMeter(
-  const Squad* const that);
+    // Send the reply, the scraper may have already closed the 
+    // connection, avoid the SIGPIPE in that case
+    char header[200];
+    sprintf(header, "HTTP/1.0 200 OK\r\n"
+      "Content-Type: text/plain; version=0.0.4\r\n"
+      "Content-Length: %lu\r\nConnection: close\r\n\r\n", 
+      (unsigned long)len);
+    bool ret = (send(sock, header, strlen(header), MSG_NOSIGNAL) != -1);
+    size_t nbSent = 0;
+    while (ret && nbSent < len) {
+      ssize_t nb = send(sock, body + nbSent, len - nbSent, MSG_NOSIGNAL);
+      ret = (nb > 0);
+      if (ret)
+        nbSent += nb;
+    }
 
-// Add one line to the history of messages for the TextOMeter
-// 'msg' is truncated if it doesn't fit in one line of history
-// If the TextOmeter is not turned on, do nothing
-// Variadic function with the same signature as printf family
-void SquadPushHistory(
-  Squad* const that, 
-         char* msg,
-               ...);
+    // Free memory
+    if (body != NULL)
+      free(body);
+    close(sock);
 
-// Add the result of SquidletInfoPrint(squidlet) to the history
-// of messages for the TextOMeter
-// The output of SquidletInfoPrint is truncated if it doesn't fit in
-// one line of history
-// If the TextOmeter is not turned on, do nothing
-void SquadPushHistorySquidletInfo(
-               Squad* const that, 
-  const SquidletInfo* const squidlet);
+    // Update the counters
+    ++nbServed;
+    ++(that->_nbScrape);
+  }
 
-// Add the result of SquidletTaskRequestPrint(request) to the history
-// of messages for the TextOMeter
-// The output of SquidletTaskRequest is truncated if it doesn't fit in
-// one line of history
-// If the TextOmeter is not turned on, do nothing
-void SquadPushHistorySquidletTaskRequest(
-                      Squad* const that, 
-  const SquidletTaskRequest* const request);
+  // Return the number of served scrapes
+  return nbServed;
+}
 
-// Add the result of SquadRunningTaskPrint(request) to the history
-// of messages for the TextOMeter
-// The output of SquadRunningTaskPrint is truncated if it doesn't fit in
-// one line of history
-// If the TextOmeter is not turned on, do nothing
-void SquadPushHistorySquadRunningTask(
-                   Squad* const that, 
-  const SquadRunningTask* const task);
+// Print the HELP and TYPE lines of the Prometheus metric 'name' of 
+// type 'type' described by 'help' on the 'stream'
+void TheSquidPrintMetricHeader(
+         FILE* const stream, 
+  const char* const name, 
+  const char* const type, 
+  const char* const help) {
+  fprintf(stream, "# HELP %s %s\n", name, help);
+  fprintf(stream, "# TYPE %s %s\n", name, type);
+}
+
+// -------------- TheSquidThermal
 
-// Request the execution of a task on a squidlet for the squad 'that'
-// Return true if the request was successfull, fals else
-bool SquadSendTaskOnSquidlet(
-  Squad* const that, 
-  SquidletInfo* const squidlet, 
-  SquidletTaskRequest* const task);
-  
 // ================ Functions implementation ====================
 
-// Return a new Squad
-Squad* SquadCreate(void) {
-  // Allocate memory for the squad
-  Squad* that = PBErrMalloc(TheSquidErr, sizeof(Squad));
-  
-  // Open the TCP/IP socket
-  // AF_INET: IPv4 Internet protocols
-  // SOCK_STREAM: Provides sequenced, reliable, two-way, 
-  // connection-based byte streams.
-  int defaultProtocol = 0;
-  that->_fd = socket(AF_INET, SOCK_STREAM, defaultProtocol);
-  
-  // If we couldn't open the socket
-  if (that->_fd == -1) {
+// Return a new TheSquidThermal sampling the 'source' with the user 
+// 'data' every 'periodMs' milliseconds in a background thread 
+// The source is sampled once before returning 
+// Return null if the thread couldn't be created
+TheSquidThermal* TheSquidThermalCreate(
+  const TheSquidThermalSource source, 
+                   void* const data, 
+            const unsigned int periodMs) {
+#if BUILDMODE == 0
+  if (source == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'source' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Allocate memory for the sampler
+  TheSquidThermal* that = PBErrMalloc(TheSquidErr, 
+    sizeof(TheSquidThermal));
+
+  // Init properties
+  that->_source = source;
+  that->_data = data;
+  that->_periodMs = MAX(1, periodMs);
+  that->_temperature = 0.0;
+  that->_throttled = false;
+  that->_stop = false;
+  pthread_mutex_init(&(that->_mutex), NULL);
+  pthread_cond_init(&(that->_cond), NULL);
+
+  // Sample once to have a value available immediately
+  float temperature = 0.0;
+  bool throttled = false;
+  if (that->_source(that->_data, &temperature, &throttled) == true) {
+    that->_temperature = temperature;
+    that->_throttled = throttled;
+  }
+
+  // Start the thread with all the signals blocked, to leave their 
+  // handling (Ctrl-C) to the thread of the caller
+  sigset_t set;
+  sigset_t prevSet;
+  sigfillset(&set);
+  pthread_sigmask(SIG_SETMASK, &set, &prevSet);
+  int ret = pthread_create(&(that->_thread), NULL, TheSquidThermalRun, 
+    that);
+  pthread_sigmask(SIG_SETMASK, &prevSet, NULL);
+
+  // If we couldn't create the thread
+  if (ret != 0) {
 
     // Free memory and return null
+    pthread_cond_destroy(&(that->_cond));
+    pthread_mutex_destroy(&(that->_mutex));
     free(that);
+    sprintf(TheSquidErr->_msg, "pthread_create() failed");
     return NULL;
   }
 
-  // Init properties
-  that->_squidlets = GSetSquidletInfoCreateStatic();
-  that->_tasks = GSetSquidletTaskRequestCreateStatic();
-  that->_runningTasks = GSetSquadRunningTaskCreateStatic();
-  that->_flagTextOMeter = false;
-  that->_textOMeter = NULL;
-  for (int iLine = 0; iLine < SQUAD_TXTOMETER_NBLINEHISTORY; ++iLine) {
-    that->_history[iLine][0] = '\n';
-    that->_history[iLine][1] = '\0';
-  }
-  that->_countLineHistory = 0;
-
-  // Return the new squad
+  // Return the new sampler
   return that;
 }
 
-// Free the memory used by the Squad 'that'
-void SquadFree(
-  Squad** that) {
+// Stop the thread and free the memory used by the TheSquidThermal 
+// 'that'
+void TheSquidThermalFree(
+  TheSquidThermal** that) {
   // If the pointer is null there is nothing to do
   if (that == NULL || *that == NULL)
     return;
 
-  // Close the socket
-  close((*that)->_fd);
+  // Stop the thread and wait for it
+  pthread_mutex_lock(&((*that)->_mutex));
+  (*that)->_stop = true;
+  pthread_cond_signal(&((*that)->_cond));
+  pthread_mutex_unlock(&((*that)->_mutex));
+  pthread_join((*that)->_thread, NULL);
 
   // Free memory
-  while (GSetNbElem(SquadSquidlets(*that)) > 0) {
-    SquidletInfo* squidletInfo = GSetPop((GSet*)SquadSquidlets(*that));
-    SquidletInfoFree(&squidletInfo);
-  }
-  while (GSetNbElem(SquadTasks(*that)) > 0) {
-    SquidletTaskRequest* task = GSetPop((GSet*)SquadTasks(*that));
-    SquidletTaskRequestFree(&task);
-  }
-  while (GSetNbElem(SquadRunningTasks(*that)) > 0) {
-    SquadRunningTask* task = GSetPop((GSet*)SquadRunningTasks(*that));
-    SquadRunningTaskFree(&task);
-  }
-  if ((*that)->_textOMeter != NULL) {
-    TextOMeterFree(&((*that)->_textOMeter));
-  }
+  pthread_cond_destroy(&((*that)->_cond));
+  pthread_mutex_destroy(&((*that)->_mutex));
   free(*that);
   *that = NULL;
 }
 
-// Load a list of tasks stored in json format from the file 'stream'
-// and add them to the set of tasks of the Squad 'that'
-// If the Squad had already tasks, the loaded ones are added to them
-// Return true if the tasks could be loaded, else false
-// Example of list of tasks:
-// {"tasks":[
-//   {"SquidletTaskType":"1", "id":"1", "maxWait":"1"},  
-//   {"SquidletTaskType":"2", "id":"1", "maxWait":"1", 
-//    "nb":"1", "payloadSize":"1"},
-//   {"SquidletTaskType":"3", "id":"1", "maxWait":"1", 
-//    "ini":"./testPov.ini", "sizeMinFragment":"100", 
-//    "sizeMaxFragment":"1000"}
-// ]}
-bool SquadLoadTasks(
-  Squad* const that, 
-   FILE* const stream) {
+// Main function of the thread of the TheSquidThermal 'arg', sample 
+// its source every period until it is stopped
+void* TheSquidThermalRun(
+  void* arg) {
+  TheSquidThermal* that = arg;
+  pthread_mutex_lock(&(that->_mutex));
+  while (that->_stop == false) {
+
+    // Wait for the period or the stop signal
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += that->_periodMs / 1000;
+    deadline.tv_nsec += (long)(that->_periodMs % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+      deadline.tv_sec += 1;
+      deadline.tv_nsec -= 1000000000L;
+    }
+    int ret = 0;
+    while (that->_stop == false && ret != ETIMEDOUT) {
+      ret = pthread_cond_timedwait(&(that->_cond), &(that->_mutex), 
+        &deadline);
+    }
+    if (that->_stop == true)
+      break;
+
+    // Sample the source without holding the mutex, the source may be 
+    // slow
+    pthread_mutex_unlock(&(that->_mutex));
+    float temperature = 0.0;
+    bool throttled = false;
+    bool success = that->_source(that->_data, &temperature, &throttled);
+    pthread_mutex_lock(&(that->_mutex));
+
+    // Update the sampled values
+    if (success == true) {
+      that->_temperature = temperature;
+      that->_throttled = throttled;
+    } else {
+      that->_temperature = 0.0;
+      that->_throttled = false;
+    }
+  }
+  pthread_mutex_unlock(&(that->_mutex));
+  return NULL;
+}
+
+// Return the last sampled temperature of the TheSquidThermal 'that' 
+// Never blocks on the source
+float TheSquidThermalGetTemperature(
+  const TheSquidThermal* const that) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (stream == NULL) {
+#endif
+  pthread_mutex_t* mutex = (pthread_mutex_t*)&(that->_mutex);
+  pthread_mutex_lock(mutex);
+  float temperature = that->_temperature;
+  pthread_mutex_unlock(mutex);
+  return temperature;
+}
+
+// Return the last sampled throttled state of the TheSquidThermal 
+// 'that' 
+// Never blocks on the source
+bool TheSquidThermalIsThrottled(
+  const TheSquidThermal* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'stream' is null");
+    sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
-  // Declare a json to load the encoded data
-  JSONNode* json = JSONCreate();
+  pthread_mutex_t* mutex = (pthread_mutex_t*)&(that->_mutex);
+  pthread_mutex_lock(mutex);
+  bool throttled = that->_throttled;
+  pthread_mutex_unlock(mutex);
+  return throttled;
+}
 
-  // Load the whole encoded data
-  if (JSONLoad(json, stream) == false) {
-    TheSquidErr->_type = PBErrTypeIOError;
-    sprintf(TheSquidErr->_msg, "JSONLoad failed");
-    JSONFree(&json);
-    return false;
-  }
-  
-  // Get the list of tasks
-  JSONNode* propTasks = JSONProperty(json, "tasks");
-  if (propTasks == NULL) {
-    TheSquidErr->_type = PBErrTypeInvalidData;
-    sprintf(TheSquidErr->_msg, "tasks not found");
-    JSONFree(&json);
+// TheSquidThermalSource reading THESQUID_THERMAL_PATHTEMP and 
+// THESQUID_THERMAL_PATHTHROTTLED, 'data' is not used 
+// The throttled state is false if its file is not available
+bool TheSquidThermalSourceSysfs(
+    void* const data, 
+   float* const temperature, 
+    bool* const throttled) {
+#if BUILDMODE == 0
+  if (temperature == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'temperature' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (throttled == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'throttled' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // The user data are not used
+  (void)data;
+
+  // Read the temperature, given in millidegree Celsius
+  FILE* fp = fopen(THESQUID_THERMAL_PATHTEMP, "r");
+  if (fp == NULL)
     return false;
+  long milliDegree = 0;
+  int ret = fscanf(fp, "%ld", &milliDegree);
+  fclose(fp);
+  if (ret != 1)
+    return false;
+  *temperature = (float)milliDegree / 1000.0;
+
+  // Read the throttled state, given as a bit mask in hexadecimal
+  *throttled = false;
+  fp = fopen(THESQUID_THERMAL_PATHTHROTTLED, "r");
+  if (fp != NULL) {
+    unsigned int mask = 0;
+    if (fscanf(fp, "%x", &mask) == 1)
+      *throttled = ((mask & THESQUID_THERMAL_MASKTHROTTLED) != 0);
+    fclose(fp);
+  }
+
+  // Return the success code
+  return true;
+}
+
+// TheSquidThermalSource returning the temperature pointed to by 
+// 'data' (a float*, 0.0 if null) and never throttled, used on the 
+// architectures without sensor and for tests 
+// The temperature is read atomically, it must be updated with 
+// __atomic_store while the sampler thread is running
+bool TheSquidThermalSourceStub(
+    void* const data, 
+   float* const temperature, 
+    bool* const throttled) {
+#if BUILDMODE == 0
+  if (temperature == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'temperature' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (throttled == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'throttled' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  *temperature = 0.0;
+  if (data != NULL)
+    __atomic_load((float*)data, temperature, __ATOMIC_RELAXED);
+  *throttled = false;
+  return true;
+}
+
+// -------------- SquidletInfo
+
+// ================ Functions implementation ====================
+
+// Return a new SquidletInfo describing a Squidlet whose name is 
+// 'name', and whose attached to the address 'ip':'port'
+SquidletInfo* SquidletInfoCreate(
+  const char* const name, 
+  const char* const ip, 
+          const int port) {
+#if BUILDMODE == 0
+  if (name == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'name' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (ip == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'ip' is null");
+    PBErrCatch(TheSquidErr);
   }
+#endif
+  // Allocate memory for the squidletInfo
+  SquidletInfo* that = PBErrMalloc(TheSquidErr, sizeof(SquidletInfo));
   
-  // Get the number of tasks
-  unsigned long nbTasks = JSONGetNbValue(propTasks);
+  // Init properties
+  that->_name = strdup(name);
+  that->_ip = strdup(ip);
+  that->_port = port;
+  that->_sock = -1;
+  that->_timeLastStats = 0;
+  that->_temperature = 0.0;
+  that->_temperatureTrend = 0.0;
+  that->_temperatureRef = 0.0;
+  that->_timeTemperatureRef = 0;
+  that->_throttled = false;
+  that->_cooling = false;
+  that->_timeLastAnnounce = 0;
+  that->_timeQuarantineEnd = 0;
+  that->_quarantineDelay = 0;
+  that->_health = SquidletHealth_Closed;
+  that->_nbFailure = 0;
+  that->_capacity = 1;
   
-  // Loop on tasks
-  for (unsigned long iTask = 0; iTask < nbTasks; ++iTask) {
+  // Init the stats
+  SquidletInfoStatsInit(&(that->_stats));
 
-    // Get the task
-    JSONNode* propTask = JSONValue(propTasks, iTask);
-    
-    // Get the type of task, id and time out
-    JSONNode* propType = JSONProperty(propTask, "SquidletTaskType");
-    if (propType == NULL) {
-      TheSquidErr->_type = PBErrTypeInvalidData;
-      sprintf(TheSquidErr->_msg, "'SquidletTaskType' not found");
-      JSONFree(&json);
-      return false;
-    }
-    JSONNode* propId = JSONProperty(propTask, "id");
-    if (propId == NULL) {
-      TheSquidErr->_type = PBErrTypeInvalidData;
-      sprintf(TheSquidErr->_msg, "'id' not found");
-      JSONFree(&json);
-      return false;
-    }
-    JSONNode* propMaxWait = JSONProperty(propTask, "maxWait");
-    if (propMaxWait == NULL) {
-      TheSquidErr->_type = PBErrTypeInvalidData;
-      sprintf(TheSquidErr->_msg, "'maxWait' not found");
-      JSONFree(&json);
-      return false;
-    }
-    
-    // Convert values
-    int type = atoi(JSONLblVal(propType));
-    unsigned long id = atol(JSONLblVal(propId));
-    time_t maxWait = atoi(JSONLblVal(propMaxWait));
+  // Init the hashes of inlined NeuraNets
+  SquidletInfoForgetNeuraNets(that);
 
-    // Switch according to the type of task and add the corresponding 
-    // task
-    JSONNode* prop = NULL;
-    switch(type) {
-      
-      // Dummy task
-      case SquidletTaskType_Dummy:
-        
-        // Add the task
-        SquadAddTask_Dummy(that, id, maxWait);
-        break;
-      
-      // Benchmark task
-      case SquidletTaskType_Benchmark:
-        
-        // Get the extra arguments
-        prop = JSONProperty(propTask, "nb");
-        if (prop == NULL) {
-          TheSquidErr->_type = PBErrTypeInvalidData;
-          sprintf(TheSquidErr->_msg, "'nb' not found");
-          JSONFree(&json);
-          return false;
-        }
-        int nb = atoi(JSONLblVal(prop));
-        prop = JSONProperty(propTask, "payloadSize");
-        if (prop == NULL) {
-          TheSquidErr->_type = PBErrTypeInvalidData;
-          sprintf(TheSquidErr->_msg, "'payloadSize' not found");
-          JSONFree(&json);
-          return false;
-        }
-        size_t payloadSize = atol(JSONLblVal(prop));
+  // Return the new squidletInfo
+  return that;
+}
 
-        // Add the task
-        SquadAddTask_Benchmark(that, id, maxWait, nb, payloadSize);
-        break;
+// Put the SquidletInfo 'that' in quarantine (open its circuit 
+// breaker), for SQUAD_QUARANTINEMIN seconds the first time, then for 
+// twice the previous delay up to SQUAD_QUARANTINEMAX seconds until it 
+// completes a task
+void SquidletInfoQuarantine(
+  SquidletInfo* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Exponential backoff of the delay of quarantine
+  if (that->_quarantineDelay == 0)
+    that->_quarantineDelay = SQUAD_QUARANTINEMIN;
+  else
+    that->_quarantineDelay = 
+      MIN(2 * that->_quarantineDelay, SQUAD_QUARANTINEMAX);
+  that->_timeQuarantineEnd = time(NULL) + that->_quarantineDelay;
+  that->_health = SquidletHealth_Open;
+}
 
-      // POV-Ray task
-      case SquidletTaskType_PovRay:
+// Return true if the SquidletInfo 'that' is in quarantine (its circuit 
+// breaker is open), false else
+bool SquidletInfoIsQuarantined(
+  const SquidletInfo* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  return (SquidletInfoGetHealth(that) == SquidletHealth_Open);
+}
 
-        // Get the extra arguments
-        prop = JSONProperty(propTask, "ini");
-        if (prop == NULL) {
-          TheSquidErr->_type = PBErrTypeInvalidData;
-          sprintf(TheSquidErr->_msg, "ini not found");
-          JSONFree(&json);
-          return false;
-        }
-        char* ini = strdup(JSONLblVal(prop));
-        prop = JSONProperty(propTask, "sizeMinFragment");
-        if (prop == NULL) {
-          TheSquidErr->_type = PBErrTypeInvalidData;
-          sprintf(TheSquidErr->_msg, "sizeMinFragment not found");
-          JSONFree(&json);
-          return false;
-        }
-        int sizeMinFragment = atoi(JSONLblVal(prop));
-        prop = JSONProperty(propTask, "sizeMaxFragment");
-        if (prop == NULL) {
-          TheSquidErr->_type = PBErrTypeInvalidData;
-          sprintf(TheSquidErr->_msg, "sizeMaxFragment not found");
-          JSONFree(&json);
-          return false;
-        }
-        int sizeMaxFragment = atoi(JSONLblVal(prop));
+// Return the health (state of the circuit breaker) of the 
+// SquidletInfo 'that'
+SquidletHealth SquidletInfoGetHealth(
+  const SquidletInfo* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // The circuit becomes half open at the end of the quarantine
+  if (that->_health == SquidletHealth_Open && 
+    time(NULL) >= that->_timeQuarantineEnd)
+    return SquidletHealth_HalfOpen;
+  return that->_health;
+}
 
-        // Add the task
-        SquadAddTask_PovRay(that, id, maxWait, ini, 
-          sizeMinFragment, sizeMaxFragment);
+// Update the circuit breaker of the SquidletInfo 'that' after a 
+// failure to connect to it or to have a task accepted by it: the 
+// circuit is opened after SQUAD_BREAKERNBFAILURE consecutive failures, 
+// or after the failure of the probe if it's half open
+void SquidletInfoReportFailure(
+  SquidletInfo* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  ++(that->_nbFailure);
+  if (SquidletInfoGetHealth(that) == SquidletHealth_HalfOpen ||
+    that->_nbFailure >= SQUAD_BREAKERNBFAILURE)
+    SquidletInfoQuarantine(that);
+}
 
-        // Free memory
-        free(ini);
-        break;
+// Update the circuit breaker of the SquidletInfo 'that' after it has 
+// accepted a task: the circuit is closed
+void SquidletInfoReportSuccess(
+  SquidletInfo* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  that->_nbFailure = 0;
+  that->_health = SquidletHealth_Closed;
+}
 
-      // Stats reset task
-      case SquidletTaskType_ResetStats:
-        
-        // Ignore this special task which can be only triggered
-        // at runtime
-        break;
+// Init the stats of the SquidletInfoStats 'that' 
+void SquidletInfoStatsInit(
+  SquidletInfoStats* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  that->_nbAcceptedConnection = 0;
+  that->_nbAcceptedTask = 0;
+  that->_nbRefusedTask = 0;
+  that->_nbFailedReceptTaskData = 0;
+  that->_nbFailedReceptTaskSize = 0;
+  that->_nbSentResult = 0;
+  that->_nbFailedSendResult = 0;
+  that->_nbFailedSendResultSize = 0;
+  that->_nbFailedReceptAck = 0;
+  that->_nbTaskComplete = 0;
+  TheSquidHistoReset(&(that->_timeToProcessMs));
+  for (int iType = SquidletTaskType_Nb; iType--;)
+    TheSquidHistoReset(that->_timeToProcessMsPerType + iType);
+  TheSquidHistoReset(&(that->_timeWaitedTaskMs));
+  TheSquidHistoReset(&(that->_timeWaitedAckMs));
+  TheSquidHistoReset(&(that->_temperature));
+  TheSquidHistoReset(&(that->_timeTransferSquadSquidUsPerKB));
+  TheSquidHistoReset(&(that->_timeTransferSquidSquadUsPerKB));
+  that->_nbByteSent = 0;
+  that->_nbByteReceived = 0;
+}
 
-      // Neuranet evaluation task
-      case SquidletTaskType_EvalNeuranet:
-        
-        prop = JSONProperty(propTask, "dataset");
-        if (prop == NULL) {
-          TheSquidErr->_type = PBErrTypeInvalidData;
-          sprintf(TheSquidErr->_msg, "dataset not found");
-          JSONFree(&json);
-          return false;
-        }
-        char* dataset = JSONLblVal(prop);
-        prop = JSONProperty(propTask, "workingDir");
-        if (prop == NULL) {
-          TheSquidErr->_type = PBErrTypeInvalidData;
-          sprintf(TheSquidErr->_msg, "workingDir not found");
+// Add the stats of the SquidletInfoStats 'stats' to the 
+// SquidletInfoStats 'that', to get the stats over several squidlets
+void SquidletInfoStatsMerge(
+        SquidletInfoStats* const that, 
+  const SquidletInfoStats* const stats) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (stats == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'stats' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Add the counters
+  that->_nbAcceptedConnection += stats->_nbAcceptedConnection;
+  that->_nbAcceptedTask += stats->_nbAcceptedTask;
+  that->_nbRefusedTask += stats->_nbRefusedTask;
+  that->_nbFailedReceptTaskData += stats->_nbFailedReceptTaskData;
+  that->_nbFailedReceptTaskSize += stats->_nbFailedReceptTaskSize;
+  that->_nbSentResult += stats->_nbSentResult;
+  that->_nbFailedSendResult += stats->_nbFailedSendResult;
+  that->_nbFailedSendResultSize += stats->_nbFailedSendResultSize;
+  that->_nbFailedReceptAck += stats->_nbFailedReceptAck;
+  that->_nbTaskComplete += stats->_nbTaskComplete;
+  that->_nbByteSent += stats->_nbByteSent;
+  that->_nbByteReceived += stats->_nbByteReceived;
+
+  // Merge the histograms
+  TheSquidHistoMerge(&(that->_timeToProcessMs), 
+    &(stats->_timeToProcessMs));
+  for (int iType = SquidletTaskType_Nb; iType--;)
+    TheSquidHistoMerge(that->_timeToProcessMsPerType + iType, 
+      stats->_timeToProcessMsPerType + iType);
+  TheSquidHistoMerge(&(that->_timeWaitedTaskMs), 
+    &(stats->_timeWaitedTaskMs));
+  TheSquidHistoMerge(&(that->_timeWaitedAckMs), 
+    &(stats->_timeWaitedAckMs));
+  TheSquidHistoMerge(&(that->_temperature), &(stats->_temperature));
+  TheSquidHistoMerge(&(that->_timeTransferSquadSquidUsPerKB), 
+    &(stats->_timeTransferSquadSquidUsPerKB));
+  TheSquidHistoMerge(&(that->_timeTransferSquidSquadUsPerKB), 
+    &(stats->_timeTransferSquidSquadUsPerKB));
+}
+
+// Forget the inlined NeuraNets the SquidletInfo 'that' is supposed to
+// know, they will be sent again with the next tasks
+void SquidletInfoForgetNeuraNets(
+  SquidletInfo* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  for (int iHash = THESQUID_NBNNCACHE; iHash--;)
+    that->_nnHashes[iHash][0] = '\0';
+  that->_nextNNHash = 0;
+}
+
+// Memorize that the squidlet of the SquidletInfo 'that' has added 
+// the NeuraNet whose hash is 'hash' to its cache, in place of the 
+// oldest one whose hash is not in 'keep' (the hashes of the NeuraNets 
+// of the current task), as the squidlet does
+void SquidletInfoAddNeuraNet(
+  SquidletInfo* const that, 
+    const char* const hash, 
+     const GSet* const keep) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (hash == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'hash' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (keep == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'keep' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+
+  // Search the oldest hash which is not needed by the current task, 
+  // there is always one, the tasks have at most THESQUID_NBNNCACHE 
+  // NeuraNets
+  int iHash = that->_nextNNHash;
+  bool needed = true;
+  for (int iTry = THESQUID_NBNNCACHE; iTry-- && needed;) {
+    needed = false;
+    if (GSetNbElem(keep) > 0) {
+      GSetIterForward iter = GSetIterForwardCreateStatic((GSet*)keep);
+      do {
+        needed = (strcmp(that->_nnHashes[iHash], GSetIterGet(&iter)) == 0);
+      } while (!needed && GSetIterStep(&iter));
+    }
+    if (needed == true)
+      iHash = (iHash + 1) % THESQUID_NBNNCACHE;
+  }
+
+  // Replace it
+  strncpy(that->_nnHashes[iHash], hash, THESQUID_NNHASHLENGTH);
+  that->_nnHashes[iHash][THESQUID_NNHASHLENGTH] = '\0';
+  that->_nextNNHash = (iHash + 1) % THESQUID_NBNNCACHE;
+}
+
+// Free the memory used by the SquidletInfo 'that'
+void SquidletInfoFree(
+  SquidletInfo** that) {
+  // If the pointer is null there is nothing to do
+  if (that == NULL || *that == NULL)
+    return;
+
+  // Close the socket if it's opened
+  if ((*that)->_sock != -1)
+    close((*that)->_sock);
+    
+  // Free memory
+  if ((*that)->_name != NULL)
+    free((*that)->_name);
+  if ((*that)->_ip != NULL)
+    free((*that)->_ip);
+  free(*that);
+  *that = NULL;
+}
+
+// Print the SquidletInfo 'that' on the file 'stream'
+void SquidletInfoPrint(
+  const SquidletInfo* const that, 
+                FILE* const stream) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (stream == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'stream' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Print the info on the stream 
+  fprintf(stream, "%s(%s:%d)", that->_name, that->_ip, that->_port);
+}
+
+// Print the SquidletInfoStats 'that' on the file 'stream'
+void SquidletInfoStatsPrintln(
+  const SquidletInfoStats* const that, 
+                     FILE* const stream) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (stream == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'stream' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Print the stats on the stream 
+  fprintf(stream, "    nbAcceptedConnection: %lu\n", 
+    that->_nbAcceptedConnection);
+  fprintf(stream, "          nbAcceptedTask: %lu\n", 
+    that->_nbAcceptedTask);
+  fprintf(stream, "           nbRefusedTask: %lu\n", 
+    that->_nbRefusedTask);
+  fprintf(stream, "  nbFailedReceptTaskData: %lu\n", 
+    that->_nbFailedReceptTaskData);
+  fprintf(stream, "  nbFailedReceptTaskSize: %lu\n", 
+    that->_nbFailedReceptTaskSize);
+  fprintf(stream, "            nbSentResult: %lu\n", 
+    that->_nbSentResult);
+  fprintf(stream, "      nbFailedSendResult: %lu\n", 
+    that->_nbFailedSendResult);
+  fprintf(stream, "  nbFailedSendResultSize: %lu\n", 
+    that->_nbFailedSendResultSize);
+  fprintf(stream, "       nbFailedReceptAck: %lu\n", 
+    that->_nbFailedReceptAck);
+  fprintf(stream, "          nbTaskComplete: %lu\n", 
+    that->_nbTaskComplete);
+  fprintf(stream, "              nbByteSent: %lu\n", 
+    that->_nbByteSent);
+  fprintf(stream, "          nbByteReceived: %lu\n", 
+    that->_nbByteReceived);
+  fprintf(stream, "         timeToProcessMs: ");
+  TheSquidHistoPrint(&(that->_timeToProcessMs), stream);
+  fprintf(stream, "\n");
+  for (int iType = 0; iType < SquidletTaskType_Nb; ++iType) {
+    if (that->_timeToProcessMsPerType[iType]._nb > 0) {
+      fprintf(stream, "%24s: ", squidletTaskTypeStr[iType]);
+      TheSquidHistoPrint(that->_timeToProcessMsPerType + iType, stream);
+      fprintf(stream, "\n");
+    }
+  }
+  fprintf(stream, "        timeWaitedTaskMs: ");
+  TheSquidHistoPrint(&(that->_timeWaitedTaskMs), stream);
+  fprintf(stream, "\n");
+  fprintf(stream, "         timeWaitedAckMs: ");
+  TheSquidHistoPrint(&(that->_timeWaitedAckMs), stream);
+  fprintf(stream, "\n");
+  fprintf(stream, "             temperature: ");
+  TheSquidHistoPrint(&(that->_temperature), stream);
+  fprintf(stream, "\n");
+  fprintf(stream, "timeTransferSquadSquidUsPerKB: ");
+  TheSquidHistoPrint(&(that->_timeTransferSquadSquidUsPerKB), stream);
+  fprintf(stream, "\n");
+  fprintf(stream, "timeTransferSquidSquadUsPerKB: ");
+  TheSquidHistoPrint(&(that->_timeTransferSquidSquadUsPerKB), stream);
+  fprintf(stream, "\n");
+}
+
+// -------------- SquidletTaskRequest
+
+// ================ Functions implementation ====================
+
+// Return a new SquidletTaskRequest for a task of type 'type'
+// The task is identified by its 'id'/'subId', it will have at
+// maximum 'maxWait' seconds to complete. It holds a copy of 'data', a 
+// string in JSON format
+SquidletTaskRequest* SquidletTaskRequestCreate(
+   SquidletTaskType type, 
+      unsigned long id, 
+      unsigned long subId, 
+  const char* const data, 
+       const time_t maxWait) {
+#if BUILDMODE == 0
+  if (data == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'data' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Allocate memory for the new SquidletTaskRequest
+  SquidletTaskRequest* that = PBErrMalloc(TheSquidErr, 
+    sizeof(SquidletTaskRequest));
+  
+  // Init properties
+  that->_id = id;
+  that->_subId = subId;
+  that->_type = type;
+  that->_data = strdup(data);
+  that->_bufferResult = NULL;
+  that->_maxWaitTime = maxWait;
+  gettimeofday(&(that->_timeQueued), NULL);
+  memset(that->_timePhases, 0, sizeof(that->_timePhases));
+  
+  // Return the new SquidletTaskRequest
+  return that;
+}
+
+// Free the memory used by the SquidletTaskRequest 'that'
+void SquidletTaskRequestFree(
+  SquidletTaskRequest** that) {
+  // If the pointer is null there is nothing to do
+  if (that == NULL || *that == NULL)
+    return;
+  
+  // Free memory
+  if ((*that)->_bufferResult != NULL)
+    free((*that)->_bufferResult);
+  if ((*that)->_data != NULL)
+    free((*that)->_data);
+  free(*that);
+  *that = NULL;  
+}
+
+// Print the SquidletTaskRequest 'that' on the file 'stream'
+// Only a maximum of 100 first characters of the data are printed
+void SquidletTaskRequestPrint(
+  const SquidletTaskRequest* const that, 
+                       FILE* const stream) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (stream == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'stream' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+
+  // Declare a buffer to truncate the data
+  #define SquidletTaskRequestPrint_lengthTrunc 100
+  char truncData[SquidletTaskRequestPrint_lengthTrunc];
+  truncData[SquidletTaskRequestPrint_lengthTrunc - 1] = '\0';
+
+  // Copy the data
+  strncpy(truncData, SquidletTaskData(that), 
+    SquidletTaskRequestPrint_lengthTrunc - 1);
+
+  // Add a mark if the data were too long
+  if (strlen(SquidletTaskData(that)) >= 
+    SquidletTaskRequestPrint_lengthTrunc) {
+    strcpy(truncData + SquidletTaskRequestPrint_lengthTrunc - 7, 
+      " (...)");
+  }
+
+  // Print the info on the stream 
+  fprintf(stream, "%s(#%lu-%lu) %s", 
+    SquidletTaskTypeAsStr(that), 
+    SquidletTaskGetId(that), 
+    SquidletTaskGetSubId(that), 
+    truncData);
+}
+
+// Return the type of the task 'that' as a string
+const char* SquidletTaskTypeAsStr(
+  const SquidletTaskRequest* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+
+  // Return the name of the type
+  return SquidletTaskTypeName(that->_type);
+}
+
+// Return the name of the task type 'type', the name of the plugin for 
+// the types registered with TheSquidRegisterTaskPlugin, "Plugin" for 
+// the unregistered ones in the range of plugins, "Null" if the type is 
+// invalid
+const char* SquidletTaskTypeName(
+  const SquidletTaskType type) {
+
+  // If the type is a built-in one
+  if (type >= 0 && type < SquidletTaskType_Nb)
+    return squidletTaskTypeStr[type];
+
+  // If the type is the one of a registered plugin
+  const TheSquidTaskPlugin* plugin = TheSquidGetTaskPlugin(type);
+  if (plugin != NULL)
+    return plugin->_name;
+
+  // If the type is in the range of plugins (e.g. when decoding the 
+  // event log of another process)
+  if (type >= THESQUID_PLUGIN_FIRSTTYPE && 
+    type < THESQUID_PLUGIN_FIRSTTYPE + THESQUID_PLUGIN_MAXNB)
+    return "Plugin";
+
+  // Else, the type is invalid, return the name of the default type
+  return squidletTaskTypeStr[0];
+}
+
+// Return true if 'type' is a built-in task type or the type of a 
+// registered plugin, else false
+bool SquidletTaskTypeIsValid(
+  const SquidletTaskType type) {
+  return (type >= 0 && type < SquidletTaskType_Nb) || 
+    TheSquidGetTaskPlugin(type) != NULL;
+}
+
+// -------------- TheSquidTaskPlugin
+
+// ================ Functions implementation ====================
+
+// Register a copy of the 'plugin' for its task type, the Squad and 
+// the squidlets of the process can then execute the tasks of this type 
+// The plugins must be registered before starting the squidlets and 
+// the threads of the Squad, and both the squad and squidlets must 
+// register the same plugins 
+// Return false if the type is out of range or already registered or 
+// the plugin has no execute function, else true
+bool TheSquidRegisterTaskPlugin(
+  const TheSquidTaskPlugin* const plugin) {
+#if BUILDMODE == 0
+  if (plugin == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'plugin' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+
+  // If the type is out of the range of plugins
+  if (plugin->_type < THESQUID_PLUGIN_FIRSTTYPE || 
+    plugin->_type >= THESQUID_PLUGIN_FIRSTTYPE + THESQUID_PLUGIN_MAXNB) {
+    TheSquidErr->_type = PBErrTypeInvalidArg;
+    sprintf(TheSquidErr->_msg, "invalid plugin type (%d)", 
+      plugin->_type);
+    return false;
+  }
+
+  // If the plugin can't execute its tasks
+  if (plugin->_execute == NULL) {
+    TheSquidErr->_type = PBErrTypeInvalidArg;
+    sprintf(TheSquidErr->_msg, "plugin without execute function (%d)", 
+      plugin->_type);
+    return false;
+  }
+
+  // If the type is already registered
+  int iPlugin = plugin->_type - THESQUID_PLUGIN_FIRSTTYPE;
+  if (theSquidTaskPluginRegistered[iPlugin] == true) {
+    TheSquidErr->_type = PBErrTypeInvalidArg;
+    sprintf(TheSquidErr->_msg, "plugin type already registered (%d)", 
+      plugin->_type);
+    return false;
+  }
+
+  // Register the copy of the plugin
+  theSquidTaskPlugins[iPlugin] = *plugin;
+  theSquidTaskPlugins[iPlugin]._name[THESQUID_PLUGIN_LENGTHNAME - 1] = 
+    '\0';
+  theSquidTaskPluginRegistered[iPlugin] = true;
+
+  // Return the success code
+  return true;
+}
+
+// Load the shared object at 'path' and register the plugins it exports 
+// through its THESQUID_PLUGIN_REGISTERFUN function 
+// The shared object stays loaded until the end of the process 
+// Return true if at least one plugin could be registered and all of 
+// them were valid, else false
+bool TheSquidLoadTaskPlugin(
+  const char* const path) {
+#if BUILDMODE == 0
+  if (path == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'path' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+
+  // Load the shared object
+  void* handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+  if (handle == NULL) {
+    TheSquidErr->_type = PBErrTypeIOError;
+    sprintf(TheSquidErr->_msg, "dlopen failed (%.200s)", dlerror());
+    return false;
+  }
+
+  // Get the registration function of the shared object
+  TheSquidPluginRegisterFun fun = NULL;
+  *(void**)(&fun) = dlsym(handle, THESQUID_PLUGIN_REGISTERFUN);
+  if (fun == NULL) {
+    TheSquidErr->_type = PBErrTypeInvalidData;
+    sprintf(TheSquidErr->_msg, "%s not found (%.200s)", 
+      THESQUID_PLUGIN_REGISTERFUN, path);
+    dlclose(handle);
+    return false;
+  }
+
+  // Get the plugins exported by the shared object
+  TheSquidTaskPlugin plugins[THESQUID_PLUGIN_MAXNB];
+  memset(plugins, 0, sizeof(TheSquidTaskPlugin) * THESQUID_PLUGIN_MAXNB);
+  int nbPlugin = fun(plugins, THESQUID_PLUGIN_MAXNB);
+  if (nbPlugin <= 0 || nbPlugin > THESQUID_PLUGIN_MAXNB) {
+    TheSquidErr->_type = PBErrTypeInvalidData;
+    sprintf(TheSquidErr->_msg, "no plugin found (%.200s)", path);
+    dlclose(handle);
+    return false;
+  }
+
+  // Register the plugins, the shared object is never unloaded as the 
+  // registered plugins point to its functions
+  bool ret = true;
+  for (int iPlugin = 0; iPlugin < nbPlugin; ++iPlugin)
+    if (TheSquidRegisterTaskPlugin(plugins + iPlugin) == false)
+      ret = false;
+
+  // Return the success code
+  return ret;
+}
+
+// Return the plugin registered for the task type 'type', or null if 
+// there is none
+const TheSquidTaskPlugin* TheSquidGetTaskPlugin(
+  const SquidletTaskType type) {
+
+  // If the type is out of the range of plugins, there is no plugin
+  if (type < THESQUID_PLUGIN_FIRSTTYPE || 
+    type >= THESQUID_PLUGIN_FIRSTTYPE + THESQUID_PLUGIN_MAXNB)
+    return NULL;
+
+  // Return the plugin if it's registered
+  int iPlugin = type - THESQUID_PLUGIN_FIRSTTYPE;
+  if (theSquidTaskPluginRegistered[iPlugin] == false)
+    return NULL;
+  return theSquidTaskPlugins + iPlugin;
+}
+
+
+// -------------- TheSquidEventLog
+
+// ================ Functions implementation ====================
+
+// Return a new TheSquidEventLog writing its records in the file at 
+// 'path', whose header gets the 'name' of the process, in a 
+// background thread 
+// Return null if the file couldn't be opened or the thread couldn't 
+// be created
+TheSquidEventLog* TheSquidEventLogCreate(
+  const char* const path, 
+  const char* const name) {
+#if BUILDMODE == 0
+  if (path == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'path' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (name == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'name' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Open the file
+  FILE* stream = fopen(path, "wb");
+  if (stream == NULL) {
+    sprintf(TheSquidErr->_msg, "fopen() failed");
+    return NULL;
+  }
+
+  // Write the header
+  TheSquidEventLogHeader header;
+  memset(&header, 0, sizeof(TheSquidEventLogHeader));
+  memcpy(header._magic, THESQUID_EVENTLOG_MAGIC, sizeof(header._magic));
+  header._pid = (uint32_t)getpid();
+  header._sizeRecord = sizeof(TheSquidEventRecord);
+  strncpy(header._name, name, THESQUID_EVENTLOG_LENGTHNAME - 1);
+  if (fwrite(&header, sizeof(TheSquidEventLogHeader), 1, stream) != 1) {
+    fclose(stream);
+    sprintf(TheSquidErr->_msg, "fwrite() failed");
+    return NULL;
+  }
+
+  // Allocate memory for the log
+  TheSquidEventLog* that = PBErrMalloc(TheSquidErr, 
+    sizeof(TheSquidEventLog));
+
+  // Init properties
+  that->_stream = stream;
+  that->_stop = false;
+  that->_nbPushed = 0;
+  that->_nbWritten = 0;
+  that->_nbDropped = 0;
+  pthread_mutex_init(&(that->_mutex), NULL);
+  pthread_cond_init(&(that->_cond), NULL);
+
+  // Start the thread with all the signals blocked, to leave their 
+  // handling (Ctrl-C) to the thread of the caller
+  sigset_t set;
+  sigset_t prevSet;
+  sigfillset(&set);
+  pthread_sigmask(SIG_SETMASK, &set, &prevSet);
+  int ret = pthread_create(&(that->_thread), NULL, TheSquidEventLogRun, 
+    that);
+  pthread_sigmask(SIG_SETMASK, &prevSet, NULL);
+
+  // If we couldn't create the thread
+  if (ret != 0) {
+
+    // Free memory and return null
+    pthread_cond_destroy(&(that->_cond));
+    pthread_mutex_destroy(&(that->_mutex));
+    fclose(that->_stream);
+    free(that);
+    sprintf(TheSquidErr->_msg, "pthread_create() failed");
+    return NULL;
+  }
+
+  // Return the new log
+  return that;
+}
+
+// Write the pending records, stop the thread, close the file and free 
+// the memory used by the TheSquidEventLog 'that'
+void TheSquidEventLogFree(
+  TheSquidEventLog** that) {
+  // If the pointer is null there is nothing to do
+  if (that == NULL || *that == NULL)
+    return;
+
+  // Stop the thread and wait for it, it writes the pending records 
+  // before ending
+  pthread_mutex_lock(&((*that)->_mutex));
+  (*that)->_stop = true;
+  pthread_cond_signal(&((*that)->_cond));
+  pthread_mutex_unlock(&((*that)->_mutex));
+  pthread_join((*that)->_thread, NULL);
+
+  // Record the number of dropped events, if any
+  if ((*that)->_nbDropped > 0) {
+    unsigned long nbDropped = (*that)->_nbDropped;
+    TheSquidEventLogPush(*that, TheSquidEventType_Dropped, 
+      SquidletTaskType_Null, 0, 0, 0, nbDropped);
+    TheSquidEventLogFlush(*that);
+  }
+
+  // Free memory
+  fclose((*that)->_stream);
+  pthread_cond_destroy(&((*that)->_cond));
+  pthread_mutex_destroy(&((*that)->_mutex));
+  free(*that);
+  *that = NULL;
+}
+
+// Push the event of type 'type' for the task 'taskType' 'id'/'subId' 
+// on the squidlet listening on 'port' with the value 'value' in the 
+// TheSquidEventLog 'that' 
+// Never blocks and never does I/O, must be called from one single 
+// thread. If the ring buffer is full the event is dropped 
+// Return true if the event could be pushed, false else
+bool TheSquidEventLogPush(
+      TheSquidEventLog* const that, 
+  const TheSquidEventType type, 
+   const SquidletTaskType taskType, 
+     const unsigned long id, 
+     const unsigned long subId, 
+          const uint16_t port, 
+     const unsigned long value) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // If the ring buffer is full, drop the event
+  unsigned long nbPushed = that->_nbPushed;
+  unsigned long nbWritten = 
+    __atomic_load_n(&(that->_nbWritten), __ATOMIC_ACQUIRE);
+  if (nbPushed - nbWritten >= THESQUID_EVENTLOG_NBRECORD) {
+    ++(that->_nbDropped);
+    return false;
+  }
+
+  // Fill the next record
+  TheSquidEventRecord* record = 
+    that->_records + nbPushed % THESQUID_EVENTLOG_NBRECORD;
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  record->_timeUs = (uint64_t)now.tv_sec * 1000000 + now.tv_usec;
+  record->_id = id;
+  record->_value = value;
+  record->_subId = (uint32_t)subId;
+  record->_port = port;
+  record->_type = (uint8_t)type;
+  record->_taskType = (uint8_t)taskType;
+
+  // Publish the record to the writer thread
+  __atomic_store_n(&(that->_nbPushed), nbPushed + 1, __ATOMIC_RELEASE);
+
+  // Return the success code
+  return true;
+}
+
+// Main function of the thread of the TheSquidEventLog 'arg', write 
+// the pushed records every period until it is stopped
+void* TheSquidEventLogRun(
+  void* arg) {
+  TheSquidEventLog* that = arg;
+  pthread_mutex_lock(&(that->_mutex));
+  bool stop = false;
+  do {
+
+    // Wait for the period or the stop signal
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += THESQUID_EVENTLOG_PERIODMS * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+      deadline.tv_sec += 1;
+      deadline.tv_nsec -= 1000000000L;
+    }
+    if (that->_stop == false) {
+      pthread_cond_timedwait(&(that->_cond), &(that->_mutex), 
+        &deadline);
+    }
+    stop = that->_stop;
+
+    // Write the records without holding the mutex
+    pthread_mutex_unlock(&(that->_mutex));
+    TheSquidEventLogFlush(that);
+    pthread_mutex_lock(&(that->_mutex));
+  } while (stop == false);
+  pthread_mutex_unlock(&(that->_mutex));
+  return NULL;
+}
+
+// Write the records pushed in the ring buffer of the TheSquidEventLog 
+// 'that' to its stream, called only by its writer thread
+void TheSquidEventLogFlush(
+  TheSquidEventLog* const that) {
+  unsigned long nbPushed = 
+    __atomic_load_n(&(that->_nbPushed), __ATOMIC_ACQUIRE);
+  unsigned long nbWritten = that->_nbWritten;
+  if (nbWritten == nbPushed)
+    return;
+
+  // Write the records, in two chunks if they wrap around the end of 
+  // the ring buffer
+  while (nbWritten < nbPushed) {
+    unsigned long iFirst = nbWritten % THESQUID_EVENTLOG_NBRECORD;
+    unsigned long nb = 
+      MIN(nbPushed - nbWritten, THESQUID_EVENTLOG_NBRECORD - iFirst);
+    fwrite(that->_records + iFirst, sizeof(TheSquidEventRecord), nb, 
+      that->_stream);
+    nbWritten += nb;
+
+    // Release the written records to the producer
+    __atomic_store_n(&(that->_nbWritten), nbWritten, __ATOMIC_RELEASE);
+  }
+  fflush(that->_stream);
+}
+
+// Decode the event log in the 'stream' and print it on the stream 
+// 'out', in text, one event per line, or in the Chrome trace event 
+// format (JSON) if 'json' is true 
+// Return true if the log could be decoded, false else
+bool TheSquidEventLogDecode(
+  FILE* const stream, 
+     FILE* const out, 
+     const bool json) {
+#if BUILDMODE == 0
+  if (stream == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'stream' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (out == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'out' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Read and check the header
+  TheSquidEventLogHeader header;
+  if (fread(&header, sizeof(TheSquidEventLogHeader), 1, stream) != 1 ||
+    memcmp(header._magic, THESQUID_EVENTLOG_MAGIC, 
+      sizeof(header._magic)) != 0 ||
+    header._sizeRecord != sizeof(TheSquidEventRecord)) {
+    sprintf(TheSquidErr->_msg, "invalid event log header");
+    return false;
+  }
+  header._name[THESQUID_EVENTLOG_LENGTHNAME - 1] = '\0';
+
+  // Print the head of the output
+  if (json == true) {
+    fprintf(out, "{\"traceEvents\":[");
+    fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\","
+      "\"pid\":%u,\"args\":{\"name\":\"%s\"}}", header._pid, 
+      header._name);
+  } else {
+    fprintf(out, "%u %s\n", header._pid, header._name);
+  }
+
+  // Loop on the records
+  TheSquidEventRecord record;
+  bool ret = true;
+  while (ret == true && 
+    fread(&record, sizeof(TheSquidEventRecord), 1, stream) == 1) {
+
+    // If the record is invalid, stop here
+    if (record._type >= TheSquidEventType_Nb || 
+      (record._taskType >= SquidletTaskType_Nb && 
+      record._taskType < THESQUID_PLUGIN_FIRSTTYPE) || 
+      record._taskType >= 
+        THESQUID_PLUGIN_FIRSTTYPE + THESQUID_PLUGIN_MAXNB) {
+      sprintf(TheSquidErr->_msg, "invalid event record");
+      ret = false;
+      break;
+    }
+
+    // Print the record, each squidlet is a thread in the trace
+    const char* name = theSquidEventTypeStr[record._type];
+    const char* cat = SquidletTaskTypeName(record._taskType);
+    if (json == true) {
+      fprintf(out, ",{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"i\","
+        "\"s\":\"t\",\"ts\":%llu,\"pid\":%u,\"tid\":%u,"
+        "\"args\":{\"id\":%llu,\"subId\":%u,\"value\":%llu}}", 
+        name, cat, (unsigned long long)(record._timeUs), header._pid, 
+        record._port, (unsigned long long)(record._id), record._subId, 
+        (unsigned long long)(record._value));
+    } else {
+      fprintf(out, "%llu.%06llu %s %s %llu/%u %u %llu\n", 
+        (unsigned long long)(record._timeUs / 1000000), 
+        (unsigned long long)(record._timeUs % 1000000), name, cat, 
+        (unsigned long long)(record._id), record._subId, record._port, 
+        (unsigned long long)(record._value));
+    }
+  }
+
+  // Print the tail of the output
+  if (json == true)
+    fprintf(out, "],\"displayTimeUnit\":\"ms\"}\n");
+
+  // Return the success code
+  return ret;
+}
+
+// -------------- SquadRunningTask
+
+// ================ Functions implementation ====================
+
+// Return a new SquadRunningTask for the SquidletTaskRequest 'request' 
+// running on the SquidletInfo 'squidlet' (may be null if the squidlet 
+// is not available anymore) 
+// The task is created in the running state
+SquadRunningTask* SquadRunningTaskCreate(
+  SquidletTaskRequest* const request, 
+         SquidletInfo* const squidlet) {
+#if BUILDMODE == 0
+  if (request == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'request' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Allocate memory for the new SquadRunningTask
+  SquadRunningTask* that = PBErrMalloc(TheSquidErr, 
+    sizeof(SquadRunningTask));
+  
+  // Init properties
+  that->_request = request;
+  that->_squidlet = squidlet;
+  that->_startTime = time(NULL);
+  that->_state = SquadRunningTaskState_Running;
+  that->_squidletAddr[0] = '\0';
+  if (squidlet != NULL) {
+    snprintf(that->_squidletAddr, SQUADRUNNINGTASK_LENGTHADDR, "%s:%d", 
+      squidlet->_ip, squidlet->_port);
+  }
+  that->_timePostProcessed.tv_sec = 0;
+  that->_timePostProcessed.tv_usec = 0;
+  
+  // Return the new SquadRunningTask
+  return that;
+}
+
+// Free the memory used by the SquadRunningTask 'that'
+void SquadRunningTaskFree(
+  SquadRunningTask** that) {
+  // If the pointer is null there is nothing to do
+  if (that == NULL || *that == NULL)
+    return;
+  
+  // Free memory
+  free(*that);
+  *that = NULL;
+}
+
+// Print the SquadRunningTask 'that' on the file 'stream'
+void SquadRunningTaskPrint(
+  const SquadRunningTask* const that, 
+                    FILE* const stream) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (stream == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'stream' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Print the info on the stream 
+  fprintf(stream, "[");
+  if (that->_request != NULL) {
+    SquidletTaskRequestPrint(that->_request, stream);
+  } else {
+    fprintf(stream, "<null>");
+  }
+  fprintf(stream, "]/[");
+  if (that->_squidlet != NULL) {
+    SquidletInfoPrint(that->_squidlet, stream);
+  } else {
+    fprintf(stream, "<null>");
+  }
+  fprintf(stream, "]");
+}
+
+// -------------- SquadBenchmarkConfig
+
+// ================ Functions implementation ====================
+
+// Return a SquadBenchmarkConfig with the default values: payloads of 
+// 9, 90 and 900 bytes, 1 to 1024 sorts per task, 1s of warm-up, 1s 
+// samples, 5s to 240s per point, 2% confidence interval, text output
+SquadBenchmarkConfig SquadBenchmarkConfigCreateStatic(void) {
+  // Declare the new config
+  SquadBenchmarkConfig that;
+
+  // Set the default values
+  that._payloadSizes = VecLongCreate(3);
+  for (long i = 0, size = 9; i < 3; ++i, size *= 10)
+    VecSet(that._payloadSizes, i, size);
+  that._nbLoops = VecLongCreate(11);
+  for (long i = 0, nbLoop = 1; i < 11; ++i, nbLoop *= 2)
+    VecSet(that._nbLoops, i, nbLoop);
+  that._warmUpMs = 1000.0;
+  that._sampleMs = 1000.0;
+  that._minLengthMs = 5000.0;
+  that._maxLengthMs = 240000.0;
+  that._targetCI = 0.02;
+  that._format = SquadBenchmarkFormat_Text;
+
+  // Return the config
+  return that;
+}
+
+// Free the memory used by the SquadBenchmarkConfig 'that'
+void SquadBenchmarkConfigFreeStatic(
+  SquadBenchmarkConfig* const that) {
+  // If the pointer is null there is nothing to do
+  if (that == NULL)
+    return;
+
+  // Free memory
+  VecFree(&(that->_payloadSizes));
+  VecFree(&(that->_nbLoops));
+}
+
+// Load the SquadBenchmarkConfig 'that' from the file 'stream'
+// All the properties are optional, the missing ones keep their 
+// current value
+// Return true if the config could be loaded, false else
+bool SquadBenchmarkConfigLoad(
+  SquadBenchmarkConfig* const that, 
+                  FILE* const stream) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (stream == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'stream' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Declare a json to load the encoded data
+  JSONNode* json = JSONCreate();
+
+  // Load the whole encoded data
+  if (JSONLoad(json, stream) == false) {
+    TheSquidErr->_type = PBErrTypeIOError;
+    sprintf(TheSquidErr->_msg, "JSONLoad failed");
+    JSONFree(&json);
+    return false;
+  }
+
+  // Decode the data from the JSON
+  bool ret = SquadBenchmarkConfigDecodeAsJSON(that, json);
+
+  // Free the memory used by the JSON
+  JSONFree(&json);
+  
+  // Return the success code
+  return ret;
+}
+
+// Decode the SquadBenchmarkConfig 'that' from the JSON node 'json'
+// Return true if the config could be decoded, false else
+bool SquadBenchmarkConfigDecodeAsJSON(
+  SquadBenchmarkConfig* const that, 
+        const JSONNode* const json) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (json == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'json' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Decode the grids of parameters
+  const char* gridLbls[2] = {"payloadSizes", "nbLoops"};
+  VecLong** grids[2] = {&(that->_payloadSizes), &(that->_nbLoops)};
+  for (int iGrid = 0; iGrid < 2; ++iGrid) {
+    JSONNode* prop = JSONProperty(json, gridLbls[iGrid]);
+    if (prop != NULL) {
+      long nbVal = JSONGetNbValue(prop);
+      if (nbVal <= 0) {
+        TheSquidErr->_type = PBErrTypeInvalidData;
+        sprintf(TheSquidErr->_msg, "%s is empty", gridLbls[iGrid]);
+        return false;
+      }
+      VecFree(grids[iGrid]);
+      *(grids[iGrid]) = VecLongCreate(nbVal);
+      for (long iVal = 0; iVal < nbVal; ++iVal) {
+        long val = atol(JSONLblVal(JSONValue(prop, iVal)));
+        if (val <= 0) {
+          TheSquidErr->_type = PBErrTypeInvalidData;
+          sprintf(TheSquidErr->_msg, "invalid value in %s", 
+            gridLbls[iGrid]);
+          return false;
+        }
+        VecSet(*(grids[iGrid]), iVal, val);
+      }
+    }
+  }
+
+  // Decode the durations and target confidence interval
+  const char* lbls[5] = 
+    {"warmUpMs", "sampleMs", "minLengthMs", "maxLengthMs", "targetCI"};
+  float* vals[5] = {&(that->_warmUpMs), &(that->_sampleMs), 
+    &(that->_minLengthMs), &(that->_maxLengthMs), &(that->_targetCI)};
+  for (int iProp = 0; iProp < 5; ++iProp) {
+    JSONNode* prop = JSONProperty(json, lbls[iProp]);
+    if (prop != NULL)
+      *(vals[iProp]) = atof(JSONLblVal(prop));
+  }
+  if (that->_sampleMs <= 0.0 || that->_warmUpMs < 0.0 ||
+    that->_minLengthMs > that->_maxLengthMs || 
+    that->_targetCI <= 0.0) {
+    TheSquidErr->_type = PBErrTypeInvalidData;
+    sprintf(TheSquidErr->_msg, "invalid durations or targetCI");
+    return false;
+  }
+
+  // Decode the format
+  JSONNode* prop = JSONProperty(json, "format");
+  if (prop != NULL) {
+    if (strcmp(JSONLblVal(prop), "text") == 0) {
+      that->_format = SquadBenchmarkFormat_Text;
+    } else if (strcmp(JSONLblVal(prop), "json") == 0) {
+      that->_format = SquadBenchmarkFormat_JSON;
+    } else if (strcmp(JSONLblVal(prop), "csv") == 0) {
+      that->_format = SquadBenchmarkFormat_CSV;
+    } else {
+      TheSquidErr->_type = PBErrTypeInvalidData;
+      sprintf(TheSquidErr->_msg, "invalid format (%s)", 
+        JSONLblVal(prop));
+      return false;
+    }
+  }
+
+  // Return the success code
+  return true;
+}
+
+// -------------- Squad
+
+// ================ Functions declaration ====================
+
+// Decode the JSON info of a Squad from the JSON node 'json'
+bool SquadDecodeAsJSON(
+     Squad* that, 
+  JSONNode* json);
+
+// Refresh the content of the TextOMeter attached to the 
+// Squad 'that', at most SQUAD_TXTOMETER_NBREFRESHPERSEC times per 
+// second. A skipped refresh is done at the next call after the delay, 
+// or when the Squad is freed
+void SquadUpdateTextOMeter(
+  Squad* const that);
+
+// Add one event with the message 'msg' to the history of messages 
+// for the TextOMeter 
+// 'msg' is truncated if it doesn't fit in one line of history 
+// If the TextOmeter is not turned on, do nothing 
+// Variadic function with the same signature as printf family
+void SquadPushHistory(
+  Squad* const that, 
+         char* msg, 
+               ...);
+
+// Add one event refering to the 'squidlet' to the history of 
+// messages for the TextOMeter 
+// If the TextOmeter is not turned on, do nothing
+void SquadPushHistorySquidletInfo(
+               Squad* const that, 
+  const SquidletInfo* const squidlet);
+
+// Add one event refering to the task 'request' to the history of 
+// messages for the TextOMeter 
+// If the TextOmeter is not turned on, do nothing
+void SquadPushHistorySquidletTaskRequest(
+                      Squad* const that, 
+  const SquidletTaskRequest* const request);
+
+// Add one event refering to the running 'task' to the history of 
+// messages for the TextOMeter 
+// If the TextOmeter is not turned on, do nothing
+void SquadPushHistorySquadRunningTask(
+                   Squad* const that, 
+  const SquadRunningTask* const task);
+
+// Add one event with the message 'msg' (may be null) refering to the 
+// task 'request' and the 'squidlet' (may be null) to the ring buffer 
+// of history of the Squad 'that' 
+// The slot of the event is reserved atomically, hence events can be 
+// pushed concurrently without lock
+void SquadPushHistoryEvent(
+                      Squad* const that, 
+                 const char* const msg, 
+  const SquidletTaskRequest* const request, 
+         const SquidletInfo* const squidlet);
+
+// Print the event 'that' of the history into the 'buffer' of 'size' 
+// bytes, as '<msg>[<task>]/[<squidlet>]' where the parts not refered 
+// to by the event are omitted
+void SquadHistoryEventToStr(
+  const SquadHistoryEvent* const that, 
+                     char* const buffer, 
+                    const size_t size);
+
+// Request the execution of a task on a squidlet for the squad 'that'
+// Return true if the request was successfull, fals else
+bool SquadSendTaskOnSquidlet(
+  Squad* const that, 
+  SquidletInfo* const squidlet, 
+  SquidletTaskRequest* const task);
+
+// Free the memory used by the SquadEvalNNShards 'that'
+void SquadEvalNNShardsFree(
+  SquadEvalNNShards** that);
+
+// Return the partial results of the sharded neuranet evaluation of 
+// which the 'task' is one of the ranges, or null if the evaluation is 
+// not running in the Squad 'that' 
+// 'isRange' is set to true if the task is a range of a sharded 
+// evaluation, running or not, else false
+SquadEvalNNShards* SquadGetEvalNNShards(
+                      const Squad* const that, 
+  const SquidletTaskRequest* const task, 
+                       bool* const isRange);
+
+// Measure with the squad 'that' the throughput of the benchmark tasks 
+// for the payload size and number of sorts of 'point' according to 
+// the configuration 'config'. The ids of the tasks are created from 
+// 'id', which is updated
+// Failed tasks are displayed on 'stream'
+// Return false if a task failed, true else
+bool SquadBenchmarkRunPoint(
+                        Squad* const that, 
+  const SquadBenchmarkConfig* const config, 
+          SquadBenchmarkPoint* const point, 
+                unsigned long* const id, 
+                         FILE* const stream);
+
+// Execute benchmark tasks for the 'point' with the squad 'that'
+// If the squad has no squidlet, execute one task on the local device 
+// with the payload 'buffer'. Else, add tasks to the squad to keep all 
+// its squidlets busy, using 'id' to create their ids, and step it 
+// For the benchmark of the protocol, the tasks are dummy tasks 
+// without processing and their latencies are added to the 'point'
+// Failed tasks are displayed on 'stream'
+// Return the number of completed tasks, or -1 if a task failed
+long SquadBenchmarkStep(
+                Squad* const that, 
+  SquadBenchmarkPoint* const point, 
+           const char* const buffer, 
+        unsigned long* const id, 
+                 FILE* const stream);
+
+// Add the throughput 'nbTaskPerSec' to the samples of the 'point'
+void SquadBenchmarkPointAddSample(
+  SquadBenchmarkPoint* const that, 
+                 const float nbTaskPerSec);
+
+// Print the durations and target of the SquadBenchmarkConfig 'that' 
+// as a JSON property "config" on the file 'stream'
+void SquadBenchmarkConfigPrintJSON(
+  const SquadBenchmarkConfig* const that, 
+                        FILE* const stream);
+
+// Add the trace of the execution of the task 'task' by the squidlet at 
+// the address 'addr' (ip:port) to the ring buffer of traces of the 
+// Squad 'that' 
+// 'timePostProcessed' is the time at which the post processing of the 
+// task has ended, or null if it's now 
+// 'completed' is true if the task has been completed, false if the 
+// Squad gave up waiting for it
+void SquadPushTrace(
+                      Squad* const that, 
+  const SquidletTaskRequest* const task, 
+                 const char* const addr, 
+       const struct timeval* const timePostProcessed, 
+                      const bool completed);
+
+// Print on the file 'stream' the Chrome trace event of the span 
+// 'name' of the category 'cat', on the thread 'tid', from 'start' to 
+// 'end' (skipped if one of them is null), preceded by a comma if 
+// '*first' is false. '*first' is then set to false
+void SquadPrintTraceEvent(
+                  FILE* const stream, 
+             const char* const name, 
+             const char* const cat, 
+                     const int tid, 
+  const struct timeval* const start, 
+  const struct timeval* const end, 
+                    bool* const first);
+
+// Return the average throughput of the samples of the 'point' 
+float SquadBenchmarkPointGetMean(
+  const SquadBenchmarkPoint* const that);
+
+// Return the half-width of the 95% confidence interval of the average
+// throughput of the samples of the 'point' (Student's t distribution)
+// Return 0.0 if there are less than 2 samples
+float SquadBenchmarkPointGetCI(
+  const SquadBenchmarkPoint* const that);
+
+// Return true if the confidence interval of the throughput of the 
+// 'point' has reached the target of the configuration 'config', 
+// false else
+bool SquadBenchmarkPointIsConverged(
+   const SquadBenchmarkPoint* const that, 
+  const SquadBenchmarkConfig* const config);
+
+// Return true if the measurement of the 'point' is complete 
+// according to the configuration 'config', i.e. if the maximum 
+// duration is reached or if the minimum duration is reached and the 
+// confidence interval has converged, false else
+bool SquadBenchmarkPointIsComplete(
+   const SquadBenchmarkPoint* const that, 
+  const SquadBenchmarkConfig* const config);
+
+// Add to the squad 'that' the neuranet evaluation task(s) whose data 
+// are made of the properties given as arguments and 'nnData', the 
+// properties describing how to get the NeuraNets. 'nnData' is always
+// placed at the end of the task data
+void SquadAddTask_EvalNeuraNetData(
+         Squad* const that, 
+  const unsigned long id,
+         const time_t maxWait,
+    const char* const datasetPath,
+ const VecLong* const nnids,
+          const float curBest,
+           const long cat,
+           const bool fastReject,
+   const unsigned int nbShard,
+    const char* const nnData);
+
+// ================ Functions implementation ====================
+
+// Return a new Squad
+Squad* SquadCreate(void) {
+  // Allocate memory for the squad
+  Squad* that = PBErrMalloc(TheSquidErr, sizeof(Squad));
+  
+  // Open the TCP/IP socket
+  // AF_INET: IPv4 Internet protocols
+  // SOCK_STREAM: Provides sequenced, reliable, two-way, 
+  // connection-based byte streams.
+  int defaultProtocol = 0;
+  that->_fd = socket(AF_INET, SOCK_STREAM, defaultProtocol);
+  
+  // If we couldn't open the socket
+  if (that->_fd == -1) {
+
+    // Free memory and return null
+    free(that);
+    return NULL;
+  }
+
+  // Init properties
+  that->_squidlets = GSetSquidletInfoCreateStatic();
+  that->_tasks = GSetSquidletTaskRequestCreateStatic();
+  that->_runningTasks = GSetSquadRunningTaskCreateStatic();
+  that->_flagTextOMeter = false;
+  that->_textOMeter = NULL;
+  for (int iEvent = 0; iEvent < SQUAD_TXTOMETER_NBHISTORYEVENT;
+    ++iEvent) {
+    that->_history[iEvent]._seq = 0;
+  }
+  that->_nbHistoryEvent = 0;
+  that->_timeLastRefresh.tv_sec = 0;
+  that->_timeLastRefresh.tv_usec = 0;
+  that->_flagTextOMeterDirty = false;
+  that->_evalNNShards = GSetCreateStatic();
+  that->_nextEvalNNShardsKey = 0;
+  that->_nbTrace = 0;
+  that->_metrics = NULL;
+  that->_eventLog = NULL;
+  that->_fdDiscovery = -1;
+  that->_batches = GSetCreateStatic();
+  that->_nextBatchId = 0;
+  that->_flagRelay = false;
+  that->_flagSendFile = false;
+  that->_shards = NULL;
+  that->_nbThread = 0;
+  that->_completedHead = 
+    PBErrMalloc(TheSquidErr, sizeof(SquadCompletedNode));
+  that->_completedHead->_next = NULL;
+  that->_completedHead->_task = NULL;
+  that->_completedTail = that->_completedHead;
+  that->_nbShardedTask = 0;
+  that->_postProcessWorkers = NULL;
+  that->_nbPostProcessThread = 0;
+  that->_nbPostProcessTask = 0;
+  that->_statsPeriod = SQUAD_STATSPERIOD;
+  that->_thermalSoft = SQUAD_THERMALSOFT;
+  that->_thermalHard = SQUAD_THERMALHARD;
+  that->_thermalHorizon = SQUAD_THERMALHORIZON;
+
+  // Return the new squad
+  return that;
+}
+
+// Free the memory used by the Squad 'that'
+void SquadFree(
+  Squad** that) {
+  // If the pointer is null there is nothing to do
+  if (that == NULL || *that == NULL)
+    return;
+
+  // Stop the threads, if any, to get back the squidlets and tasks
+  SquadStopShards(*that);
+  SquadStopPostProcessWorkers(*that);
+
+  // Do the last refresh of the TextOMeter if it has been skipped
+  if ((*that)->_textOMeter != NULL && 
+    (*that)->_flagTextOMeterDirty == true) {
+    (*that)->_timeLastRefresh.tv_sec = 0;
+    (*that)->_timeLastRefresh.tv_usec = 0;
+    SquadUpdateTextOMeter(*that);
+  }
+
+  // Close the sockets
+  close((*that)->_fd);
+  if ((*that)->_fdDiscovery != -1)
+    close((*that)->_fdDiscovery);
+
+  // Free memory
+  while (GSetNbElem(SquadSquidlets(*that)) > 0) {
+    SquidletInfo* squidletInfo = GSetPop((GSet*)SquadSquidlets(*that));
+    SquidletInfoFree(&squidletInfo);
+  }
+  while (GSetNbElem(SquadTasks(*that)) > 0) {
+    SquidletTaskRequest* task = GSetPop((GSet*)SquadTasks(*that));
+    SquidletTaskRequestFree(&task);
+  }
+  while (GSetNbElem(SquadRunningTasks(*that)) > 0) {
+    SquadRunningTask* task = GSetPop((GSet*)SquadRunningTasks(*that));
+    SquadRunningTaskFree(&task);
+  }
+  while (GSetNbElem(&((*that)->_evalNNShards)) > 0) {
+    SquadEvalNNShards* shards = GSetPop(&((*that)->_evalNNShards));
+    SquadEvalNNShardsFree(&shards);
+  }
+  while (GSetNbElem(&((*that)->_batches)) > 0) {
+    SquadBatch* batch = GSetPop(&((*that)->_batches));
+    for (unsigned long iTask = batch->_nbTask; iTask--;)
+      SquidletTaskRequestFree(batch->_tasks + iTask);
+    SquadBatchFree(&batch);
+  }
+  SquadRunningTask* completedTask = NULL;
+  bool processed = false;
+  while ((completedTask = 
+    SquadPopCompletedTask(*that, &processed)) != NULL) {
+    SquidletTaskRequestFree(&(completedTask->_request));
+    SquadRunningTaskFree(&completedTask);
+  }
+  free((*that)->_completedHead);
+  if ((*that)->_textOMeter != NULL) {
+    TextOMeterFree(&((*that)->_textOMeter));
+  }
+  TheSquidMetricsFree(&((*that)->_metrics));
+  TheSquidEventLogFree(&((*that)->_eventLog));
+  free(*that);
+  *that = NULL;
+}
+
+// Free the memory used by the SquadEvalNNShards 'that'
+void SquadEvalNNShardsFree(
+  SquadEvalNNShards** that) {
+  // If the pointer is null there is nothing to do
+  if (that == NULL || *that == NULL)
+    return;
+
+  // Free memory
+  free((*that)->_done);
+  free((*that)->_failed);
+  VecFree(&((*that)->_nnids));
+  VecFree(&((*that)->_sumErrs));
+  VecFree(&((*that)->_nbEvals));
+  free(*that);
+  *that = NULL;
+}
+
+// Return the partial results of the sharded neuranet evaluation of 
+// which the 'task' is one of the ranges, or null if the evaluation is 
+// not running in the Squad 'that' 
+// 'isRange' is set to true if the task is a range of a sharded 
+// evaluation, running or not, else false
+SquadEvalNNShards* SquadGetEvalNNShards(
+                      const Squad* const that, 
+  const SquidletTaskRequest* const task, 
+                       bool* const isRange) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (task == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'task' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (isRange == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'isRange' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+
+  // The ranges are identified by the key of their evaluation in their 
+  // data, not by their id which the user may give to other tasks
+  *isRange = false;
+  if (task->_type != SquidletTaskType_EvalNeuranet || 
+    task->_data == NULL)
+    return NULL;
+  const char* prop = strstr(task->_data, ",\"shardKey\":\"");
+  if (prop == NULL)
+    return NULL;
+  *isRange = true;
+  unsigned long key = strtoul(prop + strlen(",\"shardKey\":\""), NULL, 10);
+
+  // Search the partial results of the evaluation
+  SquadEvalNNShards* shards = NULL;
+  if (GSetNbElem(&(that->_evalNNShards)) > 0) {
+    GSetIterForward iter = 
+      GSetIterForwardCreateStatic((GSet*)&(that->_evalNNShards));
+    do {
+      SquadEvalNNShards* candidate = GSetIterGet(&iter);
+      if (candidate->_key == key)
+        shards = candidate;
+    } while (shards == NULL && GSetIterStep(&iter));
+  }
+
+  // Return the partial results
+  return shards;
+}
+
+// Load a list of tasks stored in json format from the file 'stream'
+// and add them to the set of tasks of the Squad 'that'
+// If the Squad had already tasks, the loaded ones are added to them
+// Return true if the tasks could be loaded, else false
+// Example of list of tasks:
+// {"tasks":[
+//   {"SquidletTaskType":"1", "id":"1", "maxWait":"1"},  
+//   {"SquidletTaskType":"2", "id":"1", "maxWait":"1", 
+//    "nb":"1", "payloadSize":"1"},
+//   {"SquidletTaskType":"3", "id":"1", "maxWait":"1", 
+//    "ini":"./testPov.ini", "sizeMinFragment":"100", 
+//    "sizeMaxFragment":"1000"}
+// ]}
+bool SquadLoadTasks(
+  Squad* const that, 
+   FILE* const stream) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (stream == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'stream' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Declare a json to load the encoded data
+  JSONNode* json = JSONCreate();
+
+  // Load the whole encoded data
+  if (JSONLoad(json, stream) == false) {
+    TheSquidErr->_type = PBErrTypeIOError;
+    sprintf(TheSquidErr->_msg, "JSONLoad failed");
+    JSONFree(&json);
+    return false;
+  }
+  
+  // Get the list of tasks
+  JSONNode* propTasks = JSONProperty(json, "tasks");
+  if (propTasks == NULL) {
+    TheSquidErr->_type = PBErrTypeInvalidData;
+    sprintf(TheSquidErr->_msg, "tasks not found");
+    JSONFree(&json);
+    return false;
+  }
+  
+  // Get the number of tasks
+  unsigned long nbTasks = JSONGetNbValue(propTasks);
+  
+  // Loop on tasks
+  for (unsigned long iTask = 0; iTask < nbTasks; ++iTask) {
+
+    // Get the task
+    JSONNode* propTask = JSONValue(propTasks, iTask);
+    
+    // Get the type of task, id and time out
+    JSONNode* propType = JSONProperty(propTask, "SquidletTaskType");
+    if (propType == NULL) {
+      TheSquidErr->_type = PBErrTypeInvalidData;
+      sprintf(TheSquidErr->_msg, "'SquidletTaskType' not found");
+      JSONFree(&json);
+      return false;
+    }
+    JSONNode* propId = JSONProperty(propTask, "id");
+    if (propId == NULL) {
+      TheSquidErr->_type = PBErrTypeInvalidData;
+      sprintf(TheSquidErr->_msg, "'id' not found");
+      JSONFree(&json);
+      return false;
+    }
+    JSONNode* propMaxWait = JSONProperty(propTask, "maxWait");
+    if (propMaxWait == NULL) {
+      TheSquidErr->_type = PBErrTypeInvalidData;
+      sprintf(TheSquidErr->_msg, "'maxWait' not found");
+      JSONFree(&json);
+      return false;
+    }
+    
+    // Convert values
+    int type = atoi(JSONLblVal(propType));
+    unsigned long id = atol(JSONLblVal(propId));
+    time_t maxWait = atoi(JSONLblVal(propMaxWait));
+
+    // Switch according to the type of task and add the corresponding 
+    // task
+    JSONNode* prop = NULL;
+    const TheSquidTaskPlugin* plugin = NULL;
+    switch(type) {
+      
+      // Dummy task
+      case SquidletTaskType_Dummy:
+        
+        // Add the task
+        SquadAddTask_Dummy(that, id, maxWait);
+        break;
+      
+      // Benchmark task
+      case SquidletTaskType_Benchmark:
+        
+        // Get the extra arguments
+        prop = JSONProperty(propTask, "nb");
+        if (prop == NULL) {
+          TheSquidErr->_type = PBErrTypeInvalidData;
+          sprintf(TheSquidErr->_msg, "'nb' not found");
+          JSONFree(&json);
+          return false;
+        }
+        int nb = atoi(JSONLblVal(prop));
+        prop = JSONProperty(propTask, "payloadSize");
+        if (prop == NULL) {
+          TheSquidErr->_type = PBErrTypeInvalidData;
+          sprintf(TheSquidErr->_msg, "'payloadSize' not found");
+          JSONFree(&json);
+          return false;
+        }
+        size_t payloadSize = atol(JSONLblVal(prop));
+
+        // Add the task
+        SquadAddTask_Benchmark(that, id, maxWait, nb, payloadSize);
+        break;
+
+      // POV-Ray task
+      case SquidletTaskType_PovRay:
+
+        // Get the extra arguments
+        prop = JSONProperty(propTask, "ini");
+        if (prop == NULL) {
+          TheSquidErr->_type = PBErrTypeInvalidData;
+          sprintf(TheSquidErr->_msg, "ini not found");
+          JSONFree(&json);
+          return false;
+        }
+        char* ini = strdup(JSONLblVal(prop));
+        prop = JSONProperty(propTask, "sizeMinFragment");
+        if (prop == NULL) {
+          TheSquidErr->_type = PBErrTypeInvalidData;
+          sprintf(TheSquidErr->_msg, "sizeMinFragment not found");
+          JSONFree(&json);
+          return false;
+        }
+        int sizeMinFragment = atoi(JSONLblVal(prop));
+        prop = JSONProperty(propTask, "sizeMaxFragment");
+        if (prop == NULL) {
+          TheSquidErr->_type = PBErrTypeInvalidData;
+          sprintf(TheSquidErr->_msg, "sizeMaxFragment not found");
+          JSONFree(&json);
+          return false;
+        }
+        int sizeMaxFragment = atoi(JSONLblVal(prop));
+
+        // Add the task
+        SquadAddTask_PovRay(that, id, maxWait, ini, 
+          sizeMinFragment, sizeMaxFragment);
+
+        // Free memory
+        free(ini);
+        break;
+
+      // Stats reset task
+      case SquidletTaskType_ResetStats:
+        
+        // Ignore this special task which can be only triggered
+        // at runtime
+        break;
+
+      // Stats task
+      case SquidletTaskType_Stats:
+        
+        // Ignore this special task which is only triggered by the 
+        // Squad itself
+        break;
+
+      // Batch task
+      case SquidletTaskType_Batch:
+        
+        // Ignore this special task which is only created by the 
+        // Squad itself when dispatching to a relay
+        break;
+
+      // Exec task
+      case SquidletTaskType_Exec:
+
+        // Get the extra arguments, the arguments of the command and the 
+        // path of the file whose content is written on its standard 
+        // input are optional
+        prop = JSONProperty(propTask, "cmd");
+        if (prop == NULL) {
+          TheSquidErr->_type = PBErrTypeInvalidData;
+          sprintf(TheSquidErr->_msg, "cmd not found");
+          JSONFree(&json);
+          return false;
+        }
+        char* cmd = JSONLblVal(prop);
+        prop = JSONProperty(propTask, "args");
+        int nbArg = (prop != NULL ? (int)JSONGetNbValue(prop) : 0);
+        const char** args = NULL;
+        if (nbArg > 0) {
+          args = PBErrMalloc(TheSquidErr, sizeof(char*) * nbArg);
+          for (int iArg = 0; iArg < nbArg; ++iArg)
+            args[iArg] = JSONLblVal(JSONValue(prop, iArg));
+        }
+        char* input = NULL;
+        prop = JSONProperty(propTask, "input");
+        bool added = true;
+        if (prop != NULL) {
+          size_t lenInput = 0;
+          FILE* streamInput = open_memstream(&input, &lenInput);
+          FILE* fpInput = fopen(JSONLblVal(prop), "r");
+          added = (streamInput != NULL && fpInput != NULL);
+          char chunk[THESQUID_EXEC_PIPEBUFFER];
+          size_t nbRead = 0;
+          while (added == true && (nbRead = 
+            fread(chunk, 1, THESQUID_EXEC_PIPEBUFFER, fpInput)) > 0)
+            fwrite(chunk, 1, nbRead, streamInput);
+          if (fpInput != NULL)
+            fclose(fpInput);
+          if (streamInput != NULL)
+            fclose(streamInput);
+          if (added == false) {
+            TheSquidErr->_type = PBErrTypeIOError;
+            sprintf(TheSquidErr->_msg, "couldn't read %.100s", 
+              JSONLblVal(prop));
+          }
+        }
+
+        // Add the task
+        if (added == true)
+          added = SquadAddTask_Exec(that, id, maxWait, cmd, nbArg, 
+            args, input);
+
+        // Free memory
+        free(args);
+        free(input);
+        if (added == false) {
+          JSONFree(&json);
+          return false;
+        }
+        break;
+
+      // Neuranet evaluation task
+      case SquidletTaskType_EvalNeuranet:
+        
+        prop = JSONProperty(propTask, "dataset");
+        if (prop == NULL) {
+          TheSquidErr->_type = PBErrTypeInvalidData;
+          sprintf(TheSquidErr->_msg, "dataset not found");
+          JSONFree(&json);
+          return false;
+        }
+        char* dataset = JSONLblVal(prop);
+        prop = JSONProperty(propTask, "workingDir");
+        if (prop == NULL) {
+          TheSquidErr->_type = PBErrTypeInvalidData;
+          sprintf(TheSquidErr->_msg, "workingDir not found");
+          JSONFree(&json);
+          return false;
+        }
+        char* workingDir = JSONLblVal(prop);
+        prop = JSONProperty(propTask, "nnids");
+        if (prop == NULL) {
+          TheSquidErr->_type = PBErrTypeInvalidData;
+          sprintf(TheSquidErr->_msg, "nnids not found");
+          JSONFree(&json);
+          return false;
+        }
+        VecLong* nnids = NULL;
+        VecDecodeAsJSON(&nnids, prop);
+        prop = JSONProperty(propTask, "best");
+        if (prop == NULL) {
+          TheSquidErr->_type = PBErrTypeInvalidData;
+          sprintf(TheSquidErr->_msg, "best not found");
           JSONFree(&json);
           return false;
         }
-        char* workingDir = JSONLblVal(prop);
-        prop = JSONProperty(propTask, "nnids");
-        if (prop == NULL) {
-          TheSquidErr->_type = PBErrTypeInvalidData;
-          sprintf(TheSquidErr->_msg, "nnids not found");
-          JSONFree(&json);
-          return false;
+        float bestVal = atof(JSONLblVal(prop));
+        prop = JSONProperty(propTask, "cat");
+        if (prop == NULL) {
+          TheSquidErr->_type = PBErrTypeInvalidData;
+          sprintf(TheSquidErr->_msg, "cat not found");
+          JSONFree(&json);
+          return false;
+        }
+        long cat = atol(JSONLblVal(prop));
+        bool fastReject = false;
+        prop = JSONProperty(propTask, "reject");
+        if (prop != NULL)
+          fastReject = (atoi(JSONLblVal(prop)) == 1);
+        unsigned int nbShard = 1;
+        prop = JSONProperty(propTask, "nbShard");
+        if (prop != NULL)
+          nbShard = atoi(JSONLblVal(prop));
+        
+        bool inlineNN = false;
+        prop = JSONProperty(propTask, "inline");
+        if (prop != NULL)
+          inlineNN = (atoi(JSONLblVal(prop)) == 1);
+        
+        // If the NeuraNets must be sent inline with the task
+        if (inlineNN == true) {
+
+          // Load the NeuraNets from the working directory
+          long nbNN = VecGetDim(nnids);
+          NeuraNet** nns = PBErrMalloc(TheSquidErr, 
+            sizeof(NeuraNet*) * nbNN);
+          memset(nns, 0, sizeof(NeuraNet*) * nbNN);
+          bool loaded = (nbNN <= THESQUID_NBNNCACHE);
+          for (long iNN = 0; iNN < nbNN && loaded; ++iNN) {
+            char nnFilename[100];
+            sprintf(nnFilename, "nn%ld.json", VecGet(nnids, iNN));
+            char* pathNN = PBFSJoinPath(workingDir, nnFilename);
+            FILE* fpnn = fopen(pathNN, "r");
+            free(pathNN);
+            loaded = (fpnn != NULL && NNLoad(nns + iNN, fpnn));
+            if (fpnn != NULL)
+              fclose(fpnn);
+          }
+
+          // Add the task
+          if (loaded == true) {
+            SquadAddTask_EvalNeuraNetInline(that, id, maxWait, dataset, 
+              nns, nnids, bestVal, cat, fastReject, nbShard);
+          }
+
+          // Free memory
+          for (long iNN = nbNN; iNN--;)
+            NeuraNetFree(nns + iNN);
+          free(nns);
+
+          // If we couldn't load the NeuraNets
+          if (loaded == false) {
+            TheSquidErr->_type = PBErrTypeInvalidData;
+            sprintf(TheSquidErr->_msg, "couldn't load the NeuraNets");
+            VecFree(&nnids);
+            JSONFree(&json);
+            return false;
+          }
+
+        // Else, the squidlets load the NeuraNets from the working 
+        // directory
+        } else {
+
+          // Add the task
+          SquadAddTask_EvalNeuraNet(that, id, maxWait, dataset, 
+            workingDir, nnids, bestVal, cat, fastReject, nbShard);
+        }
+        
+        // Free memory
+        VecFree(&nnids);
+        
+        break;
+      
+      // Plugin task or invalid task type
+      default:
+
+        // If the type is the one of a registered plugin
+        plugin = TheSquidGetTaskPlugin(type);
+        if (plugin != NULL) {
+
+          // Encode the data of the task, if the plugin doesn't encode 
+          // them the description of the task is sent as is
+          char* data = NULL;
+          if (plugin->_encode != NULL) {
+            data = plugin->_encode(propTask);
+          } else {
+            data = PBErrMalloc(TheSquidErr, THESQUID_MAXPAYLOADSIZE);
+            memset(data, 0, THESQUID_MAXPAYLOADSIZE);
+            bool compact = true;
+            if (JSONSaveToStr(propTask, data, THESQUID_MAXPAYLOADSIZE, 
+              compact) == false) {
+              free(data);
+              data = NULL;
+            }
+          }
+          if (data == NULL) {
+            TheSquidErr->_type = PBErrTypeInvalidData;
+            sprintf(TheSquidErr->_msg, "couldn't encode the %s task", 
+              plugin->_name);
+            JSONFree(&json);
+            return false;
+          }
+
+          // Add the task
+          SquadAddTask_Plugin(that, type, id, maxWait, data);
+
+          // Free memory
+          free(data);
+          break;
+        }
+
+        // Set the error message
+        TheSquidErr->_type = PBErrTypeInvalidData;
+        sprintf(TheSquidErr->_msg, "invalid task type (%d)", type);
+
+        // Free memory
+        JSONFree(&json);
+        
+        // Return the error code
+        return false;
+    }
+  }
+
+  // Free the memory used by the JSON
+  JSONFree(&json);
+  
+  // Return the success code
+  return true;
+  
+}
+
+// Load the Squidlet info from the file 'stream' into the Squad 'that'
+// Return true if it could load the info, else false
+bool SquadLoadSquidlets(
+  Squad* const that, 
+   FILE* const stream) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (stream == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'stream' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Discard the current squidlets info if any
+  while (GSetNbElem(SquadSquidlets(that)) > 0) {
+    SquidletInfo* squidletInfo = GSetPop((GSet*)SquadSquidlets(that));
+    SquidletInfoFree(&squidletInfo);
+  }
+
+  // Declare a json to load the encoded data
+  JSONNode* json = JSONCreate();
+
+  // Load the whole encoded data
+  if (JSONLoad(json, stream) == false) {
+    TheSquidErr->_type = PBErrTypeIOError;
+    sprintf(TheSquidErr->_msg, "JSONLoad failed");
+    JSONFree(&json);
+    return false;
+  }
+
+  // Decode the data from the JSON
+  if (!SquadDecodeAsJSON(that, json)) {
+    JSONFree(&json);
+    return false;
+  }
+
+  // Free the memory used by the JSON
+  JSONFree(&json);
+  
+  // Return the succes code
+  return true;
+}
+
+// Load the Squidlet info from the string 'str' into the Squad 'that'
+// Return true if it could load the info, else false
+bool SquadLoadSquidletsFromStr(
+  Squad* const that, 
+   char* const str) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (str == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'str' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Discard the current squidlets info if any
+  while (GSetNbElem(SquadSquidlets(that)) > 0) {
+    SquidletInfo* squidletInfo = GSetPop((GSet*)SquadSquidlets(that));
+    SquidletInfoFree(&squidletInfo);
+  }
+
+  // Declare a json to load the encoded data
+  JSONNode* json = JSONCreate();
+
+  // Load the whole encoded data
+  if (JSONLoadFromStr(json, str) == false) {
+    TheSquidErr->_type = PBErrTypeIOError;
+    sprintf(TheSquidErr->_msg, "JSONLoadFromStr failed");
+    JSONFree(&json);
+    return false;
+  }
+
+  // Decode the data from the JSON
+  if (!SquadDecodeAsJSON(that, json)) {
+    JSONFree(&json);
+    return false;
+  }
+
+  // Free the memory used by the JSON
+  JSONFree(&json);
+  
+  // Return the succes code
+  return true;
+}
+
+// Decode the JSON info of a Squad from the JSON node 'json'
+bool SquadDecodeAsJSON(
+     Squad* that, 
+  JSONNode* json) {
+
+  // Get the property _squidlets from the JSON
+  JSONNode* prop = JSONProperty(json, "_squidlets");
+  if (prop == NULL) {
+    TheSquidErr->_type = PBErrTypeInvalidData;
+    sprintf(TheSquidErr->_msg, "'_squidlets' not found");
+    return false;
+  }
+
+  // Get the number of squidlets
+  int nbSquidlet = JSONGetNbValue(prop);
+  
+  // Loop on squidlets
+  for (int iSquidlet = 0; iSquidlet < nbSquidlet; ++iSquidlet) {
+
+    // Get the JSON node for this squidlet
+    JSONNode* propSquidlet = JSONValue(prop, iSquidlet);
+    
+    // Get the property _name of the squidlet
+    JSONNode* propName = JSONProperty(propSquidlet, "_name");
+    if (propName == NULL) {
+      TheSquidErr->_type = PBErrTypeInvalidData;
+      sprintf(TheSquidErr->_msg, "'_name' not found for squidlet %d",
+        iSquidlet);
+      return false;
+    }
+
+    // Get the property _ip of the squidlet
+    JSONNode* propIp = JSONProperty(propSquidlet, "_ip");
+    if (propIp == NULL) {
+      TheSquidErr->_type = PBErrTypeInvalidData;
+      sprintf(TheSquidErr->_msg, "'_ip' not found for squidlet %d",
+        iSquidlet);
+      return false;
+    }
+
+    // Get the property _port of the squidlet
+    JSONNode* propPort = JSONProperty(propSquidlet, "_port");
+    if (propPort == NULL) {
+      TheSquidErr->_type = PBErrTypeInvalidData;
+      sprintf(TheSquidErr->_msg, "'_port' not found for squidlet %d",
+        iSquidlet);
+      return false;
+    }
+
+    // Create a SquidletInfo
+    char* name = JSONLblVal(propName);
+    char* ip = JSONLblVal(propIp);
+    int port = atoi(JSONLblVal(propPort));
+    SquidletInfo* squidletInfo = SquidletInfoCreate(name, ip, port);
+
+    // Get the optional property _capacity of the squidlet
+    JSONNode* propCapacity = JSONProperty(propSquidlet, "_capacity");
+    if (propCapacity != NULL)
+      squidletInfo->_capacity = MAX(1, atol(JSONLblVal(propCapacity)));
+        
+    // Add the squidlet to the set of squidlets
+    GSetAppend((GSet*)SquadSquidlets(that), squidletInfo);
+  }
+
+  // Return the success code
+  return true;
+}
+
+// Send the task request 'request' from the Squad 'that' to its
+// Squidlet 'squidlet'
+// Create a socket, open a connection, ask the squidlet if it can 
+// execute the task and wait for its reply
+// Return true if the request has been accepted by the squidlet, 
+// false else
+bool SquadSendTaskRequest(
+                Squad* const that, 
+  SquidletTaskRequest* const request, 
+         SquidletInfo* const squidlet) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (request == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'request' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (squidlet == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'squidlet' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // If the requested task is null
+  if (request->_type == SquidletTaskType_Null) {
+
+    // Nothing to do
+    return true;
+  }
+  
+  // Start the connection to the squidlet
+  if (SquadConnectSquidlet(that, request, squidlet) == false)
+    return false;
+
+  // Wait for the connection up to SQUAD_REQUESTTIMEOUT seconds
+  struct pollfd fds;
+  fds.fd = squidlet->_sock;
+  fds.events = POLLOUT;
+  fds.revents = 0;
+  int retPoll = poll(&fds, 1, SQUAD_REQUESTTIMEOUT * 1000);
+
+  // If the connection timed out
+  if (retPoll <= 0) {
+
+    // Close the socket
+    close(squidlet->_sock);
+    squidlet->_sock = -1;
+
+    // Update history
+    SquadPushHistory(that, "can't connect to squidlet:");
+    SquadPushHistorySquidletInfo(that, squidlet);
+
+    // Return the failure code
+    return false;
+  }
+
+  // Send the request
+  if (SquadSendTaskType(that, request, squidlet) == false)
+    return false;
+
+  // Wait for the reply from the squidlet and return it
+  return SquadRecvTaskReply(that, request, squidlet, 
+    SQUAD_REQUESTTIMEOUT);
+}
+
+// Create a non blocking socket for the request 'request' from the 
+// Squad 'that' to the squidlet 'squidlet' and start the connection 
+// Return true if the connection is in progress or established, false 
+// else
+bool SquadConnectSquidlet(
+                Squad* const that, 
+  SquidletTaskRequest* const request, 
+         SquidletInfo* const squidlet) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (request == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'request' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (squidlet == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'squidlet' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Close the socket if it was opened
+  if (squidlet->_sock != -1) {
+    close(squidlet->_sock);
+    squidlet->_sock = -1;
+  }
+
+  // Reset the time of the phases of the protocol and memorize the 
+  // start of the connection
+  memset(request->_timePhases, 0, sizeof(request->_timePhases));
+  gettimeofday(request->_timePhases + SquidletTaskPhase_Connect, NULL);
+  
+  // Create the socket
+  int protocol = 0;
+  squidlet->_sock = socket(AF_INET, SOCK_STREAM, protocol);
+  
+  // If we couldn't create the socket
+  if (squidlet->_sock == -1) {
+
+    // Update history
+    SquadPushHistory(that, "can't create socket to squidlet:");
+    SquadPushHistorySquidletInfo(that, squidlet);
+
+    // Return the failure code
+    return false;
+  }
+
+  // Make the socket non blocking, to connect to several squidlets 
+  // at the same time
+  int flagsSock = fcntl(squidlet->_sock, F_GETFL, 0);
+  if (flagsSock == -1 || 
+    fcntl(squidlet->_sock, F_SETFL, flagsSock | O_NONBLOCK) == -1) {
+
+    // Close the socket
+    close(squidlet->_sock);
+    squidlet->_sock = -1;
+
+    // Update history
+    SquadPushHistory(that, "failed to configure socket to squidlet:");
+    SquadPushHistorySquidletInfo(that, squidlet);
+
+    // Return the failure code
+    return false;
+  }
+  
+  // Create the data for the connection to the squidlet from its 
+  // ip and port
+  struct sockaddr_in remote = {0};
+  remote.sin_addr.s_addr = inet_addr(squidlet->_ip);
+  remote.sin_family = AF_INET;
+  remote.sin_port = htons(squidlet->_port);
+
+  // Start the connection to the squidlet
+  int retConnect = connect(squidlet->_sock, (struct sockaddr*)&remote, 
+    sizeof(struct sockaddr_in));
+
+  // If the connection failed immediately
+  if (retConnect == -1 && errno != EINPROGRESS) {
+
+    // Close the socket
+    close(squidlet->_sock);
+    squidlet->_sock = -1;
+
+    // Update history
+    SquadPushHistory(that, "can't connect to squidlet:");
+    SquadPushHistorySquidletInfo(that, squidlet);
+
+    // Return the failure code
+    return false;
+  }
+
+  // Return the success code
+  return true;
+}
+
+// Check the connection started by SquadConnectSquidlet() from the 
+// Squad 'that' to the squidlet 'squidlet', configure the socket and 
+// send the type of the task of the request 'request' 
+// Return true if the request could be sent, false else
+bool SquadSendTaskType(
+                Squad* const that, 
+  SquidletTaskRequest* const request, 
+         SquidletInfo* const squidlet) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (request == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'request' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (squidlet == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'squidlet' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Get the result of the connection
+  int errConnect = 0;
+  socklen_t lenErrConnect = sizeof(errConnect);
+  int retErr = getsockopt(squidlet->_sock, SOL_SOCKET, SO_ERROR, 
+    &errConnect, &lenErrConnect);
+
+  // If the connection failed
+  if (retErr == -1 || errConnect != 0) {
+
+    // Close the socket
+    close(squidlet->_sock);
+    squidlet->_sock = -1;
+
+    // Update history
+    SquadPushHistory(that, "can't connect to squidlet:");
+    SquadPushHistorySquidletInfo(that, squidlet);
+
+    // Return the failure code
+    return false;
+  }
+
+  // Update history
+  SquadPushHistory(that, "connected to squidlet:");
+  SquadPushHistorySquidletInfo(that, squidlet);
+  gettimeofday(request->_timePhases + SquidletTaskPhase_Connected, NULL);
+
+  // Put back the socket in blocking mode, the rest of the protocol 
+  // relies on the timeouts of the socket
+  int flagsSock = fcntl(squidlet->_sock, F_GETFL, 0);
+  int retBlock = -1;
+  if (flagsSock != -1) {
+    retBlock = 
+      fcntl(squidlet->_sock, F_SETFL, flagsSock & ~O_NONBLOCK);
+  }
+
+  // Set the timeout of the socket for sending and receiving to 1us 
+  // and allow the reuse of address
+  struct timeval tv;
+  tv.tv_sec = 0;
+  tv.tv_usec = 1;
+  int retSnd = setsockopt(squidlet->_sock, SOL_SOCKET, SO_SNDTIMEO, 
+    (char*)&tv, sizeof(tv));
+  int retRcv = setsockopt(squidlet->_sock, SOL_SOCKET, SO_RCVTIMEO, 
+    (char*)&tv, sizeof(tv));
+  int reuse = 1;
+  int retReuse = setsockopt(squidlet->_sock, SOL_SOCKET, SO_REUSEADDR, 
+    &reuse,sizeof(int));
+
+  // Probe the connection while the squidlet is processing the task, 
+  // to detect quickly if it dies. The keepalive is not available on 
+  // all the platforms, the squad then relies on the time limit of the 
+  // task only
+  int keepAlive = 1;
+  (void)setsockopt(squidlet->_sock, SOL_SOCKET, SO_KEEPALIVE, 
+    &keepAlive, sizeof(int));
+#ifdef TCP_KEEPIDLE
+  int keepIdle = THESQUID_KEEPALIVE_IDLE;
+  int keepIntvl = THESQUID_KEEPALIVE_INTVL;
+  int keepCnt = THESQUID_KEEPALIVE_CNT;
+  (void)setsockopt(squidlet->_sock, IPPROTO_TCP, TCP_KEEPIDLE, 
+    &keepIdle, sizeof(int));
+  (void)setsockopt(squidlet->_sock, IPPROTO_TCP, TCP_KEEPINTVL, 
+    &keepIntvl, sizeof(int));
+  (void)setsockopt(squidlet->_sock, IPPROTO_TCP, TCP_KEEPCNT, 
+    &keepCnt, sizeof(int));
+#endif
+
+  // If we couldn't configure the socket
+  if (retBlock == -1 || retSnd == -1 || retRcv == -1 || 
+    retReuse == -1) {
+
+    // Close the socket
+    close(squidlet->_sock);
+    squidlet->_sock = -1;
+
+    // Update history
+    SquadPushHistory(that, "failed to configure socket to squidlet:");
+    SquadPushHistorySquidletInfo(that, squidlet);
+
+    // Return the failure code
+    return false;
+  }
+
+  // Send the task request, the squidlet only needs the type of the 
+  // task
+  int flags = 0;
+  int retSend = send(squidlet->_sock, 
+    &(request->_type), sizeof(SquidletTaskType), flags);
+    
+  // If we couldn't send the request
+  if (retSend == -1) {
+
+    // Close the socket
+    close(squidlet->_sock);
+    squidlet->_sock = -1;
+
+    // Update history
+    SquadPushHistory(that, "failed to send the request to squidlet:");
+    SquadPushHistorySquidletInfo(that, squidlet);
+
+    // Return the failure code
+    return false;
+  }
+
+  // Return the success code
+  return true;
+}
+
+// Receive the reply of the squidlet 'squidlet' to the request 
+// 'request' from the Squad 'that'. Give up after 'maxWait' seconds. 
+// Return true if the squidlet accepted the task, false else
+bool SquadRecvTaskReply(
+                Squad* const that, 
+  SquidletTaskRequest* const request, 
+         SquidletInfo* const squidlet, 
+                const time_t maxWait) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (request == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'request' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (squidlet == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'squidlet' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Receive the reply from the squidlet
+  char reply = THESQUID_TASKREFUSED;
+  bool retRecv = SocketRecv(
+    &(squidlet->_sock), sizeof(reply), &reply, maxWait);
+
+  // If we couldn't receive the reply or the reply timed out or 
+  // the squidlet refused the task
+  if (retRecv == false || reply == THESQUID_TASKREFUSED) {
+
+    // Close the socket
+    close(squidlet->_sock);
+    squidlet->_sock = -1;
+
+    // Update history
+    SquadPushHistory(that, "task refused by squidlet:");
+    SquadPushHistorySquidletInfo(that, squidlet);
+
+    // Return the failure code
+    return false;
+  }
+
+  // Update history
+  SquadPushHistory(that, "request:");
+  SquadPushHistorySquidletTaskRequest(that, request);
+  SquadPushHistory(that, "accepted by squidlet:");
+  SquadPushHistorySquidletInfo(that, squidlet);
+  gettimeofday(request->_timePhases + SquidletTaskPhase_Accepted, NULL);
+
+  // Return the success code
+  return true;
+}
+
+// Add a dummy task uniquely identified by its 'id' to the list of 
+// task to execute by the squad 'that'
+// The task will have a maximum of 'maxWait' seconds to complete from 
+// the time it's accepted by the squidlet or it will be considered
+// as failed
+void SquadAddTask_Dummy(
+         Squad* const that, 
+  const unsigned long id,
+         const time_t maxWait) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Prepare the data as JSON
+  char buffer[100];
+  memset(buffer, 0, 100);
+  sprintf(buffer, "{\"v\":\"%lu\"}", id);
+  unsigned long subid = 0;
+
+  // Create the new task
+  SquidletTaskRequest* task = SquidletTaskRequestCreate(
+    SquidletTaskType_Dummy, id, subid, buffer, maxWait);
+  
+  // Add the new task to the set of task to execute
+  GSetAppend((GSet*)SquadTasks(that), task);
+}
+
+// Add an exec task uniquely identified by its 'id' to the list of 
+// task to execute by the squad 'that' 
+// The squidlet runs the binary named 'cmd' (one of those allowed with 
+// SquidletAddExecCommand) with the 'nbArg' arguments 'args', without 
+// shell, writes 'input' (may be null) on its standard input and 
+// returns its standard output 
+// The task will have a maximum of 'maxWait' seconds to complete from 
+// the time it's accepted by the squidlet or it will be considered 
+// as failed, the squidlet kills the command after 'maxWait' seconds 
+// Return false if the name of the command contains a line break, a 
+// quote, a backslash or a slash, or the arguments contain a line 
+// break, else true
+bool SquadAddTask_Exec(
+               Squad* const that, 
+        const unsigned long id, 
+               const time_t maxWait, 
+          const char* const cmd, 
+                  const int nbArg, 
+  const char* const* const args, 
+          const char* const input) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (cmd == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'cmd' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (nbArg > 0 && args == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'args' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Check the command and its arguments, they are sent one per line
+  if (strpbrk(cmd, "\n\"\\/") != NULL) {
+    TheSquidErr->_type = PBErrTypeInvalidArg;
+    sprintf(TheSquidErr->_msg, "invalid command (%.100s)", cmd);
+    return false;
+  }
+  for (int iArg = 0; iArg < nbArg; ++iArg) {
+    if (strchr(args[iArg], '\n') != NULL) {
+      TheSquidErr->_type = PBErrTypeInvalidArg;
+      sprintf(TheSquidErr->_msg, "invalid argument (%.100s)", 
+        args[iArg]);
+      return false;
+    }
+  }
+
+  // Encode the data: a line in JSON format with the command, its number 
+  // of arguments and time limit, followed by one line per argument and 
+  // the standard input as is
+  char* data = NULL;
+  size_t lenData = 0;
+  FILE* stream = open_memstream(&data, &lenData);
+  if (stream == NULL) {
+    TheSquidErr->_type = PBErrTypeIOError;
+    sprintf(TheSquidErr->_msg, "open_memstream failed");
+    return false;
+  }
+  fprintf(stream, "{\"cmd\":\"%s\",\"nbArg\":\"%d\",\"timeout\":\"%ld\"}\n", 
+    cmd, nbArg, (long)maxWait);
+  for (int iArg = 0; iArg < nbArg; ++iArg)
+    fprintf(stream, "%s\n", args[iArg]);
+  if (input != NULL)
+    fputs(input, stream);
+  fclose(stream);
+  unsigned long subid = 0;
+
+  // Create the new task
+  SquidletTaskRequest* task = SquidletTaskRequestCreate(
+    SquidletTaskType_Exec, id, subid, data, maxWait);
+  free(data);
+  
+  // Add the new task to the set of task to execute
+  GSetAppend((GSet*)SquadTasks(that), task);
+
+  // Return the success code
+  return true;
+}
+
+// Add a task of the plugin type 'type' uniquely identified by its 'id' 
+// to the list of task to execute by the squad 'that', with the 'data' 
+// (string in JSON format) sent as is to the squidlet 
+// The task will have a maximum of 'maxWait' seconds to complete from 
+// the time it's accepted by the squidlet or it will be considered 
+// as failed, if 'maxWait' is 0 twice the expected time of the plugin 
+// is used instead
+void SquadAddTask_Plugin(
+                Squad* const that, 
+      const SquidletTaskType type, 
+         const unsigned long id, 
+                const time_t maxWait, 
+           const char* const data) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (data == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'data' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (TheSquidGetTaskPlugin(type) == NULL) {
+    TheSquidErr->_type = PBErrTypeInvalidArg;
+    sprintf(TheSquidErr->_msg, "'type' is not a plugin (%d)", type);
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // If the task has no time limit, give it twice its expected time
+  time_t wait = maxWait;
+  const TheSquidTaskPlugin* plugin = TheSquidGetTaskPlugin(type);
+  if (wait == 0 && plugin != NULL)
+    wait = 1 + (time_t)(2 * plugin->_cost._timeMs / 1000);
+  unsigned long subid = 0;
+
+  // Create the new task
+  SquidletTaskRequest* task = SquidletTaskRequestCreate(
+    type, id, subid, data, wait);
+  
+  // Add the new task to the set of task to execute
+  GSetAppend((GSet*)SquadTasks(that), task);
+}
+
+// Add a benchmark task uniquely identified by its 'id' to the list of 
+// task to execute by the squad 'that'
+// The task will have a maximum of 'maxWait' seconds to complete from 
+// the time it's accepted by the squidlet or it will be considered
+// as failed
+// Artificially set the size of the data for the task to 'payloadSize' 
+// bytes
+// The benchmark function used is sorting 'nb' times a set of numbers
+// cf TheSquidBenchmark()
+void SquadAddTask_Benchmark(
+         Squad* const that, 
+  const unsigned long id,
+         const time_t maxWait, 
+   const unsigned int nb, 
+   const unsigned int payloadSize) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Create a dummy buffer of length 'payloadSize'
+  char* data = PBErrMalloc(TheSquidErr, payloadSize + 1);
+  memset(data, ' ', payloadSize);
+  data[payloadSize] = '\0';
+
+  // Convert the arguments into strings to get their length
+  char bufferNb[100];
+  sprintf(bufferNb, "%d", nb);
+  int bufferNbLen = strlen(bufferNb);
+  char bufferId[100];
+  sprintf(bufferId, "%ld", id);
+  int bufferIdLen = strlen(bufferId);
+
+  // Get the length of the json data without values
+  int jsonFormatLen = \
+    strlen("{\"id\":\"\",\"nb\":\"\",\"payloadSize\":\"\"}");
+
+  // Get the length of the json data with values
+  int bufferLength = 
+    jsonFormatLen + bufferIdLen + bufferNbLen + strlen(data) + 1;
+
+  // Allocate memory
+  char* buffer = PBErrMalloc(TheSquidErr, bufferLength);
+
+  // Create the JSON data
+  sprintf(buffer, "{\"id\":\"%s\",\"nb\":\"%s\",\"payloadSize\":\"%s\"}", 
+    bufferId, bufferNb, data);
+  free(data);
+
+  // Create the new task
+  unsigned long subid = 0;
+  SquidletTaskRequest* task = SquidletTaskRequestCreate(
+    SquidletTaskType_Benchmark, id, subid, buffer, maxWait);
+  free(buffer);
+  
+  // Add the new task to the set of task to execute
+  GSetAppend((GSet*)SquadTasks(that), task);
+}
+
+// Add a POV-Ray task uniquely identified by its 'id' to the list of 
+// task to execute by the squad 'that'
+// The task will have a maximum of 'maxWait' seconds to complete from 
+// the time it's accepted by the squidlet or it will be considered
+// as failed
+// The POV-Ray task is described by the POV-Ray ini file 'ini' which 
+// must include at least the following options:
+// Input_File_Name=<script.pov>
+// Width=<width> 
+// Height=<height>
+// Output_File_Name=<image.tga>
+// The output format of the image must be TGA
+// Video are not supported
+// The image is splitted into as many squared fragments as 
+// SquadGetNbSquidlets(that)^2, but the size of the fragment is clipped
+// to [sizeMinFragment, sizeMaxFragment]
+// The size of the fragments are corrected to fit the size of the image
+// if it's not a squared image
+// Fragments are rendered on the squidlets in random order
+// The final image is updated each time a fragment has been
+// rendered
+// The random generator must have been initialised before calling this 
+// function
+void SquadAddTask_PovRay(
+         Squad* const that, 
+  const unsigned long id,
+         const time_t maxWait, 
+    const char* const ini, 
+   const unsigned int sizeMinFragment,
+   const unsigned int sizeMaxFragment) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (ini == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'ini' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Init variables to memorize the dimensions and path of the final 
+  // output image
+  unsigned long width = 0;
+  unsigned long height = 0;
+  char* outImgPath = NULL;
+
+  // Open the ini file
+  FILE* fp = fopen(ini, "r");
+  
+  // If we couldn't open the ini file
+  if (fp == NULL) {
+    
+    // Report the error
+    TheSquidErr->_type = PBErrTypeInvalidArg;
+    sprintf(TheSquidErr->_msg, "Can't open %s", ini);
+    PBErrCatch(TheSquidErr);
+
+  // Else, we could open the ini file
+  } else {
+
+    // Read the ini file line by line
+    char oneLine[THESQUID_MAXPAYLOADSIZE];
+    while(fgets(oneLine, THESQUID_MAXPAYLOADSIZE, fp)) {
+      
+      // If we are on the line defining the width
+      // and there is actually a value for the width
+      if (strstr(oneLine, "Width=") &&
+        strlen(oneLine) > 7) {
+        
+        // Decode the width
+        sscanf(oneLine + 6, "%lu", &width);
+
+      // If we are on the line defining the height
+      // and there is actually a value for the height
+      } else if (strstr(oneLine, "Height=") &&
+        strlen(oneLine) > 8) {
+        
+        // Decode the height
+        sscanf(oneLine + 7, "%lu", &height);
+
+      // If we are on the line defining the path to the output file
+      // and there is actually a value for the path
+      } else if (strstr(oneLine, "Output_File_Name=") &&
+        strlen(oneLine) > 17) {
+        
+        // Copy the path
+        outImgPath = strdup(oneLine + 17);
+
+        // Remove the return line
+        if (outImgPath[strlen(outImgPath) - 1] == '\n') {
+          outImgPath[strlen(outImgPath) - 1] = '\0';
+        }
+
+        // Make sure the output file doesn't exists
+        unlink(outImgPath);
+      }
+    }
+    fclose(fp);
+  }
+  
+  // Check arguments
+  if (width == 0 || height == 0 || outImgPath == NULL) {
+    TheSquidErr->_type = PBErrTypeInvalidArg;
+    sprintf(TheSquidErr->_msg, "Can't decode arguments from %s", ini);
+    PBErrCatch(TheSquidErr);
+  }
+
+  // Get the nb of squidlets, force it to 1 at least to avoid division
+  // by zero
+  unsigned long nbSquidlets = MAX(1, SquadGetNbSquidlets(that));
+
+  // Declare a variable to memorize the size of one fragment
+  unsigned long sizeFrag[2];
+
+  // Get the size of one fragment
+  sizeFrag[0] = 
+    MAX(sizeMinFragment, MIN(sizeMaxFragment, width / nbSquidlets));
+  sizeFrag[1] = 
+    MAX(sizeMinFragment, MIN(sizeMaxFragment, width / nbSquidlets));
+  
+  // Declare a variable to memorize the nb of fragments
+  unsigned long nbFrag[2];
+
+  // Get the nb of fragments
+  nbFrag[0] = width / sizeFrag[0];
+  nbFrag[1] = height / sizeFrag[1];
+
+  // If the size of the image is not dividable we have to had one more
+  // fragment to render the last partial fragment
+  if (sizeFrag[0] * nbFrag[0] < width)
+    ++(nbFrag[0]);
+  if (sizeFrag[1] * nbFrag[1] < height)
+    ++(nbFrag[1]);
+  
+  // Create a temporary GSet where to add the tasks to be able to 
+  // shuffle it independantly of the eventual other task in the Squad
+  // Shuffling the task to render the fragments in random order
+  GSet set = GSetCreateStatic();
+  
+  // Create the tasks for each fragment
+  for (unsigned long i = 0; i < nbFrag[0]; ++i) {
+    for (unsigned long j = 0; j < nbFrag[1]; ++j) {
+
+      // Get the id of the task
+      unsigned long taskId = i * nbFrag[1] + j;
+
+      // Get the coordinates of the fragment
+      // Pov-Ray starts counting at 1, so the top left is (1,1)
+      unsigned long top = j * sizeFrag[1] + 1;
+      unsigned long left = i * sizeFrag[0] + 1;
+      unsigned long bottom = (j + 1) * sizeFrag[1] + 1;
+      if (bottom > height)
+        bottom = height;
+      unsigned long right = (i + 1) * sizeFrag[0] + 1;
+      if (right > width)
+        right = width;
+
+      // Get the name of the output file for this fragment
+      int len = strlen(outImgPath);
+      char* tga = PBErrMalloc(TheSquidErr, len + 6);
+      memset(tga, 0, len + 6);
+      strcpy(tga, outImgPath);
+      sprintf(tga + len - 4, "-%05lu.tga", taskId);
+
+      // Prepare the data as JSON
+      char buffer[THESQUID_MAXPAYLOADSIZE];
+      memset(buffer, 0, THESQUID_MAXPAYLOADSIZE);
+      sprintf(buffer, 
+        "{\"id\":\"%lu\",\"subid\":\"%lu\",\"ini\":\"%s\","
+        "\"tga\":\"%s\",\"top\":\"%lu\",\"left\":\"%lu\","
+        "\"bottom\":\"%lu\",\"right\":\"%lu\",\"width\":\"%lu\","
+        "\"height\":\"%lu\",\"outTga\":\"%s\"", 
+        id, taskId, ini, tga, top, left, bottom, right, width, height,
+        outImgPath);
+
+      // If the squidlets send the fragments over the socket, request 
+      // the fragment to be written at the path of the tga file
+      if (SquadGetFlagSendFile(that) == true)
+        sprintf(buffer + strlen(buffer), ",\"sendFile\":\"%s\"", tga);
+      strcat(buffer, "}");
+
+      // Add the new task to the set of task to execute
+      SquidletTaskRequest* task = SquidletTaskRequestCreate(
+        SquidletTaskType_PovRay, id, taskId, buffer, maxWait);
+      GSetAppend(&set, task);
+
+      // Free memory
+      free(tga);
+    }
+  }
+
+  // Shuffle the task and add them to the set of tasks
+  GSetShuffle(&set);
+  GSetAppendSet((GSet*)SquadTasks(that), &set);
+  
+  // Free memory
+  GSetFlush(&set);
+  free(outImgPath);
+
+}
+
+// Add a neuranet evaluation task uniquely identified by its 'id' to
+// the list of task to execute by the squad 'that'
+// The task will have a maximum of 'maxWait' seconds to complete from 
+// the time it's accepted by the squidlet or it will be considered
+// as failed
+// The evaluation of a NeuraNet stops as soon as it can't beat 
+// 'curBest'. If 'fastReject' is true, the result of the task contains
+// for each NeuraNet the number of samples it has been evaluated on 
+// ("nbSample") and for those whose evaluation has been stopped, an
+// upper bound of their value instead of their value on the evaluated
+// samples
+// If 'nbShard' is greater than 1, the samples of the category are 
+// split into 'nbShard' ranges evaluated as separate tasks (with 
+// subid from 0 to nbShard-1) on different squidlets. The Squad sums 
+// the partial errors of the completed ranges and only the range 
+// completing last is returned by SquadStep, with the result of the 
+// evaluation on the whole category. A NeuraNet whose evaluation has 
+// been stopped in one of the ranges gets the upper bound of its value, 
+// whatever 'fastReject', and the result then contains "nbSample". A 
+// failed range is returned by SquadStep, the evaluation is abandoned 
+// if it's not tried again with SquadTryAgainTask within 'maxWait' 
+// seconds
+void SquadAddTask_EvalNeuraNet(
+         Squad* const that, 
+  const unsigned long id,
+         const time_t maxWait,
+    const char* const datasetPath,
+    const char* const workingDirPath,
+ const VecLong* const nnids,
+          const float curBest,
+           const long cat,
+           const bool fastReject,
+   const unsigned int nbShard) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (workingDirPath == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'workingDirPath' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // The squidlets load the NeuraNets from the working directory
+  char* nnData = PBErrMalloc(TheSquidErr, strlen(workingDirPath) + 20);
+  sprintf(nnData, "\"workingDir\":\"%s\"", workingDirPath);
+
+  // Add the task
+  SquadAddTask_EvalNeuraNetData(that, id, maxWait, datasetPath, nnids,
+    curBest, cat, fastReject, nbShard, nnData);
+
+  // Free memory
+  free(nnData);
+}
+
+// Add a neuranet evaluation task uniquely identified by its 'id' to
+// the list of task to execute by the squad 'that'
+// Same as SquadAddTask_EvalNeuraNet except that the NeuraNets are
+// not read by the squidlets from a working directory but sent inside
+// the task data. The 'nns' are the NeuraNets whose ids are 'nnids'
+// Each NeuraNet is identified by the hash of its definition and only
+// sent to the squidlets which haven't received it yet (up to the last
+// THESQUID_NBNNCACHE NeuraNets)
+void SquadAddTask_EvalNeuraNetInline(
+         Squad* const that, 
+  const unsigned long id,
+         const time_t maxWait,
+    const char* const datasetPath,
+       NeuraNet** const nns,
+ const VecLong* const nnids,
+          const float curBest,
+           const long cat,
+           const bool fastReject,
+   const unsigned int nbShard) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (nns == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'nns' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (nnids == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'nnids' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (VecGetDim(nnids) > THESQUID_NBNNCACHE) {
+    TheSquidErr->_type = PBErrTypeInvalidArg;
+    sprintf(TheSquidErr->_msg, "too many NeuraNets (%ld>%d)", 
+      VecGetDim(nnids), THESQUID_NBNNCACHE);
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Declare variables to build the data about the NeuraNets:
+  // "nnhashes":[...],"nnlens":[...],"nns":{"<hash>":<NeuraNet>,...}
+  // where "nnlens" are the lengths of each "<hash>":<NeuraNet> in
+  // "nns", or 0 if the NeuraNet is a duplicate of a previous one
+  long nbNN = VecGetDim(nnids);
+  char* hashesStr = PBErrMalloc(TheSquidErr, 
+    nbNN * (THESQUID_NNHASHLENGTH + 3) + 1);
+  hashesStr[0] = '\0';
+  char* lensStr = PBErrMalloc(TheSquidErr, nbNN * 23 + 1);
+  lensStr[0] = '\0';
+  char* nnsStr = NULL;
+  size_t sizeNNsStr = 0;
+  FILE* streamNNs = open_memstream(&nnsStr, &sizeNNsStr);
+  char (*hashes)[THESQUID_NNHASHLENGTH + 1] = PBErrMalloc(TheSquidErr, 
+    nbNN * (THESQUID_NNHASHLENGTH + 1));
+
+  // Loop on the NeuraNets
+  for (long iNN = 0; iNN < nbNN; ++iNN) {
+
+    // Get the compact definition of the NeuraNet
+    char* nnStr = NULL;
+    size_t sizeNNStr = 0;
+    FILE* streamNN = open_memstream(&nnStr, &sizeNNStr);
+    bool compact = true;
+    NNSave(nns[iNN], streamNN, compact);
+    fclose(streamNN);
+
+    // Get its hash
+    TheSquidHash(nnStr, hashes[iNN]);
+
+    // Check if it's a duplicate of a previous NeuraNet
+    bool duplicate = false;
+    for (long jNN = 0; jNN < iNN && !duplicate; ++jNN)
+      duplicate = (strcmp(hashes[iNN], hashes[jNN]) == 0);
+
+    // Add the hash and the definition of the NeuraNet
+    sprintf(hashesStr + strlen(hashesStr), "%s\"%s\"", 
+      (iNN > 0 ? "," : ""), hashes[iNN]);
+    // The length excludes the comma separating the definitions
+    int len = 0;
+    if (duplicate == false) {
+      if (ftell(streamNNs) > 0)
+        fprintf(streamNNs, ",");
+      len = fprintf(streamNNs, "\"%s\":%s", hashes[iNN], nnStr);
+    }
+    sprintf(lensStr + strlen(lensStr), "%s\"%d\"", 
+      (iNN > 0 ? "," : ""), len);
+
+    // Free memory
+    free(nnStr);
+  }
+  fclose(streamNNs);
+
+  // Create the data about the NeuraNets
+  char* nnData = PBErrMalloc(TheSquidErr, 
+    strlen(hashesStr) + strlen(lensStr) + strlen(nnsStr) + 50);
+  sprintf(nnData, "\"nnhashes\":[%s],\"nnlens\":[%s],\"nns\":{%s}", 
+    hashesStr, lensStr, nnsStr);
+
+  // Add the task
+  SquadAddTask_EvalNeuraNetData(that, id, maxWait, datasetPath, nnids,
+    curBest, cat, fastReject, nbShard, nnData);
+
+  // Free memory
+  free(nnData);
+  free(hashesStr);
+  free(lensStr);
+  free(nnsStr);
+  free(hashes);
+}
+
+// Add to the squad 'that' the neuranet evaluation task(s) whose data 
+// are made of the properties given as arguments and 'nnData', the 
+// properties describing how to get the NeuraNets. 'nnData' is always
+// placed at the end of the task data
+void SquadAddTask_EvalNeuraNetData(
+         Squad* const that, 
+  const unsigned long id,
+         const time_t maxWait,
+    const char* const datasetPath,
+ const VecLong* const nnids,
+          const float curBest,
+           const long cat,
+           const bool fastReject,
+   const unsigned int nbShard,
+    const char* const nnData) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (nnids == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'nnids' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (nnData == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'nnData' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Encode the ids of the NeuraNets
+  char nnidsStr[THESQUID_MAXPAYLOADSIZE];
+  JSONNode* json = VecEncodeAsJSON(nnids);
+  JSONSaveToStr(json, nnidsStr, THESQUID_MAXPAYLOADSIZE, true);
+  JSONFree(&json);
+
+  // If the evaluation is sharded
+  unsigned long key = that->_nextEvalNNShardsKey;
+  if (nbShard > 1) {
+
+    // Create the structure to merge the partial results of the shards
+    SquadEvalNNShards* shards = PBErrMalloc(TheSquidErr, 
+      sizeof(SquadEvalNNShards));
+    shards->_id = id;
+    shards->_key = key;
+    ++(that->_nextEvalNNShardsKey);
+    shards->_nbShard = nbShard;
+    shards->_nbDone = 0;
+    shards->_done = PBErrMalloc(TheSquidErr, sizeof(bool) * nbShard);
+    shards->_failed = PBErrMalloc(TheSquidErr, sizeof(bool) * nbShard);
+    for (unsigned int iShard = nbShard; iShard--;) {
+      shards->_done[iShard] = false;
+      shards->_failed[iShard] = false;
+    }
+    shards->_expiry = 0;
+    shards->_nnids = VecLongCreate(VecGetDim(nnids));
+    shards->_sumErrs = VecFloatCreate(VecGetDim(nnids));
+    shards->_nbEvals = VecLongCreate(VecGetDim(nnids));
+    for (long iNN = VecGetDim(nnids); iNN--;) {
+      VecSet(shards->_nnids, iNN, VecGet(nnids, iNN));
+      VecSet(shards->_sumErrs, iNN, 0.0);
+      VecSet(shards->_nbEvals, iNN, 0);
+    }
+    shards->_sizeCat = 0;
+    shards->_fastReject = fastReject;
+    shards->_stopped = false;
+    GSetAppend(&(that->_evalNNShards), shards);
+  }
+
+  // Allocate memory for the data of the tasks
+  char* buffer = PBErrMalloc(TheSquidErr, 
+    THESQUID_MAXPAYLOADSIZE + strlen(nnData));
+
+  // Loop on the shards, a non sharded evaluation being one single 
+  // shard
+  for (unsigned int iShard = 0; iShard < MAX(1, nbShard); ++iShard) {
+
+    // Prepare the data as JSON
+    unsigned long subid = iShard;
+    int len = sprintf(buffer, 
+      "{\"id\":\"%lu\",\"subid\":\"%lu\",\"dataset\":\"%s\","
+      "\"nnids\":%s,\"best\":\"%f\",\"cat\":\"%ld\",\"reject\":\"%d\"", 
+      id, subid, datasetPath, nnidsStr, curBest, cat, fastReject);
+    if (nbShard > 1) {
+      len += sprintf(buffer + len, 
+        ",\"shard\":\"%u\",\"nbShard\":\"%u\",\"shardKey\":\"%lu\"", 
+        iShard, nbShard, key);
+    }
+    sprintf(buffer + len, ",%s}", nnData);
+
+    // Create the new task
+    SquidletTaskRequest* task = SquidletTaskRequestCreate(
+      SquidletTaskType_EvalNeuranet, id, subid, buffer, maxWait);
+    
+    // Add the new task to the set of task to execute
+    GSetAppend((GSet*)SquadTasks(that), task);
+  }
+
+  // Free memory
+  free(buffer);
+}
+
+// Send a request from the Squad 'that' to reset the stats of the
+// Squidlet 'squidlet'
+// Return true if the request was successfull, else false
+bool SquadRequestSquidletToResetStats(
+         Squad* const that, 
+  SquidletInfo* const squidlet) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (squidlet == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'squidlet' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+
+    // Prepare the data as JSON
+    char* buffer = "{\"id\":\"0\"}";
+    
+    // Create the task
+    unsigned long id = 0;
+    unsigned long subId = 0;
+    time_t maxWait = 60;
+    SquidletTaskRequest* task = SquidletTaskRequestCreate(
+      SquidletTaskType_ResetStats, id, subId, buffer, maxWait);
+
+    // Request the execution of the task by the squidlet
+    bool ret = SquadSendTaskRequest(that, task, squidlet);
+    if (ret) {
+
+      // If the squidlet accepted to execute the task
+      ret = SquadSendTaskData(that, squidlet, task);
+    }
+
+    // If the squidlet has reset its stats, reset the ones memorized 
+    // by the Squad too
+    if (ret)
+      SquidletInfoStatsInit(&(squidlet->_stats));
+
+    // Free memory
+    free(task);
+    
+    // Return the success of the request
+    return ret;
+}
+  
+// Send a request from the Squad 'that' to reset the stats of all its
+// non-busy Squidlets
+// Return true if all the request were successfull, else false
+bool SquadRequestAllSquidletToResetStats(
+  Squad* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+
+  // Declare a variable to memorize if all the requests were successfull
+  bool flag = true;
+  
+  // If the Squad has non-busy squidlets
+  if (SquadGetNbSquidlets(that) > 0) {
+
+    // Loop on the squidlets
+    GSetIterForward iter = 
+      GSetIterForwardCreateStatic(SquadSquidlets(that));
+    do {
+
+      // Get the current quidlet
+      SquidletInfo* squidlet = GSetIterGet(&iter);
+
+      // Request the reset of the stats of this squidlet
+      // and update the flag with the returned flag
+      flag &= SquadRequestSquidletToResetStats(that, squidlet);
+
+    } while (GSetIterStep(&iter));
+  }
+
+  // Return the flag memorizing if all the requests were successfull
+  return flag;
+}
+
+// Send the data associated to the task request 'task' from the Squad 
+// 'that' to the Squidlet 'squidlet'
+// First, send the size in byte of the data, then send the data
+// Return true if the data could be sent, false else
+// The size of the data must be less than THESQUID_MAXPAYLOADSIZE bytes
+bool SquadSendTaskData(
+                Squad* const that, 
+         SquidletInfo* const squidlet, 
+  SquidletTaskRequest* const task) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (squidlet == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'squidlet' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (task == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'task' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+
+  // Get the data to be sent, without the inlined NeuraNets already 
+  // known by the squidlet
+  GSet sentHashes = GSetCreateStatic();
+  GSet taskHashes = GSetCreateStatic();
+  char* dataForSquidlet = SquadGetTaskDataForSquidlet(task, squidlet, 
+    &sentHashes, &taskHashes);
+  const char* data = 
+    (dataForSquidlet != NULL ? dataForSquidlet : task->_data);
+
+  // Send the task data size
+  int flags = 0;
+  size_t len = strlen(data);
+  int ret = send(squidlet->_sock, (char*)&len, sizeof(size_t), flags);
+  
+  // If we couldn't send the data size
+  if (ret == -1) {
+
+    // Update history
+    SquadPushHistory(that, "couldn't send task data size %d", len);
+
+    // Free memory
+    while (GSetNbElem(&sentHashes) > 0) {
+      char* hash = GSetPop(&sentHashes);
+      free(hash);
+    }
+    while (GSetNbElem(&taskHashes) > 0) {
+      char* hash = GSetPop(&taskHashes);
+      free(hash);
+    }
+    if (dataForSquidlet != NULL)
+      free(dataForSquidlet);
+
+    return false;
+
+  // Else, we could send the data size
+  } else {
+
+    // Update history
+    SquadPushHistory(that, "sent task data size %d to squidlet:", len);
+    SquadPushHistorySquidletInfo(that, squidlet);
+
+  }
+
+  // Memorize the start time for the statistics
+  struct timeval start;
+  gettimeofday(&start, NULL);
+
+  // Send the task data, the data may be larger than what the socket
+  // accepts in one call when NeuraNets are inlined
+  time_t maxWait = THESQUID_WAITDATARECEPT_TIMEOUT + 
+    (time_t)round((float)len / 100.0);
+  bool retSend = SocketSend(squidlet->_sock, len, data, maxWait);
+
+  // If we couldn't send the data
+  if (retSend == false) {
+
+    // Update history
+    SquadPushHistory(that, "couldn't send task data");
+
+  // Else, we could send the data
+  } else {
+
+    // Get the time to send the data
+    struct timeval stop;
+    gettimeofday(&stop, NULL);
+    task->_timePhases[SquidletTaskPhase_DataSent] = stop;
+    float deltams = (float)(stop.tv_sec - start.tv_sec) * 1000.0 + 
+      (float)(stop.tv_usec - start.tv_usec) / 1000.0;
+
+    // Update the stats about transfer time
+    SquidletInfoStats* stats = 
+      (SquidletInfoStats*)SquidletInfoStatistics(squidlet);
+    SquidletInfoStatsUpdateTimeTransfer(stats, deltams, len);
+    stats->_nbByteSent += len;
+
+  }
+
+  // Loop on the inlined NeuraNets sent to the squidlet
+  while (GSetNbElem(&sentHashes) > 0) {
+    char* hash = GSetPop(&sentHashes);
+
+    // If the data have been sent, the squidlet adds the NeuraNet to 
+    // its cache, memorize it in the same way
+    if (retSend == true)
+      SquidletInfoAddNeuraNet(squidlet, hash, &taskHashes);
+    free(hash);
+  }
+  while (GSetNbElem(&taskHashes) > 0) {
+    char* hash = GSetPop(&taskHashes);
+    free(hash);
+  }
+
+  // Free memory
+  if (dataForSquidlet != NULL)
+    free(dataForSquidlet);
+
+  // Return the success code
+  return retSend;
+}
+
+// Return the data of the task 'task' to be sent to the squidlet 
+// 'squidlet', i.e. the task data without the inlined NeuraNets the 
+// squidlet already knows. The hashes of the NeuraNets kept in the 
+// data are added to 'sentHashes', and the ones of all the NeuraNets 
+// of the task to 'taskHashes' 
+// Return null if the data of the task doesn't contain inlined 
+// NeuraNets, in which case they are sent as is
+char* SquadGetTaskDataForSquidlet(
+  const SquidletTaskRequest* const task, 
+         const SquidletInfo* const squidlet, 
+                        GSet* const sentHashes, 
+                        GSet* const taskHashes) {
+#if BUILDMODE == 0
+  if (task == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'task' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (squidlet == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'squidlet' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (sentHashes == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'sentHashes' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (taskHashes == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'taskHashes' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+
+  // If the task is not a NeuraNet evaluation, or its NeuraNets are not
+  // inlined (they are always at the end of the data)
+  if (task->_type != SquidletTaskType_EvalNeuranet)
+    return NULL;
+  const char* nnsStart = strstr(task->_data, ",\"nns\":{");
+  if (nnsStart == NULL)
+    return NULL;
+
+  // Decode the hashes and lengths of the inlined NeuraNets from the 
+  // part of the data preceding the NeuraNets
+  size_t lenHeader = nnsStart - task->_data;
+  char* header = PBErrMalloc(TheSquidErr, lenHeader + 2);
+  memcpy(header, task->_data, lenHeader);
+  header[lenHeader] = '}';
+  header[lenHeader + 1] = '\0';
+  JSONNode* json = JSONCreate();
+  bool ret = JSONLoadFromStr(json, header);
+  free(header);
+  JSONNode* propHashes = NULL;
+  JSONNode* propLens = NULL;
+  if (ret == true) {
+    propHashes = JSONProperty(json, "nnhashes");
+    propLens = JSONProperty(json, "nnlens");
+  }
+
+  // If the data are invalid, send them as is
+  if (propHashes == NULL || propLens == NULL ||
+    JSONGetNbValue(propHashes) != JSONGetNbValue(propLens)) {
+    JSONFree(&json);
+    return NULL;
+  }
+
+  // Allocate memory for the data, which can't be longer than the
+  // original one, and copy the part preceding the NeuraNets
+  char* data = PBErrMalloc(TheSquidErr, strlen(task->_data) + 1);
+  memcpy(data, task->_data, lenHeader);
+  char* ptrData = data + lenHeader;
+
+  // Declare a pointer to the definition of the current NeuraNet
+  const char* nnsData = nnsStart + strlen(",\"nns\":{");
+  const char* ptrNN = nnsData;
+
+  // Loop on the NeuraNets
+  long nbNN = JSONGetNbValue(propHashes);
+  for (long iNN = 0; iNN < nbNN; ++iNN) {
+
+    // Get the hash and the length of the definition of the NeuraNet
+    const char* hash = JSONLblVal(JSONValue(propHashes, iNN));
+    long len = atol(JSONLblVal(JSONValue(propLens, iNN)));
+
+    // If the definition is not a duplicate
+    if (len > 0) {
+
+      // Skip the comma separating the definitions
+      if (ptrNN != nnsData)
+        ++ptrNN;
+      GSetAppend(taskHashes, strdup(hash));
+
+      // Check if the squidlet already knows the NeuraNet
+      bool known = false;
+      for (int iHash = THESQUID_NBNNCACHE; iHash-- && !known;)
+        known = (strcmp(squidlet->_nnHashes[iHash], hash) == 0);
+
+      // If the squidlet doesn't know it, keep its definition
+      if (known == false) {
+        ptrData += sprintf(ptrData, "%s", 
+          (GSetNbElem(sentHashes) == 0 ? ",\"nns\":{" : ","));
+        memcpy(ptrData, ptrNN, len);
+        ptrData += len;
+        GSetAppend(sentHashes, strdup(hash));
+      }
+
+      // Move to the next definition
+      ptrNN += len;
+    }
+  }
+
+  // Close the data
+  if (GSetNbElem(sentHashes) > 0)
+    *(ptrData++) = '}';
+  *(ptrData++) = '}';
+  *ptrData = '\0';
+
+  // Free memory
+  JSONFree(&json);
+
+  // Return the data
+  return data;
+}
+
+// Update the statistics about the transfer time from the Squad to the
+// squidlet of the SquidletInfoStats 'that' given that it took 'deltams'
+// millisecond to send 'len' bytes of data
+void SquidletInfoStatsUpdateTimeTransfer(
+  SquidletInfoStats* const that,
+               const float deltams,
+              const size_t len) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // If there was no data there is nothing to do
+  if (len == 0)
+    return;
+
+  // Add the delay per kilobyte to the histogram
+  float deltaUsPerKB = deltams * 1000.0 * 1024.0 / (float)len;
+  TheSquidHistoAdd(&(that->_timeTransferSquadSquidUsPerKB), deltaUsPerKB);
+}
+  
+// Try to receive the result from the running task 'runningTask'
+// If the result is ready it is stored in the _bufferResult of the 
+// SquidletTaskRequest of the 'runningTask'
+// If the size of the result data is not ready and couldn't be received 
+// give up immediately
+// If the size of the result data has been received, wait for 
+// (5 + sizeData / 100) seconds maximum to receive the data
+// First receive the size of the result data, then send an 
+// acknowledgement signal to the squidlet for the size of data,
+// then receive the data, and finally send an acknowledgement to the 
+// squidlet for the data
+// Return true if it could receive the result data, false else
+bool SquadReceiveTaskResult(
+             Squad* const that, 
+  SquadRunningTask* const runningTask) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (runningTask == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'runningTask' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Declare a variable to memorize if we have received the result
+  bool receivedFlag = false;
+
+  // Declare a variable to memorize the size in byte of the result data
+  size_t sizeResultData = 0;
+
+  // Shortcuts
+  SquidletInfo* squidlet = runningTask->_squidlet;
+  SquidletTaskRequest* task = runningTask->_request;
+  
+  // Make sure the buffer to receive the task is empty
+  if (task->_bufferResult != NULL) {
+    free(task->_bufferResult);
+    task->_bufferResult = NULL;
+  }
+  
+  // Try to receive the size of the reply from the squidlet
+  // and give up immediately
+  if (SocketRecv(&(squidlet->_sock), sizeof(size_t), 
+    (char*)&sizeResultData, 0)) {
+
+    // If we could get the size it means the result is ready
+    if (sizeResultData > 0) {
+      gettimeofday(task->_timePhases + SquidletTaskPhase_ResultSize, 
+        NULL);
+
+      // Update history
+      SquadPushHistory(that, 
+        "received the size of result from squidlet:");
+      SquadPushHistorySquidletInfo(that, squidlet);
+
+      // Send the acknowledgement of received size of result
+      char ack = 1;
+      int flags = 0;
+      (void)send(squidlet->_sock, &ack, sizeof(char), flags);
+
+      // Update history
+      SquadPushHistory(that, 
+        "send ack of received size of result data to squidlet:");
+      SquadPushHistorySquidletInfo(that, squidlet);
+
+      // Allocate memory for the result data
+      task->_bufferResult = PBErrMalloc(TheSquidErr, sizeResultData + 1);
+      memset(task->_bufferResult, 0, sizeResultData + 1);
+      
+      // Wait to receive the result data with a time limit proportional
+      // to the size of result data
+      int timeOut = 5 + (int)round((float)sizeResultData / 100.0);
+
+      // If we coudln't received the result data
+      if (!SocketRecv(&(squidlet->_sock), sizeResultData, 
+        task->_bufferResult, timeOut)) {
+
+        // Free the memory allocated to the result buffer
+        free(task->_bufferResult);
+        task->_bufferResult = NULL;
+
+        // Update history
+        SquadPushHistory(that, 
+          "couldn't received result data from squidlet:");
+        SquadPushHistorySquidletInfo(that, squidlet);
+        SquadPushHistory(that,"waited for %ds", timeOut);
+
+      // Else, if we couldn't receive the file attached to the result
+      } else if (SquadReceiveResultFile(that, squidlet, task) == false) {
+
+        // Free the memory allocated to the result buffer
+        free(task->_bufferResult);
+        task->_bufferResult = NULL;
+
+      } else {
+
+        // Set the flag to memorized we have received the result
+        receivedFlag = true;
+        squidlet->_stats._nbByteReceived += sizeResultData;
+        
+        // Send the acknowledgement of received result
+        (void)send(squidlet->_sock, &ack, 1, flags);
+        gettimeofday(task->_timePhases + SquidletTaskPhase_Completed, 
+          NULL);
+        
+        // Update history
+        SquadPushHistory(that, "received result data from squidlet:");
+        SquadPushHistorySquidletInfo(that, squidlet);
+        SquadPushHistory(that,"size result data %d", sizeResultData);
+
+      }
+
+    // Else, we couldn't get the size, it means the result is not
+    // ready yet
+    } else {
+
+      // Update history
+      SquadPushHistory(that, 
+        "received a null size of result from squidlet:");
+      SquadPushHistorySquidletInfo(that, squidlet);
+
+    }
+  }
+  
+  // Return the flag memorizing if we have received the result
+  return receivedFlag;
+}
+
+// Receive the file attached to the result of the task 'task' from the 
+// squidlet 'squidlet' of the Squad 'that', if any 
+// The file is written at the path given by the property "sendFile" of 
+// the data of the task, its size is given by the property "fileSize" 
+// of the result 
+// Return true if there was no file or it could be received, else false
+bool SquadReceiveResultFile(
+                Squad* const that, 
+         SquidletInfo* const squidlet, 
+  SquidletTaskRequest* const task) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (squidlet == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'squidlet' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (task == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'task' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Only the POV-Ray fragments can have a file attached, skip quickly 
+  // the results without one before decoding the JSON
+  if (task->_type != SquidletTaskType_PovRay || 
+    strstr(task->_data, "\"sendFile\":") == NULL || 
+    strstr(task->_bufferResult, "\"fileSize\":") == NULL)
+    return true;
+
+  // Decode the JSON data from the request and the result
+  JSONNode* jsonRequest = JSONCreate();
+  JSONNode* jsonResult = JSONCreate();
+  bool ret = JSONLoadFromStr(jsonRequest, task->_data);
+  ret &= JSONLoadFromStr(jsonResult, task->_bufferResult);
+  if (ret == true) {
+
+    // The path comes from the request, the squidlet only gives the size
+    JSONNode* propPath = JSONProperty(jsonRequest, "sendFile");
+    JSONNode* propSize = JSONProperty(jsonResult, "fileSize");
+    if (propPath != NULL && propSize != NULL) {
+
+      // Receive the file with a time limit proportional to its size
+      size_t size = strtoul(JSONLblVal(propSize), NULL, 10);
+      int timeOut = 5 + (int)(size / THESQUID_SPLICE_CHUNK);
+      ret = TheSquidSpliceToFile(squidlet->_sock, JSONLblVal(propPath), 
+        size, timeOut);
+
+      // Update history and stats
+      if (ret == true) {
+        squidlet->_stats._nbByteReceived += size;
+        SquadPushHistory(that, "received result file from squidlet:");
+        SquadPushHistorySquidletInfo(that, squidlet);
+        SquadPushHistory(that,"size result file %lu", 
+          (unsigned long)size);
+      } else {
+        SquadPushHistory(that, 
+          "couldn't receive result file from squidlet:");
+        SquadPushHistorySquidletInfo(that, squidlet);
+        SquadPushHistory(that,"waited for %ds", timeOut);
+      }
+    }
+  }
+
+  // Free memory
+  JSONFree(&jsonRequest);
+  JSONFree(&jsonResult);
+
+  // Return the flag memorizing if we have received the file
+  return ret;
+}
+
+// Request the execution of a task on a squidlet for the squad 'that'
+// Return true if the request was successfull, false else
+bool SquadSendTaskOnSquidlet(
+                Squad* const that, 
+         SquidletInfo* const squidlet, 
+  SquidletTaskRequest* const task) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (squidlet == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'squidlet' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (task == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'task' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+
+  // Request the execution of the task by the squidlet
+  bool ret = SquadSendTaskRequest(that, task, squidlet);
+
+  // If the request was successfull
+  if (ret == true) {
+
+    // Send the task's data to the squidlet
+    SquadRunningTask* runningTask = 
+      SquadRunningTaskCreate(task, squidlet);
+    ret = SquadStartRunningTask(that, runningTask);
+
+    // If we could send the task's data, add the running task to the 
+    // set of running tasks
+    if (ret == true) {
+      GSetAppend((GSet*)SquadRunningTasks(that), runningTask);
+    } else {
+      SquadRunningTaskFree(&runningTask);
+    }
+  
+  // Else, the request of execution wasn't successfull
+  } else {
+    SquadRefusedTask(that, squidlet, task);
+  }
+
+  // Return the result
+  return ret;
+}
+
+// Send the data of the task accepted by the squidlet of the 
+// 'runningTask' of the Squad 'that', and put it in the running state 
+// Return true if the data could be sent, false else
+bool SquadStartRunningTask(
+             Squad* const that, 
+  SquadRunningTask* const runningTask) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (runningTask == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'runningTask' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Shortcuts
+  SquidletInfo* squidlet = runningTask->_squidlet;
+  SquidletTaskRequest* task = runningTask->_request;
+
+  // Send the task's data to the squidlet
+  bool ret = SquadSendTaskData(that, squidlet, task);
+
+  // If we could send the task's data
+  if (ret == true) {
+
+    // The squidlet is healthy
+    SquidletInfoReportSuccess(squidlet);
+
+    // The task is running, its time limit starts now
+    runningTask->_state = SquadRunningTaskState_Running;
+    runningTask->_startTime = time(NULL);
+    SquadLogEvent(that, TheSquidEventType_SendTask, task, squidlet, 
+      strlen(task->_data));
+
+    // Update history
+    SquadPushHistory(that, "created running task:");
+    SquadPushHistorySquadRunningTask(that, runningTask);
+
+  // Else, we couldn't send the task data
+  } else {
+
+    SquadLogEvent(that, TheSquidEventType_SendDataFailed, task, 
+      squidlet, 0);
+    SquidletInfoReportFailure(squidlet);
+
+    // Update history
+    SquadPushHistory(that, "couldn't send data to squidlet:");
+    SquadPushHistorySquidletInfo(that, squidlet);
+
+  }
+
+  // Return the result
+  return ret;
+}
+
+// Update the history, the event log and the circuit breaker of the 
+// Squad 'that' when the squidlet 'squidlet' has refused the task 
+// 'task' or couldn't be reached
+void SquadRefusedTask(
+                      Squad* const that, 
+               SquidletInfo* const squidlet, 
+  const SquidletTaskRequest* const task) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (squidlet == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'squidlet' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (task == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'task' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  SquadLogEvent(that, TheSquidEventType_TaskRefused, task, squidlet, 
+    0);
+
+  // Update the circuit breaker of the squidlet, to stop sending it 
+  // tasks if it's down
+  SquidletInfoReportFailure(squidlet);
+
+  // Update history
+  SquadPushHistory(that, "task refused by squidlet:");
+  SquadPushHistorySquidletInfo(that, squidlet);
+}
+
+// Start the request of the task 'task' on the squidlet 'squidlet' for 
+// the Squad 'that' without waiting for the reply of the squidlet 
+// The request is added to the running tasks and completed by 
+// SquadStepDispatch() 
+// Return true if the request has been started, in which case the 
+// squidlet must be removed from the available squidlets, false else
+bool SquadDispatchTask(
+                Squad* const that, 
+         SquidletInfo* const squidlet, 
+  SquidletTaskRequest* const task) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (squidlet == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'squidlet' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (task == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'task' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // The null task doesn't need a connection to the squidlet
+  if (task->_type == SquidletTaskType_Null)
+    return SquadSendTaskOnSquidlet(that, squidlet, task);
+
+  // Start the connection to the squidlet
+  bool ret = SquadConnectSquidlet(that, task, squidlet);
+
+  // If the connection has started, add the request to the running 
+  // tasks to wait for the connection
+  if (ret == true) {
+    SquadRunningTask* runningTask = 
+      SquadRunningTaskCreate(task, squidlet);
+    runningTask->_state = SquadRunningTaskState_Connecting;
+    GSetAppend((GSet*)SquadRunningTasks(that), runningTask);
+
+    // Update history
+    SquadPushHistory(that, "connecting to squidlet:");
+    SquadPushHistorySquidletInfo(that, squidlet);
+
+  // Else, the squidlet can't be reached
+  } else {
+    SquadRefusedTask(that, squidlet, task);
+  }
+
+  // Return the result
+  return ret;
+}
+
+// Advance the requests of the Squad 'that' started by 
+// SquadDispatchTask(), waiting up to 'maxWait' milliseconds for the 
+// connections to the squidlets and their replies 
+// The refused requests are removed from the running tasks, their 
+// squidlet is put back in the available squidlets and their task in 
+// the set of tasks
+void SquadStepDispatch(
+     Squad* const that, 
+  const int maxWait) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Memorize the start of the dispatch
+  struct timeval start;
+  gettimeofday(&start, NULL);
+
+  // Loop until there is no more pending request or the time limit is 
+  // reached
+  bool flagPending = true;
+  while (flagPending == true) {
+
+    // Count the pending requests
+    int nbPending = 0;
+    if (SquadGetNbRunningTasks(that) > 0L) {
+      GSetIterForward iter = 
+        GSetIterForwardCreateStatic((GSet*)SquadRunningTasks(that));
+      do {
+        SquadRunningTask* runningTask = GSetIterGet(&iter);
+        if (runningTask->_state != SquadRunningTaskState_Running)
+          ++nbPending;
+      } while (GSetIterStep(&iter));
+    }
+
+    // If there is no pending request, stop here
+    if (nbPending == 0)
+      break;
+
+    // Wait for an event on the sockets of the pending requests: the 
+    // connection is established or the squidlet has replied
+    struct pollfd* fds = PBErrMalloc(TheSquidErr, 
+      sizeof(struct pollfd) * nbPending);
+    int iPending = 0;
+    GSetIterForward iter = 
+      GSetIterForwardCreateStatic((GSet*)SquadRunningTasks(that));
+    do {
+      SquadRunningTask* runningTask = GSetIterGet(&iter);
+      if (runningTask->_state != SquadRunningTaskState_Running) {
+        fds[iPending].fd = runningTask->_squidlet->_sock;
+        fds[iPending].events = 
+          (runningTask->_state == SquadRunningTaskState_Connecting ? 
+          POLLOUT : POLLIN);
+        fds[iPending].revents = 0;
+        ++iPending;
+      }
+    } while (GSetIterStep(&iter));
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    int elapsed = (int)((now.tv_sec - start.tv_sec) * 1000 + 
+      (now.tv_usec - start.tv_usec) / 1000);
+    int timeout = MAX(0, maxWait - elapsed);
+    int retPoll = poll(fds, nbPending, timeout);
+
+    // Stop after this loop if the time limit is reached
+    flagPending = (retPoll > 0 || (retPoll == -1 && errno == EINTR));
+
+    // Declare a flag to manage the removing of tasks during the loop
+    bool flag = false;
+
+    // Loop on the pending requests
+    iPending = 0;
+    time_t nowSec = time(NULL);
+    iter = GSetIterForwardCreateStatic((GSet*)SquadRunningTasks(that));
+    do {
+
+      // Reinit the flag to manage the removing of tasks during the loop
+      flag = false;
+
+      // Get the request, skip it if it's already running
+      SquadRunningTask* runningTask = GSetIterGet(&iter);
+      if (runningTask->_state == SquadRunningTaskState_Running)
+        continue;
+
+      // If the socket of the request has an event or the request has 
+      // timed out
+      bool ready = (retPoll > 0 && fds[iPending].revents != 0);
+      ++iPending;
+      if (ready == true || 
+        nowSec - runningTask->_startTime > SQUAD_REQUESTTIMEOUT) {
+
+        // Advance the request
+        bool ret = SquadAdvanceTaskRequest(that, runningTask, ready);
+
+        // If the request has failed
+        if (ret == false) {
+
+          // Put back the squidlet in the set of squidlets
+          GSetAppend((GSet*)SquadSquidlets(that), 
+            runningTask->_squidlet);
+
+          // Put back the task in the set of tasks, except the stats 
+          // heartbeat which will be sent again at the next period, and 
+          // the batch which is replaced by its tasks
+          if (runningTask->_request->_type == SquidletTaskType_Stats) {
+            SquidletTaskRequestFree(&(runningTask->_request));
+          } else if (runningTask->_request->_type == 
+            SquidletTaskType_Batch) {
+            SquadUnbatchTask(that, runningTask->_request);
+            SquidletTaskRequestFree(&(runningTask->_request));
+          } else {
+            GSetPush((GSet*)SquadTasks(that), runningTask->_request);
+          }
+
+          // Remove the request from the running tasks
+          flag = GSetIterRemoveElem(&iter);
+
+          // Free memory
+          SquadRunningTaskFree(&runningTask);
+        }
+      }
+    } while (flag || GSetIterStep(&iter));
+
+    // Free memory
+    free(fds);
+  }
+}
+
+// Advance the request 'runningTask' of the Squad 'that', 'ready' is 
+// true if its socket has an event, false if it has timed out 
+// Return true if the request is still in progress or has been 
+// accepted, false if it has failed
+bool SquadAdvanceTaskRequest(
+             Squad* const that, 
+  SquadRunningTask* const runningTask, 
+         const bool ready) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (runningTask == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'runningTask' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Shortcuts
+  SquidletInfo* squidlet = runningTask->_squidlet;
+  SquidletTaskRequest* task = runningTask->_request;
+
+  // If the squidlet hasn't answered in time
+  if (ready == false) {
+
+    // Close the socket
+    close(squidlet->_sock);
+    squidlet->_sock = -1;
+
+    // Update history
+    SquadPushHistory(that, "request timed out on squidlet:");
+    SquadPushHistorySquidletInfo(that, squidlet);
+
+  // Else, if the connection is established, send the request
+  } else if (runningTask->_state == SquadRunningTaskState_Connecting) {
+
+    // If the request could be sent, wait for the reply
+    if (SquadSendTaskType(that, task, squidlet) == true) {
+      runningTask->_state = SquadRunningTaskState_Requested;
+      runningTask->_startTime = time(NULL);
+      return true;
+    }
+
+  // Else, the squidlet has replied to the request
+  } else {
+
+    // If the squidlet has accepted the task, send its data, which 
+    // updates the circuit breaker in case of failure
+    if (SquadRecvTaskReply(that, task, squidlet, 0) == true)
+      return SquadStartRunningTask(that, runningTask);
+
+  }
+
+  // The request has failed
+  SquadRefusedTask(that, squidlet, task);
+  return false;
+}
+
+// Pop the first task of the Squad 'that' which can be sent to a 
+// squidlet in the thermal state 'thermalState', or return null if 
+// there is none. The heavy tasks of plugins are not sent to the warm 
+// squidlets, they are left in place for a cool one while the following 
+// tasks are dispatched
+SquidletTaskRequest* SquadPopTaskForThermalState(
+                 Squad* const that, 
+  const SquidletThermalState thermalState) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // If there is no task, there is nothing to pop
+  if (SquadGetNbRemainingTasks(that) == 0L)
+    return NULL;
+
+  // Loop on the tasks in their order
+  GSetIterForward iter = 
+    GSetIterForwardCreateStatic((GSet*)SquadTasks(that));
+  do {
+
+    // Get the task
+    SquidletTaskRequest* task = GSetIterGet(&iter);
+
+    // If the task is not a heavy task of a plugin, or the squidlet is 
+    // not warm, remove it from the tasks and return it
+    const TheSquidTaskPlugin* plugin = 
+      TheSquidGetTaskPlugin(task->_type);
+    if (thermalState != SquidletThermalState_Warm || 
+      plugin == NULL || plugin->_cost._heavy == false) {
+      GSetIterRemoveElem(&iter);
+      return task;
+    }
+
+  } while (GSetIterStep(&iter));
+
+  // There is no task for this squidlet
+  return NULL;
+}
+
+// If the squidlet 'squidlet' of the Squad 'that' is a relay, pop the 
+// tasks following 'task' in the set of tasks of 'that', up to the 
+// capacity of the squidlet, and return a batch task grouping them 
+// with 'task', else return 'task'
+SquidletTaskRequest* SquadBatchTasks(
+                Squad* const that, 
+  SquidletTaskRequest* const task, 
+   const SquidletInfo* const squidlet) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (task == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'task' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (squidlet == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'squidlet' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // If the squidlet is not a relay or the task can't be batched
+  if (squidlet->_capacity <= 1 || 
+    SquadIsBatchable(task) == false)
+    return task;
+
+  // Create the batch with the task
+  SquadBatch* batch = PBErrMalloc(TheSquidErr, sizeof(SquadBatch));
+  batch->_tasks = PBErrMalloc(TheSquidErr, 
+    sizeof(SquidletTaskRequest*) * squidlet->_capacity);
+  batch->_tasks[0] = task;
+  batch->_nbTask = 1;
+
+  // Add the following tasks up to the capacity of the squidlet, stop 
+  // at the first one which can't be batched to keep the order of the 
+  // tasks
+  while (batch->_nbTask < squidlet->_capacity && 
+    SquadGetNbRemainingTasks(that) > 0L) {
+    SquidletTaskRequest* next = GSetPop((GSet*)SquadTasks(that));
+    if (SquadIsBatchable(next) == false) {
+      GSetPush((GSet*)SquadTasks(that), next);
+      break;
+    }
+    batch->_tasks[batch->_nbTask] = next;
+    ++(batch->_nbTask);
+  }
+
+  // If there is only one task, no need for a batch
+  if (batch->_nbTask == 1) {
+    SquadBatchFree(&batch);
+    return task;
+  }
+
+  // Encode the batch: the types, ids, sub ids, time limits and length 
+  // of the data of the tasks, followed by their data as is
+  char* data = NULL;
+  size_t lenData = 0;
+  FILE* stream = open_memstream(&data, &lenData);
+  if (stream == NULL) {
+    for (unsigned long iTask = batch->_nbTask; iTask-- > 1;)
+      GSetPush((GSet*)SquadTasks(that), batch->_tasks[iTask]);
+    SquadBatchFree(&batch);
+    return task;
+  }
+  time_t maxWait = 0;
+  fprintf(stream, "{\"types\":[");
+  for (unsigned long iTask = 0; iTask < batch->_nbTask; ++iTask) {
+    fprintf(stream, "%s\"%d\"", (iTask > 0 ? "," : ""), 
+      batch->_tasks[iTask]->_type);
+  }
+  fprintf(stream, "],\"ids\":[");
+  for (unsigned long iTask = 0; iTask < batch->_nbTask; ++iTask) {
+    fprintf(stream, "%s\"%lu\"", (iTask > 0 ? "," : ""), 
+      batch->_tasks[iTask]->_id);
+  }
+  fprintf(stream, "],\"subIds\":[");
+  for (unsigned long iTask = 0; iTask < batch->_nbTask; ++iTask) {
+    fprintf(stream, "%s\"%lu\"", (iTask > 0 ? "," : ""), 
+      batch->_tasks[iTask]->_subId);
+  }
+  fprintf(stream, "],\"maxWaits\":[");
+  for (unsigned long iTask = 0; iTask < batch->_nbTask; ++iTask) {
+    fprintf(stream, "%s\"%ld\"", (iTask > 0 ? "," : ""), 
+      (long)(batch->_tasks[iTask]->_maxWaitTime));
+    maxWait = MAX(maxWait, batch->_tasks[iTask]->_maxWaitTime);
+  }
+  fprintf(stream, "],\"lens\":[");
+  for (unsigned long iTask = 0; iTask < batch->_nbTask; ++iTask) {
+    fprintf(stream, "%s\"%lu\"", (iTask > 0 ? "," : ""), 
+      (unsigned long)strlen(batch->_tasks[iTask]->_data));
+  }
+  fprintf(stream, "],\"data\":[");
+  for (unsigned long iTask = 0; iTask < batch->_nbTask; ++iTask) {
+    fprintf(stream, "%s%s", (iTask > 0 ? "," : ""), 
+      batch->_tasks[iTask]->_data);
+  }
+  fprintf(stream, "]}");
+  fclose(stream);
+
+  // Create the batch task, the relay needs time to dispatch the tasks 
+  // to its squidlets and to return their results in addition to the 
+  // time limit of the tasks
+  batch->_id = that->_nextBatchId;
+  ++(that->_nextBatchId);
+  unsigned long subId = 0;
+  SquidletTaskRequest* batchTask = SquidletTaskRequestCreate(
+    SquidletTaskType_Batch, batch->_id, subId, data, 
+    maxWait + 2 * SQUAD_REQUESTTIMEOUT);
+  free(data);
+
+  // Memorize the batch
+  GSetAppend(&(that->_batches), batch);
+
+  // Return the batch task
+  return batchTask;
+}
+
+// Return true if the task 'task' can be grouped in a batch sent to a 
+// relay, else false
+bool SquadIsBatchable(
+  const SquidletTaskRequest* const task) {
+#if BUILDMODE == 0
+  if (task == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'task' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  SquidletTaskType type = task->_type;
+
+  // The stats are specific to each squidlet, they can't be batched, 
+  // and the batches are not batched again
+  if (type == SquidletTaskType_Null || 
+    type == SquidletTaskType_ResetStats || 
+    type == SquidletTaskType_Stats || 
+    type == SquidletTaskType_Batch)
+    return false;
+
+  // The relays don't forward the files attached to the results, the 
+  // task data is checked rather than the flag of the Squad as the 
+  // Squad of a shard doesn't create the tasks it executes
+  if (type == SquidletTaskType_PovRay && task->_data != NULL && 
+    strstr(task->_data, "\"sendFile\":") != NULL)
+    return false;
+
+  // The tasks of a plugin are batched only if it allows it
+  const TheSquidTaskPlugin* plugin = TheSquidGetTaskPlugin(type);
+  if (plugin != NULL)
+    return plugin->_cost._batchable;
+
+  // Other tasks can be batched
+  return true;
+}
+
+// Remove from the Squad 'that' the batch whose id is 'id' and return 
+// it, or return null if there is none
+SquadBatch* SquadPopBatch(
+               Squad* const that, 
+  const unsigned long id) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Search the batch
+  SquadBatch* batch = NULL;
+  if (GSetNbElem(&(that->_batches)) > 0) {
+    GSetIterForward iter = 
+      GSetIterForwardCreateStatic(&(that->_batches));
+    do {
+      SquadBatch* candidate = GSetIterGet(&iter);
+      if (candidate->_id == id) {
+        batch = candidate;
+        GSetIterRemoveElem(&iter);
+      }
+    } while (batch == NULL && GSetIterStep(&iter));
+  }
+
+  // Return the batch
+  return batch;
+}
+
+// Free the memory used by the SquadBatch 'that', but not its tasks
+void SquadBatchFree(
+  SquadBatch** that) {
+  // If the pointer is null there is nothing to do
+  if (that == NULL || *that == NULL)
+    return;
+
+  // Free memory
+  free((*that)->_tasks);
+  free(*that);
+  *that = NULL;
+}
+
+// Put back in the set of tasks of the Squad 'that' the tasks of the 
+// batch task 'batch' which couldn't be executed 
+// 'batch' itself is not freed
+void SquadUnbatchTask(
+                      Squad* const that, 
+  const SquidletTaskRequest* const batch) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (batch == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'batch' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Get the batch
+  SquadBatch* batchTasks = SquadPopBatch(that, batch->_id);
+
+  // Put back its tasks at the head of the set of tasks, in their 
+  // original order
+  if (batchTasks != NULL) {
+    for (unsigned long iTask = batchTasks->_nbTask; iTask--;)
+      GSetPush((GSet*)SquadTasks(that), batchTasks->_tasks[iTask]);
+    SquadBatchFree(&batchTasks);
+  }
+}
+
+// Post process the tasks of the completed batch task 'runningTask' of 
+// the Squad 'that' with their results, the ones to be returned are 
+// added to 'completedTasks' and the ones without result are put back 
+// in the set of tasks
+void SquadProcessCompletedBatch(
+                Squad* const that, 
+     SquadRunningTask* const runningTask, 
+  GSetSquadRunningTask* const completedTasks) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (runningTask == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'runningTask' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (completedTasks == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'completedTasks' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Get the batch
+  SquidletTaskRequest* batchTask = runningTask->_request;
+  SquidletInfo* squidlet = runningTask->_squidlet;
+  SquadBatch* batch = SquadPopBatch(that, batchTask->_id);
+  if (batch == NULL)
+    return;
+
+  // Decode the header of the result, preceding the results of the 
+  // tasks
+  const char* result = batchTask->_bufferResult;
+  const char* resultsStart = 
+    (result != NULL ? strstr(result, ",\"results\":[") : NULL);
+  JSONNode* json = JSONCreate();
+  JSONNode* propLens = NULL;
+  JSONNode* propCapacity = NULL;
+  if (resultsStart != NULL) {
+    size_t lenHeader = resultsStart - result;
+    char* header = PBErrMalloc(TheSquidErr, lenHeader + 2);
+    memcpy(header, result, lenHeader);
+    header[lenHeader] = '}';
+    header[lenHeader + 1] = '\0';
+    if (JSONLoadFromStr(json, header) == true) {
+      propLens = JSONProperty(json, "lens");
+      propCapacity = JSONProperty(json, "capacity");
+    }
+    free(header);
+  }
+
+  // Update the capacity of the relay, if the squidlet is not a relay 
+  // anymore, it won't receive batches
+  if (propCapacity != NULL) {
+    squidlet->_capacity = MAX(1, atol(JSONLblVal(propCapacity)));
+  } else {
+    squidlet->_capacity = 1;
+  }
+
+  // Declare pointers to the results and the end of the result
+  const char* resultsData = 
+    (resultsStart != NULL ? resultsStart + strlen(",\"results\":[") : 
+    NULL);
+  const char* ptrResult = resultsData;
+  const char* resultEnd = (result != NULL ? result + strlen(result) : 
+    NULL);
+
+  // Loop on the tasks of the batch
+  long nbLen = (propLens != NULL ? JSONGetNbValue(propLens) : 0);
+  for (unsigned long iTask = 0; iTask < batch->_nbTask; ++iTask) {
+    SquidletTaskRequest* task = batch->_tasks[iTask];
+
+    // Get the length of the result of the task, 0 if the relay 
+    // couldn't complete it
+    long len = 0;
+    if ((long)iTask < nbLen)
+      len = atol(JSONLblVal(JSONValue(propLens, iTask)));
+
+    // Skip the comma separating the results
+    if (len > 0 && ptrResult != resultsData)
+      ++ptrResult;
+
+    // If the task has a valid result
+    if (len > 0 && ptrResult + len <= resultEnd) {
+
+      // Copy the result of the task, the task has gone through the 
+      // same phases as the batch
+      if (task->_bufferResult != NULL)
+        free(task->_bufferResult);
+      task->_bufferResult = PBErrMalloc(TheSquidErr, len + 1);
+      memcpy(task->_bufferResult, ptrResult, len);
+      task->_bufferResult[len] = '\0';
+      ptrResult += len;
+      memcpy(task->_timePhases, batchTask->_timePhases, 
+        sizeof(task->_timePhases));
+
+      // Post process the task as if it had been executed by the relay
+      // The tasks post processed in background are traced when they 
+      // come back from the post processing thread
+      SquadRunningTask* taskRunning = 
+        SquadRunningTaskCreate(task, squidlet);
+      bool inBackground = SquadIsPostProcessedInBackground(that, task);
+      bool toReturn = SquadProcessCompletedTask(that, taskRunning);
+      bool completed = true;
+      if (inBackground == false) {
+        SquadPushTrace(that, task, taskRunning->_squidletAddr, NULL, 
+          completed);
+      }
+
+      // If the task must be returned, add it to the completed tasks
+      if (toReturn == true) {
+        GSetAppend(completedTasks, taskRunning);
+
+      // Else, the task has been consumed by the post processing
+      } else {
+        SquidletTaskRequestFree(&(taskRunning->_request));
+        SquadRunningTaskFree(&taskRunning);
+      }
+
+    // Else, the task hasn't been completed, try it again
+    } else {
+      SquadTryAgainTask(that, task);
+    }
+  }
+
+  // Update history
+  SquadPushHistory(that, "completed batch of %lu tasks:", 
+    batch->_nbTask);
+  SquadPushHistorySquidletInfo(that, squidlet);
+
+  // Free memory
+  JSONFree(&json);
+  SquadBatchFree(&batch);
+}
+
+// Return the number of tasks the Squad 'that' can execute at once, 
+// i.e. its number of squidlets, available or not
+unsigned long SquadGetCapacity(
+  const Squad* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // The squidlets not available are the ones running a task, or being 
+  // requested one
+  return SquadGetNbSquidlets(that) + SquadGetNbRunningTasks(that);
+}
+
+// Step the Squad 'that', i.e. tries to affect the remaining tasks to 
+// available Squidlets and check for completion of running tasks. 
+// Return the GSet of the completed SquadRunningTask at this step 
+// Non blocking, if there is no task to compute or no squidlet 
+// available, and no task completed, do nothing and return an empty set 
+// The requests to the squidlets are sent without waiting for the 
+// replies, which are waited for all together up to SQUAD_DISPATCHWAIT 
+// milliseconds, the pending ones are completed at the next steps
+GSetSquadRunningTask SquadStep(
+  Squad* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Create the set of completed tasks
+  GSetSquadRunningTask completedTasks = \
+    GSetSquadRunningTaskCreateStatic();
+
+  // Serve the pending scrapes of metrics
+  if (that->_metrics != NULL) {
+    TheSquidMetricsServe(that->_metrics, SquadPrintMetricsCallback, 
+      that);
+  }
+
+  // Update the squidlets with the announces received since last step
+  SquadDiscoverSquidlets(that);
+
+  // Abandon the sharded evaluations whose failed ranges have been 
+  // dropped by the user
+  SquadPurgeEvalNNShards(that);
+
+  // Get the tasks completed by the shards and give them new tasks, 
+  // before the squidlets of 'that', which are only the ones 
+  // discovered since the Squad is multithreaded
+  SquadStepShards(that, &completedTasks);
+    
+  // If there are running tasks
+  if (SquadGetNbRunningTasks(that) > 0L) {
+
+    // Declare a flag to manage the removing of tasks during the loop
+    // on running tasks
+    bool flag = false;
+
+    // Loop on running tasks
+    GSetIterForward iter = 
+      GSetIterForwardCreateStatic((GSet*)SquadRunningTasks(that));
+    do {
+
+      // Reinit the flag to manage the removing of tasks during the loop
+      flag = false;
+
+      // Get the running tasks
+      SquadRunningTask* runningTask = GSetIterGet(&iter);
+
+      // Skip the requests not yet accepted, they are advanced by 
+      // SquadStepDispatch()
+      if (runningTask->_state != SquadRunningTaskState_Running)
+        continue;
+
+      // Request the result for this task
+      bool complete = SquadReceiveTaskResult(that, runningTask);
+
+      // If the task is not complete, check if the connection to the 
+      // squidlet has been lost (the squidlet died or its device is 
+      // unreachable), in which case there is no need to wait for the 
+      // time limit of the task
+      bool lost = (complete == false && 
+        SocketIsLost(runningTask->_squidlet->_sock) == true);
+      
+      // If the task is complete
+      if (complete == true) {
+
+        // Update history
+        SquadPushHistory(that, "completed task:");
+        SquadPushHistorySquadRunningTask(that, runningTask);
+        SquadLogEvent(that, TheSquidEventType_TaskCompleted, 
+          runningTask->_request, runningTask->_squidlet, 
+          (runningTask->_request->_bufferResult != NULL ? 
+            strlen(runningTask->_request->_bufferResult) : 0));
+
+        // A discovered squidlet doesn't announce itself while it's 
+        // processing a task, completing the task proves it's alive
+        if (runningTask->_squidlet->_timeLastAnnounce > 1)
+          runningTask->_squidlet->_timeLastAnnounce = time(NULL);
+
+        // The squidlet is healthy again
+        runningTask->_squidlet->_quarantineDelay = 0;
+
+        // Update the thermal state of the squidlet with the 
+        // temperature reported in the result
+        SquadUpdateSquidletThermal(that, runningTask->_squidlet, 
+          runningTask->_request->_bufferResult);
+
+        // If the task is a batch, post process each of its tasks, the 
+        // ones to be returned are added to the completed tasks
+        if (runningTask->_request->_type == SquidletTaskType_Batch) {
+          SquadProcessCompletedBatch(that, runningTask, 
+            &completedTasks);
+        }
+
+        // Post process the completed task, the request is still 
+        // available after post processing, even if consumed, unless 
+        // it has been handed to a post processing thread
+        SquidletTaskRequest* request = runningTask->_request;
+        bool inBackground = 
+          SquadIsPostProcessedInBackground(that, request);
+        bool toReturn = SquadProcessCompletedTask(that, runningTask);
+
+        // Memorize the trace of the task, the ones post processed in 
+        // background are traced when they come back from the post 
+        // processing thread
+        bool completed = true;
+        if (inBackground == false) {
+          SquadPushTrace(that, request, runningTask->_squidletAddr, NULL, 
+            completed);
+        }
+
+        // Put back the squidlet in the set of squidlets
+        GSetAppend((GSet*)SquadSquidlets(that), runningTask->_squidlet);
+
+        // Remove the task from the running tasks
+        flag = GSetIterRemoveElem(&iter);
+
+        // If the task must be returned, add the task to the set of 
+        // completed tasks
+        if (toReturn == true) {
+          GSetAppend(&completedTasks, runningTask);
+
+        // Else, the task has been consumed by the post processing
+        } else {
+          SquidletTaskRequestFree(&(runningTask->_request));
+          SquadRunningTaskFree(&runningTask);
+        }
+      
+      // Else, the task is not complete 
+      // If the connection has been lost or we've been waiting too long 
+      // for this task
+      } else if (lost == true || time(NULL) - runningTask->_startTime > 
+        runningTask->_request->_maxWaitTime) {
+
+        // If the connection has been lost
+        if (lost == true) {
+
+          // Update history
+          SquadPushHistory(that, "lost connection to squidlet:");
+          SquadPushHistorySquadRunningTask(that, runningTask);
+          SquadLogEvent(that, TheSquidEventType_TaskLost, 
+            runningTask->_request, runningTask->_squidlet, 0);
+
+          // Close the connection and put the squidlet in quarantine to 
+          // avoid sending it the next tasks while it's down
+          close(runningTask->_squidlet->_sock);
+          runningTask->_squidlet->_sock = -1;
+          SquidletInfoQuarantine(runningTask->_squidlet);
+
+        // Else, we've been waiting too long
+        } else {
+
+          // Update history
+          SquadPushHistory(that, "gave up task:");
+          SquadPushHistorySquadRunningTask(that, runningTask);
+          SquadLogEvent(that, TheSquidEventType_TaskGaveUp, 
+            runningTask->_request, runningTask->_squidlet, 0);
+        }
+
+        // Memorize the trace of the task
+        bool completed = false;
+        SquadPushTrace(that, runningTask->_request, 
+          runningTask->_squidletAddr, NULL, completed);
+
+        // Put back the squidlet in the set of squidlets
+        GSetAppend((GSet*)SquadSquidlets(that), runningTask->_squidlet);
+        runningTask->_squidlet = NULL;
+
+        // Put back the task to the set of tasks, except the stats 
+        // heartbeat which will be sent again at the next period, and 
+        // the batch which is replaced by its tasks
+        if (runningTask->_request->_type == SquidletTaskType_Stats) {
+          SquidletTaskRequestFree(&(runningTask->_request));
+        } else if (runningTask->_request->_type == 
+          SquidletTaskType_Batch) {
+          SquadUnbatchTask(that, runningTask->_request);
+          SquidletTaskRequestFree(&(runningTask->_request));
+        } else {
+          SquadTryAgainTask(that, runningTask->_request);
+          runningTask->_request = NULL;
+        }
+
+        // Remove the task from the running tasks
+        flag = GSetIterRemoveElem(&iter);
+
+        // Free memory
+        SquadRunningTaskFree(&runningTask);
+
+      // Else, the task is not complete and we can wait more for it
+      } else {
+
+        // Update history
+        SquadPushHistory(that, "waiting for task:");
+        SquadPushHistorySquadRunningTask(that, runningTask);
+
+      }
+
+    } while (flag || GSetIterStep(&iter));
+
+  }
+
+  // Send the stats heartbeat to the available squidlets which are due
+  SquadSendStatsHeartbeat(that);
+  
+  // Affect the tasks first to the cool squidlets, then to the warm 
+  // ones if there are still tasks, the hot ones are left cooling down
+  for (int thermalState = SquidletThermalState_Cool;
+    thermalState <= SquidletThermalState_Warm; ++thermalState) {
+
+    // If there are tasks to execute and available squidlet
+    if (SquadGetNbRemainingTasks(that) > 0L &&
+      SquadGetNbSquidlets(that) > 0L) {
+
+      // Declare a flag to manage the removing of tasks during the loop 
+      // on running tasks
+      bool flag = false;
+
+      // Loop on squidlets
+      GSetIterForward iter =
+        GSetIterForwardCreateStatic((GSet*)SquadSquidlets(that));
+      do {
+
+        // Reinit the flag to manage the removing of tasks during the loop
+        flag = false;
+
+        // Get the squidlet
+        SquidletInfo* squidlet = GSetIterGet(&iter);
+
+        // Skip the squidlet if it's not in the thermal state of this 
+        // pass or it's in quarantine
+        if (SquadGetSquidletThermalState(that, squidlet) !=
+          (SquidletThermalState)thermalState || 
+          SquidletInfoIsQuarantined(squidlet) == true)
+          continue;
+
+        // Get the next task the squidlet can complete, with the 
+        // following ones in a batch if the squidlet is a relay
+        SquidletTaskRequest* task = SquadPopTaskForThermalState(that, 
+          (SquidletThermalState)thermalState);
+        if (task != NULL)
+          task = SquadBatchTasks(that, task, squidlet);
+
+        // If there is a task to complete
+        if (task != NULL) {
+
+          // Start the request of the task on the squidlet
+          bool ret = SquadDispatchTask(that, squidlet, task);
+
+          // If the request has started
+          if (ret == true) {
+
+            // Remove the squidlet from the available squidlet
+            flag = GSetIterRemoveElem(&iter);
+
+          // Else, the squidlet can't be reached
+          } else {
+
+            // Put back the task in the set, or the tasks of the batch
+            if (task->_type == SquidletTaskType_Batch) {
+              SquadUnbatchTask(that, task);
+              SquidletTaskRequestFree(&task);
+            } else {
+              GSetPush((GSet*)SquadTasks(that), task);
+            }
+          }
+        }
+      } while (flag || GSetIterStep(&iter));
+    }
+  }
+
+  // Advance the requests sent to the squidlets at this step and the 
+  // previous ones, the connections and the replies of all the 
+  // squidlets are waited for at the same time
+  SquadStepDispatch(that, SQUAD_DISPATCHWAIT);
+  
+  // Update the TextOMeter if necessary
+  if (SquadGetFlagTextOMeter(that) == true) {
+    SquadUpdateTextOMeter(that);
+  }
+   
+  // Return the set of completed tasks
+  return completedTasks;
+}
+
+// Send a stats task to each available squidlet of the Squad 'that' 
+// whose last stats are older than the stats period, or than 
+// SQUAD_THERMALCOOLPERIOD if it's cooling down, or which have been 
+// requested with SquadRequestStats()
+// Squidlets to which the request has been sent are moved to the 
+// running tasks
+void SquadSendStatsHeartbeat(
+  Squad* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // If there is no available squidlet, there is nothing to do
+  if (SquadGetNbSquidlets(that) == 0L)
+    return;
+
+  // Declare a flag to manage the removing of squidlets during the loop
+  bool flag = false;
+
+  // Loop on squidlets
+  time_t now = time(NULL);
+  GSetIterForward iter = 
+    GSetIterForwardCreateStatic((GSet*)SquadSquidlets(that));
+  do {
+
+    // Reinit the flag to manage the removing of squidlets during the 
+    // loop
+    flag = false;
+
+    // Get the squidlet
+    SquidletInfo* squidlet = GSetIterGet(&iter);
+
+    // If the stats of this squidlet are due and it's not in quarantine 
+    // A squidlet cooling down receives no task and its temperature is 
+    // only updated by the stats, which are then always requested 
+    if (SquidletInfoIsQuarantined(squidlet) == false && 
+      (squidlet->_timeLastStats == 0 || 
+      (that->_statsPeriod > 0 && 
+      now - squidlet->_timeLastStats >= that->_statsPeriod) ||
+      (squidlet->_cooling == true && 
+      now - squidlet->_timeLastStats >= SQUAD_THERMALCOOLPERIOD))) {
+
+      // Create the stats task
+      char* buffer = "{\"id\":\"0\"}";
+      unsigned long id = 0;
+      unsigned long subId = 0;
+      time_t maxWait = 5;
+      SquidletTaskRequest* task = SquidletTaskRequestCreate(
+        SquidletTaskType_Stats, id, subId, buffer, maxWait);
+
+      // Memorize the time of the request, even if it fails, to avoid 
+      // flooding an unresponsive squidlet
+      squidlet->_timeLastStats = now;
+
+      // Start the request of the task on the squidlet
+      bool ret = SquadDispatchTask(that, squidlet, task);
+
+      // If the request has started, remove the squidlet from the 
+      // available squidlets
+      if (ret == true) {
+        flag = GSetIterRemoveElem(&iter);
+      } else {
+        SquidletTaskRequestFree(&task);
+      }
+    }
+  } while (flag || GSetIterStep(&iter));
+}
+
+// Request the statistics of all the squidlets of the Squad 'that'
+// The requests are sent during the following SquadStep, as soon as 
+// the squidlets are available
+void SquadRequestStats(
+  Squad* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Mark the available squidlets as due
+  if (SquadGetNbSquidlets(that) > 0L) {
+    GSetIterForward iter = 
+      GSetIterForwardCreateStatic((GSet*)SquadSquidlets(that));
+    do {
+      SquidletInfo* squidlet = GSetIterGet(&iter);
+      squidlet->_timeLastStats = 0;
+    } while (GSetIterStep(&iter));
+  }
+
+  // Mark the squidlets currently running a task as due
+  if (SquadGetNbRunningTasks(that) > 0L) {
+    GSetIterForward iter = 
+      GSetIterForwardCreateStatic((GSet*)SquadRunningTasks(that));
+    do {
+      SquadRunningTask* task = GSetIterGet(&iter);
+      if (task->_squidlet != NULL)
+        task->_squidlet->_timeLastStats = 0;
+    } while (GSetIterStep(&iter));
+  }
+}
+
+// Update the thermal state of the 'squidlet' of the Squad 'that' with 
+// the temperature and throttled state in the result 'bufferResult' 
+// of a task it has completed 
+// The squidlet starts cooling down if it is throttled or its predicted 
+// temperature is above the hard threshold, and stops when it's not 
+// throttled anymore and its temperature is below the soft threshold
+void SquadUpdateSquidletThermal(
+         Squad* const that, 
+  SquidletInfo* const squidlet, 
+    const char* const bufferResult) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (squidlet == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'squidlet' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // If there is no result, there is nothing to do
+  if (bufferResult == NULL)
+    return;
+
+  // Get the temperature and throttled state, searched directly in the 
+  // result to avoid decoding the whole JSON of every result
+  const char* lblTemperature = "\"temperature\":\"";
+  const char* ptr = strstr(bufferResult, lblTemperature);
+  if (ptr == NULL)
+    return;
+  float temperature = atof(ptr + strlen(lblTemperature));
+  const char* lblThrottled = "\"throttled\":\"";
+  ptr = strstr(bufferResult, lblThrottled);
+  if (ptr != NULL)
+    squidlet->_throttled = (ptr[strlen(lblThrottled)] == '1');
+
+  // Update the trend of the temperature, the samples received during 
+  // the same second as the reference are not used for the trend
+  time_t now = time(NULL);
+  if (squidlet->_timeTemperatureRef == 0) {
+    squidlet->_temperatureRef = temperature;
+    squidlet->_timeTemperatureRef = now;
+  } else if (now > squidlet->_timeTemperatureRef) {
+    float slope = (temperature - squidlet->_temperatureRef) /
+      (float)(now - squidlet->_timeTemperatureRef);
+    squidlet->_temperatureTrend =
+      SQUAD_THERMALTRENDWEIGHT * slope +
+      (1.0 - SQUAD_THERMALTRENDWEIGHT) * squidlet->_temperatureTrend;
+    squidlet->_temperatureRef = temperature;
+    squidlet->_timeTemperatureRef = now;
+  }
+  squidlet->_temperature = temperature;
+
+  // Update the cooling down flag
+  float predicted = temperature +
+    MAX(0.0, squidlet->_temperatureTrend) * (float)that->_thermalHorizon;
+  if (squidlet->_throttled == true || predicted >= that->_thermalHard) {
+    if (squidlet->_cooling == false) {
+      SquadPushHistory(that, "squidlet cooling down (%.1fC):", 
+        temperature);
+      SquadPushHistorySquidletInfo(that, squidlet);
+    }
+    squidlet->_cooling = true;
+  } else if (squidlet->_cooling == true &&
+    temperature < that->_thermalSoft) {
+    SquadPushHistory(that, "squidlet cooled down (%.1fC):", 
+      temperature);
+    SquadPushHistorySquidletInfo(that, squidlet);
+    squidlet->_cooling = false;
+  }
+}
+
+// Return the thermal state of the 'squidlet' of the Squad 'that' 
+// The squidlet is hot if it is cooling down, else warm if its 
+// temperature predicted from its trend is above the soft threshold, 
+// else cool
+SquidletThermalState SquadGetSquidletThermalState(
+         const Squad* const that, 
+  const SquidletInfo* const squidlet) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (squidlet == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'squidlet' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  if (squidlet->_cooling == true)
+    return SquidletThermalState_Hot;
+  float predicted = squidlet->_temperature +
+    MAX(0.0, squidlet->_temperatureTrend) * (float)that->_thermalHorizon;
+  if (predicted >= that->_thermalSoft)
+    return SquidletThermalState_Warm;
+  return SquidletThermalState_Cool;
+}
+
+// Process the completed 'task' with the Squad 'that' after its 
+// reception in SquadStep()
+// Return true if the task must be returned by SquadStep, false if 
+// it has been consumed by the Squad (partial result of a sharded 
+// task)
+bool SquadProcessCompletedTask(
+             Squad* const that, 
+  SquadRunningTask* const task) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (task == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'task' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+
+  // Declare a variable to memorize if the task must be returned
+  bool toReturn = true;
+
+  // Call the appropriate function based on the type of the task
+  const TheSquidTaskPlugin* plugin = NULL;
+  switch (task->_request->_type) {
+    case SquidletTaskType_Dummy:
+      break;
+    case SquidletTaskType_Benchmark:
+      break;
+    case SquidletTaskType_PovRay:
+      // If there are post processing threads, the image is composed 
+      // in background and the task is returned once done
+      if (SquadIsPostProcessedInBackground(that, task->_request)) {
+        SquadPostProcessTask(that, task);
+        toReturn = false;
+      } else if (that->_flagRelay == false) {
+        SquadProcessCompletedTask_PovRay(that, task->_request);
+      }
+      break;
+    case SquidletTaskType_ResetStats:
+      // Nothing to do
+      break;
+    case SquidletTaskType_Stats:
+      // Update the stats about the squidlet, the heartbeat is 
+      // internal to the Squad and not returned to the user
+      SquidletInfoUpdateStats(task->_squidlet, task->_request);
+      toReturn = false;
+      break;
+    case SquidletTaskType_EvalNeuranet:
+      // If the squidlet didn't have some of the inlined NeuraNets in 
+      // its cache, forget the ones it's supposed to know and try 
+      // again the task, they will be sent with it this time
+      if (task->_request->_bufferResult != NULL &&
+        strstr(task->_request->_bufferResult, 
+          THESQUID_ERRUNKNOWNNN) != NULL) {
+        SquidletInfoForgetNeuraNets(task->_squidlet);
+        SquadTryAgainTask(that, task->_request);
+        task->_request = NULL;
+        toReturn = false;
+      } else {
+        toReturn = (that->_flagRelay == true || 
+          SquadProcessCompletedTask_EvalNeuranet(that, task->_request));
+      }
+      break;
+    case SquidletTaskType_Batch:
+      // The tasks of the batch have been post processed by 
+      // SquadProcessCompletedBatch
+      toReturn = false;
+      break;
+    case SquidletTaskType_Exec:
+      // Nothing to do, the output of the command is in the result
+      break;
+    default:
+      // Post process the task of a plugin, a relay leaves it to the 
+      // Squad it reports to
+      plugin = TheSquidGetTaskPlugin(task->_request->_type);
+      if (that->_flagRelay == false && plugin != NULL && 
+        plugin->_postProcess != NULL && 
+        task->_request->_bufferResult != NULL) {
+        toReturn = plugin->_postProcess(task->_request->_data, 
+          task->_request->_bufferResult);
+      }
+      break;
+  }
+
+  // Return the flag
+  return toReturn;
+}
+
+// Update the statitics of the SquidletInfo 'that' with the result of
+// the Stats 'task'
+void SquidletInfoUpdateStats(
+         SquidletInfo* const that, 
+  SquidletTaskRequest* const task) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (task == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'task' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+
+  // Declare a variable to decode the JSON data from the completed task
+  JSONNode* jsonResult = JSONCreate();
+
+  // Decode the JSON data from the completed task
+  bool ret = JSONLoadFromStr(jsonResult, task->_bufferResult);
+  
+  // If we could decode the JSON
+  if (ret == true) {
+
+    // Get the properties
+    JSONNode* propNbAcceptedConnection = \
+      JSONProperty(jsonResult, "nbAcceptedConnection");
+    JSONNode* propNbAcceptedTask = \
+      JSONProperty(jsonResult, "nbAcceptedTask");
+    JSONNode* propNbRefusedTask = \
+      JSONProperty(jsonResult, "nbRefusedTask");
+    JSONNode* propNbFailedReceptTaskData = \
+      JSONProperty(jsonResult, "nbFailedReceptTaskData");
+    JSONNode* propNbFailedReceptTaskSize = \
+      JSONProperty(jsonResult, "nbFailedReceptTaskSize");
+    JSONNode* propNbSentResult = \
+      JSONProperty(jsonResult, "nbSentResult");
+    JSONNode* propNbFailedSendResult = \
+      JSONProperty(jsonResult, "nbFailedSendResult");
+    JSONNode* propNbFailedSendResultSize = \
+      JSONProperty(jsonResult, "nbFailedSendResultSize");
+    JSONNode* propNbFailedReceptAck = \
+      JSONProperty(jsonResult, "nbFailedReceptAck");
+    JSONNode* propNbTaskComplete = \
+      JSONProperty(jsonResult, "nbTaskComplete");
+    JSONNode* propTemperature = \
+      JSONProperty(jsonResult, "temperature");
+  
+    // If all the counters are present
+    if (propNbAcceptedConnection != NULL &&
+      propNbAcceptedTask != NULL &&
+      propNbRefusedTask != NULL &&
+      propNbFailedReceptTaskData != NULL &&
+      propNbFailedReceptTaskSize != NULL &&
+      propNbSentResult != NULL &&
+      propNbFailedSendResult != NULL &&
+      propNbFailedSendResultSize != NULL &&
+      propNbFailedReceptAck != NULL &&
+      propNbTaskComplete != NULL) {
+
+      // Update the stats with the received info from the Squidlet 
+      SquidletInfoStats* stats = 
+        (SquidletInfoStats*)SquidletInfoStatistics(that);
+      stats->_nbAcceptedConnection = 
+        atol(JSONLblVal(propNbAcceptedConnection));
+      stats->_nbAcceptedTask = 
+        atol(JSONLblVal(propNbAcceptedTask));
+      stats->_nbRefusedTask = 
+        atol(JSONLblVal(propNbRefusedTask));
+      stats->_nbFailedReceptTaskData = 
+        atol(JSONLblVal(propNbFailedReceptTaskData));
+      stats->_nbFailedReceptTaskSize = 
+        atol(JSONLblVal(propNbFailedReceptTaskSize));
+      stats->_nbSentResult = 
+        atol(JSONLblVal(propNbSentResult));
+      stats->_nbFailedSendResult = 
+        atol(JSONLblVal(propNbFailedSendResult));
+      stats->_nbFailedSendResultSize = 
+        atol(JSONLblVal(propNbFailedSendResultSize));
+      stats->_nbFailedReceptAck = 
+        atol(JSONLblVal(propNbFailedReceptAck));
+      stats->_nbTaskComplete = 
+        atol(JSONLblVal(propNbTaskComplete));
+
+      // The temperature is sampled once per heartbeat
+      if (propTemperature != NULL) {
+        TheSquidHistoAdd(&(stats->_temperature), 
+          atof(JSONLblVal(propTemperature)));
+      }
+
+      // Only the relays send their capacity, the other squidlets 
+      // execute one task at a time
+      JSONNode* propCapacity = JSONProperty(jsonResult, "capacity");
+      if (propCapacity != NULL) {
+        that->_capacity = MAX(1, atol(JSONLblVal(propCapacity)));
+      } else {
+        that->_capacity = 1;
+      }
+
+      // The squidlet sends its whole histograms, replace the local 
+      // copies with them. The histograms of the processing time per 
+      // type are sent only if non empty
+      TheSquidHistoReset(&(stats->_timeToProcessMs));
+      for (int iType = 0; iType < SquidletTaskType_Nb; ++iType) {
+        char lbl[50];
+        sprintf(lbl, "timeToProcessMs%s", squidletTaskTypeStr[iType]);
+        JSONNode* prop = JSONProperty(jsonResult, lbl);
+        if (prop == NULL ||
+          !TheSquidHistoFromStr(stats->_timeToProcessMsPerType + iType, 
+            JSONLblVal(prop))) {
+          TheSquidHistoReset(stats->_timeToProcessMsPerType + iType);
+        }
+        TheSquidHistoMerge(&(stats->_timeToProcessMs), 
+          stats->_timeToProcessMsPerType + iType);
+      }
+      JSONNode* prop = JSONProperty(jsonResult, "timeWaitedTaskMs");
+      if (prop != NULL)
+        TheSquidHistoFromStr(&(stats->_timeWaitedTaskMs), 
+          JSONLblVal(prop));
+      prop = JSONProperty(jsonResult, "timeWaitedAckMs");
+      if (prop != NULL)
+        TheSquidHistoFromStr(&(stats->_timeWaitedAckMs), 
+          JSONLblVal(prop));
+      prop = JSONProperty(jsonResult, "timeTransferSquidSquadUsPerKB");
+      if (prop != NULL)
+        TheSquidHistoFromStr(&(stats->_timeTransferSquidSquadUsPerKB), 
+          JSONLblVal(prop));
+
+    }
+
+  }
+
+  // Free memory
+  JSONFree(&jsonResult);
+}
+
+// Process the completed Pov-Ray 'task' with the Squad 'that'
+void SquadProcessCompletedTask_PovRay(
+                Squad* const that, 
+  SquidletTaskRequest* const task) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (task == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'task' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+
+  // Declare variables to decode the JSON data from the request 
+  // and the completed task
+  JSONNode* jsonRequest = JSONCreate();
+  JSONNode* jsonResult = JSONCreate();
+
+  // Decode the JSON data from the request and the completed task
+  bool ret = JSONLoadFromStr(jsonResult, task->_bufferResult);
+  ret &= JSONLoadFromStr(jsonRequest, task->_data);
+  
+  // If we could decode the JSON
+  if (ret == true) {
+
+    // Get the necessary properties
+    JSONNode* propResultImg = JSONProperty(jsonRequest, "outTga");
+    JSONNode* propWidth = JSONProperty(jsonRequest, "width");
+    JSONNode* propHeight = JSONProperty(jsonRequest, "height");
+    JSONNode* propTga = JSONProperty(jsonResult, "tga");
+    JSONNode* propTop = JSONProperty(jsonResult, "top");
+    JSONNode* propLeft = JSONProperty(jsonResult, "left");
+    JSONNode* propRight = JSONProperty(jsonResult, "right");
+    JSONNode* propBottom = JSONProperty(jsonResult, "bottom");
+
+    // If the necessary properties were present
+    if (propTga != NULL && propTop != NULL && propLeft != NULL &&
+      propRight != NULL && propBottom != NULL && propResultImg != NULL) {
+      
+      // Load the result image
+      GenBrush* resultImg = 
+        GBCreateFromFile(JSONLblVal(propResultImg));
+
+      // If the result image doesn't exists
+      if (resultImg == NULL) {
+        
+        // Create the result image
+        VecShort2D dim = VecShortCreateStatic2D();
+        VecSet(&dim, 0, atoi(JSONLblVal(propWidth)));
+        VecSet(&dim, 1, atoi(JSONLblVal(propHeight)));
+        resultImg = GBCreateImage(&dim);
+        GBSetFileName(resultImg, JSONLblVal(propResultImg));
+      }
+
+      // Load the fragment
+      GenBrush* fragment = 
+        GBCreateFromFile(JSONLblVal(propTga));
+
+      // If we could load the fragment
+      if (fragment != NULL) {
+        
+        // Crop the relevant portion of the image
+        // Pov-Ray has its coordinate system origin at the top left of 
+        // the image, while GenBrush has its own at the bottom left
+        // Pov-Ray starts counting at 1, so the top left is (1,1)
+        VecShort2D dim = VecShortCreateStatic2D();
+        VecSet(&dim, 0,
+          atoi(JSONLblVal(propRight)) -
+          atoi(JSONLblVal(propLeft)) + 1);
+        VecSet(&dim, 1, 
+          atoi(JSONLblVal(propBottom)) -
+          atoi(JSONLblVal(propTop)) + 1);
+        VecShort2D posLR = VecShortCreateStatic2D();
+        VecSet(&posLR, 0, atoi(JSONLblVal(propLeft)) - 1);
+        VecSet(&posLR, 1, 
+          atoi(JSONLblVal(propHeight)) -
+          atoi(JSONLblVal(propBottom)));
+        
+        // Add the fragment to the result image
+        GBCopyFragment(fragment, resultImg, &posLR, &posLR, &dim);
+
+        // Save the result image
+        GBRender(resultImg);
+
+        // Free memory
+        GBFree(&fragment);
+      
+      // Else, we couldn't load the fragment
+      } else {
+        
+        // Update history
+        SquadPushHistory(that, "Couldn't read the fragment (%s)", 
+          GenBrushErr->_msg);
+      }
+
+      // Free memory
+      GBFree(&resultImg);
+
+      // Delete the fragment
+      unlink(JSONLblVal(propTga));
+
+    } else {
+
+      SquadPushHistory(that, 
+        "Can't preprocess the Pov-Ray task (invalid data)");
+
+    }
+
+    // Free memory
+    if (jsonResult != NULL)
+      JSONFree(&jsonResult);
+    if (jsonRequest != NULL)
+      JSONFree(&jsonRequest);
+  }
+}
+
+// Process the completed neuranet evaluation 'task' with the Squad 
+// 'that'
+// If the task is one range of a sharded evaluation, its partial 
+// result is merged with the other ranges. When all the ranges have
+// completed, the result of the last one is replaced with the result
+// of the evaluation on the whole category
+// Return true if the task must be returned by SquadStep, false if 
+// it has been merged and the evaluation is not complete yet
+bool SquadProcessCompletedTask_EvalNeuranet(
+                Squad* const that, 
+  SquidletTaskRequest* const task) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (task == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'task' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+
+  // Search the partial results of the task, if it's sharded
+  bool isRange = false;
+  SquadEvalNNShards* shards = SquadGetEvalNNShards(that, task, &isRange);
+
+  // If the task is not sharded, there is nothing to do
+  if (isRange == false)
+    return true;
+
+  // If the evaluation has been abandoned (one of its failed ranges 
+  // hasn't been tried again), or this range has already been merged 
+  // (the task has been tried again and completed twice), ignore it
+  if (shards == NULL || task->_subId >= shards->_nbShard || 
+    shards->_done[task->_subId] == true) {
+    SquadPushHistory(that, "Ignore the range %lu of the evaluation %lu", 
+      task->_subId, task->_id);
+    return false;
+  }
+
+  // Decode the partial result
+  JSONNode* json = JSONCreate();
+  bool ret = SquidletTaskHasSucceeded(task) && 
+    JSONLoadFromStr(json, task->_bufferResult);
+  VecFloat* sumErrs = NULL;
+  VecLong* nbEvals = NULL;
+  JSONNode* propSizeCat = NULL;
+  if (ret == true) {
+    ret = VecDecodeAsJSON(&sumErrs, JSONProperty(json, "sumErr")) &&
+      VecDecodeAsJSON(&nbEvals, JSONProperty(json, "nbSample"));
+    propSizeCat = JSONProperty(json, "sizeCat");
+  }
+
+  // If the range has failed or its partial result is invalid
+  if (ret == false || propSizeCat == NULL ||
+    VecGetDim(sumErrs) != VecGetDim(shards->_sumErrs) ||
+    VecGetDim(nbEvals) != VecGetDim(shards->_nbEvals)) {
+
+    // Turn the task into a failed one, to be tried again by the user
+    if (SquidletTaskHasSucceeded(task) == true) {
+      free(task->_bufferResult);
+      task->_bufferResult = strdup(
+        "{\"success\":\"0\",\"temperature\":\"0.0\","
+        "\"err\":\"Invalid partial result\"}");
+    }
+
+    // The evaluation is abandoned if the user doesn't try again the 
+    // range in time
+    shards->_failed[task->_subId] = true;
+    shards->_expiry = time(NULL) + task->_maxWaitTime;
+
+    // Free memory
+    VecFree(&sumErrs);
+    VecFree(&nbEvals);
+    JSONFree(&json);
+
+    // Return the failed task
+    return true;
+  }
+
+  // Merge the partial result, and check if the evaluation of some 
+  // NeuraNets has been stopped before the end of the range
+  long sizeCat = atol(JSONLblVal(propSizeCat));
+  long sizeRange = sizeCat * (long)(task->_subId + 1) / 
+    (long)(shards->_nbShard) - 
+    sizeCat * (long)(task->_subId) / (long)(shards->_nbShard);
+  for (long iNN = VecGetDim(sumErrs); iNN--;) {
+    VecSet(shards->_sumErrs, iNN, 
+      VecGet(shards->_sumErrs, iNN) + VecGet(sumErrs, iNN));
+    VecSet(shards->_nbEvals, iNN, 
+      VecGet(shards->_nbEvals, iNN) + VecGet(nbEvals, iNN));
+    if (VecGet(nbEvals, iNN) < sizeRange)
+      shards->_stopped = true;
+  }
+  shards->_sizeCat = sizeCat;
+  shards->_done[task->_subId] = true;
+  ++(shards->_nbDone);
+
+  // Free memory
+  VecFree(&sumErrs);
+  VecFree(&nbEvals);
+  JSONFree(&json);
+
+  // If there are still ranges to be evaluated, the task is consumed
+  if (shards->_nbDone < shards->_nbShard)
+    return false;
+
+  // Calculate the values of the NeuraNets on the whole category
+  // A range stops the evaluation of a NeuraNet only when its own sum 
+  // of errors shows the NeuraNet can't beat the best value, the sum 
+  // on the evaluated samples then gives the upper bound of the value 
+  // of the NeuraNet, whatever the fast reject mode, as the value on 
+  // the samples evaluated in the other ranges is not the one the 
+  // serial evaluation would have stopped at
+  VecFloat* values = VecFloatCreate(VecGetDim(shards->_sumErrs));
+  for (long iNN = VecGetDim(values); iNN--;) {
+    float sumErr = VecGet(shards->_sumErrs, iNN);
+    VecSet(values, iNN, -1.0 * sumErr / (float)(shards->_sizeCat));
+  }
+
+  // Replace the result of the task with the result of the whole 
+  // evaluation
+  JSONNode* jsonResult = JSONCreate();
+  char successStr[2] = {'1', '\0'};
+  JSONAddProp(jsonResult, "success", successStr);
+  JSONAddProp(jsonResult, "nnids", VecEncodeAsJSON(shards->_nnids));
+  JSONAddProp(jsonResult, "v", VecEncodeAsJSON(values));
+  if (shards->_fastReject == true || shards->_stopped == true) {
+    JSONAddProp(jsonResult, "nbSample", 
+      VecEncodeAsJSON(shards->_nbEvals));
+    char sizeCatStr[20] = {'\0'};
+    sprintf(sizeCatStr, "%ld", shards->_sizeCat);
+    JSONAddProp(jsonResult, "sizeCat", sizeCatStr);
+  }
+  char* bufferResult = PBErrMalloc(TheSquidErr, THESQUID_MAXPAYLOADSIZE);
+  bool compact = true;
+  if (JSONSaveToStr(jsonResult, bufferResult, 
+    THESQUID_MAXPAYLOADSIZE, compact) == false) {
+    sprintf(bufferResult, 
+      "{\"success\":\"0\",\"temperature\":\"0.0\","
+      "\"err\":\"JSONSaveToStr failed\"}");
+  }
+  free(task->_bufferResult);
+  task->_bufferResult = bufferResult;
+
+  // Remove the partial results from the squad
+  GSetIterForward iter = 
+    GSetIterForwardCreateStatic(&(that->_evalNNShards));
+  do {
+    if (GSetIterGet(&iter) == shards) {
+      GSetIterRemoveElem(&iter);
+      break;
+    }
+  } while (GSetIterStep(&iter));
+  SquadEvalNNShardsFree(&shards);
+
+  // Free memory
+  VecFree(&values);
+  JSONFree(&jsonResult);
+
+  // Return the completed task
+  return true;
+}
+
+// Abandon the sharded neuranet evaluations of the Squad 'that' having 
+// a failed range which hasn't been tried again with SquadTryAgainTask 
+// within its 'maxWait' seconds, the ranges completing later are 
+// ignored
+void SquadPurgeEvalNNShards(
+  Squad* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+
+  // If there is no sharded evaluation, nothing to do
+  if (GSetNbElem(&(that->_evalNNShards)) == 0)
+    return;
+
+  // Loop on the sharded evaluations
+  time_t now = time(NULL);
+  bool flag = false;
+  GSetIterForward iter = 
+    GSetIterForwardCreateStatic(&(that->_evalNNShards));
+  do {
+    flag = false;
+    SquadEvalNNShards* shards = GSetIterGet(&iter);
+
+    // If one of the failed ranges hasn't been tried again in time
+    bool dropped = false;
+    for (unsigned int iShard = shards->_nbShard; iShard-- && !dropped;)
+      dropped = shards->_failed[iShard];
+    if (dropped == true && now >= shards->_expiry) {
+
+      // Abandon the evaluation
+      SquadPushHistory(that, "Abandon the sharded evaluation %lu", 
+        shards->_id);
+      flag = GSetIterRemoveElem(&iter);
+      SquadEvalNNShardsFree(&shards);
+    }
+  } while (flag || GSetIterStep(&iter));
+}
+
+// Set the flag memorizing if the TextOMeter is displayed for
+// the Squad 'that' to 'flag'
+void SquadSetFlagTextOMeter(
+  Squad* const that, 
+    const bool flag) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  
+  // Create a copy of the flag
+  bool effectiveFlag = flag;
+  
+  // If the requested flag is different from the current flag;
+  if (that->_flagTextOMeter != effectiveFlag) {
+    
+    // If the user requested to turn on the textometer and the 
+    // textometer is currently off
+    if (effectiveFlag && that->_textOMeter == NULL) {
+      
+      // Create the TextOMeter
+      char title[] = "Squad";
+      int width = SQUAD_TXTOMETER_LENGTHLINEHISTORY + 1;
+      int height = SQUAD_TXTOMETER_NBLINEHISTORY + 
+        SQUAD_TXTOMETER_NBTASKDISPLAYED + 4;
+      that->_textOMeter = TextOMeterCreate(title, width, height);
+      
+      // If we couldn't create the TextOMeter
+      if (that->_textOMeter == NULL) {
+
+        // Force the flag to false
+        effectiveFlag = false;
+      }
+    }
+
+    // If the user requested to turn off the textometer and the 
+    // textometer is currently on
+    if (!effectiveFlag && that->_textOMeter != NULL) {
+      
+      // Terminate the TextOMeter
+      TextOMeterFree(&(that->_textOMeter));
+    }
+
+    // Memorize the current status of the TextOMeter
+    that->_flagTextOMeter = effectiveFlag;
+  }
+}
+
+// Add one event with the message 'msg' to the history of messages 
+// for the TextOMeter 
+// 'msg' is truncated if it doesn't fit in one line of history 
+// If the TextOmeter is not turned on, do nothing 
+// Variadic function with the same signature as printf family
+void SquadPushHistory(
+  Squad* const that, 
+         char* msg, 
+               ...) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (msg == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'msg' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+
+  // If the TextOMeter is not turned on
+  if (SquadGetFlagTextOMeter(that) == false) {
+
+    // Do nothing
+    return;
+  }
+
+  // Format the message
+  char buffer[SQUAD_TXTOMETER_LENGTHLINEHISTORY];
+  va_list ap;
+  va_start(ap, msg);
+  vsnprintf(buffer, sizeof(buffer), msg, ap);
+  va_end(ap);
+
+  // Add the event
+  SquadPushHistoryEvent(that, buffer, NULL, NULL);
+}
+
+// Add one event refering to the 'squidlet' to the history of 
+// messages for the TextOMeter 
+// If the TextOmeter is not turned on, do nothing
+void SquadPushHistorySquidletInfo(
+               Squad* const that, 
+  const SquidletInfo* const squidlet) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (squidlet == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'squidlet' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  if (SquadGetFlagTextOMeter(that) == true)
+    SquadPushHistoryEvent(that, NULL, NULL, squidlet);
+}
+
+// Add one event refering to the task 'request' to the history of 
+// messages for the TextOMeter 
+// If the TextOmeter is not turned on, do nothing
+void SquadPushHistorySquidletTaskRequest(
+                      Squad* const that, 
+  const SquidletTaskRequest* const request) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (request == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'request' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  if (SquadGetFlagTextOMeter(that) == true)
+    SquadPushHistoryEvent(that, NULL, request, NULL);
+}
+
+// Add one event refering to the running 'task' to the history of 
+// messages for the TextOMeter 
+// If the TextOmeter is not turned on, do nothing
+void SquadPushHistorySquadRunningTask(
+                   Squad* const that, 
+  const SquadRunningTask* const task) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (task == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'task' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  if (SquadGetFlagTextOMeter(that) == true)
+    SquadPushHistoryEvent(that, NULL, task->_request, task->_squidlet);
+}
+
+// Add one event with the message 'msg' (may be null) refering to the 
+// task 'request' and the 'squidlet' (may be null) to the ring buffer 
+// of history of the Squad 'that' 
+// The slot of the event is reserved atomically, hence events can be 
+// pushed concurrently without lock
+void SquadPushHistoryEvent(
+                      Squad* const that, 
+                 const char* const msg, 
+  const SquidletTaskRequest* const request, 
+         const SquidletInfo* const squidlet) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Reserve the slot of the event and mark it as being written
+  unsigned long seq =
+    __atomic_fetch_add(&(that->_nbHistoryEvent), 1, __ATOMIC_RELAXED);
+  SquadHistoryEvent* event =
+    that->_history + (seq % SQUAD_TXTOMETER_NBHISTORYEVENT);
+  __atomic_store_n(&(event->_seq), 0, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  // Copy the message, task and squidlet
+  if (msg != NULL) {
+    strncpy(event->_msg, msg, sizeof(event->_msg) - 1);
+    event->_msg[sizeof(event->_msg) - 1] = '\0';
+  } else {
+    event->_msg[0] = '\0';
+  }
+  event->_hasTask = (request != NULL);
+  if (request != NULL) {
+    event->_type = request->_type;
+    event->_id = request->_id;
+    event->_subId = request->_subId;
+  }
+  event->_hasSquidlet = (squidlet != NULL);
+  if (squidlet != NULL) {
+    strncpy(event->_name, squidlet->_name, sizeof(event->_name) - 1);
+    event->_name[sizeof(event->_name) - 1] = '\0';
+    strncpy(event->_ip, squidlet->_ip, sizeof(event->_ip) - 1);
+    event->_ip[sizeof(event->_ip) - 1] = '\0';
+    event->_port = squidlet->_port;
+  }
+
+  // Publish the event
+  __atomic_store_n(&(event->_seq), seq + 1, __ATOMIC_RELEASE);
+}
+
+// Print the event 'that' of the history into the 'buffer' of 'size' 
+// bytes, as '<msg>[<task>]/[<squidlet>]' where the parts not refered 
+// to by the event are omitted
+void SquadHistoryEventToStr(
+  const SquadHistoryEvent* const that, 
+                     char* const buffer, 
+                    const size_t size) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (buffer == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'buffer' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  const char* typeStr = "<unknown>";
+  if (that->_hasTask == true && SquidletTaskTypeIsValid(that->_type))
+    typeStr = SquidletTaskTypeName(that->_type);
+  if (that->_hasTask == true && that->_hasSquidlet == true) {
+    snprintf(buffer, size, "%s[%s(#%lu-%lu)]/[%s(%s:%d)]", 
+      that->_msg, typeStr, that->_id, that->_subId, 
+      that->_name, that->_ip, that->_port);
+  } else if (that->_hasTask == true) {
+    snprintf(buffer, size, "%s%s(#%lu-%lu)", 
+      that->_msg, typeStr, that->_id, that->_subId);
+  } else if (that->_hasSquidlet == true) {
+    snprintf(buffer, size, "%s%s(%s:%d)", 
+      that->_msg, that->_name, that->_ip, that->_port);
+  } else {
+    snprintf(buffer, size, "%s", that->_msg);
+  }
+}
+
+// Refresh the content of the TextOMeter attached to the 
+// Squad 'that', at most SQUAD_TXTOMETER_NBREFRESHPERSEC times per 
+// second. A skipped refresh is done at the next call after the delay, 
+// or when the Squad is freed
+void SquadUpdateTextOMeter(
+  Squad* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (that->_textOMeter == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that->_textOMeter' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // If the TextOMeter has been refreshed too recently, do nothing
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  long elapsedUs =
+    (now.tv_sec - that->_timeLastRefresh.tv_sec) * 1000000L +
+    (now.tv_usec - that->_timeLastRefresh.tv_usec);
+  if (elapsedUs >= 0 &&
+    elapsedUs < 1000000L / SQUAD_TXTOMETER_NBREFRESHPERSEC) {
+    that->_flagTextOMeterDirty = true;
+    return;
+  }
+  that->_timeLastRefresh = now;
+  that->_flagTextOMeterDirty = false;
+
+  // Clear the TextOMeter
+  TextOMeterClear(that->_textOMeter);
+
+  // Declare a buffer to send text to the TextOMeter
+  char buffer[SQUAD_TXTOMETER_LENGTHLINEHISTORY + 1];
+
+  // Print the header
+  sprintf(buffer, SQUAD_TXTOMETER_FORMAT1, 
+    SquadGetNbRunningTasks(that), SquadGetNbRemainingTasks(that), 
+    SquadGetNbSquidlets(that));
+  TextOMeterPrint(that->_textOMeter, buffer);
+
+  // Print the last events of the history, skipping the ones being 
+  // written
+  char bufferEvent[SQUAD_TXTOMETER_LENGTHLINEHISTORY - 10];
+  unsigned long nbEvent =
+    __atomic_load_n(&(that->_nbHistoryEvent), __ATOMIC_ACQUIRE);
+  for (unsigned long iLine = 0; iLine < SQUAD_TXTOMETER_NBLINEHISTORY;
+    ++iLine) {
+    buffer[0] = '\n';
+    buffer[1] = '\0';
+    if (nbEvent + iLine >= SQUAD_TXTOMETER_NBLINEHISTORY) {
+      unsigned long seq = nbEvent + iLine - SQUAD_TXTOMETER_NBLINEHISTORY;
+      const SquadHistoryEvent* slot =
+        that->_history + (seq % SQUAD_TXTOMETER_NBHISTORYEVENT);
+      if (__atomic_load_n(&(slot->_seq), __ATOMIC_ACQUIRE) == seq + 1) {
+        SquadHistoryEvent event = *slot;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&(slot->_seq), __ATOMIC_RELAXED) == seq + 1) {
+          SquadHistoryEventToStr(&event, bufferEvent, 
+            sizeof(bufferEvent));
+          snprintf(buffer, sizeof(buffer), "[%06lu] %s\n", seq + 1, 
+            bufferEvent);
+        }
+      }
+    }
+    TextOMeterPrint(that->_textOMeter, buffer);
+  }
+
+  // Print the tasks header
+  sprintf(buffer, SQUAD_TXTOMETER_TASKHEADER);
+  TextOMeterPrint(that->_textOMeter, buffer);
+
+  // Print the running tasks
+  SquadHistoryEvent event;
+  event._msg[0] = '\0';
+  int iLine = 0;
+  if (SquadGetNbRunningTasks(that) > 0) {
+    GSetIterForward iter = GSetIterForwardCreateStatic(
+      (GSet*)SquadRunningTasks(that));
+    do {
+      SquadRunningTask* task = GSetIterGet(&iter);
+      if (task != NULL) {
+        event._hasTask = (task->_request != NULL);
+        if (task->_request != NULL) {
+          event._type = task->_request->_type;
+          event._id = task->_request->_id;
+          event._subId = task->_request->_subId;
         }
-        VecLong* nnids = NULL;
-        VecDecodeAsJSON(&nnids, prop);
-        prop = JSONProperty(propTask, "best");
-        if (prop == NULL) {
-          TheSquidErr->_type = PBErrTypeInvalidData;
-          sprintf(TheSquidErr->_msg, "best not found");
-          JSONFree(&json);
-          return false;
+        event._hasSquidlet = (task->_squidlet != NULL);
+        if (task->_squidlet != NULL) {
+          snprintf(event._name, sizeof(event._name), "%s", 
+            task->_squidlet->_name);
+          snprintf(event._ip, sizeof(event._ip), "%s", 
+            task->_squidlet->_ip);
+          event._port = task->_squidlet->_port;
+        }
+        SquadHistoryEventToStr(&event, bufferEvent, sizeof(bufferEvent));
+        snprintf(buffer, sizeof(buffer), SQUAD_TXTOMETER_FORMATRUNNING, 
+          bufferEvent);
+      } else {
+        buffer[0] = '\0';
+      }
+      TextOMeterPrint(that->_textOMeter, buffer);
+      ++iLine;
+    } while (GSetIterStep(&iter) &&
+      iLine < SQUAD_TXTOMETER_NBTASKDISPLAYED);
+  }
+
+  // Print the remaining tasks
+  if (SquadGetNbRemainingTasks(that) > 0 &&
+    iLine < SQUAD_TXTOMETER_NBTASKDISPLAYED) {
+    GSetIterForward iter = GSetIterForwardCreateStatic(
+      (GSet*)SquadTasks(that));
+    event._hasSquidlet = false;
+    do {
+      SquidletTaskRequest* task = GSetIterGet(&iter);
+      if (task != NULL) {
+        event._hasTask = true;
+        event._type = task->_type;
+        event._id = task->_id;
+        event._subId = task->_subId;
+        SquadHistoryEventToStr(&event, bufferEvent, sizeof(bufferEvent));
+        snprintf(buffer, sizeof(buffer), SQUAD_TXTOMETER_FORMATQUEUED, 
+          bufferEvent);
+      } else {
+        buffer[0] = '\0';
+      }
+      TextOMeterPrint(that->_textOMeter, buffer);
+      ++iLine;
+    } while (GSetIterStep(&iter) &&
+      iLine < SQUAD_TXTOMETER_NBTASKDISPLAYED - 1);
+  }
+
+  // If there are more tasks than space to print them all
+  if (iLine == SQUAD_TXTOMETER_NBTASKDISPLAYED - 1) {
+
+    // Print a mark to specify there are non displayed tasks
+    sprintf(buffer, "...\n");
+    TextOMeterPrint(that->_textOMeter, buffer);
+
+  // Else, there are remaining space to display more tasks
+  } else {
+
+    // Fill in the remainnig space with empty lines
+    sprintf(buffer, "\n");
+    for (; iLine < SQUAD_TXTOMETER_NBTASKDISPLAYED; ++iLine) {
+      TextOMeterPrint(that->_textOMeter, buffer);
+    }
+  }
+
+  // Add an empty line at the bottom of the TextOMeter
+  sprintf(buffer, "\n");
+  TextOMeterPrint(that->_textOMeter, buffer);
+
+  // Flush the content of the TextOMeter
+  TextOMeterFlush(that->_textOMeter);
+}
+
+// Check all the squidlets of the Squad 'that' by processing a dummy 
+// task and display information about each one on the file 'stream'
+// Return true if all the tasks could be performed, false else
+bool SquadCheckSquidlets(
+  Squad* const that, 
+   FILE* const stream) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (stream == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'stream' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+
+  // Declare a variable to memorize the result
+  bool res = true;
+
+  // Declare variables to create a dummy task request
+  char* buffer = "{\"v\":\"0\"}";
+  time_t maxWait = 5;
+
+  // If there are squidlets
+  if (SquadGetNbSquidlets(that) > 0) {
+
+    // Loop on the squidlets
+    GSetIterForward iter = 
+      GSetIterForwardCreateStatic(SquadSquidlets(that));
+    do {
+
+      // Get the squidlet
+      SquidletInfo* squidlet = GSetIterGet(&iter);
+
+      // Display info about the squidlet
+      SquidletInfoPrint(squidlet, stream);
+      fprintf(stream, "\n");
+
+      // Create a dummy task
+      unsigned long id = 0;
+      unsigned long subId = 0;
+      SquidletTaskRequest* task = SquidletTaskRequestCreate(
+        SquidletTaskType_Dummy, id, subId, buffer, maxWait);
+      GSetAppend((GSet*)SquadTasks(that), task);
+
+      // Memorize the start time
+      struct timeval start;
+      gettimeofday(&start, NULL);
+
+      // Request the execution of the dummy task on the squidlet
+      bool ret = SquadSendTaskOnSquidlet(that, squidlet, task);
+
+      // Memorize the time to send the request
+      struct timeval timeToSend;
+      gettimeofday(&timeToSend, NULL);
+
+      // If the request was not successfull
+      if (!ret) {
+        
+        // Set the flag and display a message on the stream
+        res = false;
+        fprintf(stream, "\tThe request for a dummy task failed.\n");
+
+      // Else, the request was successfull
+      } else {
+
+        // Get the running tasks
+        SquadRunningTask* runningTask = 
+          GSetPop((GSet*)SquadRunningTasks(that));
+
+        // Loop until the task ends
+        bool flagStop = false;
+        while (!flagStop && time(NULL) - runningTask->_startTime <= 
+          runningTask->_request->_maxWaitTime) {
+
+          // If the task is completed
+          if (SquadReceiveTaskResult(that, runningTask)) {
+
+            // Get the time to process
+            struct timeval timeToProcess;
+            gettimeofday(&timeToProcess, NULL);
+
+            // Stop the loop
+            flagStop = true;
+
+            // Process the result
+            SquidletTaskRequest* request = runningTask->_request;
+            fprintf(stream, "\tRequest for dummy task succeeded.\n");
+            fprintf(stream, "\t%s\n", request->_bufferResult);
+            unsigned long delayToSendms = 
+              (timeToSend.tv_sec - start.tv_sec) * 1000 + 
+              (timeToSend.tv_usec - start.tv_usec) / 1000;
+            unsigned long delayToProcessms = 
+              (timeToProcess.tv_sec - timeToSend.tv_sec) * 1000 + 
+              (timeToProcess.tv_usec - timeToSend.tv_usec) / 1000;
+            fprintf(stream, 
+              "\tdelay to send: %lums, delay to process: %lums\n", 
+              delayToSendms, delayToProcessms);
+          }
         }
-        float bestVal = atof(JSONLblVal(prop));
-        prop = JSONProperty(propTask, "cat");
-        if (prop == NULL) {
-          TheSquidErr->_type = PBErrTypeInvalidData;
-          sprintf(TheSquidErr->_msg, "cat not found");
-          JSONFree(&json);
-          return false;
+
+        // If we got out of the loop without the flag raising, it means
+        // we gave up on time
+        if (!flagStop) {
+          fprintf(stream, "\tGave up due to time limit.\n");
         }
-        long cat = atol(JSONLblVal(prop));
-        
-        // Add the task
-        SquadAddTask_EvalNeuraNet(that, id, maxWait,
-          dataset, workingDir, nnids, bestVal, cat);
-        
-        // Free memory
-        VecFree(&nnids);
-        
-        break;
-      
-      // Invalid task type
-      default:
-        // Set the error message
-        TheSquidErr->_type = PBErrTypeInvalidData;
-        sprintf(TheSquidErr->_msg, "invalid task type (%d)", type);
 
         // Free memory
-        JSONFree(&json);
-        
-        // Return the error code
-        return false;
-    }
+        runningTask->_request = NULL;
+        runningTask->_squidlet = NULL;
+        SquadRunningTaskFree(&runningTask);
+      }
+    } while (GSetIterStep(&iter));
   }
 
-  // Free the memory used by the JSON
-  JSONFree(&json);
-  
-  // Return the success code
-  return true;
-  
+  // Return the result
+  return res;
 }
 
-// Load the Squidlet info from the file 'stream' into the Squad 'that'
-// Return true if it could load the info, else false
-bool SquadLoadSquidlets(
+// Run the benchmark with the squad 'that' and output the result on 
+// the file 'stream'
+// The benchmark consists of executing benchmark tasks with several
+// size and number of loop, first locally and then on the squidlet 
+// (which must have been loaded before calling this function)
+void SquadBenchmark(
   Squad* const that, 
    FILE* const stream) {
 #if BUILDMODE == 0
@@ -792,820 +7536,1545 @@ bool SquadLoadSquidlets(
     PBErrCatch(TheSquidErr);
   }
 #endif
-  // Discard the current squidlets info if any
-  while (GSetNbElem(SquadSquidlets(that)) > 0) {
-    SquidletInfo* squidletInfo = GSetPop((GSet*)SquadSquidlets(that));
-    SquidletInfoFree(&squidletInfo);
-  }
-
-  // Declare a json to load the encoded data
-  JSONNode* json = JSONCreate();
-
-  // Load the whole encoded data
-  if (JSONLoad(json, stream) == false) {
-    TheSquidErr->_type = PBErrTypeIOError;
-    sprintf(TheSquidErr->_msg, "JSONLoad failed");
-    JSONFree(&json);
-    return false;
-  }
 
-  // Decode the data from the JSON
-  if (!SquadDecodeAsJSON(that, json)) {
-    JSONFree(&json);
-    return false;
-  }
-
-  // Free the memory used by the JSON
-  JSONFree(&json);
-  
-  // Return the succes code
-  return true;
+  // Run the benchmark with the default configuration
+  SquadBenchmarkConfig config = SquadBenchmarkConfigCreateStatic();
+  SquadBenchmarkWithConfig(that, &config, stream);
+  SquadBenchmarkConfigFreeStatic(&config);
 }
 
-// Load the Squidlet info from the string 'str' into the Squad 'that'
-// Return true if it could load the info, else false
-bool SquadLoadSquidletsFromStr(
-  Squad* const that, 
-   char* const str) {
+// Run the benchmark with the squad 'that' and the configuration 
+// 'config', and output the result on the file 'stream' in the format
+// of the configuration
+// For each pair of payload size and number of sorts, benchmark tasks
+// are executed during a warm-up phase, then the number of tasks 
+// completed per second is sampled until the confidence interval of 
+// its average reaches the target or the maximum duration is reached
+// If the squad has no squidlet the tasks are executed locally
+void SquadBenchmarkWithConfig(
+                        Squad* const that, 
+  const SquadBenchmarkConfig* const config, 
+                         FILE* const stream) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (str == NULL) {
+  if (config == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'str' is null");
+    sprintf(TheSquidErr->_msg, "'config' is null");
     PBErrCatch(TheSquidErr);
   }
-#endif
-  // Discard the current squidlets info if any
-  while (GSetNbElem(SquadSquidlets(that)) > 0) {
-    SquidletInfo* squidletInfo = GSetPop((GSet*)SquadSquidlets(that));
-    SquidletInfoFree(&squidletInfo);
+  if (stream == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'stream' is null");
+    PBErrCatch(TheSquidErr);
   }
+#endif
 
-  // Declare a json to load the encoded data
-  JSONNode* json = JSONCreate();
-
-  // Load the whole encoded data
-  if (JSONLoadFromStr(json, str) == false) {
-    TheSquidErr->_type = PBErrTypeIOError;
-    sprintf(TheSquidErr->_msg, "JSONLoadFromStr failed");
-    JSONFree(&json);
-    return false;
+  // Get the number of squidlets, if the squad has no squidlet, it 
+  // means we are running the benchmark on the local device for 
+  // comparison
+  long nbSquidlet = 
+    SquadGetNbSquidlets(that) + SquadGetNbRunningTasks(that);
+  const char* mode = (nbSquidlet == 0 ? "local" : "squidlets");
+
+  // Display the header of the results
+  switch (config->_format) {
+    case SquadBenchmarkFormat_JSON:
+      fprintf(stream, "{\"mode\":\"%s\",\"nbSquidlet\":\"%ld\",", 
+        mode, nbSquidlet);
+      SquadBenchmarkConfigPrintJSON(config, stream);
+      fprintf(stream, ",\"results\":[");
+      break;
+    case SquadBenchmarkFormat_CSV:
+      fprintf(stream, "mode,nbSquidlet,nbLoopPerTask,nbBytePayload,"
+        "nbTask,nbSample,lengthMs,taskPerSec,ciTaskPerSec,converged\n");
+      break;
+    default:
+      fprintf(stream, "-- Benchmark started --\n");
+      if (nbSquidlet == 0)
+        fprintf(stream, "Execution on local device:\n");
+      else
+        fprintf(stream, "Execution on TheSquid:\n");
+      fprintf(stream, "nbLoopPerTask\tnbBytePayload\tnbTask\tnbSample\t"
+        "lengthMs\ttaskPerSec\tciTaskPerSec\tconverged\n");
+      break;
   }
 
-  // Decode the data from the JSON
-  if (!SquadDecodeAsJSON(that, json)) {
-    JSONFree(&json);
-    return false;
+  // Declare a variable to create unique ids for the tasks
+  unsigned long id = 0;
+
+  // Loop on payload size and nbLoop
+  bool flagStop = false;
+  for (long iSize = 0; 
+    !flagStop && iSize < VecGetDim(config->_payloadSizes); ++iSize) {
+    for (long iLoop = 0; 
+      !flagStop && iLoop < VecGetDim(config->_nbLoops); ++iLoop) {
+
+      // Measure the throughput for this pair
+      SquadBenchmarkPoint point = {
+        ._sizePayload = VecGet(config->_payloadSizes, iSize),
+        ._nbLoop = VecGet(config->_nbLoops, iLoop),
+        ._nbTask = 0, ._sum = 0.0, ._sumSq = 0.0, ._nbSample = 0,
+        ._lengthMs = 0.0};
+      flagStop = !SquadBenchmarkRunPoint(that, config, &point, &id, 
+        stream);
+
+      // Display the result
+      float mean = SquadBenchmarkPointGetMean(&point);
+      float ci = SquadBenchmarkPointGetCI(&point);
+      bool converged = SquadBenchmarkPointIsConverged(&point, config);
+      switch (config->_format) {
+        case SquadBenchmarkFormat_JSON:
+          fprintf(stream, 
+            "%s{\"nbLoopPerTask\":\"%ld\",\"nbBytePayload\":\"%ld\","
+            "\"nbTask\":\"%lu\",\"nbSample\":\"%ld\","
+            "\"lengthMs\":\"%.3f\",\"taskPerSec\":\"%.6f\","
+            "\"ciTaskPerSec\":\"%.6f\",\"converged\":\"%d\"}",
+            (iSize + iLoop > 0 ? "," : ""), point._nbLoop, 
+            point._sizePayload, point._nbTask, point._nbSample, 
+            point._lengthMs, mean, ci, converged);
+          break;
+        case SquadBenchmarkFormat_CSV:
+          fprintf(stream, "%s,%ld,%ld,%ld,%lu,%ld,%.3f,%.6f,%.6f,%d\n",
+            mode, nbSquidlet, point._nbLoop, point._sizePayload, 
+            point._nbTask, point._nbSample, point._lengthMs, mean, ci, 
+            converged);
+          break;
+        default:
+          fprintf(stream, "%04ld\t%08ld\t%lu\t%ld\t%.3f\t%.6f\t%.6f\t%d\n",
+            point._nbLoop, point._sizePayload, point._nbTask, 
+            point._nbSample, point._lengthMs, mean, ci, converged);
+          break;
+      }
+      fflush(stream);
+    }
   }
 
-  // Free the memory used by the JSON
-  JSONFree(&json);
-  
-  // Return the succes code
-  return true;
+  // Display the footer of the results
+  switch (config->_format) {
+    case SquadBenchmarkFormat_JSON:
+      fprintf(stream, "]}\n");
+      break;
+    case SquadBenchmarkFormat_CSV:
+      break;
+    default:
+      fprintf(stream, "-- Benchmark ended --\n");
+      break;
+  }
+  fflush(stream);
 }
 
-// Decode the JSON info of a Squad from the JSON node 'json'
-bool SquadDecodeAsJSON(
-     Squad* that, 
-  JSONNode* json) {
-
-  // Get the property _squidlets from the JSON
-  JSONNode* prop = JSONProperty(json, "_squidlets");
-  if (prop == NULL) {
-    TheSquidErr->_type = PBErrTypeInvalidData;
-    sprintf(TheSquidErr->_msg, "'_squidlets' not found");
-    return false;
+// Run the benchmark of the protocol between the squad 'that' and its 
+// squidlets with the configuration 'config', and output the result on 
+// the file 'stream' in the format of the configuration
+// The squidlets execute dummy tasks without processing, first on one
+// squidlet, then two, up to all the squidlets of the squad, to 
+// measure the maximum number of tasks per second and the latency of 
+// each phase of the protocol
+// The grids of parameters of the configuration are ignored
+void SquadBenchmarkProtocol(
+                        Squad* const that, 
+  const SquadBenchmarkConfig* const config, 
+                         FILE* const stream) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (config == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'config' is null");
+    PBErrCatch(TheSquidErr);
   }
+  if (stream == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'stream' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
 
   // Get the number of squidlets
-  int nbSquidlet = JSONGetNbValue(prop);
-  
-  // Loop on squidlets
-  for (int iSquidlet = 0; iSquidlet < nbSquidlet; ++iSquidlet) {
+  long nbSquidlet = SquadGetNbSquidlets(that);
+
+  // Display the header of the results
+  switch (config->_format) {
+    case SquadBenchmarkFormat_JSON:
+      fprintf(stream, "{\"mode\":\"protocol\",");
+      SquadBenchmarkConfigPrintJSON(config, stream);
+      fprintf(stream, ",\"results\":[");
+      break;
+    default:
+      if (config->_format == SquadBenchmarkFormat_Text) {
+        fprintf(stream, "-- Protocol benchmark started --\n");
+      }
+      const char* sep = 
+        (config->_format == SquadBenchmarkFormat_CSV ? "," : "\t");
+      fprintf(stream, "nbSquidlet%snbTask%staskPerSec%sciTaskPerSec%s"
+        "converged", sep, sep, sep, sep);
+      for (int iLat = 0; iLat < SquidletTaskPhase_Nb; ++iLat) {
+        const char* lbl = squadBenchmarkLatencyStr[iLat];
+        fprintf(stream, "%s%sP50Us%s%sP90Us%s%sP99Us%s%sMaxUs", 
+          sep, lbl, sep, lbl, sep, lbl, sep, lbl);
+      }
+      fprintf(stream, "\n");
+      break;
+  }
 
-    // Get the JSON node for this squidlet
-    JSONNode* propSquidlet = JSONValue(prop, iSquidlet);
-    
-    // Get the property _name of the squidlet
-    JSONNode* propName = JSONProperty(propSquidlet, "_name");
-    if (propName == NULL) {
-      TheSquidErr->_type = PBErrTypeInvalidData;
-      sprintf(TheSquidErr->_msg, "'_name' not found for squidlet %d",
-        iSquidlet);
-      return false;
-    }
+  // Set aside all the squidlets but one
+  GSet squidletsAside = GSetCreateStatic();
+  while (GSetNbElem(SquadSquidlets(that)) > 1) {
+    GSetAppend(&squidletsAside, GSetPop((GSet*)SquadSquidlets(that)));
+  }
 
-    // Get the property _ip of the squidlet
-    JSONNode* propIp = JSONProperty(propSquidlet, "_ip");
-    if (propIp == NULL) {
-      TheSquidErr->_type = PBErrTypeInvalidData;
-      sprintf(TheSquidErr->_msg, "'_ip' not found for squidlet %d",
-        iSquidlet);
-      return false;
+  // Loop on the number of squidlets
+  unsigned long id = 0;
+  bool flagStop = false;
+  for (long iSquidlet = 1; !flagStop && iSquidlet <= nbSquidlet; 
+    ++iSquidlet) {
+
+    // Add one more squidlet
+    if (iSquidlet > 1) {
+      GSetAppend((GSet*)SquadSquidlets(that), 
+        GSetPop(&squidletsAside));
     }
 
-    // Get the property _port of the squidlet
-    JSONNode* propPort = JSONProperty(propSquidlet, "_port");
-    if (propPort == NULL) {
-      TheSquidErr->_type = PBErrTypeInvalidData;
-      sprintf(TheSquidErr->_msg, "'_port' not found for squidlet %d",
-        iSquidlet);
-      return false;
+    // Measure the throughput and latencies
+    SquadBenchmarkPoint point = {
+      ._sizePayload = 0, ._nbLoop = 0, ._nbTask = 0, ._sum = 0.0, 
+      ._sumSq = 0.0, ._nbSample = 0, ._lengthMs = 0.0, 
+      ._protocol = true};
+    flagStop = !SquadBenchmarkRunPoint(that, config, &point, &id, 
+      stream);
+
+    // Display the result
+    float mean = SquadBenchmarkPointGetMean(&point);
+    float ci = SquadBenchmarkPointGetCI(&point);
+    bool converged = SquadBenchmarkPointIsConverged(&point, config);
+    const float quantiles[3] = {0.5, 0.9, 0.99};
+    switch (config->_format) {
+      case SquadBenchmarkFormat_JSON:
+        fprintf(stream, 
+          "%s{\"nbSquidlet\":\"%ld\",\"nbTask\":\"%lu\","
+          "\"taskPerSec\":\"%.6f\",\"ciTaskPerSec\":\"%.6f\","
+          "\"converged\":\"%d\",\"latencyUs\":{",
+          (iSquidlet > 1 ? "," : ""), iSquidlet, point._nbTask, mean, 
+          ci, converged);
+        for (int iLat = 0; iLat < SquidletTaskPhase_Nb; ++iLat) {
+          const TheSquidHisto* histo = point._latencies + iLat;
+          fprintf(stream, 
+            "%s\"%s\":{\"p50\":\"%.1f\",\"p90\":\"%.1f\","
+            "\"p99\":\"%.1f\",\"max\":\"%.1f\"}", 
+            (iLat > 0 ? "," : ""), squadBenchmarkLatencyStr[iLat], 
+            TheSquidHistoGetQuantile(histo, quantiles[0]), 
+            TheSquidHistoGetQuantile(histo, quantiles[1]), 
+            TheSquidHistoGetQuantile(histo, quantiles[2]), 
+            histo->_max);
+        }
+        fprintf(stream, "}}");
+        break;
+      default:
+        {
+          const char* sep = 
+            (config->_format == SquadBenchmarkFormat_CSV ? "," : "\t");
+          fprintf(stream, "%ld%s%lu%s%.6f%s%.6f%s%d", iSquidlet, sep, 
+            point._nbTask, sep, mean, sep, ci, sep, converged);
+          for (int iLat = 0; iLat < SquidletTaskPhase_Nb; ++iLat) {
+            const TheSquidHisto* histo = point._latencies + iLat;
+            fprintf(stream, "%s%.1f%s%.1f%s%.1f%s%.1f", 
+              sep, TheSquidHistoGetQuantile(histo, quantiles[0]), 
+              sep, TheSquidHistoGetQuantile(histo, quantiles[1]), 
+              sep, TheSquidHistoGetQuantile(histo, quantiles[2]), 
+              sep, histo->_max);
+          }
+          fprintf(stream, "\n");
+        }
+        break;
     }
+    fflush(stream);
+  }
 
-    // Create a SquidletInfo
-    char* name = JSONLblVal(propName);
-    char* ip = JSONLblVal(propIp);
-    int port = atoi(JSONLblVal(propPort));
-    SquidletInfo* squidletInfo = SquidletInfoCreate(name, ip, port);
-    
-    // Add the squidlet to the set of squidlets
-    GSetAppend((GSet*)SquadSquidlets(that), squidletInfo);
+  // Put back the squidlets set aside
+  while (GSetNbElem(&squidletsAside) > 0) {
+    GSetAppend((GSet*)SquadSquidlets(that), GSetPop(&squidletsAside));
   }
 
-  // Return the success code
-  return true;
+  // Display the footer of the results
+  switch (config->_format) {
+    case SquadBenchmarkFormat_JSON:
+      fprintf(stream, "]}\n");
+      break;
+    case SquadBenchmarkFormat_CSV:
+      break;
+    default:
+      fprintf(stream, "-- Protocol benchmark ended --\n");
+      break;
+  }
+  fflush(stream);
 }
 
-// Send the task request 'request' from the Squad 'that' to its
-// Squidlet 'squidlet'
-// Create a socket, open a connection, ask the squidlet if it can 
-// execute the task and wait for its reply
-// Return true if the request has been accepted by the squidlet, 
-// false else
-bool SquadSendTaskRequest(
-                      Squad* const that, 
-  const SquidletTaskRequest* const request, 
-               SquidletInfo* const squidlet) {
+// Print the durations and target of the SquadBenchmarkConfig 'that' 
+// as a JSON property "config" on the file 'stream'
+void SquadBenchmarkConfigPrintJSON(
+  const SquadBenchmarkConfig* const that, 
+                        FILE* const stream) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (request == NULL) {
+  if (stream == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'request' is null");
+    sprintf(TheSquidErr->_msg, "'stream' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (squidlet == NULL) {
+#endif
+  fprintf(stream, 
+    "\"config\":{\"warmUpMs\":\"%.3f\",\"sampleMs\":\"%.3f\","
+    "\"minLengthMs\":\"%.3f\",\"maxLengthMs\":\"%.3f\","
+    "\"targetCI\":\"%.6f\"}", 
+    that->_warmUpMs, that->_sampleMs, that->_minLengthMs, 
+    that->_maxLengthMs, that->_targetCI);
+}
+
+// Measure with the squad 'that' the throughput of the benchmark tasks 
+// for the payload size and number of sorts of 'point' according to 
+// the configuration 'config'. The ids of the tasks are created from 
+// 'id', which is updated
+// Failed tasks are displayed on 'stream'
+// Return false if a task failed, true else
+bool SquadBenchmarkRunPoint(
+                        Squad* const that, 
+  const SquadBenchmarkConfig* const config, 
+          SquadBenchmarkPoint* const point, 
+                unsigned long* const id, 
+                         FILE* const stream) {
+#if BUILDMODE == 0
+  if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'squidlet' is null");
+    sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-#endif
-  // If the requested task is null
-  if (request->_type == SquidletTaskType_Null) {
-
-    // Nothing to do
-    return true;
+  if (config == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'config' is null");
+    PBErrCatch(TheSquidErr);
   }
-  
-  // Close the socket if it was opened
-  if (squidlet->_sock != -1) {
-    close(squidlet->_sock);
-    squidlet->_sock = -1;
+  if (point == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'point' is null");
+    PBErrCatch(TheSquidErr);
   }
-  
-  // Create the socket
-  int protocol = 0;
-  squidlet->_sock = socket(AF_INET, SOCK_STREAM, protocol);
-  
-  // If we couldn't create the socket
-  if (squidlet->_sock == -1) {
-
-    // Update history
-    SquadPushHistory(that, "can't create socket to squidlet:");
-    SquadPushHistorySquidletInfo(that, squidlet);
-
-    // Return the failure code
-    return false;
+  if (id == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'id' is null");
+    PBErrCatch(TheSquidErr);
   }
-  
-  // Create the data for the connection to the squidlet from its
-  // ip and port
-  struct sockaddr_in remote = {0};
-  remote.sin_addr.s_addr = inet_addr(squidlet->_ip);
-  remote.sin_family = AF_INET;
-  remote.sin_port = htons(squidlet->_port);
-
-  // Connect to the squidlet
-  int retConnect = connect(squidlet->_sock, (struct sockaddr*)&remote, 
-    sizeof(struct sockaddr_in));
-
-  // If the connection failed
-  if (retConnect == -1) {
+  if (stream == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'stream' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
 
-    // Close the socket
-    close(squidlet->_sock);
-    squidlet->_sock = -1;
+  // Create a dummy buffer with the size of the payload for the 
+  // execution on the local device
+  char* buffer = PBErrMalloc(TheSquidErr, point->_sizePayload + 1);
+  memset(buffer, ' ', point->_sizePayload);
+  buffer[point->_sizePayload] = '\0';
 
-    // Update history
-    SquadPushHistory(that, "can't connect to squidlet:");
-    SquadPushHistorySquidletInfo(that, squidlet);
+  // Reset the stats of all the squidlets
+  if (SquadGetNbSquidlets(that) > 0)
+    SquadRequestAllSquidletToResetStats(that);
 
-    // Return the failure code
-    return false;
+  // Warm-up phase, the completed tasks are ignored
+  bool success = true;
+  struct timeval start;
+  gettimeofday(&start, NULL);
+  while (success && TheSquidGetElapsedMs(&start) < config->_warmUpMs) {
+    long nbTask = 
+      SquadBenchmarkStep(that, point, buffer, id, stream);
+    success = (nbTask >= 0);
   }
 
-  // Update history
-  SquadPushHistory(that, "connected to squidlet:");
-  SquadPushHistorySquidletInfo(that, squidlet);
+  // Measurement phase
+  for (int iPhase = SquidletTaskPhase_Nb; iPhase--;)
+    TheSquidHistoReset(point->_latencies + iPhase);
+  struct timeval startSample;
+  gettimeofday(&start, NULL);
+  startSample = start;
+  unsigned long nbTaskSample = 0;
+  while (success && !SquadBenchmarkPointIsComplete(point, config)) {
+
+    // Execute tasks
+    long nbTask = 
+      SquadBenchmarkStep(that, point, buffer, id, stream);
+    success = (nbTask >= 0);
+    if (success == true) {
+      nbTaskSample += nbTask;
+      point->_nbTask += nbTask;
+    }
 
-  // Set the timeout of the socket for sending and receiving to 1us
-  // and allow the reuse of address
-  struct timeval tv;
-  tv.tv_sec = 0;
-  tv.tv_usec = 1;
-  int retSnd = setsockopt(squidlet->_sock, SOL_SOCKET, SO_SNDTIMEO, 
-    (char*)&tv, sizeof(tv));
-  int retRcv = setsockopt(squidlet->_sock, SOL_SOCKET, SO_RCVTIMEO, 
-    (char*)&tv, sizeof(tv));
-  int reuse = 1;
-  int retReuse = setsockopt(squidlet->_sock, SOL_SOCKET, SO_REUSEADDR,
-    &reuse,sizeof(int));
-    
-  // If we couldn't configure the socket
-  if (retSnd == -1 || retRcv == -1 || retReuse == -1) {
+    // If the duration of a sample is reached, add the throughput over
+    // this duration to the samples
+    float sampleMs = TheSquidGetElapsedMs(&startSample);
+    if (sampleMs >= config->_sampleMs) {
+      SquadBenchmarkPointAddSample(point, 
+        (float)nbTaskSample * 1000.0 / sampleMs);
+      nbTaskSample = 0;
+      gettimeofday(&startSample, NULL);
+    }
 
-    // Close the socket
-    close(squidlet->_sock);
-    squidlet->_sock = -1;
+    // Update the duration of the measurement
+    point->_lengthMs = TheSquidGetElapsedMs(&start);
+  }
 
-    // Update history
-    SquadPushHistory(that, "failed to configure socket to squidlet:");
-    SquadPushHistorySquidletInfo(that, squidlet);
+  // Flush the remaining tasks to let only the remaining Squidlet
+  // finish their task and avoid starting new ones
+  while (SquadGetNbRemainingTasks(that) > 0) {
+    SquidletTaskRequest* task = GSetPop(&(that->_tasks));
+    SquidletTaskRequestFree(&task);
+  }
 
-    // Return the failure code
-    return false;
+  // Wait for the running tasks, their result is ignored
+  while (SquadGetNbRunningTasks(that) > 0) {
+    GSetSquadRunningTask completedTasks = SquadStep(that);
+    while (GSetNbElem(&completedTasks) > 0L) {
+      SquadRunningTask* completedTask = GSetPop(&completedTasks);
+      SquidletTaskRequestFree(&(completedTask->_request));
+      SquadRunningTaskFree(&completedTask);
+    }
   }
 
-  // Send the task request
-  int flags = 0;
-  int retSend = send(squidlet->_sock, 
-    request, sizeof(SquidletTaskRequest), flags);
-    
-  // If we couldn't send the request
-  if (retSend == -1) {
+  // Free memory
+  free(buffer);
 
-    // Close the socket
-    close(squidlet->_sock);
-    squidlet->_sock = -1;
+  // Return the success code
+  return success;
+}
 
-    // Update history
-    SquadPushHistory(that, "failed to send the request to squidlet:");
-    SquadPushHistorySquidletInfo(that, squidlet);
+// Execute benchmark tasks for the 'point' with the squad 'that'
+// If the squad has no squidlet, execute one task on the local device 
+// with the payload 'buffer'. Else, add tasks to the squad to keep all 
+// its squidlets busy, using 'id' to create their ids, and step it 
+// For the benchmark of the protocol, the tasks are dummy tasks 
+// without processing and their latencies are added to the 'point'
+// Failed tasks are displayed on 'stream'
+// Return the number of completed tasks, or -1 if a task failed
+long SquadBenchmarkStep(
+                Squad* const that, 
+  SquadBenchmarkPoint* const point, 
+           const char* const buffer, 
+        unsigned long* const id, 
+                 FILE* const stream) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (point == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'point' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
 
-    // Return the failure code
-    return false;
+  // Get the number of squidlets
+  long nbSquidlet = 
+    SquadGetNbSquidlets(that) + SquadGetNbRunningTasks(that);
+
+  // If the squad has no squidlet, execute the benchmark function on 
+  // the local device
+  if (nbSquidlet == 0) {
+    TheSquidBenchmark(point->_nbLoop, buffer);
+    return 1;
+  }
+
+  // Create benchmark tasks, twice as many as squidlets to ensure
+  // there is always task ready to send in the SquadStep loop
+  time_t maxWait = 10000;
+  while (SquadGetNbRunningTasks(that) + 
+    SquadGetNbRemainingTasks(that) < 2 * (unsigned long)nbSquidlet) {
+    if (point->_protocol == true) {
+      unsigned long subid = 0;
+      SquidletTaskRequest* task = SquidletTaskRequestCreate(
+        SquidletTaskType_Dummy, (*id)++, subid, "{\"v\":\"0\"}", maxWait);
+      GSetAppend((GSet*)SquadTasks(that), task);
+    } else {
+      SquadAddTask_Benchmark(that, (*id)++, maxWait, point->_nbLoop, 
+        point->_sizePayload);
+    }
   }
 
-  // Wait for the reply from the squidlet up to 5s
-  char reply = THESQUID_TASKREFUSED;
-  time_t maxWait = 5; 
-  bool retRecv = SocketRecv(
-    &(squidlet->_sock), sizeof(reply), &reply, maxWait);
+  // Step the Squad
+  GSetSquadRunningTask completedTasks = SquadStep(that);
+
+  // Loop on completed tasks
+  long nbTask = 0;
+  while (GSetNbElem(&completedTasks) > 0L) {
+
+    // Get the completed task
+    SquadRunningTask* completedTask = GSetPop(&completedTasks);
+    SquidletTaskRequest* task = completedTask->_request;
+
+    // If the task failed
+    if (strstr(task->_bufferResult, "\"success\":\"1\"") == NULL) {
+
+      // Display info and stop the benchmark
+      SquidletTaskRequestPrint(task, stream);
+      fprintf(stream, " failed !!\n");
+      fprintf(stream, "%s\n", task->_bufferResult);
+      nbTask = -1;
+
+    // Else, the task succeeded
+    } else if (nbTask >= 0) {
+      ++nbTask;
+
+      // Update the latencies of the protocol
+      if (point->_protocol == true) {
+        const struct timeval* t = task->_timePhases;
+        for (int iPhase = 0; iPhase < SquidletTaskPhase_Nb; ++iPhase) {
+          int from = (iPhase == 0 ? 
+            SquidletTaskPhase_Connect : iPhase - 1);
+          int to = (iPhase == 0 ? 
+            SquidletTaskPhase_Completed : iPhase);
+          float deltaUs = 
+            (float)(t[to].tv_sec - t[from].tv_sec) * 1000000.0 + 
+            (float)(t[to].tv_usec - t[from].tv_usec);
+          TheSquidHistoAdd(point->_latencies + iPhase, deltaUs);
+        }
+      }
+    }
 
-  // If we couldn't receive the reply or the reply timed out or
-  // the squidlet refused the task
-  if (retRecv == false || reply == THESQUID_TASKREFUSED) {
+    // Free memory
+    SquidletTaskRequestFree(&task);
+    SquadRunningTaskFree(&completedTask);
+  }
 
-    // Close the socket
-    close(squidlet->_sock);
-    squidlet->_sock = -1;
+  // Return the number of completed tasks
+  return nbTask;
+}
 
-    // Update history
-    SquadPushHistory(that, "task refused by squidlet:");
-    SquadPushHistorySquidletInfo(that, squidlet);
+// Add the throughput 'nbTaskPerSec' to the samples of the 'point'
+void SquadBenchmarkPointAddSample(
+  SquadBenchmarkPoint* const that, 
+                 const float nbTaskPerSec) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  that->_sum += nbTaskPerSec;
+  that->_sumSq += nbTaskPerSec * nbTaskPerSec;
+  ++(that->_nbSample);
+}
 
-    // Return the failure code
-    return false;
+// Return the average throughput of the samples of the 'point' 
+float SquadBenchmarkPointGetMean(
+  const SquadBenchmarkPoint* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
   }
+#endif
+  if (that->_nbSample == 0)
+    return 0.0;
+  return that->_sum / (double)(that->_nbSample);
+}
 
-  // Update history
-  SquadPushHistory(that, "request:");
-  SquadPushHistorySquidletTaskRequest(that, request);
-  SquadPushHistory(that, "accepted by squidlet:");
-  SquadPushHistorySquidletInfo(that, squidlet);
+// Return the half-width of the 95% confidence interval of the average
+// throughput of the samples of the 'point' (Student's t distribution)
+// Return 0.0 if there are less than 2 samples
+float SquadBenchmarkPointGetCI(
+  const SquadBenchmarkPoint* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  if (that->_nbSample < 2)
+    return 0.0;
 
-  // Return the success code
-  return true;
+  // Get the unbiased variance of the samples
+  double n = (double)(that->_nbSample);
+  double mean = that->_sum / n;
+  double var = (that->_sumSq - n * mean * mean) / (n - 1.0);
+  if (var < 0.0)
+    var = 0.0;
+
+  // Get the quantile of the Student's t distribution, tabulated for
+  // the small number of degrees of freedom and approximated beyond
+  const double tQuantiles[9] = 
+    {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262};
+  long df = that->_nbSample - 1;
+  double t = (df <= 9 ? tQuantiles[df - 1] : 1.96 + 2.4 / (double)df);
+
+  // Return the half-width
+  return t * sqrt(var / n);
 }
 
-// Add a dummy task uniquely identified by its 'id' to the list of 
-// task to execute by the squad 'that'
-// The task will have a maximum of 'maxWait' seconds to complete from 
-// the time it's accepted by the squidlet or it will be considered
-// as failed
-void SquadAddTask_Dummy(
-         Squad* const that, 
-  const unsigned long id,
-         const time_t maxWait) {
+// Return true if the confidence interval of the throughput of the 
+// 'point' has reached the target of the configuration 'config', 
+// false else
+bool SquadBenchmarkPointIsConverged(
+   const SquadBenchmarkPoint* const that, 
+  const SquadBenchmarkConfig* const config) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
+  if (config == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'config' is null");
+    PBErrCatch(TheSquidErr);
+  }
 #endif
-  // Prepare the data as JSON
-  char buffer[100];
-  memset(buffer, 0, 100);
-  sprintf(buffer, "{\"v\":\"%lu\"}", id);
-  unsigned long subid = 0;
+  if (that->_nbSample < SQUAD_BENCHMARK_MINNBSAMPLE)
+    return false;
+  return (SquadBenchmarkPointGetCI(that) <= 
+    config->_targetCI * SquadBenchmarkPointGetMean(that));
+}
 
-  // Create the new task
-  SquidletTaskRequest* task = SquidletTaskRequestCreate(
-    SquidletTaskType_Dummy, id, subid, buffer, maxWait);
-  
-  // Add the new task to the set of task to execute
-  GSetAppend((GSet*)SquadTasks(that), task);
+// Return true if the measurement of the 'point' is complete 
+// according to the configuration 'config', i.e. if the maximum 
+// duration is reached or if the minimum duration is reached and the 
+// confidence interval has converged, false else
+bool SquadBenchmarkPointIsComplete(
+   const SquadBenchmarkPoint* const that, 
+  const SquadBenchmarkConfig* const config) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (config == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'config' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  if (that->_lengthMs >= config->_maxLengthMs)
+    return true;
+  if (that->_lengthMs < config->_minLengthMs)
+    return false;
+  return SquadBenchmarkPointIsConverged(that, config);
 }
 
-// Add a benchmark task uniquely identified by its 'id' to the list of 
-// task to execute by the squad 'that'
-// The task will have a maximum of 'maxWait' seconds to complete from 
-// the time it's accepted by the squidlet or it will be considered
-// as failed
-// Artificially set the size of the data for the task to 'payloadSize' 
-// bytes
-// The benchmark function used is sorting 'nb' times a set of numbers
-// cf TheSquidBenchmark()
-void SquadAddTask_Benchmark(
-         Squad* const that, 
-  const unsigned long id,
-         const time_t maxWait, 
-   const unsigned int nb, 
-   const unsigned int payloadSize) {
+// Put back the 'task' into the set of task to complete of the Squad 
+// 'that'
+// Failed tasks (by timeout due to there 'maxWait' in 
+// SquadAddTask_xxx() or by failure code from the squidlet in the 
+// result data) are automatically put back into the set of task to 
+// complete
+void SquadTryAgainTask(
+                Squad* const that, 
+  SquidletTaskRequest* const task) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
+  if (task == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'task' is null");
+    PBErrCatch(TheSquidErr);
+  }
 #endif
-  // Create a dummy buffer of length 'payloadSize'
-  char* data = PBErrMalloc(TheSquidErr, payloadSize + 1);
-  memset(data, ' ', payloadSize);
-  data[payloadSize] = '\0';
-
-  // Convert the arguments into strings to get their length
-  char bufferNb[100];
-  sprintf(bufferNb, "%d", nb);
-  int bufferNbLen = strlen(bufferNb);
-  char bufferId[100];
-  sprintf(bufferId, "%ld", id);
-  int bufferIdLen = strlen(bufferId);
-
-  // Get the length of the json data without values
-  int jsonFormatLen = \
-    strlen("{\"id\":\"\",\"nb\":\"\",\"payloadSize\":\"\"}");
-
-  // Get the length of the json data with values
-  int bufferLength = 
-    jsonFormatLen + bufferIdLen + bufferNbLen + strlen(data) + 1;
 
-  // Allocate memory
-  char* buffer = PBErrMalloc(TheSquidErr, bufferLength);
+  // Ensure the result buffer is empty
+  if (task->_bufferResult != NULL) {
+    free(task->_bufferResult);
+    task->_bufferResult = NULL;
+  }
 
-  // Create the JSON data
-  sprintf(buffer, "{\"id\":\"%s\",\"nb\":\"%s\",\"payloadSize\":\"%s\"}", 
-    bufferId, bufferNb, data);
-  free(data);
+  // If the task is a failed range of a sharded neuranet evaluation, 
+  // the user hasn't dropped it and the evaluation goes on
+  bool isRange = false;
+  SquadEvalNNShards* shards = SquadGetEvalNNShards(that, task, &isRange);
+  if (shards != NULL && task->_subId < shards->_nbShard)
+    shards->_failed[task->_subId] = false;
 
-  // Create the new task
-  unsigned long subid = 0;
-  SquidletTaskRequest* task = SquidletTaskRequestCreate(
-    SquidletTaskType_Benchmark, id, subid, buffer, maxWait);
-  free(buffer);
-  
-  // Add the new task to the set of task to execute
+  // Put back the task in the set of task to complete
+  gettimeofday(&(task->_timeQueued), NULL);
   GSetAppend((GSet*)SquadTasks(that), task);
 }
 
-// Add a POV-Ray task uniquely identified by its 'id' to the list of 
-// task to execute by the squad 'that'
-// The task will have a maximum of 'maxWait' seconds to complete from 
-// the time it's accepted by the squidlet or it will be considered
-// as failed
-// The POV-Ray task is described by the POV-Ray ini file 'ini' which 
-// must include at least the following options:
-// Input_File_Name=<script.pov>
-// Width=<width> 
-// Height=<height>
-// Output_File_Name=<image.tga>
-// The output format of the image must be TGA
-// Video are not supported
-// The image is splitted into as many squared fragments as 
-// SquadGetNbSquidlets(that)^2, but the size of the fragment is clipped
-// to [sizeMinFragment, sizeMaxFragment]
-// The size of the fragments are corrected to fit the size of the image
-// if it's not a squared image
-// Fragments are rendered on the squidlets in random order
-// The final image is updated each time a fragment has been
-// rendered
-// The random generator must have been initialised before calling this 
-// function
-void SquadAddTask_PovRay(
-         Squad* const that, 
-  const unsigned long id,
-         const time_t maxWait, 
-    const char* const ini, 
-   const unsigned int sizeMinFragment,
-   const unsigned int sizeMaxFragment) {
+// Add the trace of the execution of the task 'task' by the squidlet at 
+// the address 'addr' (ip:port) to the ring buffer of traces of the 
+// Squad 'that' 
+// 'timePostProcessed' is the time at which the post processing of the 
+// task has ended, or null if it's now 
+// 'completed' is true if the task has been completed, false if the 
+// Squad gave up waiting for it
+void SquadPushTrace(
+                      Squad* const that, 
+  const SquidletTaskRequest* const task, 
+                 const char* const addr, 
+       const struct timeval* const timePostProcessed, 
+                      const bool completed) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (ini == NULL) {
+  if (task == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'ini' is null");
+    sprintf(TheSquidErr->_msg, "'task' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (addr == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'addr' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
-  // Init variables to memorize the dimensions and path of the final 
-  // output image
-  unsigned long width = 0;
-  unsigned long height = 0;
-  char* outImgPath = NULL;
+  // Get the next trace in the ring buffer, overwriting the oldest one
+  SquadTaskTrace* trace = that->_traces + that->_nbTrace % SQUAD_NBTRACE;
+  ++(that->_nbTrace);
+
+  // Copy the data of the task
+  trace->_type = task->_type;
+  trace->_id = task->_id;
+  trace->_subId = task->_subId;
+  snprintf(trace->_squidlet, SQUAD_TRACELENGTHADDR, "%s", addr);
+  trace->_timeQueued = task->_timeQueued;
+  memcpy(trace->_timePhases, task->_timePhases, 
+    sizeof(trace->_timePhases));
+  if (timePostProcessed != NULL)
+    trace->_timePostProcessed = *timePostProcessed;
+  else
+    gettimeofday(&(trace->_timePostProcessed), NULL);
+  trace->_completed = completed;
+}
 
-  // Open the ini file
-  FILE* fp = fopen(ini, "r");
-  
-  // If we couldn't open the ini file
-  if (fp == NULL) {
-    
-    // Report the error
-    TheSquidErr->_type = PBErrTypeInvalidArg;
-    sprintf(TheSquidErr->_msg, "Can't open %s", ini);
+// Export the traces of the last SQUAD_NBTRACE tasks executed by the 
+// Squad 'that' on the file 'stream' in the Chrome trace event format
+// (JSON, viewable in chrome://tracing or Perfetto)
+// Each squidlet is displayed as a thread, on which each task is a 
+// span subdivided into the phases of its lifecycle
+// Return true if the traces could be exported, false else
+bool SquadExportTrace(
+  const Squad* const that, 
+   FILE* const stream) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
-
-  // Else, we could open the ini file
-  } else {
-
-    // Read the ini file line by line
-    char oneLine[THESQUID_MAXPAYLOADSIZE];
-    while(fgets(oneLine, THESQUID_MAXPAYLOADSIZE, fp)) {
-      
-      // If we are on the line defining the width
-      // and there is actually a value for the width
-      if (strstr(oneLine, "Width=") &&
-        strlen(oneLine) > 7) {
-        
-        // Decode the width
-        sscanf(oneLine + 6, "%lu", &width);
-
-      // If we are on the line defining the height
-      // and there is actually a value for the height
-      } else if (strstr(oneLine, "Height=") &&
-        strlen(oneLine) > 8) {
-        
-        // Decode the height
-        sscanf(oneLine + 7, "%lu", &height);
-
-      // If we are on the line defining the path to the output file
-      // and there is actually a value for the path
-      } else if (strstr(oneLine, "Output_File_Name=") &&
-        strlen(oneLine) > 17) {
-        
-        // Copy the path
-        outImgPath = strdup(oneLine + 17);
-
-        // Remove the return line
-        if (outImgPath[strlen(outImgPath) - 1] == '\n') {
-          outImgPath[strlen(outImgPath) - 1] = '\0';
-        }
-
-        // Make sure the output file doesn't exists
-        char* cmd = PBErrMalloc(TheSquidErr, sizeof(char) * 
-          (strlen("rm -f ") + strlen(outImgPath) + 1));
-        sprintf(cmd, "rm -f %s", outImgPath);
-        int ret = system(cmd);
-        free(cmd);
-        (void)ret;
-      }
-    }
-    fclose(fp);
   }
-  
-  // Check arguments
-  if (width == 0 || height == 0 || outImgPath == NULL) {
-    TheSquidErr->_type = PBErrTypeInvalidArg;
-    sprintf(TheSquidErr->_msg, "Can't decode arguments from %s", ini);
+  if (stream == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'stream' is null");
     PBErrCatch(TheSquidErr);
   }
+#endif
+  // Get the number of traces and the index of the oldest one
+  unsigned long nbTrace = MIN(that->_nbTrace, SQUAD_NBTRACE);
+  unsigned long iFirst = that->_nbTrace - nbTrace;
+
+  // Declare a variable to manage the separator between events
+  bool first = true;
+  fprintf(stream, "{\"traceEvents\":[");
+
+  // Loop on the traces from the oldest to the newest
+  for (unsigned long iTrace = 0; iTrace < nbTrace; ++iTrace) {
+    const SquadTaskTrace* trace = 
+      that->_traces + (iFirst + iTrace) % SQUAD_NBTRACE;
+
+    // Get the thread id of the squidlet, i.e. the index of the first 
+    // trace with the same squidlet, and name the thread if it's new
+    int tid = 0;
+    while (tid < (int)iTrace && strcmp(trace->_squidlet, 
+      that->_traces[(iFirst + tid) % SQUAD_NBTRACE]._squidlet) != 0)
+      ++tid;
+    if (tid == (int)iTrace) {
+      fprintf(stream, "%s{\"name\":\"thread_name\",\"ph\":\"M\","
+        "\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", 
+        (first ? "" : ","), tid, trace->_squidlet);
+      first = false;
+    }
 
-  // Get the nb of squidlets, force it to 1 at least to avoid division
-  // by zero
-  unsigned long nbSquidlets = MAX(1, SquadGetNbSquidlets(that));
-
-  // Declare a variable to memorize the size of one fragment
-  unsigned long sizeFrag[2];
-
-  // Get the size of one fragment
-  sizeFrag[0] = 
-    MAX(sizeMinFragment, MIN(sizeMaxFragment, width / nbSquidlets));
-  sizeFrag[1] = 
-    MAX(sizeMinFragment, MIN(sizeMaxFragment, width / nbSquidlets));
-  
-  // Declare a variable to memorize the nb of fragments
-  unsigned long nbFrag[2];
-
-  // Get the nb of fragments
-  nbFrag[0] = width / sizeFrag[0];
-  nbFrag[1] = height / sizeFrag[1];
-
-  // If the size of the image is not dividable we have to had one more
-  // fragment to render the last partial fragment
-  if (sizeFrag[0] * nbFrag[0] < width)
-    ++(nbFrag[0]);
-  if (sizeFrag[1] * nbFrag[1] < height)
-    ++(nbFrag[1]);
-  
-  // Create a temporary GSet where to add the tasks to be able to 
-  // shuffle it independantly of the eventual other task in the Squad
-  // Shuffling the task to render the fragments in random order
-  GSet set = GSetCreateStatic();
-  
-  // Create the tasks for each fragment
-  for (unsigned long i = 0; i < nbFrag[0]; ++i) {
-    for (unsigned long j = 0; j < nbFrag[1]; ++j) {
-
-      // Get the id of the task
-      unsigned long taskId = i * nbFrag[1] + j;
-
-      // Get the coordinates of the fragment
-      // Pov-Ray starts counting at 1, so the top left is (1,1)
-      unsigned long top = j * sizeFrag[1] + 1;
-      unsigned long left = i * sizeFrag[0] + 1;
-      unsigned long bottom = (j + 1) * sizeFrag[1] + 1;
-      if (bottom > height)
-        bottom = height;
-      unsigned long right = (i + 1) * sizeFrag[0] + 1;
-      if (right > width)
-        right = width;
-
-      // Get the name of the output file for this fragment
-      int len = strlen(outImgPath);
-      char* tga = PBErrMalloc(TheSquidErr, len + 6);
-      memset(tga, 0, len + 6);
-      strcpy(tga, outImgPath);
-      sprintf(tga + len - 4, "-%05lu.tga", taskId);
-
-      // Prepare the data as JSON
-      char buffer[THESQUID_MAXPAYLOADSIZE];
-      memset(buffer, 0, THESQUID_MAXPAYLOADSIZE);
-      sprintf(buffer, 
-        "{\"id\":\"%lu\",\"subid\":\"%lu\",\"ini\":\"%s\","
-        "\"tga\":\"%s\",\"top\":\"%lu\",\"left\":\"%lu\","
-        "\"bottom\":\"%lu\",\"right\":\"%lu\",\"width\":\"%lu\","
-        "\"height\":\"%lu\",\"outTga\":\"%s\"}", 
-        id, taskId, ini, tga, top, left, bottom, right, width, height,
-        outImgPath);
-
-      // Add the new task to the set of task to execute
-      SquidletTaskRequest* task = SquidletTaskRequestCreate(
-        SquidletTaskType_PovRay, id, taskId, buffer, maxWait);
-      GSetAppend(&set, task);
+    // Get the end of the task, which is its last reached phase if the
+    // Squad gave up
+    const struct timeval* end = &(trace->_timePostProcessed);
+    if (trace->_completed == false) {
+      for (int iPhase = 0; iPhase < SquidletTaskPhase_Nb; ++iPhase)
+        if (trace->_timePhases[iPhase].tv_sec != 0)
+          end = trace->_timePhases + iPhase;
+    }
 
-      // Free memory
-      free(tga);
+    // Print the span of the whole task
+    const char* cat = SquidletTaskTypeName(trace->_type);
+    char name[100];
+    sprintf(name, "%s %lu/%lu%s", cat, trace->_id, trace->_subId, 
+      (trace->_completed ? "" : " (gave up)"));
+    SquadPrintTraceEvent(stream, name, cat, tid, 
+      &(trace->_timeQueued), end, &first);
+
+    const struct timeval* t = trace->_timePhases;
+
+    // Print the spans of the phases of the lifecycle
+    SquadPrintTraceEvent(stream, "queued", cat, tid, 
+      &(trace->_timeQueued), t + SquidletTaskPhase_Connect, &first);
+    SquadPrintTraceEvent(stream, "connect", cat, tid, 
+      t + SquidletTaskPhase_Connect, t + SquidletTaskPhase_Connected, 
+      &first);
+    SquadPrintTraceEvent(stream, "request", cat, tid, 
+      t + SquidletTaskPhase_Connected, t + SquidletTaskPhase_Accepted, 
+      &first);
+    SquadPrintTraceEvent(stream, "send data", cat, tid, 
+      t + SquidletTaskPhase_Accepted, t + SquidletTaskPhase_DataSent, 
+      &first);
+    if (trace->_completed == true) {
+      // The processing span lasts from the end of the data sending 
+      // to the reception of the result size, the processing time is 
+      // not reported anymore by the squidlet in the result
+      SquadPrintTraceEvent(stream, "process", cat, tid, 
+        t + SquidletTaskPhase_DataSent, t + SquidletTaskPhase_ResultSize, 
+        &first);
+      SquadPrintTraceEvent(stream, "receive result", cat, tid, 
+        t + SquidletTaskPhase_ResultSize, 
+        t + SquidletTaskPhase_Completed, &first);
+      SquadPrintTraceEvent(stream, "post process", cat, tid, 
+        t + SquidletTaskPhase_Completed, &(trace->_timePostProcessed), 
+        &first);
     }
   }
+  fprintf(stream, "],\"displayTimeUnit\":\"ms\"}\n");
 
-  // Shuffle the task and add them to the set of tasks
-  GSetShuffle(&set);
-  GSetAppendSet((GSet*)SquadTasks(that), &set);
-  
-  // Free memory
-  GSetFlush(&set);
-  free(outImgPath);
-
+  // Return the success code
+  return (ferror(stream) == 0);
 }
 
-// Add a neuranet evaluation task uniquely identified by its 'id' to
-// the list of task to execute by the squad 'that'
-// The task will have a maximum of 'maxWait' seconds to complete from 
-// the time it's accepted by the squidlet or it will be considered
-// as failed
-void SquadAddTask_EvalNeuraNet(
-         Squad* const that, 
-  const unsigned long id,
-         const time_t maxWait,
-    const char* const datasetPath,
-    const char* const workingDirPath,
- const VecLong* const nnids,
-          const float curBest,
-           const long cat) {
+// Print on the file 'stream' the Chrome trace event of the span 
+// 'name' of the category 'cat', on the thread 'tid', from 'start' to 
+// 'end' (skipped if one of them is null), preceded by a comma if 
+// '*first' is false. '*first' is then set to false
+void SquadPrintTraceEvent(
+                  FILE* const stream, 
+             const char* const name, 
+             const char* const cat, 
+                     const int tid, 
+  const struct timeval* const start, 
+  const struct timeval* const end, 
+                    bool* const first) {
 #if BUILDMODE == 0
-  if (that == NULL) {
+  if (stream == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'stream' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (start == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'that' is null");
+    sprintf(TheSquidErr->_msg, "'start' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (end == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'end' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
-  // Prepare the data as JSON
-  unsigned long subid = 0;
-  char nnidsStr[THESQUID_MAXPAYLOADSIZE];
-  JSONNode* json = VecEncodeAsJSON(nnids);
-  JSONSaveToStr(json, nnidsStr, THESQUID_MAXPAYLOADSIZE, true);
-  char buffer[THESQUID_MAXPAYLOADSIZE];
-  JSONFree(&json);
-  memset(buffer, 0, THESQUID_MAXPAYLOADSIZE);
-  sprintf(buffer, 
-    "{\"id\":\"%lu\",\"subid\":\"%lu\",\"dataset\":\"%s\","
-    "\"workingDir\":\"%s\",\"nnids\":%s,\"best\":\"%f\","
-    "\"cat\":\"%ld\"}", 
-    id, subid, datasetPath, workingDirPath, nnidsStr, curBest, cat);
+  // If one of the time is not reached, there is nothing to print
+  if (start->tv_sec == 0 || end->tv_sec == 0)
+    return;
 
-  // Create the new task
-  SquidletTaskRequest* task = SquidletTaskRequestCreate(
-    SquidletTaskType_EvalNeuranet, id, subid, buffer, maxWait);
-  
-  // Add the new task to the set of task to execute
-  GSetAppend((GSet*)SquadTasks(that), task);
+  // Print the event with time in microseconds
+  double ts = (double)(start->tv_sec) * 1000000.0 + 
+    (double)(start->tv_usec);
+  double dur = (double)(end->tv_sec - start->tv_sec) * 1000000.0 + 
+    (double)(end->tv_usec - start->tv_usec);
+  fprintf(stream, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+    "\"ts\":%.0f,\"dur\":%.0f,\"pid\":1,\"tid\":%d}", 
+    (*first ? "" : ","), name, cat, ts, MAX(0.0, dur), tid);
+  *first = false;
 }
 
-// Send a request from the Squad 'that' to reset the stats of the
-// Squidlet 'squidlet'
-// Return true if the request was successfull, else false
-bool SquadRequestSquidletToResetStats(
-         Squad* const that, 
-  SquidletInfo* const squidlet) {
+// Print the statistics about the currently available Squidlets of 
+// the Squad 'that' on the 'stream'
+void SquadPrintStatsSquidlets(
+  const Squad* const that, 
+         FILE* const stream) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (squidlet == NULL) {
+  if (stream == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'squidlet' is null");
+    sprintf(TheSquidErr->_msg, "'stream' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
 
-    // Prepare the data as JSON
-    char* buffer = "{\"id\":\"0\"}";
-    
-    // Create the task
-    unsigned long id = 0;
-    unsigned long subId = 0;
-    time_t maxWait = 60;
-    SquidletTaskRequest* task = SquidletTaskRequestCreate(
-      SquidletTaskType_ResetStats, id, subId, buffer, maxWait);
+  // If there are currently available squidlets
+  if (SquadGetNbSquidlets(that) > 0) {
 
-    // Request the execution of the task by the squidlet
-    bool ret = SquadSendTaskRequest(that, task, squidlet);
-    if (ret) {
+    // Declare a variable to merge the stats of all the squidlets
+    SquidletInfoStats statsAll;
+    SquidletInfoStatsInit(&statsAll);
 
-      // If the squidlet accepted to execute the task
-      ret = SquadSendTaskData(that, squidlet, task);
-    }
+    // Loop on the squidlets
+    GSetIterForward iter = 
+      GSetIterForwardCreateStatic(SquadSquidlets(that));
+    do {
 
-    // Free memory
-    free(task);
-    
-    // Return the success of the request
-    return ret;
+      // Get the squidlet
+      SquidletInfo* squidlet = GSetIterGet(&iter);
+
+      // Print the stats about this squidlet
+      fprintf(stream, " --- ");
+      SquidletInfoPrint(squidlet, stream);
+      fprintf(stream, " --- \n");
+      fprintf(stream, "health: %s, consecutive failures: %u, ", 
+        squidletHealthStr[SquidletInfoGetHealth(squidlet)], 
+        squidlet->_nbFailure);
+      fprintf(stream, "capacity: %lu\n", squidlet->_capacity);
+      SquidletInfoStatsPrintln(SquidletInfoStatistics(squidlet), stream);
+      SquidletInfoStatsMerge(&statsAll, SquidletInfoStatistics(squidlet));
+    } while (GSetIterStep(&iter));
+
+    // Print the stats over all the squidlets
+    fprintf(stream, " --- all squidlets --- \n");
+    SquidletInfoStatsPrintln(&statsAll, stream);
+  }
 }
-  
-// Send a request from the Squad 'that' to reset the stats of all its
-// non-busy Squidlets
-// Return true if all the request were successfull, else false
-bool SquadRequestAllSquidletToResetStats(
-  Squad* const that) {
+
+// Print the metrics of the Squad 'that' and the statistics of its 
+// squidlets (available or running a task) on the 'stream' in the 
+// Prometheus text format
+void SquadPrintMetrics(
+  const Squad* const that, 
+         FILE* const stream) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
+  if (stream == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'stream' is null");
+    PBErrCatch(TheSquidErr);
+  }
 #endif
+  // Print the gauges about the tasks and squidlets
+  TheSquidPrintMetricHeader(stream, "thesquid_squad_tasks_queued", 
+    "gauge", "Number of tasks waiting for a squidlet");
+  fprintf(stream, "thesquid_squad_tasks_queued %lu\n", 
+    SquadGetNbRemainingTasks(that));
+  TheSquidPrintMetricHeader(stream, "thesquid_squad_tasks_running", 
+    "gauge", "Number of tasks under execution");
+  fprintf(stream, "thesquid_squad_tasks_running %lu\n", 
+    SquadGetNbRunningTasks(that));
+  TheSquidPrintMetricHeader(stream, "thesquid_squad_squidlets_available",
+    "gauge", "Number of squidlets not executing a task");
+  fprintf(stream, "thesquid_squad_squidlets_available %lu\n", 
+    SquadGetNbSquidlets(that));
 
-  // Declare a variable to memorize if all the requests were successfull
-  bool flag = true;
-  
-  // If the Squad has non-busy squidlets
+  // Get all the squidlets, the available ones and the ones executing 
+  // a task, and their labels
+  unsigned long nbSquidlet = 
+    SquadGetNbSquidlets(that) + SquadGetNbRunningTasks(that);
+  if (nbSquidlet == 0)
+    return;
+  const SquidletInfo** squidlets = 
+    PBErrMalloc(TheSquidErr, sizeof(SquidletInfo*) * nbSquidlet);
+  char (*labels)[200] = 
+    PBErrMalloc(TheSquidErr, sizeof(char[200]) * nbSquidlet);
+  unsigned long iSquidlet = 0;
   if (SquadGetNbSquidlets(that) > 0) {
-
-    // Loop on the squidlets
     GSetIterForward iter = 
       GSetIterForwardCreateStatic(SquadSquidlets(that));
     do {
-
-      // Get the current quidlet
-      SquidletInfo* squidlet = GSetIterGet(&iter);
-
-      // Request the reset of the stats of this squidlet
-      // and update the flag with the returned flag
-      flag &= SquadRequestSquidletToResetStats(that, squidlet);
-
+      squidlets[iSquidlet++] = GSetIterGet(&iter);
+    } while (GSetIterStep(&iter));
+  }
+  if (SquadGetNbRunningTasks(that) > 0) {
+    GSetIterForward iter = 
+      GSetIterForwardCreateStatic(SquadRunningTasks(that));
+    do {
+      squidlets[iSquidlet++] = 
+        ((SquadRunningTask*)GSetIterGet(&iter))->_squidlet;
     } while (GSetIterStep(&iter));
   }
+  for (iSquidlet = 0; iSquidlet < nbSquidlet; ++iSquidlet) {
+    snprintf(labels[iSquidlet], 200, "squidlet=\"%s\",addr=\"%s:%d\"", 
+      squidlets[iSquidlet]->_name, squidlets[iSquidlet]->_ip, 
+      squidlets[iSquidlet]->_port);
+  }
+
+  // Print the thermal state of the squidlets
+  TheSquidPrintMetricHeader(stream, 
+    "thesquid_squidlet_thermal_state", "gauge", 
+    "Thermal state of the squidlet (0: cool, 1: warm, 2: hot)");
+  for (iSquidlet = 0; iSquidlet < nbSquidlet; ++iSquidlet) {
+    fprintf(stream, "thesquid_squidlet_thermal_state{%s} %d\n", 
+      labels[iSquidlet], 
+      SquadGetSquidletThermalState(that, squidlets[iSquidlet]));
+  }
+
+  // Print the health of the squidlets
+  TheSquidPrintMetricHeader(stream, 
+    "thesquid_squidlet_health", "gauge", 
+    "State of the circuit breaker of the squidlet (0: closed, 1: open, "
+    "2: half open)");
+  for (iSquidlet = 0; iSquidlet < nbSquidlet; ++iSquidlet) {
+    fprintf(stream, "thesquid_squidlet_health{%s} %d\n", 
+      labels[iSquidlet], SquidletInfoGetHealth(squidlets[iSquidlet]));
+  }
+  TheSquidPrintMetricHeader(stream, 
+    "thesquid_squidlet_consecutive_failures", "gauge", 
+    "Number of consecutive failures to send a task to the squidlet");
+  for (iSquidlet = 0; iSquidlet < nbSquidlet; ++iSquidlet) {
+    fprintf(stream, "thesquid_squidlet_consecutive_failures{%s} %u\n", 
+      labels[iSquidlet], squidlets[iSquidlet]->_nbFailure);
+  }
+
+  // Print the counters reported by the squidlets
+  TheSquidPrintMetricHeader(stream,  
+    "thesquid_squidlet_tasks_completed_total", "counter", 
+    "Number of tasks completed by the squidlet");
+  for (iSquidlet = 0; iSquidlet < nbSquidlet; ++iSquidlet) {
+    fprintf(stream, "thesquid_squidlet_tasks_completed_total{%s} %lu\n",
+      labels[iSquidlet], squidlets[iSquidlet]->_stats._nbTaskComplete);
+  }
+  TheSquidPrintMetricHeader(stream, 
+    "thesquid_squidlet_failures_total", "counter", 
+    "Number of failures of the protocol by cause");
+  for (iSquidlet = 0; iSquidlet < nbSquidlet; ++iSquidlet) {
+    const SquidletInfoStats* stats = &(squidlets[iSquidlet]->_stats);
+    const char* format = 
+      "thesquid_squidlet_failures_total{%s,cause=\"%s\"} %lu\n";
+    fprintf(stream, format, labels[iSquidlet], "refused_task", 
+      stats->_nbRefusedTask);
+    fprintf(stream, format, labels[iSquidlet], "recv_task_size", 
+      stats->_nbFailedReceptTaskSize);
+    fprintf(stream, format, labels[iSquidlet], "recv_task_data", 
+      stats->_nbFailedReceptTaskData);
+    fprintf(stream, format, labels[iSquidlet], "send_result_size", 
+      stats->_nbFailedSendResultSize);
+    fprintf(stream, format, labels[iSquidlet], "send_result", 
+      stats->_nbFailedSendResult);
+    fprintf(stream, format, labels[iSquidlet], "recv_ack", 
+      stats->_nbFailedReceptAck);
+  }
+
+  // Print the counters of transferred bytes
+  TheSquidPrintMetricHeader(stream, 
+    "thesquid_squidlet_task_bytes_total", "counter", 
+    "Number of bytes of task data sent to the squidlet");
+  for (iSquidlet = 0; iSquidlet < nbSquidlet; ++iSquidlet) {
+    fprintf(stream, "thesquid_squidlet_task_bytes_total{%s} %lu\n",
+      labels[iSquidlet], squidlets[iSquidlet]->_stats._nbByteSent);
+  }
+  TheSquidPrintMetricHeader(stream, 
+    "thesquid_squidlet_result_bytes_total", "counter", 
+    "Number of bytes of result received from the squidlet");
+  for (iSquidlet = 0; iSquidlet < nbSquidlet; ++iSquidlet) {
+    fprintf(stream, "thesquid_squidlet_result_bytes_total{%s} %lu\n",
+      labels[iSquidlet], squidlets[iSquidlet]->_stats._nbByteReceived);
+  }
+
+  // Print the histograms
+  TheSquidPrintMetricHeader(stream, 
+    "thesquid_squidlet_process_time_ms", "histogram", 
+    "Time to process a task, per type of task");
+  for (iSquidlet = 0; iSquidlet < nbSquidlet; ++iSquidlet) {
+    const SquidletInfoStats* stats = &(squidlets[iSquidlet]->_stats);
+    for (int iType = 0; iType < SquidletTaskType_Nb; ++iType) {
+      if (stats->_timeToProcessMsPerType[iType]._nb > 0) {
+        char label[250];
+        sprintf(label, "%s,type=\"%s\"", labels[iSquidlet], 
+          squidletTaskTypeStr[iType]);
+        TheSquidHistoPrintPrometheus(
+          stats->_timeToProcessMsPerType + iType, 
+          "thesquid_squidlet_process_time_ms", label, stream);
+      }
+    }
+  }
+  TheSquidPrintMetricHeader(stream, 
+    "thesquid_squidlet_temperature_celsius", "histogram", 
+    "Temperature of the squidlet when completing a task");
+  for (iSquidlet = 0; iSquidlet < nbSquidlet; ++iSquidlet) {
+    TheSquidHistoPrintPrometheus(
+      &(squidlets[iSquidlet]->_stats._temperature), 
+      "thesquid_squidlet_temperature_celsius", labels[iSquidlet], 
+      stream);
+  }
+  TheSquidPrintMetricHeader(stream, 
+    "thesquid_squidlet_transfer_us_per_kb", "histogram", 
+    "Time to transfer one kilobyte between the squad and the squidlet");
+  for (iSquidlet = 0; iSquidlet < nbSquidlet; ++iSquidlet) {
+    const SquidletInfoStats* stats = &(squidlets[iSquidlet]->_stats);
+    char label[250];
+    sprintf(label, "%s,direction=\"squad_to_squidlet\"", 
+      labels[iSquidlet]);
+    TheSquidHistoPrintPrometheus(&(stats->_timeTransferSquadSquidUsPerKB),
+      "thesquid_squidlet_transfer_us_per_kb", label, stream);
+    sprintf(label, "%s,direction=\"squidlet_to_squad\"", 
+      labels[iSquidlet]);
+    TheSquidHistoPrintPrometheus(&(stats->_timeTransferSquidSquadUsPerKB),
+      "thesquid_squidlet_transfer_us_per_kb", label, stream);
+  }
 
-  // Return the flag memorizing if all the requests were successfull
-  return flag;
+  // Free memory
+  free(squidlets);
+  free(labels);
 }
 
-// Send the data associated to the task request 'task' from the Squad 
-// 'that' to the Squidlet 'squidlet'
-// First, send the size in byte of the data, then send the data
-// Return true if the data could be sent, false else
-// The size of the data must be less than THESQUID_MAXPAYLOADSIZE bytes
-bool SquadSendTaskData(
-                Squad* const that, 
-         SquidletInfo* const squidlet, 
-  SquidletTaskRequest* const task) {
+// Open the endpoint serving the metrics of the Squad 'that' over HTTP 
+// on the port 'port'. The scrapes are served during SquadStep 
+// Return true if the endpoint could be opened, false else or if 'that' 
+// is multithreaded
+bool SquadSetMetricsPort(
+  Squad* const that, 
+   const int port) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (squidlet == NULL) {
+#endif
+  // The squidlets of the shards are not visible from 'that'
+  if (that->_shards != NULL) {
+    TheSquidErr->_type = PBErrTypeInvalidArg;
+    sprintf(TheSquidErr->_msg, "the metrics can't be used with threads");
+    return false;
+  }
+
+  // Close the current endpoint if any and open the new one
+  TheSquidMetricsFree(&(that->_metrics));
+  that->_metrics = TheSquidMetricsCreate(port);
+
+  // Return the success code
+  return (that->_metrics != NULL);
+}
+
+// Open the binary log of the events of the Squad 'that' in the file 
+// at 'path', or close it if 'path' is null 
+// Return true if the log could be opened, false else or if 'that' is 
+// multithreaded
+bool SquadSetEventLog(
+        Squad* const that, 
+  const char* const path) {
+#if BUILDMODE == 0
+  if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'squidlet' is null");
+    sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (task == NULL) {
+#endif
+  // The tasks executed by the shards are not visible from 'that'
+  if (path != NULL && that->_shards != NULL) {
+    TheSquidErr->_type = PBErrTypeInvalidArg;
+    sprintf(TheSquidErr->_msg, "the event log can't be used with threads");
+    return false;
+  }
+
+  // Close the current log if any and open the new one
+  TheSquidEventLogFree(&(that->_eventLog));
+  if (path != NULL)
+    that->_eventLog = TheSquidEventLogCreate(path, "squad");
+
+  // Return the success code
+  return (path == NULL || that->_eventLog != NULL);
+}
+
+// Push the event of type 'type' for the task 'task' on the squidlet 
+// 'squidlet' with the value 'value' in the event log of the Squad 
+// 'that', if any
+void SquadLogEvent(
+                      Squad* const that, 
+          const TheSquidEventType type, 
+  const SquidletTaskRequest* const task, 
+         const SquidletInfo* const squidlet, 
+             const unsigned long value) {
+  if (that->_eventLog != NULL) {
+    TheSquidEventLogPush(that->_eventLog, type, task->_type, task->_id, 
+      task->_subId, (uint16_t)(squidlet->_port), value);
+  }
+}
+
+// Receive the announces of the squidlets on the UDP port 'port' and 
+// add or remove them from the Squad 'that' at runtime, during 
+// SquadStep. Stop the discovery if 'port' is negative 
+// Return true if the port could be opened, false else
+bool SquadSetDiscoveryPort(
+  Squad* const that, 
+   const int port) {
+#if BUILDMODE == 0
+  if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'task' is null");
+    sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
+  // Close the current socket if any
+  if (that->_fdDiscovery != -1) {
+    close(that->_fdDiscovery);
+    that->_fdDiscovery = -1;
+  }
 
-  // Send the task data size
-  int flags = 0;
-  size_t len = strlen(task->_data);
-  int ret = send(squidlet->_sock, (char*)&len, sizeof(size_t), flags);
-  
-  // If we couldn't send the data size
-  if (ret == -1) {
-
-    // Update history
-    SquadPushHistory(that, "couldn't send task data size %d", len);
+  // If the discovery is stopped, nothing else to do
+  if (port < 0)
+    return true;
 
+  // Open the socket
+  that->_fdDiscovery = socket(AF_INET, SOCK_DGRAM, 0);
+  if (that->_fdDiscovery == -1) {
+    sprintf(TheSquidErr->_msg, "socket() failed");
     return false;
+  }
 
-  // Else, we could send the data size
-  } else {
+  // Make the socket non blocking, so that the announces can be polled 
+  // at each step
+  int reuse = 1;
+  int flags = fcntl(that->_fdDiscovery, F_GETFL, 0);
+  bool ret = (flags != -1 && 
+    fcntl(that->_fdDiscovery, F_SETFL, flags | O_NONBLOCK) != -1);
+  ret &= (setsockopt(that->_fdDiscovery, SOL_SOCKET, SO_REUSEADDR, 
+    &reuse, sizeof(int)) != -1);
+
+  // Bind the socket on the requested port of all the interfaces
+  struct sockaddr_in sock;
+  memset(&sock, 0, sizeof(struct sockaddr_in));
+  sock.sin_family = AF_INET;
+  sock.sin_addr.s_addr = htonl(INADDR_ANY);
+  sock.sin_port = htons(port);
+  ret = ret && (bind(that->_fdDiscovery, (struct sockaddr *)&sock, 
+    sizeof(struct sockaddr_in)) != -1);
+
+  // If we couldn't setup the socket
+  if (ret == false) {
+    close(that->_fdDiscovery);
+    that->_fdDiscovery = -1;
+    sprintf(TheSquidErr->_msg, "couldn't bind on port %d", port);
+    return false;
+  }
 
-    // Update history
-    SquadPushHistory(that, "sent task data size %d to squidlet:", len);
-    SquadPushHistorySquidletInfo(that, squidlet);
+  // Return the success code
+  return true;
+}
 
+// Split the squidlets of the Squad 'that' into 'nbThread' shards, each 
+// stepped by its own thread which does the I/O with its squidlets, 
+// receives their results and updates their statistics. SquadStep 
+// hands the tasks to the shards and returns the tasks they have 
+// completed, after post processing them. 'nbThread' lower than 2 
+// stops the threads and gives back the squidlets to 'that' 
+// The squidlets of the shards are not available to the other 
+// functions of the Squad until the threads are stopped, and the 
+// shards get the stats period, thermal thresholds and send file flag 
+// of 'that' when they are created. The tasks returned by SquadStep 
+// have no squidlet, and the traces of the tasks the shards gave up 
+// are not recorded by 'that'. The metrics and the event log 
+// would miss the squidlets and tasks of the shards, they can't be 
+// used at the same time 
+// Return true if the threads could be created, false else or if 
+// there are tasks running, or the metrics or event log are used
+bool SquadSetNbThread(
+                Squad* const that, 
+  const unsigned int nbThread) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // The squidlets can't be moved while they are executing tasks
+  if (SquadGetNbRunningTasks(that) > 0L || that->_nbShardedTask > 0L) {
+    TheSquidErr->_type = PBErrTypeInvalidArg;
+    sprintf(TheSquidErr->_msg, "there are running tasks");
+    return false;
   }
 
-  // Memorize the start time for the statistics
-  struct timeval start;
-  gettimeofday(&start, NULL);
+  // The metrics and the event log only see the squidlets and tasks of 
+  // 'that', not the ones of the shards
+  if (nbThread > 1 && (that->_metrics != NULL || 
+    that->_eventLog != NULL)) {
+    TheSquidErr->_type = PBErrTypeInvalidArg;
+    sprintf(TheSquidErr->_msg, 
+      "the metrics and event log can't be used with threads");
+    return false;
+  }
 
-  // Send the task data
-  ret = send(squidlet->_sock, task->_data, len, flags);
+  // Stop the current threads if any
+  SquadStopShards(that);
 
-  // If we couldn't send the data
-  if (ret == -1) {
+  // There is no need for more threads than squidlets
+  unsigned int nbShard = 
+    MIN(nbThread, (unsigned int)SquadGetNbSquidlets(that));
+  if (nbShard < 2)
+    return true;
 
-    // Update history
-    SquadPushHistory(that, "couldn't send task data");
+  // Create the shards
+  that->_shards = PBErrMalloc(TheSquidErr, sizeof(SquadShard*) * nbShard);
+  for (unsigned int iShard = 0; iShard < nbShard; ++iShard) {
+    SquadShard* shard = PBErrMalloc(TheSquidErr, sizeof(SquadShard));
+    shard->_squad = SquadCreate();
+    if (shard->_squad == NULL) {
+      free(shard);
+      for (unsigned int jShard = 0; jShard < iShard; ++jShard) {
+        shard = that->_shards[jShard];
+        SquadFree(&(shard->_squad));
+        pthread_cond_destroy(&(shard->_cond));
+        pthread_mutex_destroy(&(shard->_mutex));
+        free(shard);
+      }
+      free(that->_shards);
+      that->_shards = NULL;
+      sprintf(TheSquidErr->_msg, "couldn't create the Squad of a shard");
+      return false;
+    }
 
+    // The results are returned as is by the Squad of the shard and 
+    // post processed by the thread calling SquadStep
+    shard->_squad->_flagRelay = true;
+    shard->_squad->_statsPeriod = that->_statsPeriod;
+    shard->_squad->_thermalSoft = that->_thermalSoft;
+    shard->_squad->_thermalHard = that->_thermalHard;
+    shard->_squad->_thermalHorizon = that->_thermalHorizon;
+    shard->_squad->_flagSendFile = that->_flagSendFile;
+    shard->_parent = that;
+    shard->_stop = false;
+    shard->_inbox = GSetSquidletTaskRequestCreateStatic();
+    shard->_capacity = 0;
+    shard->_nbPending = 0;
+    pthread_mutex_init(&(shard->_mutex), NULL);
+    pthread_cond_init(&(shard->_cond), NULL);
+    that->_shards[iShard] = shard;
+  }
+
+  // Distribute the squidlets among the shards
+  unsigned int iShard = 0;
+  while (SquadGetNbSquidlets(that) > 0L) {
+    SquidletInfo* squidlet = GSetPop((GSet*)SquadSquidlets(that));
+    SquadShard* shard = that->_shards[iShard];
+    GSetAppend((GSet*)SquadSquidlets(shard->_squad), squidlet);
+    shard->_capacity += squidlet->_capacity;
+    iShard = (iShard + 1) % nbShard;
+  }
+
+  // Start the threads with all the signals blocked, to leave their 
+  // handling (Ctrl-C) to the thread of the caller
+  sigset_t set;
+  sigset_t prevSet;
+  sigfillset(&set);
+  pthread_sigmask(SIG_SETMASK, &set, &prevSet);
+  bool ret = true;
+  for (iShard = 0; iShard < nbShard && ret == true; ++iShard) {
+    SquadShard* shard = that->_shards[iShard];
+    ret = (pthread_create(&(shard->_thread), NULL, SquadShardRun, 
+      shard) == 0);
+    if (ret == true)
+      that->_nbThread = iShard + 1;
+  }
+  pthread_sigmask(SIG_SETMASK, &prevSet, NULL);
+
+  // If we couldn't create all the threads, stop the created ones and 
+  // give back the squidlets
+  if (ret == false) {
+    for (iShard = that->_nbThread; iShard < nbShard; ++iShard) {
+      SquadShard* shard = that->_shards[iShard];
+      while (SquadGetNbSquidlets(shard->_squad) > 0L) {
+        GSetAppend((GSet*)SquadSquidlets(that), 
+          GSetPop((GSet*)SquadSquidlets(shard->_squad)));
+      }
+      SquadFree(&(shard->_squad));
+      pthread_cond_destroy(&(shard->_cond));
+      pthread_mutex_destroy(&(shard->_mutex));
+      free(shard);
+    }
+    SquadStopShards(that);
+    sprintf(TheSquidErr->_msg, "pthread_create() failed");
     return false;
+  }
 
-  // Else, we could send the data
-  } else {
+  // Update history
+  SquadPushHistory(that, "started %u threads", that->_nbThread);
 
-    // Get the time to send the data
-    struct timeval stop;
-    gettimeofday(&stop, NULL);
-    float deltams = (float)(stop.tv_sec - start.tv_sec) * 1000.0 + 
-      (float)(stop.tv_usec - start.tv_usec) / 1000.0;
+  // Return the success code
+  return true;
+}
 
-    // Update the stats about transfer time
-    SquidletInfoStatsUpdateTimeTransfer(
-      (SquidletInfoStats*)SquidletInfoStatistics(squidlet),
-      deltams, len);
+// Main function of the thread of the SquadShard 'arg', step its Squad 
+// with the tasks handed by the parent Squad and push the completed 
+// ones in the queue of the parent, until it is stopped
+void* SquadShardRun(
+  void* arg) {
+  SquadShard* that = arg;
+  pthread_mutex_lock(&(that->_mutex));
+  while (that->_stop == false) {
+
+    // Take the tasks handed by the parent Squad
+    while (GSetNbElem(&(that->_inbox)) > 0) {
+      GSetAppend((GSet*)SquadTasks(that->_squad), 
+        GSetPop(&(that->_inbox)));
+    }
+
+    // Step the Squad of the shard without holding the mutex, and 
+    // return the completed tasks to the parent Squad
+    pthread_mutex_unlock(&(that->_mutex));
+    GSetSquadRunningTask completedTasks = SquadStep(that->_squad);
+    while (GSetNbElem(&completedTasks) > 0) {
+      SquadRunningTask* task = GSetPop(&completedTasks);
+      __atomic_fetch_sub(&(that->_nbPending), 1, __ATOMIC_RELEASE);
+      bool processed = false;
+      SquadPushCompletedTask(that->_parent, task, processed);
+    }
+    pthread_mutex_lock(&(that->_mutex));
+
+    // Wait for new tasks, the stop signal, or the period to step again 
+    // the running tasks and send the stats heartbeats
+    if (that->_stop == false && GSetNbElem(&(that->_inbox)) == 0) {
+      struct timespec deadline;
+      clock_gettime(CLOCK_REALTIME, &deadline);
+      deadline.tv_nsec += SQUAD_THREADSTEPPERIOD * 1000000L;
+      if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec += 1;
+        deadline.tv_nsec -= 1000000000L;
+      }
+      pthread_cond_timedwait(&(that->_cond), &(that->_mutex), 
+        &deadline);
+    }
+  }
+  pthread_mutex_unlock(&(that->_mutex));
+  return NULL;
+}
+
+// Stop the threads of the shards of the Squad 'that', give back their 
+// squidlets to 'that' and their tasks not yet completed to the set of 
+// tasks of 'that'
+void SquadStopShards(
+  Squad* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // If the Squad is not multithreaded, there is nothing to do
+  if (that->_shards == NULL)
+    return;
+
+  // Loop on the shards
+  for (unsigned int iShard = 0; iShard < that->_nbThread; ++iShard) {
+    SquadShard* shard = that->_shards[iShard];
+
+    // Stop the thread and wait for it
+    pthread_mutex_lock(&(shard->_mutex));
+    shard->_stop = true;
+    pthread_cond_signal(&(shard->_cond));
+    pthread_mutex_unlock(&(shard->_mutex));
+    pthread_join(shard->_thread, NULL);
+
+    // Give back the squidlets running a task, and their task except 
+    // the stats heartbeat
+    Squad* squad = shard->_squad;
+    while (SquadGetNbRunningTasks(squad) > 0L) {
+      SquadRunningTask* runningTask = 
+        GSetPop((GSet*)SquadRunningTasks(squad));
+      if (runningTask->_squidlet->_sock != -1) {
+        close(runningTask->_squidlet->_sock);
+        runningTask->_squidlet->_sock = -1;
+      }
+      GSetAppend((GSet*)SquadSquidlets(that), runningTask->_squidlet);
+      if (runningTask->_request->_type == SquidletTaskType_Stats) {
+        SquidletTaskRequestFree(&(runningTask->_request));
+      } else if (runningTask->_request->_type == 
+        SquidletTaskType_Batch) {
+        SquadUnbatchTask(squad, runningTask->_request);
+        SquidletTaskRequestFree(&(runningTask->_request));
+      } else {
+        GSetAppend((GSet*)SquadTasks(squad), runningTask->_request);
+      }
+      SquadRunningTaskFree(&runningTask);
+    }
+
+    // Give back the tasks not yet completed
+    while (GSetNbElem(&(shard->_inbox)) > 0) {
+      GSetAppend((GSet*)SquadTasks(squad), GSetPop(&(shard->_inbox)));
+    }
+    while (SquadGetNbRemainingTasks(squad) > 0L) {
+      GSetAppend((GSet*)SquadTasks(that), 
+        GSetPop((GSet*)SquadTasks(squad)));
+      --(that->_nbShardedTask);
+    }
+
+    // Give back the available squidlets
+    while (SquadGetNbSquidlets(squad) > 0L) {
+      GSetAppend((GSet*)SquadSquidlets(that), 
+        GSetPop((GSet*)SquadSquidlets(squad)));
+    }
+
+    // Free memory
+    SquadFree(&(shard->_squad));
+    pthread_cond_destroy(&(shard->_cond));
+    pthread_mutex_destroy(&(shard->_mutex));
+    free(shard);
+  }
+  free(that->_shards);
+  that->_shards = NULL;
+  that->_nbThread = 0;
+}
 
+// Push the task 'task' completed by a shard, or post processed by a 
+// background thread if 'processed' is true, in the queue of the Squad 
+// 'that', can be called by several threads at the same time
+void SquadPushCompletedTask(
+             Squad* const that, 
+  SquadRunningTask* const task, 
+             const bool processed) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
   }
-
-  // Return the success code
-  return true;
+#endif
+  // Create the node
+  SquadCompletedNode* node = 
+    PBErrMalloc(TheSquidErr, sizeof(SquadCompletedNode));
+  node->_next = NULL;
+  node->_task = task;
+  node->_processed = processed;
+
+  // Make the node the new tail, then link it to the previous tail. 
+  // Until it's linked, the consumer sees the queue as ending at the 
+  // previous tail and will get the node at its next pop
+  SquadCompletedNode* prev = 
+    __atomic_exchange_n(&(that->_completedTail), node, __ATOMIC_ACQ_REL);
+  __atomic_store_n(&(prev->_next), node, __ATOMIC_RELEASE);
 }
 
-// Update the statistics about the transfer time of the SquidletInfoStats
-// 'that' given that it took 'deltams' millisecond to send 'len' bytes
-// of data
-void SquidletInfoStatsUpdateTimeTransfer(
-  SquidletInfoStats* const that,
-               const float deltams,
-              const size_t len) {
+// Pop the next task completed by a shard, or post processed by a 
+// background thread, from the queue of the Squad 'that', and set 
+// 'processed' accordingly, or return null if the queue is empty. Must 
+// be called by one single thread
+SquadRunningTask* SquadPopCompletedTask(
+  Squad* const that, 
+   bool* const processed) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
@@ -1613,2374 +9082,2749 @@ void SquidletInfoStatsUpdateTimeTransfer(
     PBErrCatch(TheSquidErr);
   }
 #endif
+  // The head is a stub node, the next task is in the following node 
+  // which becomes the new stub
+  SquadCompletedNode* head = that->_completedHead;
+  SquadCompletedNode* next = 
+    __atomic_load_n(&(head->_next), __ATOMIC_ACQUIRE);
+  if (next == NULL)
+    return NULL;
+  SquadRunningTask* task = next->_task;
+  *processed = next->_processed;
+  next->_task = NULL;
+  that->_completedHead = next;
+  free(head);
+
+  // Return the task
+  return task;
+}
 
-  // Get the delay per byte
-  float deltamsUnit = deltams / (float)len;
-
-  // Update the max
-  if (that->_timeTransferSquadSquidMs[0] > deltamsUnit) {
-    that->_timeTransferSquadSquidMs[0] = deltamsUnit;
+// Post process the tasks completed by the shards of the Squad 'that' 
+// and add the ones to be returned to 'completedTasks', with the ones 
+// post processed by the background threads, then hand the tasks to 
+// execute to the shards which can execute more
+void SquadStepShards(
+                 Squad* const that, 
+  GSetSquadRunningTask* const completedTasks) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
   }
+#endif
+  // Loop on the tasks completed by the shards or post processed
+  SquadRunningTask* runningTask = NULL;
+  bool processed = false;
+  while ((runningTask = 
+    SquadPopCompletedTask(that, &processed)) != NULL) {
+
+    // If the task has been post processed in background, it's ready 
+    // to be returned
+    if (processed == true) {
+      --(that->_nbPostProcessTask);
+      bool completed = true;
+      SquadPushTrace(that, runningTask->_request, 
+        runningTask->_squidletAddr, &(runningTask->_timePostProcessed), 
+        completed);
+      GSetAppend(completedTasks, runningTask);
+      continue;
+    }
+    --(that->_nbShardedTask);
 
-  // Update the sliding average
-  // If the number of completed tasks is less than the length of the
-  // sliding average and there are actually completed tasks
-  if (that->_nbTaskComplete <= SQUID_RANGEAVGSTAT &&
-    that->_nbTaskComplete > 0) {
-
-    // Update the sliding average
-    that->_timeTransferSquadSquidMs[1] = 
-      (that->_timeTransferSquadSquidMs[1] * 
-      (float)(that->_nbTaskComplete - 1) +
-      deltamsUnit) / (float)(that->_nbTaskComplete);
-
-  // Else, the number of completed tasks is more than the length of the
-  // sliding average or there are no completed tasks yet
-  } else {
+    // The squidlet belongs to the shard and may be reused by its thread 
+    // at any time, forget it
+    runningTask->_squidlet = NULL;
 
-    // Update the sliding average
-    that->_timeTransferSquadSquidMs[1] = 
-      (that->_timeTransferSquadSquidMs[1] * 
-      (float)(SQUID_RANGEAVGSTAT - 1) +
-      deltamsUnit) / (float)SQUID_RANGEAVGSTAT;
+    // Update history
+    SquadPushHistory(that, "completed task %lu by a shard", 
+      runningTask->_request->_id);
+
+    // Post process the completed task, and memorize its trace unless 
+    // it's post processed in background
+    SquidletTaskRequest* request = runningTask->_request;
+    bool inBackground = SquadIsPostProcessedInBackground(that, request);
+    bool toReturn = SquadProcessCompletedTask(that, runningTask);
+    if (inBackground == false) {
+      bool completed = true;
+      SquadPushTrace(that, request, runningTask->_squidletAddr, NULL, 
+        completed);
+    }
+    if (toReturn == true) {
+      GSetAppend(completedTasks, runningTask);
+    } else {
+      SquidletTaskRequestFree(&(runningTask->_request));
+      SquadRunningTaskFree(&runningTask);
+    }
   }
 
-  // Update the min
-  if (that->_timeTransferSquadSquidMs[2] < deltamsUnit) {
-    that->_timeTransferSquadSquidMs[2] = deltamsUnit;
+  // Hand the tasks to the shards which can execute more of them
+  for (unsigned int iShard = 0; iShard < that->_nbThread && 
+    SquadGetNbRemainingTasks(that) > 0L; ++iShard) {
+    SquadShard* shard = that->_shards[iShard];
+    unsigned long nbPending = 
+      __atomic_load_n(&(shard->_nbPending), __ATOMIC_ACQUIRE);
+    if (nbPending >= shard->_capacity)
+      continue;
+    pthread_mutex_lock(&(shard->_mutex));
+    while (nbPending < shard->_capacity && 
+      SquadGetNbRemainingTasks(that) > 0L) {
+      GSetAppend(&(shard->_inbox), GSetPop((GSet*)SquadTasks(that)));
+      __atomic_fetch_add(&(shard->_nbPending), 1, __ATOMIC_RELEASE);
+      ++nbPending;
+      ++(that->_nbShardedTask);
+    }
+    pthread_cond_signal(&(shard->_cond));
+    pthread_mutex_unlock(&(shard->_mutex));
   }
 }
-  
-// Try to receive the result from the running task 'runningTask'
-// If the result is ready it is stored in the _bufferResult of the 
-// SquidletTaskRequest of the 'runningTask'
-// If the size of the result data is not ready and couldn't be received 
-// give up immediately
-// If the size of the result data has been received, wait for 
-// (5 + sizeData / 100) seconds maximum to receive the data
-// First receive the size of the result data, then send an 
-// acknowledgement signal to the squidlet for the size of data,
-// then receive the data, and finally send an acknowledgement to the 
-// squidlet for the data
-// Return true if it could receive the result data, false else
-bool SquadReceiveTaskResult(
-             Squad* const that, 
-  SquadRunningTask* const runningTask) {
+
+// Post process the completed tasks of the Squad 'that' in 'nbThread' 
+// background threads instead of SquadStep, which then never waits for 
+// the composition of the POV-Ray images. The tasks with the same id 
+// are post processed by the same thread in the order of their 
+// completion, and returned without squidlet by the SquadStep 
+// following the end of their post processing. 'nbThread' equal to 0 
+// stops the threads, after they have post processed their pending 
+// tasks 
+// Return true if the threads could be created, false else
+bool SquadSetNbPostProcessThread(
+                Squad* const that, 
+  const unsigned int nbThread) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (runningTask == NULL) {
-    TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'runningTask' is null");
-    PBErrCatch(TheSquidErr);
-  }
 #endif
-  // Declare a variable to memorize if we have received the result
-  bool receivedFlag = false;
-
-  // Declare a variable to memorize the size in byte of the result data
-  size_t sizeResultData = 0;
-
-  // Shortcuts
-  SquidletInfo* squidlet = runningTask->_squidlet;
-  SquidletTaskRequest* task = runningTask->_request;
-  
-  // Make sure the buffer to receive the task is empty
-  if (task->_bufferResult != NULL) {
-    free(task->_bufferResult);
-    task->_bufferResult = NULL;
-  }
-  
-  // Try to receive the size of the reply from the squidlet
-  // and give up immediately
-  if (SocketRecv(&(squidlet->_sock), sizeof(size_t), 
-    (char*)&sizeResultData, 0)) {
-
-    // If we could get the size it means the result is ready
-    if (sizeResultData > 0) {
-
-      // Update history
-      SquadPushHistory(that, 
-        "received the size of result from squidlet:");
-      SquadPushHistorySquidletInfo(that, squidlet);
-
-      // Send the acknowledgement of received size of result
-      char ack = 1;
-      int flags = 0;
-      (void)send(squidlet->_sock, &ack, sizeof(char), flags);
-
-      // Update history
-      SquadPushHistory(that, 
-        "send ack of received size of result data to squidlet:");
-      SquadPushHistorySquidletInfo(that, squidlet);
-
-      // Allocate memory for the result data
-      task->_bufferResult = PBErrMalloc(TheSquidErr, sizeResultData + 1);
-      memset(task->_bufferResult, 0, sizeResultData + 1);
-      
-      // Wait to receive the result data with a time limit proportional
-      // to the size of result data
-      int timeOut = 5 + (int)round((float)sizeResultData / 100.0);
-
-      // If we coudln't received the result data
-      if (!SocketRecv(&(squidlet->_sock), sizeResultData, 
-        task->_bufferResult, timeOut)) {
-
-        // Free the memory allocated to the result buffer
-        free(task->_bufferResult);
-        task->_bufferResult = NULL;
-
-        // Update history
-        SquadPushHistory(that, 
-          "couldn't received result data from squidlet:");
-        SquadPushHistorySquidletInfo(that, squidlet);
-        SquadPushHistory(that,"waited for %ds", timeOut);
-
-      } else {
-
-        // Set the flag to memorized we have received the result
-        receivedFlag = true;
-        
-        // Send the acknowledgement of received result
-        (void)send(squidlet->_sock, &ack, 1, flags);
-        
-        // Update history
-        SquadPushHistory(that, "received result data from squidlet:");
-        SquadPushHistorySquidletInfo(that, squidlet);
-        SquadPushHistory(that,"size result data %d", sizeResultData);
-
-      }
+  // Stop the current threads if any, the tasks they have post 
+  // processed are returned by the next SquadStep
+  SquadStopPostProcessWorkers(that);
+  if (nbThread == 0)
+    return true;
 
-    // Else, we couldn't get the size, it means the result is not
-    // ready yet
+  // Create the threads with all the signals blocked, to leave their 
+  // handling (Ctrl-C) to the thread of the caller
+  that->_postProcessWorkers = PBErrMalloc(TheSquidErr, 
+    sizeof(SquadPostProcessWorker*) * nbThread);
+  sigset_t set;
+  sigset_t prevSet;
+  sigfillset(&set);
+  pthread_sigmask(SIG_SETMASK, &set, &prevSet);
+  bool ret = true;
+  for (unsigned int iThread = 0; iThread < nbThread && ret == true; 
+    ++iThread) {
+    SquadPostProcessWorker* worker = 
+      PBErrMalloc(TheSquidErr, sizeof(SquadPostProcessWorker));
+    worker->_squad = that;
+    worker->_stop = false;
+    worker->_jobs = GSetSquadRunningTaskCreateStatic();
+    pthread_mutex_init(&(worker->_mutex), NULL);
+    pthread_cond_init(&(worker->_cond), NULL);
+    ret = (pthread_create(&(worker->_thread), NULL, 
+      SquadPostProcessWorkerRun, worker) == 0);
+    if (ret == true) {
+      that->_postProcessWorkers[iThread] = worker;
+      that->_nbPostProcessThread = iThread + 1;
     } else {
-
-      // Update history
-      SquadPushHistory(that, 
-        "received a null size of result from squidlet:");
-      SquadPushHistorySquidletInfo(that, squidlet);
-
+      pthread_cond_destroy(&(worker->_cond));
+      pthread_mutex_destroy(&(worker->_mutex));
+      free(worker);
     }
   }
-  
-  // Return the flag memorizing if we have received the result
-  return receivedFlag;
+  pthread_sigmask(SIG_SETMASK, &prevSet, NULL);
+
+  // If we couldn't create all the threads, stop the created ones
+  if (ret == false) {
+    SquadStopPostProcessWorkers(that);
+    sprintf(TheSquidErr->_msg, "pthread_create() failed");
+    return false;
+  }
+
+  // Return the success code
+  return true;
 }
 
-// Request the execution of a task on a squidlet for the squad 'that'
-// Return true if the request was successfull, false else
-bool SquadSendTaskOnSquidlet(
-                Squad* const that, 
-         SquidletInfo* const squidlet, 
-  SquidletTaskRequest* const task) {
+// Return true if the completed task 'task' of the Squad 'that' is 
+// post processed by a background thread, else false
+bool SquadIsPostProcessedInBackground(
+                const Squad* const that, 
+  const SquidletTaskRequest* const task) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (squidlet == NULL) {
+  if (task == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'squidlet' is null");
+    sprintf(TheSquidErr->_msg, "'task' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (task == NULL) {
+#endif
+  // Only the composition of the POV-Ray images is done in background, 
+  // a relay leaves it to the Squad it reports to
+  return (task->_type == SquidletTaskType_PovRay && 
+    that->_flagRelay == false && that->_nbPostProcessThread > 0);
+}
+
+// Hand the completed task 'task' of the Squad 'that' to the thread 
+// post processing the tasks with its id, its request is moved to the 
+// thread and will be returned by SquadStep once post processed
+void SquadPostProcessTask(
+             Squad* const that, 
+  SquadRunningTask* const task) {
+#if BUILDMODE == 0
+  if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'task' is null");
+    sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
+  // Move the request to a new running task owned by the thread, all 
+  // the tasks with the same id (for example the fragments of a same 
+  // image) go to the same thread to keep their order 
+  // The squidlet may have been freed by SquadDiscoverSquidlets when 
+  // the task comes back, so the job has no squidlet, only its address 
+  // for the trace
+  SquadRunningTask* job = SquadRunningTaskCreate(task->_request, NULL);
+  strcpy(job->_squidletAddr, task->_squidletAddr);
+  SquadPostProcessWorker* worker = that->_postProcessWorkers[
+    task->_request->_id % that->_nbPostProcessThread];
+  task->_request = NULL;
+
+  // Hand the task to the thread
+  pthread_mutex_lock(&(worker->_mutex));
+  GSetAppend(&(worker->_jobs), job);
+  ++(that->_nbPostProcessTask);
+  pthread_cond_signal(&(worker->_cond));
+  pthread_mutex_unlock(&(worker->_mutex));
+}
 
-  // Request the execution of the task by the squidlet
-  bool ret = SquadSendTaskRequest(that, task, squidlet);
+// Main function of the SquadPostProcessWorker 'arg', post process the 
+// tasks handed by its Squad and push them in the queue of the Squad, 
+// until it is stopped and has no more task
+void* SquadPostProcessWorkerRun(
+  void* arg) {
+  SquadPostProcessWorker* that = arg;
+  pthread_mutex_lock(&(that->_mutex));
+  while (true) {
+
+    // Wait for a task or the stop signal
+    while (that->_stop == false && GSetNbElem(&(that->_jobs)) == 0)
+      pthread_cond_wait(&(that->_cond), &(that->_mutex));
+    if (GSetNbElem(&(that->_jobs)) == 0)
+      break;
 
-  // If the request was successfull
-  if (ret == true) {
+    // Post process the task without holding the mutex, and return it 
+    // to the Squad
+    SquadRunningTask* job = GSetPop(&(that->_jobs));
+    pthread_mutex_unlock(&(that->_mutex));
+    SquadProcessCompletedTask_PovRay(that->_squad, job->_request);
+    gettimeofday(&(job->_timePostProcessed), NULL);
+    bool processed = true;
+    SquadPushCompletedTask(that->_squad, job, processed);
+    pthread_mutex_lock(&(that->_mutex));
+  }
+  pthread_mutex_unlock(&(that->_mutex));
+  return NULL;
+}
 
-    // Send the task's data to the squidlet
-    ret = SquadSendTaskData(that, squidlet, task);
+// Stop the threads post processing the tasks of the Squad 'that', 
+// after they have post processed their pending tasks
+void SquadStopPostProcessWorkers(
+  Squad* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // If there is no thread, there is nothing to do
+  if (that->_postProcessWorkers == NULL)
+    return;
 
-    // If we could send the task's data
-    if (ret == true) {
+  // Stop the threads and wait for them
+  for (unsigned int iThread = 0; iThread < that->_nbPostProcessThread; 
+    ++iThread) {
+    SquadPostProcessWorker* worker = that->_postProcessWorkers[iThread];
+    pthread_mutex_lock(&(worker->_mutex));
+    worker->_stop = true;
+    pthread_cond_signal(&(worker->_cond));
+    pthread_mutex_unlock(&(worker->_mutex));
+    pthread_join(worker->_thread, NULL);
+    pthread_cond_destroy(&(worker->_cond));
+    pthread_mutex_destroy(&(worker->_mutex));
+    free(worker);
+  }
+  free(that->_postProcessWorkers);
+  that->_postProcessWorkers = NULL;
+  that->_nbPostProcessThread = 0;
+}
 
-      // Create a new running task and add it to the set of running tasks
-      SquadRunningTask* runningTask = 
-        SquadRunningTaskCreate(task, squidlet);
-      GSetAppend((GSet*)SquadRunningTasks(that), runningTask);
+// Return the squidlet of the Squad 'that' at the address 'ip':'port', 
+// available or running a task, or null if there is none
+SquidletInfo* SquadGetSquidletInfo(
+        Squad* const that, 
+  const char* const ip, 
+          const int port) {
+  // Search among the available squidlets
+  if (SquadGetNbSquidlets(that) > 0) {
+    GSetIterForward iter = 
+      GSetIterForwardCreateStatic((GSet*)SquadSquidlets(that));
+    do {
+      SquidletInfo* squidlet = GSetIterGet(&iter);
+      if (squidlet->_port == port && strcmp(squidlet->_ip, ip) == 0)
+        return squidlet;
+    } while (GSetIterStep(&iter));
+  }
 
-      // Update history
-      SquadPushHistory(that, "created running task:");
-      SquadPushHistorySquadRunningTask(that, runningTask);
+  // Search among the squidlets running a task
+  if (SquadGetNbRunningTasks(that) > 0) {
+    GSetIterForward iter = 
+      GSetIterForwardCreateStatic((GSet*)SquadRunningTasks(that));
+    do {
+      SquadRunningTask* runningTask = GSetIterGet(&iter);
+      SquidletInfo* squidlet = runningTask->_squidlet;
+      if (squidlet->_port == port && strcmp(squidlet->_ip, ip) == 0)
+        return squidlet;
+    } while (GSetIterStep(&iter));
+  }
 
-    // Else, we couldn't send the task data
-    } else {
+  // The squidlet wasn't found
+  return NULL;
+}
 
-      // Update history
-      SquadPushHistory(that, "couldn't send data to squidlet:");
-      SquadPushHistorySquidletInfo(that, squidlet);
+// Receive the pending announces of the squidlets on the discovery 
+// socket of the Squad 'that', add the new squidlets, and remove the 
+// available ones which said goodbye or haven't announced themselves 
+// for more than SQUAD_DISCOVERY_TIMEOUT seconds
+void SquadDiscoverSquidlets(
+  Squad* const that) {
+  // If the discovery is not used, nothing to do
+  if (that->_fdDiscovery == -1)
+    return;
 
-    }
-  
-  // Else, the request of execution wasn't successfull
-  } else {
+  time_t now = time(NULL);
+
+  // Loop on the pending announces
+  char buffer[THESQUID_ANNOUNCE_LENGTH + 1];
+  struct sockaddr_in sender;
+  socklen_t sizeSender = sizeof(sender);
+  ssize_t nb = 0;
+  while ((nb = recvfrom(that->_fdDiscovery, buffer, 
+    THESQUID_ANNOUNCE_LENGTH, 0, (struct sockaddr*)&sender, 
+    &sizeSender)) > 0) {
+
+    // Decode the announce, ignore it if it's invalid
+    buffer[nb] = '\0';
+    char cmd[10] = {0};
+    char name[THESQUID_ANNOUNCE_LENGTH] = {0};
+    int port = -1;
+    int ret = sscanf(buffer, THESQUID_ANNOUNCE_MAGIC " %9s %d %255s", 
+      cmd, &port, name);
+    sizeSender = sizeof(sender);
+    if (ret < 2 || port < 0)
+      continue;
+
+    // The IP of the squidlet is the one it has announced itself from
+    char ip[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &(sender.sin_addr), ip, INET_ADDRSTRLEN);
+    SquidletInfo* squidlet = SquadGetSquidletInfo(that, ip, port);
+
+    // If the squidlet says hello
+    if (strcmp(cmd, "hello") == 0) {
+
+      // If it's a new squidlet, add it to the available squidlets
+      if (squidlet == NULL) {
+        squidlet = SquidletInfoCreate((ret == 3 ? name : "discovered"), 
+          ip, port);
+        GSetAppend((GSet*)SquadSquidlets(that), squidlet);
 
-    // Update history
-    SquadPushHistory(that, "task refused by squidlet:");
-    SquadPushHistorySquidletInfo(that, squidlet);
+        // Update history
+        SquadPushHistory(that, "discovered squidlet:");
+        SquadPushHistorySquidletInfo(that, squidlet);
+      }
+      squidlet->_timeLastAnnounce = now;
 
+    // Else, if a known squidlet says goodbye, it will be removed once 
+    // available
+    } else if (strcmp(cmd, "bye") == 0 && squidlet != NULL) {
+      squidlet->_timeLastAnnounce = 1;
+    }
   }
 
-  // Return the result
-  return ret;
-}
+  // Remove the available squidlets which said goodbye or haven't 
+  // announced themselves recently
+  if (SquadGetNbSquidlets(that) > 0) {
+    bool flag = false;
+    GSetIterForward iter = 
+      GSetIterForwardCreateStatic((GSet*)SquadSquidlets(that));
+    do {
+      flag = false;
+      SquidletInfo* squidlet = GSetIterGet(&iter);
+      if (squidlet->_timeLastAnnounce != 0 && 
+        now - squidlet->_timeLastAnnounce > SQUAD_DISCOVERY_TIMEOUT) {
 
-// Step the Squad 'that', i.e. tries to affect the remaining tasks to 
-// available Squidlets and check for completion of running tasks.
-// Return the GSet of the completed SquadRunningTask at this step
-// Non blocking, if there is no task to compute or no squidlet 
-// available, and no task completed, do nothing and return an empty set
-GSetSquadRunningTask SquadStep(
-  Squad* const that) {
-#if BUILDMODE == 0
-  if (that == NULL) {
-    TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'that' is null");
-    PBErrCatch(TheSquidErr);
+        // Update history
+        SquadPushHistory(that, "removed squidlet:");
+        SquadPushHistorySquidletInfo(that, squidlet);
+
+        flag = GSetIterRemoveElem(&iter);
+        SquidletInfoFree(&squidlet);
+      }
+    } while (flag || GSetIterStep(&iter));
   }
-#endif
-  // Create the set of completed tasks
-  GSetSquadRunningTask completedTasks = \
-    GSetSquadRunningTaskCreateStatic();
-  
-  // If there are running tasks
-  if (SquadGetNbRunningTasks(that) > 0L) {
+}
 
-    // Declare a flag to manage the removing of tasks during the loop
-    // on running tasks
-    bool flag = false;
+// Print the metrics of the Squad 'that' on the 'stream', 
+// TheSquidMetricsPrinter wrapper of SquadPrintMetrics
+void SquadPrintMetricsCallback(
+  const void* const that, 
+        FILE* const stream) {
+  SquadPrintMetrics((const Squad*)that, stream);
+}
 
-    // Loop on running tasks
-    GSetIterForward iter = 
-      GSetIterForwardCreateStatic((GSet*)SquadRunningTasks(that));
-    do {
+// -------------- Squidlet
 
-      // Reinit the flag to manage the removing of tasks during the loop
-      flag = false;
+// ================= Global variable ==================
 
-      // Get the running tasks
-      SquadRunningTask* runningTask = GSetIterGet(&iter);
+// Variable to handle the signal Ctrl-C
+bool Squidlet_CtrlC = false;
 
-      // Request the result for this task
-      bool complete = SquadReceiveTaskResult(that, runningTask);
-      
-      // If the task is complete
-      if (complete == true) {
+// ================ Functions implementation ====================
 
-        // Update history
-        SquadPushHistory(that, "completed task:");
-        SquadPushHistorySquadRunningTask(that, runningTask);
+// Handler for the signal Ctrl-C
+void SquidletHandlerCtrlC(
+  const int sig) {
+  // Don't use the signal
+  (void)sig;
+  // Raise the flag to memorize we have received the signal Ctrl-C
+  Squidlet_CtrlC = true;
+  // Display info
+  time_t intTime = time(NULL);
+  char* strIntTime = ctime(&intTime);
+  printf("Squidlet :  !!! Interrupted by Ctrl-C !!! %s", strIntTime);
+  fflush(stdout);
+}
 
-        // Post process the completed task
-        SquadProcessCompletedTask(that, runningTask);
+// Handler for the signal SIGPIPE
+// Catch the signal to avoid the Squidlet dying over a socket failure
+void SquidletHandlerSigPipe(
+  const int sig) {
+  // Don't use the signal
+  (void)sig;
+  // Display info
+  time_t intTime = time(NULL);
+  char* strIntTime = ctime(&intTime);
+  printf("Squidlet :  !!! Received SIGPIPE !!! %s", strIntTime);
+  fflush(stdout);
+}
 
-        // Put back the squidlet in the set of squidlets
-        GSetAppend((GSet*)SquadSquidlets(that), runningTask->_squidlet);
+// Return a new Squidlet listening to the IP adress 'addr' and port 
+// 'port'
+// If 'addr' equals 0, select automatically the first network address 
+// of the host 
+// If 'port' equals -1, select automatically one available between 
+// THESQUID_PORTMIN and THESQUID_PORTMAX
+Squidlet* SquidletCreateOnPort(
+  const uint32_t addr, 
+       const int port) {
+  
+  // Allocate memory for the squidlet
+  Squidlet* that = PBErrMalloc(TheSquidErr, sizeof(Squidlet));
+  
+  // Open the socket
+  that->_fd = socket(AF_INET, SOCK_STREAM, 0);
+  
+  // If we couldn't open the socket
+  if (that->_fd == -1) {
 
-        // Add the task to the set of completed tasks
-        GSetAppend(&completedTasks, runningTask);
+    // Free memory and return null
+    free(that);
+    sprintf(TheSquidErr->_msg, "socket() failed");
+    return NULL;
+  }
 
-        // Remove the task from the running tasks
-        flag = GSetIterRemoveElem(&iter);
-      
-      // Else, the task is not complete
-      // If we've been waiting too long for this task
-      } else if (time(NULL) - runningTask->_startTime > 
-        runningTask->_request->_maxWaitTime) {
+  // Set the timeout for sending and receiving on this socket to 
+  // THESQUID_ACCEPT_TIMEOUT seconds
+  struct timeval tv;
+  tv.tv_sec = THESQUID_ACCEPT_TIMEOUT;
+  tv.tv_usec = 0;  
+  int reuse = 1;
+  bool ret = (setsockopt(that->_fd, SOL_SOCKET, SO_SNDTIMEO, 
+    (char*)&tv, sizeof(tv)) != -1);
+  ret &= (setsockopt(that->_fd, SOL_SOCKET, SO_RCVTIMEO, 
+    (char*)&tv, sizeof(tv)) != -1);
+  ret &= (setsockopt(that->_fd, SOL_SOCKET, SO_REUSEADDR,
+    &reuse,sizeof(int)) != -1);
 
-        // Update history
-        SquadPushHistory(that, "gave up task:");
-        SquadPushHistorySquadRunningTask(that, runningTask);
+  // If we couldn't set the timeout, free memory and return null
+  if (ret == false) {
+    
+    // Free memory and return null
+    close(that->_fd);
+    free(that);
+    sprintf(TheSquidErr->_msg, "setsockopt() failed");
+    return NULL;
+  }
 
-        // Put back the squidlet in the set of squidlets
-        GSetAppend((GSet*)SquadSquidlets(that), runningTask->_squidlet);
-        runningTask->_squidlet = NULL;
+  // Get the hostname
+  ret = (gethostname(that->_hostname, sizeof(that->_hostname)) != -1);
 
-        // Put back the task to the set of tasks
-        SquadTryAgainTask(that, runningTask->_request);
-        runningTask->_request = NULL;
+  // If we couldn't get the hostname
+  if (ret == false) {
 
-        // Remove the task from the running tasks
-        flag = GSetIterRemoveElem(&iter);
+    // Free memory and return null
+    close(that->_fd);
+    free(that);
+    sprintf(TheSquidErr->_msg, "gethostname() failed");
+    return NULL;
+  }
+  
+  // Get the info about the host
+  that->_host = gethostbyname(that->_hostname); 
 
-        // Free memory
-        SquadRunningTaskFree(&runningTask);
+  // If we couldn't get the host info
+  if (that->_host == NULL) {
 
-      // Else, the task is not complete and we can wait more for it
-      } else {
+    // Free memory and return null
+    close(that->_fd);
+    free(that);
+    sprintf(TheSquidErr->_msg, "gethostbyname() failed");
+    return NULL;
+  }
+  
+  // Init the port and socket info
+  memset(&(that->_sock), 0, sizeof(struct sockaddr_in));
+  that->_sock.sin_family = AF_INET;
+  if (addr != 0)
+    that->_sock.sin_addr.s_addr = addr;
+  else
+    that->_sock.sin_addr.s_addr = *(uint32_t*)(that->_host->h_addr_list[0]);
+  if (port != -1)
+    that->_port = port;
+  else
+    that->_port = THESQUID_PORTMIN;
+  that->_sock.sin_port = htons(that->_port);
+  
+  // If the port is not specified by the user
+  if (port == -1) {
 
-        // Update history
-        SquadPushHistory(that, "waiting for task:");
-        SquadPushHistorySquadRunningTask(that, runningTask);
+    // Loop on the ports until we find one availalble
+    while (bind(that->_fd, (struct sockaddr *)&(that->_sock), 
+      sizeof(struct sockaddr_in)) == -1 && 
+      that->_port < THESQUID_PORTMAX) {
+      ++(that->_port);
+      that->_sock.sin_port = htons(that->_port);
+    }
+    
+    // If we couldn't find an available port
+    if (that->_port == THESQUID_PORTMAX) {
 
-      }
+      // Free memory and return null
+      close(that->_fd);
+      free(that);
+      sprintf(TheSquidErr->_msg, "bind() failed");
+      return NULL;
+    }
 
-    } while (flag || GSetIterStep(&iter));
+  // Else if the port is specified by the user, try to bind only on 
+  // that port
+  } else {
+
+    // If we couldn't bind the socket on the requested port
+    if (bind(that->_fd, (struct sockaddr *)&(that->_sock), 
+      sizeof(struct sockaddr_in)) == -1) {
 
+      // Free memory and return null
+      close(that->_fd);
+      free(that);
+      sprintf(TheSquidErr->_msg, "bind() failed");
+      return NULL;
+    }
   }
   
-  // If there are tasks to execute and available squidlet
-  if (SquadGetNbRemainingTasks(that) > 0L && 
-    SquadGetNbSquidlets(that) > 0L) {
+  // Start listening through the socket
+  if (listen(that->_fd, THESQUID_NBMAXPENDINGCONN) == -1) {
 
-    // Declare a flag to manage the removing of tasks during the loop
-    // on running tasks
-    bool flag = false;
+    // If we can't listen through the socket, close it, free memory and 
+    // return null
+    close(that->_fd);
+    free(that);
+    sprintf(TheSquidErr->_msg, "listen() failed");
+    return NULL;
+  }
 
-    // Loop on squidlets
-    GSetIterForward iter = 
-      GSetIterForwardCreateStatic((GSet*)SquadSquidlets(that));
-    do {
+  // Init the PID
+  that->_pid = getpid();
 
-      // Reinit the flag to manage the removing of tasks during the loop
-      flag = false;
+  // Init the socket for reply
+  that->_sockReply = -1;
 
-      // Get the squidlet
-      SquidletInfo* squidlet = GSetIterGet(&iter);
+  // Set the handler to catch the signal Ctrl-C
+  signal(SIGINT, SquidletHandlerCtrlC);
 
-      // Get the next task to complete
-      SquidletTaskRequest* task = GSetPop((GSet*)SquadTasks(that));
+  // Init the stream for output
+  that->_streamInfo = NULL;
+  that->_taskType = SquidletTaskType_Null;
+  that->_taskId = 0;
+  that->_taskSubId = 0;
 
-      // If there is a task to complete
-      if (task != NULL) {
+  // Init the variables for statistics
+  SquidletResetStats(that);
 
-        // Request the task on the squidlet
-        bool ret = SquadSendTaskOnSquidlet(that, squidlet, task);
+  // Init the properties for neuranet evaluation task
+  that->_datasetPath = NULL;
+  that->_dataset = GDataSetVecFloatCreateStatic();
+  that->_samplesCat = -1;
+  that->_nbSample = 0;
+  that->_dimSample = 0;
+  that->_samples = NULL;
+  for (int iNN = THESQUID_NBNNCACHE; iNN--;) {
+    that->_nnCache[iNN] = NULL;
+    that->_nnCacheHashes[iNN][0] = '\0';
+  }
+  that->_nextNNCache = 0;
+
+  // Use by default one thread per available core
+  SquidletSetNbThread(that, (int)sysconf(_SC_NPROCESSORS_ONLN));
+
+  // No metrics endpoint, no event log and no announce by default
+  that->_metrics = NULL;
+  that->_eventLog = NULL;
+  that->_fdAnnounce = -1;
+  that->_relay = NULL;
+  that->_timeLastAnnounce = 0;
+
+  // No binary allowed for the Exec tasks by default
+  that->_nbExecCommand = 0;
+
+  // No file attached to the result until a task produces one
+  that->_resultFilePath = NULL;
+  that->_resultFileSize = 0;
+
+  // Start sampling the temperature in background, from the thermal 
+  // sensor on the Raspberry Pi, the temperature is not available on 
+  // other architectures
+#if BUILDARCH == 0
+  that->_thermal = TheSquidThermalCreate(TheSquidThermalSourceStub, 
+    NULL, THESQUID_THERMAL_PERIODMS);
+#else
+  that->_thermal = TheSquidThermalCreate(TheSquidThermalSourceSysfs, 
+    NULL, THESQUID_THERMAL_PERIODMS);
+#endif
 
-        // If the squidlet accepted the task
-        if (ret == true) {
+  // Return the new squidlet
+  return that;
+}
 
-          // Remove the squidlet from the available squidlet
-          flag = GSetIterRemoveElem(&iter);
+// Free the memory used by the Squidlet 'that'
+void SquidletFree(
+  Squidlet** that) {
 
-        // Else, the squidlet refused the task or the data couldn't be
-        // sent
-        } else {
+  // If the pointer is null there is nothing to do
+  if (that == NULL || *that == NULL)
+    return;
 
-          // Put back the task in the set
-          GSetPush((GSet*)SquadTasks(that), task);
-        }
-      }
-    } while (flag || GSetIterStep(&iter));
-  }
-  
-  // Update the TextOMeter if necessary
-  if (SquadGetFlagTextOMeter(that) == true) {
-    SquadUpdateTextOMeter(that);
+  // Close the socket
+  close((*that)->_fd);
+
+  // Say goodbye to the squads and close the socket for the announces
+  if ((*that)->_fdAnnounce != -1) {
+    SquidletAnnounce(*that, "bye");
+    close((*that)->_fdAnnounce);
   }
-   
-  // Return the set of completed tasks
-  return completedTasks;
-}
 
-// Process the completed 'task' with the Squad 'that' after its 
-// reception in SquadStep()
-void SquadProcessCompletedTask(
-             Squad* const that, 
-  SquadRunningTask* const task) {
+  // Close the socket for the reply if it is opened
+  if ((*that)->_sockReply != -1)
+    close((*that)->_sockReply);
+
+  // Free memory
+  GDataSetVecFloatFreeStatic(&((*that)->_dataset));
+  if ((*that)->_samples != NULL)
+    free((*that)->_samples);
+  for (int iNN = THESQUID_NBNNCACHE; iNN--;)
+    NeuraNetFree((*that)->_nnCache + iNN);
+  TheSquidMetricsFree(&((*that)->_metrics));
+  TheSquidThermalFree(&((*that)->_thermal));
+  TheSquidEventLogFree(&((*that)->_eventLog));
+  SquadFree(&((*that)->_relay));
+  for (int iCmd = (*that)->_nbExecCommand; iCmd--;)
+    free((*that)->_execCommands[iCmd]);
+  if ((*that)->_resultFilePath != NULL) {
+    unlink((*that)->_resultFilePath);
+    free((*that)->_resultFilePath);
+  }
+  free(*that);
+  *that = NULL;
+}
+
+// Print the PID, Hostname, IP and Port of the Squidlet 'that' on the 
+// file 'stream'
+// Example: 100 localhost 0.0.0.0:3000
+void SquidletPrint(
+  const Squidlet* const that, 
+            FILE* const stream) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (task == NULL) {
+  if (stream == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'task' is null");
+    sprintf(TheSquidErr->_msg, "'stream' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
 
-  // Call the appropriate function based on the type of the task
-  switch (task->_request->_type) {
-    case SquidletTaskType_Dummy:
-      break;
-    case SquidletTaskType_Benchmark:
-      break;
-    case SquidletTaskType_PovRay:
-      SquadProcessCompletedTask_PovRay(that, task->_request);
-      break;
-    case SquidletTaskType_ResetStats:
-      // Nothing to do
-      break;
-    case SquidletTaskType_EvalNeuranet:
-      break;
-    default:
-      break;
-  }
-  
-  // Update the stats about the squidlets
-  SquidletInfoUpdateStats(task->_squidlet, task->_request);
+  // Print the info on the stream
+  fprintf(stream, "%d %s %s:%d", SquidletGetPID(that), 
+    SquidletHostname(that), SquidletIP(that), SquidletGetPort(that));
 }
 
-// Update the statitics of the SquidletInfo 'that' with the result of
-// the 'task'
-void SquidletInfoUpdateStats(
-         SquidletInfo* const that, 
-  SquidletTaskRequest* const task) {
+// Reset the statistics of the Squidlet 'that'
+void SquidletResetStats(
+  Squidlet* const that) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (task == NULL) {
+#endif
+
+  that->_nbAcceptedConnection = 0;
+  that->_nbAcceptedTask = 0;
+  that->_nbRefusedTask = 0;
+  that->_nbFailedReceptTaskData = 0;
+  that->_nbFailedReceptTaskSize = 0;
+  that->_nbSentResult = 0;
+  that->_nbFailedSendResult = 0;
+  that->_nbFailedSendResultSize = 0;
+  that->_nbFailedReceptAck = 0;
+  that->_nbTaskComplete = 0;
+  that->_timeToProcessMs = 0;
+  that->_timeWaitedTaskMs = 0;
+  that->_timeWaitedAckMs = 0;
+  that->_nbByteReceived = 0;
+  that->_nbByteSent = 0;
+  for (int iType = SquidletTaskType_Nb; iType--;)
+    TheSquidHistoReset(that->_histoTimeToProcessMs + iType);
+  TheSquidHistoReset(&(that->_histoTimeWaitedTaskMs));
+  TheSquidHistoReset(&(that->_histoTimeWaitedAckMs));
+  TheSquidHistoReset(&(that->_histoTimeTransferSquidSquadUsPerKB));
+
+}
+
+// Wait for a task request to be received by the Squidlet 'that'
+// Return the received task request, or give up after 
+// THESQUID_ACCEPT_TIMEOUT if there was no request and return a task 
+// request of type SquidletTaskType_Null
+SquidletTaskRequest SquidletWaitRequest(
+  Squidlet* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'task' is null");
+    sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
+  // Declare a variable to memorize the reply to the request
+  char reply = THESQUID_TASKREFUSED;
 
-  // Declare a variable to decode the JSON data from the completed task
-  JSONNode* jsonResult = JSONCreate();
+  // Declare a buffer to receive the payload of the connection
+  SquidletTaskRequest taskRequest;
 
-  // Decode the JSON data from the completed task
-  bool ret = JSONLoadFromStr(jsonResult, task->_bufferResult);
+  // Initialize the type of th received task to SquidletTaskType_Null
+  taskRequest._type = SquidletTaskType_Null;
+
+  // Declare a variable to memorize the info about the incoming 
+  // connection
+  struct sockaddr_in incomingSock;
+  socklen_t incomingSockSize = sizeof(incomingSock);
   
-  // If we could decode the JSON
-  if (ret == true) {
+  // Make sure the socket for reply is closed
+  if (that->_sockReply != -1) {
+    close(that->_sockReply);
+    that->_sockReply = -1;
+  }
 
-    // Get the properties
-    JSONNode* propNbAcceptedConnection = \
-      JSONProperty(jsonResult, "nbAcceptedConnection");
-    JSONNode* propNbAcceptedTask = \
-      JSONProperty(jsonResult, "nbAcceptedTask");
-    JSONNode* propNbRefusedTask = \
-      JSONProperty(jsonResult, "nbRefusedTask");
-    JSONNode* propNbFailedReceptTaskData = \
-      JSONProperty(jsonResult, "nbFailedReceptTaskData");
-    JSONNode* propNbFailedReceptTaskSize = \
-      JSONProperty(jsonResult, "nbFailedReceptTaskSize");
-    JSONNode* propNbSentResult = \
-      JSONProperty(jsonResult, "nbSentResult");
-    JSONNode* propNbFailedSendResult = \
-      JSONProperty(jsonResult, "nbFailedSendResult");
-    JSONNode* propNbFailedSendResultSize = \
-      JSONProperty(jsonResult, "nbFailedSendResultSize");
-    JSONNode* propNbFailedReceptAck = \
-      JSONProperty(jsonResult, "nbFailedReceptAck");
-    JSONNode* propNbTaskComplete = \
-      JSONProperty(jsonResult, "nbTaskComplete");
-    JSONNode* propTimeToProcessMs = \
-      JSONProperty(jsonResult, "timeToProcessMs");
-    JSONNode* propTimeWaitedTaskMs = \
-      JSONProperty(jsonResult, "timeWaitedTaskMs");
-    JSONNode* propTimeWaitedAckMs = \
-      JSONProperty(jsonResult, "timeWaitedAckMs");
-    JSONNode* propTemperature = \
-      JSONProperty(jsonResult, "temperature");
-    JSONNode* propTimeTransferSquidSquad = \
-      JSONProperty(jsonResult, "timeTransferSquidSquadMs");
+  // Serve the pending scrapes of metrics
+  if (that->_metrics != NULL) {
+    TheSquidMetricsServe(that->_metrics, SquidletPrintMetricsCallback, 
+      that);
+  }
+
+  // Announce the squidlet if it's time to
+  if (that->_fdAnnounce != -1 && 
+    time(NULL) - that->_timeLastAnnounce >= THESQUID_ANNOUNCE_PERIOD) {
+    SquidletAnnounce(that, "hello");
+  }
   
-    // If all the properties are present
-    if (propNbAcceptedConnection != NULL &&
-      propNbAcceptedTask != NULL &&
-      propNbRefusedTask != NULL &&
-      propNbFailedReceptTaskData != NULL &&
-      propNbFailedReceptTaskSize != NULL &&
-      propNbSentResult != NULL &&
-      propNbFailedSendResult != NULL &&
-      propNbFailedSendResultSize != NULL &&
-      propNbFailedReceptAck != NULL &&
-      propNbTaskComplete != NULL &&
-      propTimeToProcessMs != NULL &&
-      propTimeWaitedTaskMs != NULL &&
-      propTimeWaitedAckMs != NULL &&
-      propTemperature != NULL &&
-      propTimeTransferSquidSquad != NULL) {
+  // Extract the first connection request on the queue of pending 
+  // connections if there was one. If there are none wait for
+  // one during THESQUID_ACCEPT_TIMEOUT seconds and then give up
+  that->_sockReply = accept(that->_fd, (struct sockaddr *)&incomingSock,
+    &incomingSockSize);
 
-      // Update the stats with the received info from the Squidlet 
-      SquidletInfoStats* stats = 
-        (SquidletInfoStats*)SquidletInfoStatistics(that);
-      stats->_nbAcceptedConnection = 
-        atol(JSONLblVal(propNbAcceptedConnection));
-      stats->_nbAcceptedTask = 
-        atol(JSONLblVal(propNbAcceptedTask));
-      stats->_nbRefusedTask = 
-        atol(JSONLblVal(propNbRefusedTask));
-      stats->_nbFailedReceptTaskData = 
-        atol(JSONLblVal(propNbFailedReceptTaskData));
-      stats->_nbFailedReceptTaskSize = 
-        atol(JSONLblVal(propNbFailedReceptTaskSize));
-      stats->_nbSentResult = 
-        atol(JSONLblVal(propNbSentResult));
-      stats->_nbFailedSendResult = 
-        atol(JSONLblVal(propNbFailedSendResult));
-      stats->_nbFailedSendResultSize = 
-        atol(JSONLblVal(propNbFailedSendResultSize));
-      stats->_nbFailedReceptAck = 
-        atol(JSONLblVal(propNbFailedReceptAck));
-      stats->_nbTaskComplete = 
-        atol(JSONLblVal(propNbTaskComplete));
-      
-      // If its not the first completed task
-      if (stats->_nbTaskComplete > 1) {
-        
-        // Update the statistics about time
-        float timeToProcessMs = 
-          atof(JSONLblVal(propTimeToProcessMs));
-        if (stats->_timeToProcessMs[0] > timeToProcessMs) {
-          stats->_timeToProcessMs[0] = timeToProcessMs;
-        }
-        if (stats->_nbTaskComplete <= SQUID_RANGEAVGSTAT) {
-          stats->_timeToProcessMs[1] = 
-            (stats->_timeToProcessMs[1] * 
-            (float)(stats->_nbTaskComplete - 1) +
-            timeToProcessMs) / 
-            (float)(stats->_nbTaskComplete);
-        } else {
-          stats->_timeToProcessMs[1] = 
-            (stats->_timeToProcessMs[1] * 
-            (float)(SQUID_RANGEAVGSTAT - 1) +
-            timeToProcessMs) / 
-            (float)SQUID_RANGEAVGSTAT;
-        }
-        if (stats->_timeToProcessMs[2] < timeToProcessMs) {
-          stats->_timeToProcessMs[2] = timeToProcessMs;
-        }
-        
-        float timeWaitedTaskMs = 
-          atof(JSONLblVal(propTimeWaitedTaskMs));
-        if (stats->_timeWaitedTaskMs[0] > timeWaitedTaskMs) {
-          stats->_timeWaitedTaskMs[0] = timeWaitedTaskMs;
-        }
-        if (stats->_nbTaskComplete <= SQUID_RANGEAVGSTAT) {
-          stats->_timeWaitedTaskMs[1] = 
-            (stats->_timeWaitedTaskMs[1] * 
-            (float)(stats->_nbTaskComplete - 1) +
-            timeWaitedTaskMs) / 
-            (float)(stats->_nbTaskComplete);
-        } else {
-          stats->_timeWaitedTaskMs[1] = 
-            (stats->_timeWaitedTaskMs[1] * 
-            (float)(SQUID_RANGEAVGSTAT - 1) +
-            timeWaitedTaskMs) / 
-            (float)SQUID_RANGEAVGSTAT;
-        }
-        if (stats->_timeWaitedTaskMs[2] < timeWaitedTaskMs) {
-          stats->_timeWaitedTaskMs[2] = timeWaitedTaskMs;
+  // If we could extract a pending connection
+  if (that->_sockReply >= 0) {
+
+    // Update the number of accepted connection
+    ++(that->_nbAcceptedConnection);
+
+    SquidletLogEvent(that, TheSquidEventType_AcceptConnection, 0);
+
+    if (SquidletStreamInfo(that)){
+      SquidletPrint(that, SquidletStreamInfo(that));
+      fprintf(SquidletStreamInfo(that), " : accepted connection\n");
+    }
+    
+    // Set the timeout for sending and receiving on the
+    // extracted socket to THESQUID_PROC_TIMEOUT sec
+    struct timeval tv;
+    tv.tv_sec = THESQUID_PROC_TIMEOUT;
+    tv.tv_usec = 0;  
+    int reuse = 1;
+    bool ret = (setsockopt(that->_sockReply, SOL_SOCKET, SO_SNDTIMEO, 
+      (char*)&tv, sizeof(tv)) != -1);
+    ret &= (setsockopt(that->_sockReply, SOL_SOCKET, SO_RCVTIMEO, 
+      (char*)&tv, sizeof(tv)) != -1);
+    ret &= (setsockopt(that->_sockReply, SOL_SOCKET, SO_REUSEADDR,
+      &reuse, sizeof(int)) != -1);
+
+    // If we couldn't set the timeout
+    if (ret == false) {
+ 
+      // Refuse the task
+      reply = THESQUID_TASKREFUSED;
+
+      SquidletLogEvent(that, TheSquidEventType_SetSockOptFailed, 0);
+
+      if (SquidletStreamInfo(that)){
+        SquidletPrint(that, SquidletStreamInfo(that));
+        fprintf(SquidletStreamInfo(that), " : setsockopt failed\n");
+      }
+
+    // Else, we could set the timeout
+    } else {
+
+      // Receive the task type, give up after 
+      // THESQUID_PROC_TIMEOUT seconds
+      ret = SocketRecv(&(that->_sockReply), sizeof(SquidletTaskType), 
+        (char*)&taskRequest, THESQUID_PROC_TIMEOUT);
+
+      // If we received an unknown task type (plugin not registered 
+      // on this squidlet)
+      if (ret == true && 
+        SquidletTaskTypeIsValid(taskRequest._type) == false) {
+
+        // Refuse the task
+        SquidletLogEvent(that, TheSquidEventType_RecvTaskType, 
+          taskRequest._type);
+        if (SquidletStreamInfo(that)){
+          SquidletPrint(that, SquidletStreamInfo(that));
+          fprintf(SquidletStreamInfo(that), 
+            " : unknown task type %d\n", taskRequest._type);
         }
+        taskRequest._type = SquidletTaskType_Null;
+        reply = THESQUID_TASKREFUSED;
+
+        // Update the number of refused task
+        ++(that->_nbRefusedTask);
+
+      // Else, if we could receive the task type
+      } else if (ret == true) {
         
-        float timeWaitedAckMs = 
-          atof(JSONLblVal(propTimeWaitedAckMs));
-        if (stats->_timeWaitedAckMs[0] > timeWaitedAckMs) {
-          stats->_timeWaitedAckMs[0] = timeWaitedAckMs;
+        // The task is accepted
+        reply = THESQUID_TASKACCEPTED;
+
+        // Update the number of accepted task
+        ++(that->_nbAcceptedTask);
+      
+        // Update the statistics
+        if (that->_nbTaskComplete > 0) {
+          struct timeval now;
+          gettimeofday(&now, NULL);
+          that->_timeWaitedTaskMs = 
+            (now.tv_sec - that->_timeLastTaskComplete.tv_sec) * 1000 +
+            (now.tv_usec - that->_timeLastTaskComplete.tv_usec) / 1000;
+          TheSquidHistoAdd(&(that->_histoTimeWaitedTaskMs), 
+            (float)(that->_timeWaitedTaskMs));
         }
-        if (stats->_nbTaskComplete <= SQUID_RANGEAVGSTAT) {
-          stats->_timeWaitedAckMs[1] = 
-            (stats->_timeWaitedAckMs[1] * 
-            (float)(stats->_nbTaskComplete - 1) +
-            timeWaitedAckMs) / 
-            (float)(stats->_nbTaskComplete);
-        } else {
-          stats->_timeWaitedAckMs[1] = 
-            (stats->_timeWaitedAckMs[1] * 
-            (float)(SQUID_RANGEAVGSTAT - 1) +
-            timeWaitedAckMs) / 
-            (float)SQUID_RANGEAVGSTAT;
+
+        that->_taskType = taskRequest._type;
+        SquidletLogEvent(that, TheSquidEventType_RecvTaskType, 
+          taskRequest._type);
+
+        if (SquidletStreamInfo(that)){
+          SquidletPrint(that, SquidletStreamInfo(that));
+          fprintf(SquidletStreamInfo(that), 
+            " : received task type %d\n", taskRequest._type);
         }
-        if (stats->_timeWaitedAckMs[2] < timeWaitedAckMs) {
-          stats->_timeWaitedAckMs[2] = timeWaitedAckMs;
+
+      // Else, we couldn't receive the task type
+      } else {
+
+        // Refuse the task and ensure the task type is equal to
+        // SquidletTaskType_Null
+        taskRequest._type = SquidletTaskType_Null;
+        reply = THESQUID_TASKREFUSED;
+
+        // Update the number of refused task
+        ++(that->_nbRefusedTask);
+
+        SquidletLogEvent(that, TheSquidEventType_RecvTaskTypeFailed, 0);
+
+        if (SquidletStreamInfo(that)){
+          SquidletPrint(that, SquidletStreamInfo(that));
+          fprintf(SquidletStreamInfo(that),
+            " : couldn't receive task type\n");
         }
+      }
 
-        float temperature = 
-          atof(JSONLblVal(propTemperature));
-        if (stats->_temperature[0] > temperature) {
-          stats->_temperature[0] = temperature;
-        }
-        if (stats->_nbTaskComplete <= SQUID_RANGEAVGSTAT) {
-          stats->_temperature[1] = 
-            (stats->_temperature[1] * 
-            (float)(stats->_nbTaskComplete - 1) +
-            temperature) / 
-            (float)(stats->_nbTaskComplete);
-        } else {
-          stats->_temperature[1] = 
-            (stats->_temperature[1] * 
-            (float)(SQUID_RANGEAVGSTAT - 1) +
-            temperature) / 
-            (float)SQUID_RANGEAVGSTAT;
-        }
-        if (stats->_temperature[2] < temperature) {
-          stats->_temperature[2] = temperature;
+      // Send the reply to the task request
+      int flags = 0;
+      ret = (send(that->_sockReply, &reply, sizeof(reply), flags) != -1);
+
+      // If we couldn't send the reply
+      if (ret == false) {
+
+        // If we couldn't send the reply, do not process the task
+        taskRequest._type = SquidletTaskType_Null;
+
+        SquidletLogEvent(that, TheSquidEventType_SendReplyFailed, reply);
+
+        if (SquidletStreamInfo(that)){
+          SquidletPrint(that, SquidletStreamInfo(that));
+          fprintf(SquidletStreamInfo(that),
+            " : couldn't sent reply to task request %d\n", reply);
         }
-        
-        float timeTransferSquidSquadMs = 
-          atof(JSONLblVal(propTimeTransferSquidSquad));
-        SquidletInfoStatsUpdateTimeTransfer(
-          stats, timeTransferSquidSquadMs, 1);
 
-      // Else, this is the first completed task
+      // Else, we could send the reply
       } else {
 
-        float timeToProcessMs = 
-          atof(JSONLblVal(propTimeToProcessMs));
-        stats->_timeToProcessMs[0] = timeToProcessMs;
-        stats->_timeToProcessMs[1] = timeToProcessMs;
-        stats->_timeToProcessMs[2] = timeToProcessMs;
-
-        float timeWaitedTaskMs = 
-          atof(JSONLblVal(propTimeWaitedTaskMs));
-        stats->_timeWaitedTaskMs[0] = timeWaitedTaskMs;
-        stats->_timeWaitedTaskMs[1] = timeWaitedTaskMs;
-        stats->_timeWaitedTaskMs[2] = timeWaitedTaskMs;
-        
-        float timeWaitedAckMs = 
-          atof(JSONLblVal(propTimeWaitedAckMs));
-        stats->_timeWaitedAckMs[0] = timeWaitedAckMs;
-        stats->_timeWaitedAckMs[1] = timeWaitedAckMs;
-        stats->_timeWaitedAckMs[2] = timeWaitedAckMs;
-        
-        float temperature = 
-          atof(JSONLblVal(propTemperature));
-        stats->_temperature[0] = temperature;
-        stats->_temperature[1] = temperature;
-        stats->_temperature[2] = temperature;
-        
-        float timeTransferSquidSquadMs = 
-          atof(JSONLblVal(propTimeTransferSquidSquad));
-        stats->_timeTransferSquidSquadMs[0] = timeTransferSquidSquadMs;
-        stats->_timeTransferSquidSquadMs[1] = timeTransferSquidSquadMs;
-        stats->_timeTransferSquidSquadMs[2] = timeTransferSquidSquadMs;
-        
-      }
+        SquidletLogEvent(that, TheSquidEventType_SendReply, reply);
 
+        if (SquidletStreamInfo(that)){
+          SquidletPrint(that, SquidletStreamInfo(that));
+          fprintf(SquidletStreamInfo(that),
+            " : sent reply to task request %d\n", reply);
+        }
+      }
     }
-
   }
 
+  // Return the received task request
+  return taskRequest;
 }
 
-// Process the completed Pov-Ray 'task' with the Squad 'that'
-void SquadProcessCompletedTask_PovRay(
-                Squad* const that, 
-  SquidletTaskRequest* const task) {
+// Process the task request 'request' with the Squidlet 'that'
+void SquidletProcessRequest(
+             Squidlet* const that, 
+  SquidletTaskRequest* const request) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (task == NULL) {
+  if (request == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'task' is null");
+    sprintf(TheSquidErr->_msg, "'request' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
 
-  // Declare variables to decode the JSON data from the request 
-  // and the completed task
-  JSONNode* jsonRequest = JSONCreate();
-  JSONNode* jsonResult = JSONCreate();
+  // If the task is of type null
+  if (request->_type == SquidletTaskType_Null) {
 
-  // Decode the JSON data from the request and the completed task
-  bool ret = JSONLoadFromStr(jsonResult, task->_bufferResult);
-  ret &= JSONLoadFromStr(jsonRequest, task->_data);
+    // Nothing to do
+    return;
+  }
+
+  that->_taskType = request->_type;
+  SquidletLogEvent(that, TheSquidEventType_ProcessTask, 0);
+
+  if (SquidletStreamInfo(that)){
+    SquidletPrint(that, SquidletStreamInfo(that));
+    fprintf(SquidletStreamInfo(that), " : process task\n");
+  }
+
+  // Declare a variable to memorize the size in byte of the input data
+  unsigned long int sizeInputData = 0;
+
+  // Declare a buffer for the result data
+  char* bufferResult = NULL;
+
+  // Wait to receive the size of the input data with a time limit of
+  // THESQUID_WAITDATARECEPT_TIMEOUT seconds
+  bool ret = SocketRecv(&(that->_sockReply), sizeof(size_t), 
+    (char*)&sizeInputData, THESQUID_WAITDATARECEPT_TIMEOUT);
   
-  // If we could decode the JSON
+  // If we could receive the data size
   if (ret == true) {
 
-    // Get the necessary properties
-    JSONNode* propResultImg = JSONProperty(jsonRequest, "outTga");
-    JSONNode* propWidth = JSONProperty(jsonRequest, "width");
-    JSONNode* propHeight = JSONProperty(jsonRequest, "height");
-    JSONNode* propTga = JSONProperty(jsonResult, "tga");
-    JSONNode* propTop = JSONProperty(jsonResult, "top");
-    JSONNode* propLeft = JSONProperty(jsonResult, "left");
-    JSONNode* propRight = JSONProperty(jsonResult, "right");
-    JSONNode* propBottom = JSONProperty(jsonResult, "bottom");
+    // Declare a buffer for the raw input data
+    char* buffer = NULL;
 
-    // If the necessary properties were present
-    if (propTga != NULL && propTop != NULL && propLeft != NULL &&
-      propRight != NULL && propBottom != NULL && propResultImg != NULL) {
-      
-      // Load the result image
-      GenBrush* resultImg = 
-        GBCreateFromFile(JSONLblVal(propResultImg));
+    // If there are input data
+    if (sizeInputData > 0) {
 
-      // If the result image doesn't exists
-      if (resultImg == NULL) {
-        
-        // Create the result image
-        VecShort2D dim = VecShortCreateStatic2D();
-        VecSet(&dim, 0, atoi(JSONLblVal(propWidth)));
-        VecSet(&dim, 1, atoi(JSONLblVal(propHeight)));
-        resultImg = GBCreateImage(&dim);
-        GBSetFileName(resultImg, JSONLblVal(propResultImg));
+      SquidletLogEvent(that, TheSquidEventType_RecvDataSize, 
+        sizeInputData);
+
+      if (SquidletStreamInfo(that)) {
+        SquidletPrint(that, SquidletStreamInfo(that));
+        fprintf(SquidletStreamInfo(that), 
+          " : received size task data %ld\n", sizeInputData);
       }
 
-      // Load the fragment
-      GenBrush* fragment = 
-        GBCreateFromFile(JSONLblVal(propTga));
+      // Allocate memory for the input data
+      buffer = PBErrMalloc(TheSquidErr, sizeInputData + 1);
+      memset(buffer, 0, sizeInputData + 1);
+      
+      // Wait to receive the input data with a time limit proportional
+      // to the size of input data
+      int timeLimit = THESQUID_WAITDATARECEPT_TIMEOUT + \
+        (int)round((float)sizeInputData / 100.0);
+      ret = SocketRecv(&(that->_sockReply), sizeInputData, buffer, 
+        timeLimit);
+      
+      // If we couldn't receive the data
+      if (ret == false) {
 
-      // If we could load the fragment
-      if (fragment != NULL) {
-        
-        // Crop the relevant portion of the image
-        // Pov-Ray has its coordinate system origin at the top left of 
-        // the image, while GenBrush has its own at the bottom left
-        // Pov-Ray starts counting at 1, so the top left is (1,1)
-        VecShort2D dim = VecShortCreateStatic2D();
-        VecSet(&dim, 0,
-          atoi(JSONLblVal(propRight)) -
-          atoi(JSONLblVal(propLeft)) + 1);
-        VecSet(&dim, 1, 
-          atoi(JSONLblVal(propBottom)) -
-          atoi(JSONLblVal(propTop)) + 1);
-        VecShort2D posLR = VecShortCreateStatic2D();
-        VecSet(&posLR, 0, atoi(JSONLblVal(propLeft)) - 1);
-        VecSet(&posLR, 1, 
-          atoi(JSONLblVal(propHeight)) -
-          atoi(JSONLblVal(propBottom)));
+        // Free memory
+        free(buffer);
+        buffer = NULL;
         
-        // Add the fragment to the result image
-        GBCopyFragment(fragment, resultImg, &posLR, &posLR, &dim);
+        // Update the number of failed reception of data
+        ++(that->_nbFailedReceptTaskData);
 
-        // Save the result image
-        GBRender(resultImg);
+        SquidletLogEvent(that, TheSquidEventType_RecvDataFailed, 
+          sizeInputData);
 
-        // Free memory
-        GBFree(&fragment);
+        if (SquidletStreamInfo(that)){
+          SquidletPrint(that, SquidletStreamInfo(that));
+          fprintf(SquidletStreamInfo(that), 
+            " : couldn't receive task data\n");
+        }
       
-      // Else, we couldn't load the fragment
+      // Else, we could receive the data
       } else {
-        
-        // Update history
-        SquadPushHistory(that, "Couldn't read the fragment (%s)", 
-          GenBrushErr->_msg);
-      }
-
-      // Free memory
-      GBFree(&resultImg);
 
-      // Delete the fragment
-      char* cmd = PBErrMalloc(TheSquidErr, 
-        sizeof(char) * (1 + strlen(JSONLblVal(propTga)) + 3));
-      sprintf(cmd, "rm %s", JSONLblVal(propTga));
-      int ret = system(cmd);
-      free(cmd);
-      (void)ret;
+        SquidletLogEvent(that, TheSquidEventType_RecvData, 
+          sizeInputData);
 
-    } else {
+        if (SquidletStreamInfo(that)){
+          SquidletPrint(that, SquidletStreamInfo(that));
+          fprintf(SquidletStreamInfo(that), 
+            " : received task data (%lu bytes)\n", sizeInputData);
+        }
+      }
+    }
 
-      SquadPushHistory(that, 
-        "Can't preprocess the Pov-Ray task (invalid data)");
+    // If we could receive the expected data
+    if (sizeInputData > 0 && buffer != NULL) {
 
-    }
+      // Update the number of received bytes
+      that->_nbByteReceived += sizeInputData;
 
-    // Free memory
-    if (jsonResult != NULL)
-      JSONFree(&jsonResult);
-    if (jsonRequest != NULL)
-      JSONFree(&jsonRequest);
-  }
-}
+      // Memorize the id of the task for the event log
+      SquidletSetTaskId(that, buffer);
 
-// Set the flag memorizing if the TextOMeter is displayed for
-// the Squad 'that' to 'flag'
-void SquadSetFlagTextOMeter(
-  Squad* const that, 
-    const bool flag) {
-#if BUILDMODE == 0
-  if (that == NULL) {
-    TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'that' is null");
-    PBErrCatch(TheSquidErr);
-  }
-#endif
-  
-  // Create a copy of the flag
-  bool effectiveFlag = flag;
-  
-  // If the requested flag is different from the current flag;
-  if (that->_flagTextOMeter != effectiveFlag) {
-    
-    // If the user requested to turn on the textometer and the 
-    // textometer is currently off
-    if (effectiveFlag && that->_textOMeter == NULL) {
-      
-      // Create the TextOMeter
-      char title[] = "Squad";
-      int width = SQUAD_TXTOMETER_LENGTHLINEHISTORY + 1;
-      int height = SQUAD_TXTOMETER_NBLINEHISTORY + 
-        SQUAD_TXTOMETER_NBTASKDISPLAYED + 4;
-      that->_textOMeter = TextOMeterCreate(title, width, height);
-      
-      // If we couldn't create the TextOMeter
-      if (that->_textOMeter == NULL) {
+      // Process the request according to the request type
+      // and store the result into bufferResult
+      switch (request->_type) {
+        case SquidletTaskType_Dummy:
+          SquidletProcessRequest_Dummy(that, buffer, &bufferResult);
+          break;
+        case SquidletTaskType_Benchmark:
+          SquidletProcessRequest_Benchmark(that, buffer, &bufferResult);
+          break;
+        case SquidletTaskType_PovRay:
+          SquidletProcessRequest_PovRay(that, buffer, &bufferResult);
+          break;
+        case SquidletTaskType_ResetStats:
+          SquidletProcessRequest_StatsReset(that);
+          break;
+        case SquidletTaskType_EvalNeuranet:
+          SquidletProcessRequest_EvalNeuranet(that, buffer, 
+            &bufferResult);
+          break;
+        case SquidletTaskType_Stats:
+          SquidletProcessRequest_Stats(that, &bufferResult);
+          break;
+        case SquidletTaskType_Batch:
+          SquidletProcessRequest_Batch(that, buffer, &bufferResult);
+          break;
+        case SquidletTaskType_Exec:
+          SquidletProcessRequest_Exec(that, buffer, &bufferResult);
+          break;
+        default:
+          // Task of a plugin, the type has been checked at reception
+          if (TheSquidGetTaskPlugin(request->_type) != NULL) {
+            SquidletProcessRequest_Plugin(that, 
+              TheSquidGetTaskPlugin(request->_type), buffer, 
+              &bufferResult);
+          }
+          break;
+      }
 
-        // Force the flag to false
-        effectiveFlag = false;
+      // Update the distribution of the processing time
+      if (bufferResult != NULL && request->_type < SquidletTaskType_Nb &&
+        request->_type != SquidletTaskType_Stats) {
+        TheSquidHistoAdd(that->_histoTimeToProcessMs + request->_type, 
+          (float)(that->_timeToProcessMs));
       }
+
+      // Free memory
+      free(buffer);
     }
 
-    // If the user requested to turn off the textometer and the 
-    // textometer is currently on
-    if (!effectiveFlag && that->_textOMeter != NULL) {
-      
-      // Terminate the TextOMeter
-      TextOMeterFree(&(that->_textOMeter));
+  // Else we couldn't receive the data size
+  } else {
+
+    // Update the number of failed reception of data
+    ++(that->_nbFailedReceptTaskSize);
+    
+    SquidletLogEvent(that, TheSquidEventType_RecvDataSizeFailed, 0);
+
+    if (SquidletStreamInfo(that)){
+      SquidletPrint(that, SquidletStreamInfo(that));
+      fprintf(SquidletStreamInfo(that), 
+        " : couldn't receive data size\n");
     }
 
-    // Memorize the current status of the TextOMeter
-    that->_flagTextOMeter = effectiveFlag;
   }
-}
+  
+  // If bufferResult is not null here it means there is a result
+  // to be sent
+  if (bufferResult != NULL) {
 
-// Add one line to the history of messages for the TextOMeter
-// 'msg' is truncated if it doesn't fit in one line of history
-// If the TextOmeter is not turned on, do nothing
-// Variadic function with the same signature as printf family
-void SquadPushHistory(
-  Squad* const that, 
-         char* msg,
-               ...) {
-#if BUILDMODE == 0
-  if (that == NULL) {
-    TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'that' is null");
-    PBErrCatch(TheSquidErr);
-  }
-  if (msg == NULL) {
-    TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'msg' is null");
-    PBErrCatch(TheSquidErr);
-  }
-#endif
- 
-  // If the TextOMeter is not turned on
-  if (SquadGetFlagTextOMeter(that) == false) {
+    // Send the result
+    SquidletSendResultData(that, bufferResult);
 
-    // Do nothing
-    return;
-  }
- 
-  // Loop on each line of the history except the last one
-  for (int iLine = 0; iLine < SQUAD_TXTOMETER_NBLINEHISTORY - 1; 
-    ++iLine) {
+    // Free memory 
+    free(bufferResult);
 
-    // Copy the following line into the current line to 
-    // 'move up' the history by one step
-    strcpy(that->_history[iLine], that->_history[iLine + 1]);
   }
 
-  // Increment the counter of lines written in history
-  ++(that->_countLineHistory);
-
-  // Write the new line at the end of history, ensuring there is no
-  // overflow
-  sprintf(that->_history[SQUAD_TXTOMETER_NBLINEHISTORY - 1], 
-    "[%06u] ", that->_countLineHistory);
-  va_list ap;
-  va_start(ap, msg);
-  vsnprintf(that->_history[SQUAD_TXTOMETER_NBLINEHISTORY - 1] + 9,
-    SQUAD_TXTOMETER_LENGTHLINEHISTORY - 11, msg, ap);
-  va_end(ap);
+  // Delete the file attached to the result, if any, whether it could 
+  // be sent or not
+  if (that->_resultFilePath != NULL) {
+    unlink(that->_resultFilePath);
+    free(that->_resultFilePath);
+    that->_resultFilePath = NULL;
+    that->_resultFileSize = 0;
+  }
 
-  // Force a line return at the end of the line in history
-  unsigned long len = 
-    MIN(SQUAD_TXTOMETER_LENGTHLINEHISTORY - 2, strlen(
-    that->_history[SQUAD_TXTOMETER_NBLINEHISTORY - 1]));
-  that->_history[SQUAD_TXTOMETER_NBLINEHISTORY - 1][len] = '\n';
-  that->_history[SQUAD_TXTOMETER_NBLINEHISTORY - 1][len + 1] = '\0';
+  // Update the time when we last processed a request to calculate
+  // later the time between two processing
+  gettimeofday(&(that->_timeLastTaskComplete), NULL);
 
-  // Update the TextOMeter
-  SquadUpdateTextOMeter(that);
 }
 
-// Add the result of SquidletInfoPrint(squidlet) to the history
-// of messages for the TextOMeter
-// The output of SquidletInfoPrint is truncated if it doesn't fit in
-// one line of history
-// If the TextOmeter is not turned on, do nothing
-void SquadPushHistorySquidletInfo(
-               Squad* const that, 
-  const SquidletInfo* const squidlet) {
+// Send the result 'bufferResult' of the processing of a task
+// by the Squidlet 'that' 
+void SquidletSendResultData(
+             Squidlet* const that, 
+           const char* const bufferResult) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (squidlet == NULL) {
+  if (bufferResult == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'squidlet' is null");
+    sprintf(TheSquidErr->_msg, "'bufferResult' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
-  
-  // Declare a buffer to memorize the result of the SquidletInfoPrint
-  char buffer[SQUAD_TXTOMETER_LENGTHLINEHISTORY - 1];
-  
-  // Open a stream on the buffer
-  FILE* stream = fmemopen(buffer, sizeof(buffer), "w");
-  
-  // Print the task
-  SquidletInfoPrint(squidlet, stream);
 
-  // Close the stream
-  fclose(stream);
+  // Get the current time for statistics
+  struct timeval start;
+  gettimeofday(&start, NULL);
 
-  // Push the buffer in history
-  SquadPushHistory(that, buffer);
-}
+  // Send the result data size
+  int flags = 0;
+  size_t len = strlen(bufferResult);
+  bool ret = (send(that->_sockReply, 
+    (char*)&len, sizeof(size_t), flags) != -1);
 
-// Add the result of SquidletTaskRequestPrint(request) to the history
-// of messages for the TextOMeter
-// The output of SquidletTaskRequest is truncated if it doesn't fit in
-// one line of history
-// If the TextOmeter is not turned on, do nothing
-void SquadPushHistorySquidletTaskRequest(
-                      Squad* const that, 
-  const SquidletTaskRequest* const request) {
-#if BUILDMODE == 0
-  if (that == NULL) {
-    TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'that' is null");
-    PBErrCatch(TheSquidErr);
+  if (ret == true) {
+
+    // Update stats
+    struct timeval stop;
+    gettimeofday(&stop, NULL);
+    that->_timeTransferSquidSquadMs = 
+      (stop.tv_sec - start.tv_sec) * 1000 + 
+      (stop.tv_usec - start.tv_usec) / 1000;
+    that->_timeTransferSquidSquadMs /= (float)len;
+    TheSquidHistoAdd(&(that->_histoTimeTransferSquidSquadUsPerKB), 
+      that->_timeTransferSquidSquadMs * 1000.0 * 1024.0);
+
+    SquidletLogEvent(that, TheSquidEventType_SendResultSize, len);
+
+    if (SquidletStreamInfo(that)){
+      SquidletPrint(that, SquidletStreamInfo(that));
+      fprintf(SquidletStreamInfo(that), 
+        " : sent result size\n");
+      SquidletPrint(that, SquidletStreamInfo(that));
+      fprintf(SquidletStreamInfo(that), 
+        " : wait for acknowledgement from squad\n");
+    }
+
+    // Receive the acknowledgement
+    char ack = 0;
+    int waitDelayMaxSec = 60;
+    struct timeval start;
+    gettimeofday(&start, NULL);
+    ret = SocketRecv(&(that->_sockReply), sizeof(char), &ack, 
+      waitDelayMaxSec);
+
+    // If we could receive the acknowledgment
+    if (ret == true) {
+
+      // Update the statistics
+      struct timeval now;
+      gettimeofday(&now, NULL);
+      that->_timeWaitedAckMs = 
+        (now.tv_sec - start.tv_sec) * 1000 +
+        (now.tv_usec - start.tv_usec) / 1000;
+      TheSquidHistoAdd(&(that->_histoTimeWaitedAckMs), 
+        (float)(that->_timeWaitedAckMs));
+
+      SquidletLogEvent(that, TheSquidEventType_RecvAck, 0);
+
+      if (SquidletStreamInfo(that)){
+        SquidletPrint(that, SquidletStreamInfo(that));
+        fprintf(SquidletStreamInfo(that), 
+          " : received acknowledgement from squad\n");
+      }
+
+      // Send the result
+      ret = (send(that->_sockReply, bufferResult, len, flags) != -1);
+      if (ret == true)
+        that->_nbByteSent += len;
+
+      // Send the file attached to the result, if any
+      if (ret == true && that->_resultFilePath != NULL)
+        ret = SquidletSendResultFile(that);
+
+      // If we could send the result
+      if (ret == true) {
+        
+        // Update the number of successfully sent result
+        ++(that->_nbSentResult);
+
+        SquidletLogEvent(that, TheSquidEventType_SendResult, len);
+
+        if (SquidletStreamInfo(that)){
+          SquidletPrint(that, SquidletStreamInfo(that));
+          fprintf(SquidletStreamInfo(that), 
+            " : sent result (%lu bytes)\n", (unsigned long)len);
+        }
+      
+      // Else, we couldn't send the result
+      } else {
+
+        // Update the number of unsuccessfully sent result
+        ++(that->_nbFailedSendResult);
+
+        SquidletLogEvent(that, TheSquidEventType_SendResultFailed, len);
+
+        if (SquidletStreamInfo(that)){
+          SquidletPrint(that, SquidletStreamInfo(that));
+          fprintf(SquidletStreamInfo(that), 
+            " : couldn't send result (%lu bytes)\n", 
+              (unsigned long)len);
+        }
+      }
+    
+    // Else, we couldn't receive the acknowledgement
+    } else {
+
+      // Update the number of unsuccessfully received acknowledgment
+      ++(that->_nbFailedReceptAck);
+
+      SquidletLogEvent(that, TheSquidEventType_RecvAckFailed, 0);
+
+      if (SquidletStreamInfo(that)){
+        SquidletPrint(that, SquidletStreamInfo(that));
+        fprintf(SquidletStreamInfo(that), 
+          " : couldn't receive acknowledgement\n");
+      }
+    }
+
+  // Else, we couldn't send the result size
+  } else {
+
+
+    // Update the number of unsuccessfully sent result size
+    ++(that->_nbFailedSendResultSize);
+
+    SquidletLogEvent(that, TheSquidEventType_SendResultSizeFailed, len);
+
+    if (SquidletStreamInfo(that)){
+      SquidletPrint(that, SquidletStreamInfo(that));
+      fprintf(SquidletStreamInfo(that), 
+        " : couldn't send data size\n");
+    }
   }
-  if (request == NULL) {
-    TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'request' is null");
-    PBErrCatch(TheSquidErr);
+
+  if (SquidletStreamInfo(that)){
+    SquidletPrint(that, SquidletStreamInfo(that));
+    fprintf(SquidletStreamInfo(that), 
+      " : wait for acknowledgement from squad\n");
   }
-#endif
-  
-  // Declare a buffer to memorize the result of the
-  // SquidletTaskRequestPrint
-  char buffer[SQUAD_TXTOMETER_LENGTHLINEHISTORY - 1];
-  
-  // Open a stream on the buffer
-  FILE* stream = fmemopen(buffer, sizeof(buffer), "w");
-  
-  // Print the task
-  SquidletTaskRequestPrint(request, stream);
 
-  // Close the stream
-  fclose(stream);
+  // Receive the acknowledgment of reception of result
+  // Give up after THESQUID_PROC_TIMEOUT seconds
+  char ack = 0;
+  ret = SocketRecv(&(that->_sockReply), 1, &ack, 
+    THESQUID_PROC_TIMEOUT);
 
-  // Push the buffer in history
-  SquadPushHistory(that, buffer);
-}
+  // If we could receive the acknowledgement
+  if (ret == true) {
 
-// Add the result of SquadRunningTaskPrint(request) to the history
-// of messages for the TextOMeter
-// The output of SquadRunningTaskPrint is truncated if it doesn't fit in
-// one line of history
-// If the TextOmeter is not turned on, do nothing
-void SquadPushHistorySquadRunningTask(
-                   Squad* const that, 
-  const SquadRunningTask* const task) {
-#if BUILDMODE == 0
-  if (that == NULL) {
-    TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'that' is null");
-    PBErrCatch(TheSquidErr);
-  }
-  if (task == NULL) {
-    TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'task' is null");
-    PBErrCatch(TheSquidErr);
+    SquidletLogEvent(that, TheSquidEventType_RecvAck, 0);
+
+    if (SquidletStreamInfo(that)){
+      SquidletPrint(that, SquidletStreamInfo(that));
+      fprintf(SquidletStreamInfo(that), 
+        " : received acknowledgement from squad\n");
+    }
+
+  // Else, we couldn't receive the acknowledgement
+  } else {
+
+    // Update the number of unsuccessfully received acknowledgement
+    ++(that->_nbFailedReceptAck);
+
+    SquidletLogEvent(that, TheSquidEventType_RecvAckFailed, 0);
+
+    if (SquidletStreamInfo(that)){
+      SquidletPrint(that, SquidletStreamInfo(that));
+      fprintf(SquidletStreamInfo(that), 
+        " : couldn't receive acknowledgement from squad\n");
+    }
   }
-#endif
-  
-  // Declare a buffer to memorize the result of the SquadRunningTaskPrint
-  char buffer[SQUAD_TXTOMETER_LENGTHLINEHISTORY - 1];
-  
-  // Open a stream on the buffer
-  FILE* stream = fmemopen(buffer, sizeof(buffer), "w");
-  
-  // Print the task
-  SquadRunningTaskPrint(task, stream);
 
-  // Close the stream
-  fclose(stream);
+  SquidletLogEvent(that, TheSquidEventType_Ready, 0);
+  that->_taskType = SquidletTaskType_Null;
+  that->_taskId = 0;
+  that->_taskSubId = 0;
+
+  if (SquidletStreamInfo(that)){
+    SquidletPrint(that, SquidletStreamInfo(that));
+    fprintf(SquidletStreamInfo(that), 
+      " : ready for next task\n");
+  }
 
-  // Push the buffer in history
-  SquadPushHistory(that, buffer);
 }
 
-// Refresh the content of the TextOMeter attached to the 
-// Squad 'that'
-void SquadUpdateTextOMeter(const Squad* const that) {
+// Send the file attached to the result of the task currently processed 
+// by the Squidlet 'that' with sendfile(), without copying it in user 
+// space 
+// Return true if the whole file could be sent, else false
+bool SquidletSendResultFile(
+  Squidlet* const that) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (that->_textOMeter == NULL) {
+  if (that->_resultFilePath == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'that->_textOMeter' is null");
+    sprintf(TheSquidErr->_msg, "'that->_resultFilePath' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
-  // Clear the TextOMeter
-  TextOMeterClear(that->_textOMeter);
-  
-  // Declare a buffer to send text to the TextOMeter
-  char buffer[SQUAD_TXTOMETER_LENGTHLINEHISTORY + 1];
-  
-  // Print the header
-  sprintf(buffer, SQUAD_TXTOMETER_FORMAT1, 
-    SquadGetNbRunningTasks(that), SquadGetNbRemainingTasks(that),
-    SquadGetNbSquidlets(that));
-  TextOMeterPrint(that->_textOMeter, buffer);
-
-  // Print the history
-  for (int iLine = 0; iLine < SQUAD_TXTOMETER_NBLINEHISTORY; ++iLine) {
-    TextOMeterPrint(that->_textOMeter, that->_history[iLine]);
-  }
-
-  // Print the tasks header
-  sprintf(buffer, SQUAD_TXTOMETER_TASKHEADER);
-  TextOMeterPrint(that->_textOMeter, buffer);
-
-  // Print the running tasks
-  int iLine = 0;
-  if (SquadGetNbRunningTasks(that) > 0) {
-    GSetIterForward iter = GSetIterForwardCreateStatic(
-      (GSet*)SquadRunningTasks(that));
-    do {
-      SquadRunningTask* task = GSetIterGet(&iter);
-      if (task != NULL) {
-        char bufferTask[SQUAD_TXTOMETER_LENGTHLINEHISTORY - 12];
-        FILE* stream = fmemopen(
-          bufferTask, sizeof(bufferTask), "w");
-        SquadRunningTaskPrint(task, stream);
-        fclose(stream);
-        sprintf(buffer, SQUAD_TXTOMETER_FORMATRUNNING, bufferTask);
-      } else {
-        buffer[0] = '\0';
-      }
-      TextOMeterPrint(that->_textOMeter, buffer);
-      ++iLine;
-    } while (GSetIterStep(&iter) && 
-      iLine < SQUAD_TXTOMETER_NBTASKDISPLAYED);
-  }
+  // Open the file
+  int fd = open(that->_resultFilePath, O_RDONLY);
+  bool ret = (fd != -1);
 
-  // Print the remaining tasks
-  if (SquadGetNbRemainingTasks(that) > 0 &&
-    iLine < SQUAD_TXTOMETER_NBTASKDISPLAYED) {
-    GSetIterForward iter = GSetIterForwardCreateStatic(
-      (GSet*)SquadTasks(that));
-    do {
-      SquidletTaskRequest* task = GSetIterGet(&iter);
-      if (task != NULL) {
-        char bufferTask[SQUAD_TXTOMETER_LENGTHLINEHISTORY - 12];
-        FILE* stream = fmemopen(
-          bufferTask, sizeof(bufferTask), "w");
-        SquidletTaskRequestPrint(task, stream);
-        fclose(stream);
-        sprintf(buffer, SQUAD_TXTOMETER_FORMATQUEUED, bufferTask);
-      } else {
-        buffer[0] = '\0';
-      }
-      TextOMeterPrint(that->_textOMeter, buffer);
-      ++iLine;
-    } while (GSetIterStep(&iter) && 
-      iLine < SQUAD_TXTOMETER_NBTASKDISPLAYED - 1);
+  // Send the file until it's complete, give up after 
+  // THESQUID_PROC_TIMEOUT seconds
+  struct timeval start;
+  gettimeofday(&start, NULL);
+  off_t offset = 0;
+  while (ret == true && (size_t)offset < that->_resultFileSize) {
+    ssize_t nbSent = sendfile(that->_sockReply, fd, &offset, 
+      that->_resultFileSize - (size_t)offset);
+    if (nbSent <= 0 && (nbSent == 0 || 
+      (errno != EAGAIN && errno != EINTR) || 
+      TheSquidGetElapsedMs(&start) > 1000.0 * THESQUID_PROC_TIMEOUT))
+      ret = false;
   }
+  if (fd != -1)
+    close(fd);
 
-  // If there are more tasks than space to print them all
-  if (iLine == SQUAD_TXTOMETER_NBTASKDISPLAYED - 1) {
-
-    // Print a mark to specify there are non displayed tasks
-    sprintf(buffer, "...\n");
-    TextOMeterPrint(that->_textOMeter, buffer);
+  if (ret == true)
+    that->_nbByteSent += that->_resultFileSize;
 
-  // Else, there are remaining space to display more tasks
-  } else {
-    
-    // Fill in the remainnig space with empty lines
-    sprintf(buffer, "\n");
-    for (; iLine < SQUAD_TXTOMETER_NBTASKDISPLAYED; ++iLine) {
-      TextOMeterPrint(that->_textOMeter, buffer);
-    }
+  if (SquidletStreamInfo(that)){
+    SquidletPrint(that, SquidletStreamInfo(that));
+    fprintf(SquidletStreamInfo(that), 
+      " : %s result file %s (%lu bytes)\n", 
+      (ret == true ? "sent" : "couldn't send"), that->_resultFilePath, 
+      (unsigned long)(that->_resultFileSize));
   }
 
-  // Add an empty line at the bottom of the TextOMeter
-  sprintf(buffer, "\n");
-  TextOMeterPrint(that->_textOMeter, buffer);
-
-  // Flush the content of the TextOMeter
-  TextOMeterFlush(that->_textOMeter);
+  // Return the flag memorizing if we could send the file
+  return ret;
 }
 
-// Check all the squidlets of the Squad 'that' by processing a dummy 
-// task and display information about each one on the file 'stream'
-// Return true if all the tasks could be performed, false else
-bool SquadCheckSquidlets(
-  Squad* const that, 
-   FILE* const stream) {
+// Process a dummy task request with the Squidlet 'that'
+// The task request parameters are encoded in JSON and stored in the 
+// string 'buffer'
+// The result of the task are encoded in JSON format and stored in 
+// 'bufferResult' which is allocated as necessary
+void SquidletProcessRequest_Dummy(
+    Squidlet* const that,
+  const char* const buffer, 
+             char** bufferResult) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (stream == NULL) {
+  if (buffer == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'stream' is null");
+    sprintf(TheSquidErr->_msg, "'buffer' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
 
-  // Declare a variable to memorize the result
-  bool res = true;
-
-  // Declare variables to create a dummy task request
-  char* buffer = "{\"v\":\"0\"}";
-  time_t maxWait = 5;
+  // Declare a variable to memorize if the process has been successful
+  bool success = false;
 
-  // If there are squidlets
-  if (SquadGetNbSquidlets(that) > 0) {
+  // Declare a variable to memorize the result of processing
+  int result = 0; 
 
-    // Loop on the squidlets
-    GSetIterForward iter = 
-      GSetIterForwardCreateStatic(SquadSquidlets(that));
-    do {
+  // Allocate memory for the result
+  *bufferResult = PBErrMalloc(TheSquidErr, THESQUID_MAXPAYLOADSIZE);
+  memset(*bufferResult, 0, THESQUID_MAXPAYLOADSIZE);
 
-      // Get the squidlet
-      SquidletInfo* squidlet = GSetIterGet(&iter);
+  // Start measuring the time used to process the task
+  that->_timeToProcessMs = 0;
+  struct timeval start;
+  gettimeofday(&start, NULL);
 
-      // Display info about the squidlet
-      SquidletInfoPrint(squidlet, stream);
-      fprintf(stream, "\n");
+  // Process the data
+  if (SquidletStreamInfo(that)){
+    SquidletPrint(that, SquidletStreamInfo(that));
+    fprintf(SquidletStreamInfo(that), 
+      " : process dummy task %s\n", buffer);
+  }
 
-      // Create a dummy task
-      unsigned long id = 0;
-      unsigned long subId = 0;
-      SquidletTaskRequest* task = SquidletTaskRequestCreate(
-        SquidletTaskType_Dummy, id, subId, buffer, maxWait);
-      GSetAppend((GSet*)SquadTasks(that), task);
+  // Decode the input from JSON
+  JSONNode* json = JSONCreate();
+  bool ret = JSONLoadFromStr(json, buffer);
 
-      // Memorize the start time
-      struct timeval start;
-      gettimeofday(&start, NULL);
+  // If we could decode the input
+  if (ret == true) {
 
-      // Request the execution of the dummy task on the squidlet
-      bool ret = SquadSendTaskOnSquidlet(that, squidlet, task);
+    // Get the value to process
+    JSONNode* prop = JSONProperty(json, "v");
+    
+    // If the value is present
+    if (prop != NULL) {
+      
+      // Convert the value from string to int
+      int v = atoi(JSONLblVal(prop));
 
-      // Memorize the time to send the request
-      struct timeval timeToSend;
-      gettimeofday(&timeToSend, NULL);
+      // Process the value
+      result = v * -1;
 
-      // If the request was not successfull
-      if (!ret) {
-        
-        // Set the flag and display a message on the stream
-        res = false;
-        fprintf(stream, "\tThe request for a dummy task failed.\n");
+      // Sleep for v seconds
+      sleep(v);
 
-      // Else, the request was successfull
-      } else {
+      // Set the flag for successfull process
+      success = true;
 
-        // Get the running tasks
-        SquadRunningTask* runningTask = 
-          GSetPop((GSet*)SquadRunningTasks(that));
+      // Update the time used to process the task
+      struct timeval now;
+      gettimeofday(&now, NULL);
+      that->_timeToProcessMs = 
+        (now.tv_sec - start.tv_sec) * 1000 +
+        (now.tv_usec - start.tv_usec) / 1000;
 
-        // Loop until the task ends
-        bool flagStop = false;
-        while (!flagStop && time(NULL) - runningTask->_startTime <= 
-          runningTask->_request->_maxWaitTime) {
+      // Update the number of completed tasks
+      ++(that->_nbTaskComplete);
 
-          // If the task is completed
-          if (SquadReceiveTaskResult(that, runningTask)) {
+      // Prepare the result data as JSON
+      JSONNode* jsonResult = JSONCreate();
+      float temperature = SquidletGetTemperature(that);
+      char temperatureStr[10] = {'\0'};
+      sprintf(temperatureStr, "%.2f", temperature);
+      JSONAddProp(jsonResult, "temperature", temperatureStr);
+      char successStr[2] = {'\0'};
+      sprintf(successStr, "%d", success);
+      JSONAddProp(jsonResult, "success", successStr);
+      char resultStr[10] = {'\0'};
+      sprintf(resultStr, "%d", result);
+      JSONAddProp(jsonResult, "v", resultStr);
 
-            // Get the time to process
-            struct timeval timeToProcess;
-            gettimeofday(&timeToProcess, NULL);
+      // Convert the JSON to a string
+      bool compact = true;
+      ret = JSONSaveToStr(jsonResult, *bufferResult, 
+        THESQUID_MAXPAYLOADSIZE, compact);
+      if (ret == false) {
+        sprintf(*bufferResult, 
+          "{\"success\":\"0\",\"temperature\":\"0.0\","
+          "\"err\":\"JSONSaveToStr failed\"}");
+      }
 
-            // Stop the loop
-            flagStop = true;
+    // else the value is not present
+    } else {
 
-            // Process the result
-            SquidletTaskRequest* request = runningTask->_request;
-            fprintf(stream, "\tRequest for dummy task succeeded.\n");
-            fprintf(stream, "\t%s\n", request->_bufferResult);
-            unsigned long delayToSendms = 
-              (timeToSend.tv_sec - start.tv_sec) * 1000 + 
-              (timeToSend.tv_usec - start.tv_usec) / 1000;
-            unsigned long delayToProcessms = 
-              (timeToProcess.tv_sec - timeToSend.tv_sec) * 1000 + 
-              (timeToProcess.tv_usec - timeToSend.tv_usec) / 1000;
-            fprintf(stream, 
-              "\tdelay to send: %lums, delay to process: %lums\n", 
-              delayToSendms, delayToProcessms);
-          }
-        }
+      sprintf(*bufferResult, 
+        "{\"success\":\"0\",\"temperature\":\"0.0\","
+        "\"err\":\"Invalid input\"}");
+    }
 
-        // If we got out of the loop without the flag raising, it means
-        // we gave up on time
-        if (!flagStop) {
-          fprintf(stream, "\tGave up due to time limit.\n");
-        }
+  // Else, we couldn't decode the input
+  } else {
 
-        // Free memory
-        runningTask->_request = NULL;
-        runningTask->_squidlet = NULL;
-        SquadRunningTaskFree(&runningTask);
-      }
-    } while (GSetIterStep(&iter));
+    sprintf(*bufferResult, 
+      "{\"success\":\"0\",\"temperature\":\"0.0\","
+      "\"err\":\"JSONLoadFromStr failed\"}");
   }
 
-  // Return the result
-  return res;
-}
+  // Free memory
+  JSONFree(&json);
+}  
 
-// Run the benchmark with the squad 'that' and output the result on 
-// the file 'stream'
-// The benchmark consists of executing benchmark tasks with several
-// size and number of loop, first locally and then on the squidlet 
-// (which must have been loaded before calling this function)
-void SquadBenchmark(
-  Squad* const that, 
-   FILE* const stream) {
+// Append the statistical data about the squidlet 'that' to the JSON 
+// node 'json'
+void SquidletAddStatsToJSON(
+  const Squidlet* const that, 
+        JSONNode* const json) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (stream == NULL) {
+  if (json == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'stream' is null");
+    sprintf(TheSquidErr->_msg, "'json' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
+  // Declare a variable to convert numbers into string
+  // Hopefully numbers won't have more than 99 digits
+  const int bufferSize = 99;
+  char buffer[bufferSize];
 
-  fprintf(stream, "-- Benchmark started --\n");
-
-  // Declare parameters of the benchmark
-  // The benchmark will last 'lengthTest' per pair of 'maxSizePayload'
-  // and 'nbMaxLoop'
-  // 'maxSizePayload' is the max size of the set to be sorted by the 
-  // Squidlet. The size starts at 9 and increment geometrically by 10
-  // 'nbMaxLoop' is the max number of time the set is sorted by the
-  // Squidlet for one given task. The number starts at 1 and increment
-  // geometrically by 2.
-  float lengthTest = 240000.0; // ms
-  size_t maxSizePayload = 900;
-  int nbMaxLoop = 1024;
-
-  // Header for the results
-  char* header = "nbLoopPerTask\tnbBytePayload\tCompleted\tExpected\n";
-
-  // If the squad has no squidlet, it means we are running the benchmark
-  // on the local device for comparison
-  if (SquadGetNbSquidlets(that) == 0) {
-
-    // Display info
-    fprintf(stream, "Execution on local device:\n");
-    fprintf(stream, "%s", header);
-
-    // Loop on the payload
-    for (unsigned long int sizePayload = 9; 
-      sizePayload <= maxSizePayload; sizePayload *= 10) {
-
-      // Create a dummy buffer with the size of the payload
-      // The content of the buffer is actually set up by the benchmark 
-      // function on the squidlet
-      char* buffer = PBErrMalloc(TheSquidErr, sizePayload + 1);
-      memset(buffer, ' ', sizePayload);
-      buffer[sizePayload] = '\0';
-
-      // Loop on nbLoop
-      for (int nbLoop = 1; nbLoop <= nbMaxLoop; nbLoop *= 2) {
-
-        // Variable to memorize the starting time
-        struct timeval stop, start;
-        gettimeofday(&start, NULL);
-
-        // Variabel to memorize the number of completed tasks and 
-        // final time
-        unsigned long nbComplete = 0;
-        float deltams = 0;
-        
-        // Loop on the duration of the test
-        do {
-          
-          // Execute the benchmark function
-          TheSquidBenchmark(nbLoop, buffer);
-          
-          // Increment the number of completed task
-          ++nbComplete;
-          
-          // Get the current time
-          gettimeofday(&stop, NULL);
-          deltams = (float)(stop.tv_sec - start.tv_sec) * 1000.0 + 
-            (float)(stop.tv_usec - start.tv_usec) / 1000.0;
-
-        } while (deltams < lengthTest);
-
-        // Calculate the exact nb of tasks completed in the delay of 
-        // the test
-        float nbTaskExpected = lengthTest / deltams * (float)nbComplete;
-        
-        // Print results
-        fprintf(stream, "%04d\t%08lu\t%lu*%f/%f\t%.6f\n", 
-          nbLoop, sizePayload, nbComplete, lengthTest, deltams, nbTaskExpected);
-        fflush(stdout);
-      }
-
-      // Free memory
-      free(buffer);
-    }
-
-  // Else the squad has at least one squidlet, it means we execute the 
-  // benchmark on TheSquid
-  } else {
-    
-    // Display info
-    fprintf(stream, "Execution on TheSquid:\n");
-    fprintf(stream, "%s", header);
-
-    // Variables to create the tasks and manage the loops
-    time_t maxWait = 10000;
-    unsigned int id = 0;
-    bool flagStop = false;
-
-    // Loop on payload size
-    for (unsigned long int sizePayload = 9; !flagStop && 
-      sizePayload <= maxSizePayload; sizePayload *= 10) {
-
-      // Loop on nbLoop
-      for (int nbLoop = 1; !flagStop && nbLoop <= nbMaxLoop; 
-        nbLoop *= 2) {
-
-        // Reset the stats of all the squidlets
-        SquadRequestAllSquidletToResetStats(that);
-
-        // Variable ti measure time of execution
-        struct timeval stop, start;
-        gettimeofday(&start, NULL);
-        float deltams = 0.0;
-
-        // Loop during lengthTest seconds
-        do {
-          
-          // Create benchmark tasks, twice as many as squidlets to ensure
-          // there is always task ready to send in the SquadStep loop
-          while (SquadGetNbRunningTasks(that) + 
-            SquadGetNbRemainingTasks(that) < 
-            2 * SquadGetNbSquidlets(that)) {
-
-            SquadAddTask_Benchmark(that, id++, maxWait, nbLoop, 
-              sizePayload);
-
-          }
-
-          // Step the Squad
-          GSetSquadRunningTask completedTasks = SquadStep(that);
-
-          // Loop on co,pleted tasks
-          while (GSetNbElem(&completedTasks) > 0L) {
-
-            // Get the completed task
-            SquadRunningTask* completedTask = GSetPop(&completedTasks);
-            SquidletTaskRequest* task = completedTask->_request;
-
-            // If the task failed
-            if (strstr(task->_bufferResult, 
-              "\"success\":\"1\"") == NULL) {
-
-              // Display info and stop the benchmark
-              SquidletTaskRequestPrint(task, stdout);
-              fprintf(stream, " failed !!\n");
-              fprintf(stream, "%s\n", task->_bufferResult);
-              flagStop = true;
-            }
-
-            // Free memory
-            SquidletTaskRequestFree(&task);
-            SquadRunningTaskFree(&completedTask);
-          }
-
-          // Get the time
-          gettimeofday(&stop, NULL);
-          deltams = (float)(stop.tv_sec - start.tv_sec) * 1000.0 + 
-            (float)(stop.tv_usec - start.tv_usec) / 1000.0;
-
-        } while (!flagStop && deltams < lengthTest);
-
-        // If there are Squidlets which are not running at this point
-        if (SquadGetNbSquidlets(that) > 0) {
-
-          // Loop on free Squidlets
-          GSetIterForward iter = 
-            GSetIterForwardCreateStatic(SquadSquidlets(that));
-          do {
-
-            // Get the Squidlet
-            SquidletInfo* squidlet = GSetIterGet(&iter);
+  // Convert numbers into string and add the JSON property for each one
+  sprintf(buffer, "%lu", that->_nbAcceptedConnection);
+  JSONAddProp(json, "nbAcceptedConnection", buffer);
+  memset(buffer, 0, bufferSize);
 
-            // Update the timePerTask of the Squidlets
-            SquidletInfoStats* stats = 
-              (SquidletInfoStats*)SquidletInfoStatistics(squidlet);
-            stats->_timePerTask = 
-              deltams / (float)(stats->_nbTaskComplete);
+  sprintf(buffer, "%lu", that->_nbAcceptedTask);
+  JSONAddProp(json, "nbAcceptedTask", buffer);
+  memset(buffer, 0, bufferSize);
 
-          } while (GSetIterStep(&iter));
-        }
+  sprintf(buffer, "%lu", that->_nbRefusedTask);
+  JSONAddProp(json, "nbRefusedTask", buffer);
+  memset(buffer, 0, bufferSize);
 
-        // Flush the remaining tasks to let only the remaining Squidlet
-        // finish their task and avoid starting new ones
-        while (SquadGetNbRemainingTasks(that) > 0) {
-          SquidletTaskRequest* task = GSetPop(&(that->_tasks));
-          SquidletTaskRequestFree(&task);
-        }
+  sprintf(buffer, "%lu", that->_nbFailedReceptTaskSize);
+  JSONAddProp(json, "nbFailedReceptTaskSize", buffer);
+  memset(buffer, 0, bufferSize);
 
-        // While there are currently running tasks
-        while (!flagStop && SquadGetNbRunningTasks(that) > 0) {
+  sprintf(buffer, "%lu", that->_nbFailedReceptTaskData);
+  JSONAddProp(json, "nbFailedReceptTaskData", buffer);
+  memset(buffer, 0, bufferSize);
 
-          // Get the completed tasks
-          GSetSquadRunningTask completedTasks = SquadStep(that);
+  sprintf(buffer, "%lu", that->_nbSentResult);
+  JSONAddProp(json, "nbSentResult", buffer);
+  memset(buffer, 0, bufferSize);
 
-          // Measure time
-          gettimeofday(&stop, NULL);
-          deltams = (float)(stop.tv_sec - start.tv_sec) * 1000.0 + 
-            (float)(stop.tv_usec - start.tv_usec) / 1000.0;
+  sprintf(buffer, "%lu", that->_nbFailedSendResult);
+  JSONAddProp(json, "nbFailedSendResult", buffer);
+  memset(buffer, 0, bufferSize);
 
-          // Loop on completed tasks
-          while (GSetNbElem(&completedTasks) > 0L) {
+  sprintf(buffer, "%lu", that->_nbFailedSendResultSize);
+  JSONAddProp(json, "nbFailedSendResultSize", buffer);
+  memset(buffer, 0, bufferSize);
 
-            // Get the completed task
-            SquadRunningTask* completedTask = GSetPop(&completedTasks);
-            SquidletTaskRequest* task = completedTask->_request;
+  sprintf(buffer, "%lu", that->_nbFailedReceptAck);
+  JSONAddProp(json, "nbFailedReceptAck", buffer);
+  memset(buffer, 0, bufferSize);
 
-            // If the task failed
-            if (strstr(task->_bufferResult, 
-              "\"success\":\"1\"") == NULL) {
-                
-              // Display info and stop the benchmark
-              SquidletTaskRequestPrint(task, stdout);
-              fprintf(stream, " failed !!\n");
-              fprintf(stream, "%s\n", task->_bufferResult);
-              flagStop = true;
+  sprintf(buffer, "%lu", that->_nbTaskComplete);
+  JSONAddProp(json, "nbTaskComplete", buffer);
+  memset(buffer, 0, bufferSize);
 
-            // Else, the task succeeded
-            } else {
+  sprintf(buffer, "%lu", that->_nbByteReceived);
+  JSONAddProp(json, "nbByteReceived", buffer);
+  memset(buffer, 0, bufferSize);
 
-              // Update the timePerTask
-              SquidletInfo* squidlet = completedTask->_squidlet;
-              SquidletInfoStats* stats = 
-                (SquidletInfoStats*)SquidletInfoStatistics(squidlet);
-              stats->_timePerTask = 
-                deltams / (float)(stats->_nbTaskComplete);
-            }
-            
-            // Free memory
-            SquidletTaskRequestFree(&task);
-            SquadRunningTaskFree(&completedTask);
-          }
-        } 
- 
-        // Get the time when all the tasks have finished
-        gettimeofday(&stop, NULL);
+  sprintf(buffer, "%lu", that->_nbByteSent);
+  JSONAddProp(json, "nbByteSent", buffer);
+  memset(buffer, 0, bufferSize);
 
-        // Display the stats of all the squidlets
-        //SquadPrintStatsSquidlets(that, stream);
-        
-        // Decalre a variable to memorize the extrapolated total
-        // number of completed tasks at the current time
-        float nbTaskComplete = 0.0;
-        
-        // Calculate the delay from the start of this run
-        deltams = (float)(stop.tv_sec - start.tv_sec) * 1000.0 + 
-          (float)(stop.tv_usec - start.tv_usec) / 1000.0;
-
-        // Loop on the Squidlets
-        GSetIterForward iter = 
-          GSetIterForwardCreateStatic(SquadSquidlets(that));
-        do {
-
-          // Calculate the total nb of completed tasks at the time of 
-          // completion
-          SquidletInfo* squidlet = GSetIterGet(&iter);
-          SquidletInfoStats* stats = 
-            (SquidletInfoStats*)SquidletInfoStatistics(squidlet);
-          nbTaskComplete += deltams / stats->_timePerTask;
-        } while (GSetIterStep(&iter));
-
-        // Calculate the exact nb of tasks completed in the delay of 
-        // the test
-        float nbTaskExpected = lengthTest / deltams * nbTaskComplete;
-
-        // Display the results
-        fprintf(stream, "%04d\t%08lu\t%f*%f/%f\t%.6f\n", 
-          nbLoop, sizePayload, nbTaskComplete, lengthTest,
-          deltams, nbTaskExpected);
-        fflush(stream);
-      }
+  // Add the non empty histograms
+  char* str = NULL;
+  for (int iType = 0; iType < SquidletTaskType_Nb; ++iType) {
+    if (that->_histoTimeToProcessMs[iType]._nb > 0) {
+      char lbl[50];
+      sprintf(lbl, "timeToProcessMs%s", squidletTaskTypeStr[iType]);
+      str = TheSquidHistoToStr(that->_histoTimeToProcessMs + iType);
+      JSONAddProp(json, lbl, str);
+      free(str);
     }
   }
-  
-  // Display info
-  fprintf(stream, "-- Benchmark ended --\n");
-  
-}
-
-// Put back the 'task' into the set of task to complete of the Squad 
-// 'that'
-// Failed tasks (by timeout due to there 'maxWait' in 
-// SquadAddTask_xxx() or by failure code from the squidlet in the 
-// result data) are automatically put back into the set of task to 
-// complete
-void SquadTryAgainTask(
-                Squad* const that, 
-  SquidletTaskRequest* const task) {
-#if BUILDMODE == 0
-  if (that == NULL) {
-    TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'that' is null");
-    PBErrCatch(TheSquidErr);
-  }
-  if (task == NULL) {
-    TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'task' is null");
-    PBErrCatch(TheSquidErr);
-  }
-#endif
-
-  // Ensure the result buffer is empty
-  if (task->_bufferResult != NULL) {
-    free(task->_bufferResult);
-    task->_bufferResult = NULL;
-  }
-
-  // Put back the task in the set of task to complete
-  GSetAppend((GSet*)SquadTasks(that), task);
+  str = TheSquidHistoToStr(&(that->_histoTimeWaitedTaskMs));
+  JSONAddProp(json, "timeWaitedTaskMs", str);
+  free(str);
+  str = TheSquidHistoToStr(&(that->_histoTimeWaitedAckMs));
+  JSONAddProp(json, "timeWaitedAckMs", str);
+  free(str);
+  str = TheSquidHistoToStr(&(that->_histoTimeTransferSquidSquadUsPerKB));
+  JSONAddProp(json, "timeTransferSquidSquadUsPerKB", str);
+  free(str);
 }
 
-// Print the statistics about the currently available Squidlets of 
-// the Squad 'that' on the 'stream'
-void SquadPrintStatsSquidlets(
-  const Squad* const that, 
-         FILE* const stream) {
+// Process a benchmark task request with the Squidlet 'that'
+// The task request parameters are encoded in JSON and stored in the 
+// string 'buffer'
+// The result of the task are encoded in JSON format and stored in 
+// 'bufferResult' which is allocated as necessary
+void SquidletProcessRequest_Benchmark(
+    Squidlet* const that,
+  const char* const buffer, 
+             char** bufferResult) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (stream == NULL) {
-    TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'stream' is null");
-    PBErrCatch(TheSquidErr);
-  }
 #endif
 
-  // If there are currently available squidlets
-  if (SquadGetNbSquidlets(that) > 0) {
-
-    // Loop on the squidlets
-    GSetIterForward iter = 
-      GSetIterForwardCreateStatic(SquadSquidlets(that));
-    do {
-
-      // Get the squidlet
-      SquidletInfo* squidlet = GSetIterGet(&iter);
-
-      // Print the stats about this squidlet
-      fprintf(stream, " --- ");
-      SquidletInfoPrint(squidlet, stream);
-      fprintf(stream, " --- \n");
-      SquidletInfoStatsPrintln(SquidletInfoStatistics(squidlet), stream);
-    } while (GSetIterStep(&iter));
-  }
-}
-
-// -------------- Squidlet
-
-// ================= Global variable ==================
-
-// Variable to handle the signal Ctrl-C
-bool Squidlet_CtrlC = false;
-
-// ================ Functions implementation ====================
-
-// Handler for the signal Ctrl-C
-void SquidletHandlerCtrlC(
-  const int sig) {
-  // Don't use the signal
-  (void)sig;
-  // Raise the flag to memorize we have received the signal Ctrl-C
-  Squidlet_CtrlC = true;
-  // Display info
-  time_t intTime = time(NULL);
-  char* strIntTime = ctime(&intTime);
-  printf("Squidlet :  !!! Interrupted by Ctrl-C !!! %s", strIntTime);
-  fflush(stdout);
-}
-
-// Handler for the signal SIGPIPE
-// Catch the signal to avoid the Squidlet dying over a socket failure
-void SquidletHandlerSigPipe(
-  const int sig) {
-  // Don't use the signal
-  (void)sig;
-  // Display info
-  time_t intTime = time(NULL);
-  char* strIntTime = ctime(&intTime);
-  printf("Squidlet :  !!! Received SIGPIPE !!! %s", strIntTime);
-  fflush(stdout);
-}
+  // Start measuring the time used to process the task
+  that->_timeToProcessMs = 0;
+  struct timeval start;
+  gettimeofday(&start, NULL);
 
-// Return a new Squidlet listening to the IP adress 'addr' and port 
-// 'port'
-// If 'addr' equals 0, select automatically the first network address 
-// of the host 
-// If 'port' equals -1, select automatically one available between 
-// THESQUID_PORTMIN and THESQUID_PORTMAX
-Squidlet* SquidletCreateOnPort(
-  const uint32_t addr, 
-       const int port) {
-  
-  // Allocate memory for the squidlet
-  Squidlet* that = PBErrMalloc(TheSquidErr, sizeof(Squidlet));
-  
-  // Open the socket
-  that->_fd = socket(AF_INET, SOCK_STREAM, 0);
-  
-  // If we couldn't open the socket
-  if (that->_fd == -1) {
+  // Declare a variable to memorize if the process has been successful
+  bool success = false;
 
-    // Free memory and return null
-    free(that);
-    sprintf(TheSquidErr->_msg, "socket() failed");
-    return NULL;
-  }
+  // Variable to memorize the result of the benchmark function
+  int result = 0;
 
-  // Set the timeout for sending and receiving on this socket to 
-  // THESQUID_ACCEPT_TIMEOUT seconds
-  struct timeval tv;
-  tv.tv_sec = THESQUID_ACCEPT_TIMEOUT;
-  tv.tv_usec = 0;  
-  int reuse = 1;
-  bool ret = (setsockopt(that->_fd, SOL_SOCKET, SO_SNDTIMEO, 
-    (char*)&tv, sizeof(tv)) != -1);
-  ret &= (setsockopt(that->_fd, SOL_SOCKET, SO_RCVTIMEO, 
-    (char*)&tv, sizeof(tv)) != -1);
-  ret &= (setsockopt(that->_fd, SOL_SOCKET, SO_REUSEADDR,
-    &reuse,sizeof(int)) != -1);
+  // Declare a variable to store the error message if any
+  char errMsg[THESQUID_MAXPAYLOADSIZE] = {'\0'};
 
-  // If we couldn't set the timeout, free memory and return null
-  if (ret == false) {
+  // Decode the input from JSON
+  JSONNode* json = JSONCreate();
+  bool ret = JSONLoadFromStr(json, buffer);
+
+  // If we could decode the JSON
+  if (ret == true) {
+
+    // Get the values to process
+    JSONNode* propNb = JSONProperty(json, "nb");
+    JSONNode* propPayloadSize = JSONProperty(json, "payloadSize");
     
-    // Free memory and return null
-    close(that->_fd);
-    free(that);
-    sprintf(TheSquidErr->_msg, "setsockopt() failed");
-    return NULL;
-  }
+    // If the value were in the JSON
+    if (propNb != NULL && propPayloadSize != NULL) {
 
-  // Get the hostname
-  ret = (gethostname(that->_hostname, sizeof(that->_hostname)) != -1);
+      // Convert the value from string to int 
+      int nb = atoi(JSONLblVal(propNb));
 
-  // If we couldn't get the hostname
-  if (ret == false) {
+      if (SquidletStreamInfo(that)){
+        SquidletPrint(that, SquidletStreamInfo(that));
+        fprintf(SquidletStreamInfo(that), 
+          " : run benchmark\n");
+      }
 
-    // Free memory and return null
-    close(that->_fd);
-    free(that);
-    sprintf(TheSquidErr->_msg, "gethostname() failed");
-    return NULL;
-  }
-  
-  // Get the info about the host
-  that->_host = gethostbyname(that->_hostname); 
+      // Run the benchmark function
+      result = TheSquidBenchmark(nb, 
+        JSONLblVal(propPayloadSize));
 
-  // If we couldn't get the host info
-  if (that->_host == NULL) {
+      if (SquidletStreamInfo(that)){
+        SquidletPrint(that, SquidletStreamInfo(that));
+        fprintf(SquidletStreamInfo(that), 
+          " : benchmark complete\n");
+      }
 
-    // Free memory and return null
-    close(that->_fd);
-    free(that);
-    sprintf(TheSquidErr->_msg, "gethostbyname() failed");
-    return NULL;
-  }
-  
-  // Init the port and socket info
-  memset(&(that->_sock), 0, sizeof(struct sockaddr_in));
-  that->_sock.sin_family = AF_INET;
-  if (addr != 0)
-    that->_sock.sin_addr.s_addr = addr;
-  else
-    that->_sock.sin_addr.s_addr = *(uint32_t*)(that->_host->h_addr_list[0]);
-  if (port != -1)
-    that->_port = port;
-  else
-    that->_port = THESQUID_PORTMIN;
-  that->_sock.sin_port = htons(that->_port);
-  
-  // If the port is not specified by the user
-  if (port == -1) {
+      // Set the flag for successfull process
+      success = true;
 
-    // Loop on the ports until we find one availalble
-    while (bind(that->_fd, (struct sockaddr *)&(that->_sock), 
-      sizeof(struct sockaddr_in)) == -1 && 
-      that->_port < THESQUID_PORTMAX) {
-      ++(that->_port);
-      that->_sock.sin_port = htons(that->_port);
-    }
-    
-    // If we couldn't find an available port
-    if (that->_port == THESQUID_PORTMAX) {
+    // Else, at least one value was missing
+    } else {
 
-      // Free memory and return null
-      close(that->_fd);
-      free(that);
-      sprintf(TheSquidErr->_msg, "bind() failed");
-      return NULL;
+      // Update the error message
+      sprintf(errMsg, "missing data (nb or v)");
+
+      if (SquidletStreamInfo(that)){
+        SquidletPrint(that, SquidletStreamInfo(that));
+        fprintf(SquidletStreamInfo(that), " : missing data (nb or v)\n");
+      }
     }
 
-  // Else if the port is specified by the user, try to bind only on 
-  // that port
+  // Else, we couldn't decode the JSON
   } else {
 
-    // If we couldn't bind the socket on the requested port
-    if (bind(that->_fd, (struct sockaddr *)&(that->_sock), 
-      sizeof(struct sockaddr_in)) == -1) {
+    // Update the error message
+    sprintf(errMsg, "couldn't load json (%s)", JSONErr->_msg);
 
-      // Free memory and return null
-      close(that->_fd);
-      free(that);
-      sprintf(TheSquidErr->_msg, "bind() failed");
-      return NULL;
+    if (SquidletStreamInfo(that)){
+      SquidletPrint(that, SquidletStreamInfo(that));
+      fprintf(SquidletStreamInfo(that), 
+        " : couldn't load json %s\n", buffer);
     }
   }
-  
-  // Start listening through the socket
-  if (listen(that->_fd, THESQUID_NBMAXPENDINGCONN) == -1) {
 
-    // If we can't listen through the socket, close it, free memory and 
-    // return null
-    close(that->_fd);
-    free(that);
-    sprintf(TheSquidErr->_msg, "listen() failed");
-    return NULL;
+  // Free memory
+  JSONFree(&json);
+
+  // Update the time used to process the task
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  that->_timeToProcessMs = 
+    (now.tv_sec - start.tv_sec) * 1000 +
+    (now.tv_usec - start.tv_usec) / 1000;
+
+  // Update the number of completed tasks if it was successfull
+  if (success == true) {
+    ++(that->_nbTaskComplete);
   }
 
-  // Init the PID
-  that->_pid = getpid();
+  // Prepare the result data as JSON
+  JSONNode* jsonResult = JSONCreate();
+  float temperature = SquidletGetTemperature(that);
+  // This software is not guaranteed to run under temperature having
+  // more than 7 digits, you've be warned !
+  char temperatureStr[10] = {'\0'};
+  sprintf(temperatureStr, "%.2f", temperature);
+  JSONAddProp(jsonResult, "temperature", temperatureStr);
+  char successStr[2] = {'\0'};
+  sprintf(successStr, "%d", success);
+  JSONAddProp(jsonResult, "success", successStr);
+  // Result is an int, 10 digits will be fine
+  char resultStr[10] = {'\0'};
+  sprintf(resultStr, "%d", result);
+  JSONAddProp(jsonResult, "v", resultStr);
+  JSONAddProp(jsonResult, "err", errMsg);
 
-  // Init the socket for reply
-  that->_sockReply = -1;
+  // Convert the JSON to a string and store it in the result buffer
+  *bufferResult = PBErrMalloc(TheSquidErr, THESQUID_MAXPAYLOADSIZE);
+  memset(*bufferResult, 0, THESQUID_MAXPAYLOADSIZE);
+  bool compact = true;
+  ret = JSONSaveToStr(jsonResult, 
+    *bufferResult, THESQUID_MAXPAYLOADSIZE, compact);
+  if (ret == false) {
+    sprintf(*bufferResult, 
+      "{\"success\":\"0\",\"temperature\":\"0.0\","
+      "\"err\":\"JSONSaveToStr failed\"}");
+  }
 
-  // Set the handler to catch the signal Ctrl-C
-  signal(SIGINT, SquidletHandlerCtrlC);
+}  
 
-  // Init the stream for output
-  that->_streamInfo = NULL;
+// Process a Pov-Ray task request with the Squidlet 'that'
+// The task request parameters are encoded in JSON and stored in the 
+// string 'buffer'
+// The result of the task are encoded in JSON format and stored in 
+// 'bufferResult' which is allocated as necessary
+void SquidletProcessRequest_PovRay(
+    Squidlet* const that,
+  const char* const buffer, 
+             char** bufferResult) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Declare a variable to memorize if the process has been successful
+  bool success = false;
 
-  // Init the variables for statistics
-  SquidletResetStats(that);
+  // Display info
+  if (SquidletStreamInfo(that)) {
+    SquidletPrint(that, SquidletStreamInfo(that));
+    fprintf(SquidletStreamInfo(that), 
+      " : process Pov-Ray task %s\n", buffer);
+    fflush(SquidletStreamInfo(that));
+  }
 
-  // Init the properties for neuranet evaluation task
-  that->_datasetPath = NULL;
-  that->_dataset = GDataSetVecFloatCreateStatic();
+  // Decode the input from JSON
+  JSONNode* json = JSONCreate();
+  bool ret = JSONLoadFromStr(json, buffer);
 
-  // Return the new squidlet
-  return that;
-}
+  // If we could decode the JSON
+  if (ret == true) {
 
-// Free the memory used by the Squidlet 'that'
-void SquidletFree(
-  Squidlet** that) {
+    // Get the arguments
+    JSONNode* propIni = JSONProperty(json, "ini");
+    JSONNode* propTga = JSONProperty(json, "tga");
+    JSONNode* propTop = JSONProperty(json, "top");
+    JSONNode* propLeft = JSONProperty(json, "left");
+    JSONNode* propBottom = JSONProperty(json, "bottom");
+    JSONNode* propRight = JSONProperty(json, "right");
+    JSONNode* propSendFile = JSONProperty(json, "sendFile");
+
+    // If the fragment must be sent back over the socket, render it in 
+    // a temporary file private to the squidlet instead of the tga file
+    char tmpPath[] = "/tmp/TheSquidPovRayXXXXXX.tga";
+    bool retTmp = true;
+    if (propSendFile != NULL) {
+      int fdTmp = mkstemps(tmpPath, 4);
+      retTmp = (fdTmp != -1);
+      if (retTmp == true)
+        close(fdTmp);
+    }
 
-  // If the pointer is null there is nothing to do
-  if (that == NULL || *that == NULL)
-    return;
+    // If all the arguments are presents
+    if (propIni != NULL && propTga != NULL && propTop != NULL && 
+      propLeft != NULL && propBottom != NULL && propRight != NULL && 
+      retTmp == true) {
+
+      // Create the arguments of the Pov-Ray command 
+      // povray <ini> +SC<left> +SR<top> +EC<right> +ER<bottom> +O<tga> 
+      //   +FT -D
+      char* args[6];
+      const char* prefixes[6] = {"+SC", "+SR", "+EC", "+ER", "+O", ""};
+      const char* vals[6] = {
+        JSONLblVal(propLeft), JSONLblVal(propTop), JSONLblVal(propRight), 
+        JSONLblVal(propBottom), JSONLblVal(propTga), JSONLblVal(propIni)};
+      if (propSendFile != NULL)
+        vals[4] = tmpPath;
+      for (int iArg = 0; iArg < 6; ++iArg) {
+        args[iArg] = PBErrMalloc(TheSquidErr, 
+          strlen(prefixes[iArg]) + strlen(vals[iArg]) + 1);
+        sprintf(args[iArg], "%s%s", prefixes[iArg], vals[iArg]);
+      }
+      char* argv[] = {
+        "povray", args[5], args[0], args[1], args[2], args[3], args[4], 
+        "+FT", "-D", NULL};
+
+      // Execute the Pov-Ray command, without shell, its standard input 
+      // and output are the ones of the squidlet
+      int timeout = 0;
+      int ret = TheSquidSpawn("povray", argv, NULL, 0, NULL, NULL, 
+        timeout);
+      for (int iArg = 0; iArg < 6; ++iArg)
+        free(args[iArg]);
+      
+      if (ret == 0) {
+        // Set the flag for successfull process
+        success = true;
+      }
 
-  // Close the socket
-  close((*that)->_fd);
+      // Memorize the rendered fragment to send it after the result
+      struct stat statTmp;
+      if (success == true && propSendFile != NULL) {
+        if (stat(tmpPath, &statTmp) == 0) {
+          that->_resultFilePath = strdup(tmpPath);
+          that->_resultFileSize = (size_t)(statTmp.st_size);
+          char sizeStr[21] = {'\0'};
+          sprintf(sizeStr, "%lu", (unsigned long)(statTmp.st_size));
+          JSONAddProp(json, "fileSize", sizeStr);
+        } else {
+          success = false;
+        }
+      }
+    }
 
-  // Close the socket for the reply if it is opened
-  if ((*that)->_sockReply != -1)
-    close((*that)->_sockReply);
+    // Delete the temporary file if the fragment couldn't be rendered
+    if (propSendFile != NULL && retTmp == true && success == false)
+      unlink(tmpPath);
+  }
+
+  // Update the number of completed tasks if it was successfull
+  if (success == true) {
+    ++(that->_nbTaskComplete);
+  }
+
+  // Prepare the result data as JSON
+  *bufferResult = PBErrMalloc(TheSquidErr, THESQUID_MAXPAYLOADSIZE);
+  memset(*bufferResult, 0, THESQUID_MAXPAYLOADSIZE);
+  char successStr[2] = {'\0'};
+  sprintf(successStr, "%d", success);
+  JSONAddProp(json, "success", successStr);
+  float temperature = SquidletGetTemperature(that);
+  // This software is not guaranteed to run under temperature having
+  // more than 7 digits, you've be warned !
+  char temperatureStr[10] = {'\0'};
+  sprintf(temperatureStr, "%.2f", temperature);
+  JSONAddProp(json, "temperature", temperatureStr);
+  ret = JSONSaveToStr(json, 
+    *bufferResult, THESQUID_MAXPAYLOADSIZE, true);
+  if (ret == false) {
+    sprintf(*bufferResult, 
+      "{\"success\":\"0\",\"temperature\":\"0.0\","
+      "\"err\":\"JSONSaveToStr failed\"}");
+  }
 
   // Free memory
-  GDataSetVecFloatFreeStatic(&((*that)->_dataset));
-  free(*that);
-  *that = NULL;
-}
+  JSONFree(&json);
 
-// Print the PID, Hostname, IP and Port of the Squidlet 'that' on the 
-// file 'stream'
-// Example: 100 localhost 0.0.0.0:3000
-void SquidletPrint(
-  const Squidlet* const that, 
-            FILE* const stream) {
+}  
+
+// Process a stats reset task request with the Squidlet 'that'
+void SquidletProcessRequest_StatsReset(
+    Squidlet* const that) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (stream == NULL) {
-    TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'stream' is null");
-    PBErrCatch(TheSquidErr);
-  }
 #endif
 
-  // Print the info on the stream
-  fprintf(stream, "%d %s %s:%d", SquidletGetPID(that), 
-    SquidletHostname(that), SquidletIP(that), SquidletGetPort(that));
-}
+  // Reset the stats
+  SquidletResetStats(that);
+}  
 
-// Reset the statistics of the Squidlet 'that'
-void SquidletResetStats(
-  Squidlet* const that) {
+// Process a stats task request with the Squidlet 'that'
+// The statistics of the squidlet are encoded in JSON format and 
+// stored in 'bufferResult' which is allocated as necessary
+void SquidletProcessRequest_Stats(
+    Squidlet* const that,
+             char** bufferResult) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
+  if (bufferResult == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'bufferResult' is null");
+    PBErrCatch(TheSquidErr);
+  }
 #endif
 
-  that->_nbAcceptedConnection = 0;
-  that->_nbAcceptedTask = 0;
-  that->_nbRefusedTask = 0;
-  that->_nbFailedReceptTaskData = 0;
-  that->_nbFailedReceptTaskSize = 0;
-  that->_nbSentResult = 0;
-  that->_nbFailedSendResult = 0;
-  that->_nbFailedSendResultSize = 0;
-  that->_nbFailedReceptAck = 0;
-  that->_nbTaskComplete = 0;
-  that->_timeToProcessMs = 0;
-  that->_timeWaitedTaskMs = 0;
-  that->_timeWaitedAckMs = 0;
+  // Prepare the result data as JSON
+  JSONNode* json = JSONCreate();
+  char successStr[2] = "1";
+  JSONAddProp(json, "success", successStr);
+  char temperatureStr[10] = {'\0'};
+  sprintf(temperatureStr, "%.2f", SquidletGetTemperature(that));
+  JSONAddProp(json, "temperature", temperatureStr);
+  char throttledStr[2] = "0";
+  if (SquidletIsThrottled(that) == true)
+    throttledStr[0] = '1';
+  JSONAddProp(json, "throttled", throttledStr);
+  SquidletAddStatsToJSON(that, json);
 
-}
+  // If the squidlet is a relay, add its capacity and the merged stats 
+  // of its squidlets
+  if (that->_relay != NULL) {
+    char capacityStr[20] = {'\0'};
+    sprintf(capacityStr, "%lu", SquadGetCapacity(that->_relay));
+    JSONAddProp(json, "capacity", capacityStr);
+    SquidletInfoStats relayStats;
+    SquidletInfoStatsInit(&relayStats);
+    if (GSetNbElem(SquadSquidlets(that->_relay)) > 0) {
+      GSetIterForward iter = 
+        GSetIterForwardCreateStatic(SquadSquidlets(that->_relay));
+      do {
+        SquidletInfo* squidlet = GSetIterGet(&iter);
+        SquidletInfoStatsMerge(&relayStats, 
+          SquidletInfoStatistics(squidlet));
+      } while (GSetIterStep(&iter));
+    }
+    if (GSetNbElem(SquadRunningTasks(that->_relay)) > 0) {
+      GSetIterForward iter = 
+        GSetIterForwardCreateStatic(SquadRunningTasks(that->_relay));
+      do {
+        SquadRunningTask* runningTask = GSetIterGet(&iter);
+        SquidletInfoStatsMerge(&relayStats, 
+          SquidletInfoStatistics(runningTask->_squidlet));
+      } while (GSetIterStep(&iter));
+    }
+    char relayStr[20] = {'\0'};
+    sprintf(relayStr, "%lu", relayStats._nbTaskComplete);
+    JSONAddProp(json, "relayNbTaskComplete", relayStr);
+    sprintf(relayStr, "%lu", relayStats._nbRefusedTask);
+    JSONAddProp(json, "relayNbRefusedTask", relayStr);
+  }
+
+  // Convert the JSON to a string, its size depends on the number of
+  // non empty buckets in the histograms, so it's not limited to 
+  // THESQUID_MAXPAYLOADSIZE
+  size_t len = 0;
+  *bufferResult = NULL;
+  FILE* stream = open_memstream(bufferResult, &len);
+  bool compact = true;
+  bool ret = (stream != NULL && JSONSave(json, stream, compact));
+  if (stream != NULL)
+    fclose(stream);
+  if (ret == false) {
+    if (*bufferResult != NULL)
+      free(*bufferResult);
+    *bufferResult = PBErrMalloc(TheSquidErr, THESQUID_MAXPAYLOADSIZE);
+    sprintf(*bufferResult, 
+      "{\"success\":\"0\",\"temperature\":\"0.0\","
+      "\"err\":\"JSONSave failed\"}");
+  }
 
-// Wait for a task request to be received by the Squidlet 'that'
-// Return the received task request, or give up after 
-// THESQUID_ACCEPT_TIMEOUT if there was no request and return a task 
-// request of type SquidletTaskType_Null
-SquidletTaskRequest SquidletWaitRequest(
-  Squidlet* const that) {
+  // Free memory
+  JSONFree(&json);
+}  
+
+// Process a neuranet evaluation task request with the Squidlet 'that'
+// The task request parameters are encoded in JSON and stored in the 
+// string 'buffer'
+// The result of the task are encoded in JSON format and stored in 
+// 'bufferResult' which is allocated as necessary
+void SquidletProcessRequest_EvalNeuranet(
+    Squidlet* const that,
+  const char* const buffer, 
+             char** bufferResult) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
+  if (buffer == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'buffer' is null");
+    PBErrCatch(TheSquidErr);
+  }
 #endif
-  // Declare a variable to memorize the reply to the request
-  char reply = THESQUID_TASKREFUSED;
 
-  // Declare a buffer to receive the payload of the connection
-  SquidletTaskRequest taskRequest;
+  // Declare a variable to memorize if the process has been successful
+  bool success = false;
 
-  // Initialize the type of th received task to SquidletTaskType_Null
-  taskRequest._type = SquidletTaskType_Null;
+  // Allocate memory for the result
+  *bufferResult = PBErrMalloc(TheSquidErr, THESQUID_MAXPAYLOADSIZE);
+  memset(*bufferResult, 0, THESQUID_MAXPAYLOADSIZE);
 
-  // Declare a variable to memorize the info about the incoming 
-  // connection
-  struct sockaddr_in incomingSock;
-  socklen_t incomingSockSize = sizeof(incomingSock);
-  
-  // Make sure the socket for reply is closed
-  if (that->_sockReply != -1) {
-    close(that->_sockReply);
-    that->_sockReply = -1;
+  // Start measuring the time used to process the task
+  that->_timeToProcessMs = 0;
+  struct timeval start;
+  gettimeofday(&start, NULL);
+
+  // Process the data
+  if (SquidletStreamInfo(that)){
+    SquidletPrint(that, SquidletStreamInfo(that));
+    fprintf(SquidletStreamInfo(that), 
+      " : process neuranet evaluation task %s\n", buffer);
   }
-  
-  // Extract the first connection request on the queue of pending 
-  // connections if there was one. If there are none wait for
-  // one during THESQUID_ACCEPT_TIMEOUT seconds and then give up
-  that->_sockReply = accept(that->_fd, (struct sockaddr *)&incomingSock,
-    &incomingSockSize);
 
-  // If we could extract a pending connection
-  if (that->_sockReply >= 0) {
+  // Decode the input from JSON
+  JSONNode* json = JSONCreate();
+  bool ret = JSONLoadFromStr(json, buffer);
 
-    // Update the number of accepted connection
-    ++(that->_nbAcceptedConnection);
+  // If we could decode the input
+  if (ret == true) {
 
-    if (SquidletStreamInfo(that)){
-      SquidletPrint(that, SquidletStreamInfo(that));
-      fprintf(SquidletStreamInfo(that), " : accepted connection\n");
+    // Get the dataset path
+    JSONNode* propDataset = JSONProperty(json, "dataset");
+    
+    // Get the working dir path
+    JSONNode* propWorkingDir = JSONProperty(json, "workingDir");
+    
+    // Get the hashes and definitions of the inlined NeuraNets, the 
+    // definitions are absent for the NeuraNets already sent to this
+    // squidlet
+    JSONNode* propNNHashes = JSONProperty(json, "nnhashes");
+    JSONNode* propNNs = JSONProperty(json, "nns");
+    
+    // Get the entity ids
+    JSONNode* propIds = JSONProperty(json, "nnids");
+    VecLong* nnids = NULL;
+    VecDecodeAsJSON(&nnids, propIds);
+    
+    // Get the best value
+    JSONNode* propBest = JSONProperty(json, "best");
+    
+    // Get the category in dataset
+    JSONNode* propCat = JSONProperty(json, "cat");
+    
+    // Get the flag for fast reject mode, optional
+    JSONNode* propReject = JSONProperty(json, "reject");
+    bool fastReject = (propReject != NULL && 
+      atoi(JSONLblVal(propReject)) == 1);
+    
+    // Get the range of samples for a sharded evaluation, optional
+    JSONNode* propShard = JSONProperty(json, "shard");
+    JSONNode* propNbShard = JSONProperty(json, "nbShard");
+    long shard = 0;
+    long nbShard = 1;
+    if (propShard != NULL && propNbShard != NULL) {
+      shard = atol(JSONLblVal(propShard));
+      nbShard = MAX(1, atol(JSONLblVal(propNbShard)));
     }
     
-    // Set the timeout for sending and receiving on the
-    // extracted socket to THESQUID_PROC_TIMEOUT sec
-    struct timeval tv;
-    tv.tv_sec = THESQUID_PROC_TIMEOUT;
-    tv.tv_usec = 0;  
-    int reuse = 1;
-    bool ret = (setsockopt(that->_sockReply, SOL_SOCKET, SO_SNDTIMEO, 
-      (char*)&tv, sizeof(tv)) != -1);
-    ret &= (setsockopt(that->_sockReply, SOL_SOCKET, SO_RCVTIMEO, 
-      (char*)&tv, sizeof(tv)) != -1);
-    ret &= (setsockopt(that->_sockReply, SOL_SOCKET, SO_REUSEADDR,
-      &reuse, sizeof(int)) != -1);
+    // If all the values are present
+    if (propDataset != NULL && 
+      (propWorkingDir != NULL || (propNNHashes != NULL && 
+      JSONGetNbValue(propNNHashes) == VecGetDim(nnids) &&
+      VecGetDim(nnids) <= THESQUID_NBNNCACHE)) && 
+      propIds != NULL && 
+      propBest != NULL &&
+      propCat != NULL) {
+      
+      // Convert the ids, cat and best value from string
+      long cat = atol(JSONLblVal(propCat));
+      float bestVal = atof(JSONLblVal(propBest));
 
-    // If we couldn't set the timeout
-    if (ret == false) {
- 
-      // Refuse the task
-      reply = THESQUID_TASKREFUSED;
+      // If the dataset in argument is different from the last one used
+      if (that->_datasetPath == NULL ||
+        strcmp(that->_datasetPath, JSONLblVal(propDataset)) != 0) {
+
+        // Free the current dataset
+        GDataSetVecFloatFreeStatic(&(that->_dataset));
+
+        // Load the requested dataset
+        that->_dataset = GDataSetVecFloatCreateStaticFromFile(
+          JSONLblVal(propDataset));
+
+        // Memorize the path
+        if (that->_datasetPath != NULL)
+          free(that->_datasetPath);
+        that->_datasetPath = strdup(JSONLblVal(propDataset));
+        
+        // The samples of the previous dataset are not valid anymore
+        if (that->_samples != NULL)
+          free(that->_samples);
+        that->_samples = NULL;
+        that->_samplesCat = -1;
 
-      if (SquidletStreamInfo(that)){
-        SquidletPrint(that, SquidletStreamInfo(that));
-        fprintf(SquidletStreamInfo(that), " : setsockopt failed\n");
       }
 
-    // Else, we could set the timeout
-    } else {
+      // If we could load the dataset and its samples for the
+      // requested category
+      if (GDSGetSizeCat(&(that->_dataset), cat) > 0 &&
+        SquidletCacheSamples(that, cat)) {
 
-      // Receive the task type, give up after 
-      // THESQUID_PROC_TIMEOUT seconds
-      ret = SocketRecv(&(that->_sockReply), sizeof(SquidletTaskType), 
-        (char*)&taskRequest, THESQUID_PROC_TIMEOUT);
+        // Declare a variable to memorize the values
+        VecFloat* values = VecFloatCreate(VecGetDim(nnids));
+        
+        // Declare a variable to memorize the number of samples on
+        // which each NeuraNet has been evaluated
+        VecLong* nbEvals = VecLongCreate(VecGetDim(nnids));
+        
+        // Declare a variable to memorize the sum of errors
+        VecFloat* sumErrs = VecFloatCreate(VecGetDim(nnids));
 
-      // If we could receive the task type
-      if (ret == true) {
+        // Get the range of samples to evaluate
+        long first = that->_nbSample * shard / nbShard;
+        long last = that->_nbSample * (shard + 1) / nbShard;
         
-        // The task is accepted
-        reply = THESQUID_TASKACCEPTED;
+        // Declare a variable to memorize the NeuraNets
+        NeuraNet** nns = PBErrMalloc(TheSquidErr, 
+          sizeof(NeuraNet*) * VecGetDim(nnids));
+        memset(nns, 0, sizeof(NeuraNet*) * VecGetDim(nnids));
+
+        // Set the flag for successfull process by default
+        success = true;
+        const char* errMsg = "Invalid neuranet";
+
+        // If the NeuraNets are inlined
+        if (propWorkingDir == NULL) {
+
+          // Add to the cache the NeuraNets whose definition is in the
+          // data, in the order the Squad memorizes them
+          for (long iNN = 0; iNN < VecGetDim(nnids) && success; ++iNN) {
+            const char* hash = 
+              JSONLblVal(JSONValue(propNNHashes, iNN));
+            bool duplicate = false;
+            for (long jNN = 0; jNN < iNN && !duplicate; ++jNN)
+              duplicate = (strcmp(hash, 
+                JSONLblVal(JSONValue(propNNHashes, jNN))) == 0);
+            if (duplicate == false && propNNs != NULL &&
+              JSONProperty(propNNs, hash) != NULL) {
+              success = (SquidletGetNeuraNet(that, hash, propNNs, 
+                propNNHashes) != NULL);
+            }
+          }
+
+          // Get the NeuraNets from the cache
+          for (long iNN = 0; iNN < VecGetDim(nnids) && success; ++iNN) {
+            nns[iNN] = SquidletGetNeuraNet(that, 
+              JSONLblVal(JSONValue(propNNHashes, iNN)), NULL, NULL);
+            if (nns[iNN] == NULL) {
+              success = false;
+              errMsg = THESQUID_ERRUNKNOWNNN;
+            }
+          }
+
+          // If some NeuraNets are unknown, the Squad forgets the ones 
+          // it supposes in the cache and sends them again, empty the 
+          // cache to stay in sync with it
+          if (strcmp(errMsg, THESQUID_ERRUNKNOWNNN) == 0) {
+            for (int iNN = THESQUID_NBNNCACHE; iNN--;) {
+              NeuraNetFree(that->_nnCache + iNN);
+              that->_nnCacheHashes[iNN][0] = '\0';
+            }
+            that->_nextNNCache = 0;
+          }
+        }
+
+        // Loop on the NeuraNet to evaluate if they must be loaded
+        // from the working directory
+        for (long iNN = 0; 
+          iNN < VecGetDim(nnids) && success && propWorkingDir != NULL;
+          ++iNN) {
+
+          // Load the Neuranet
+          char nnFilename[100];
+          sprintf(nnFilename, "nn%ld.json", VecGet(nnids, iNN));
+          char* pathNN = PBFSJoinPath(
+            JSONLblVal(propWorkingDir), 
+            nnFilename);
+          FILE* fpnn = fopen(pathNN, "r");
+          free(pathNN);
+
+          // If we couldn't load the Neuranet
+          if (fpnn == NULL || !NNLoad(nns + iNN, fpnn)) {
+
+            // Set the successfull flag to false
+            success = false;
+
+          }
 
-        // Update the number of accepted task
-        ++(that->_nbAcceptedTask);
-      
-        // Update the statistics
-        if (that->_nbTaskComplete > 0) {
-          struct timeval now;
-          gettimeofday(&now, NULL);
-          that->_timeWaitedTaskMs = 
-            (now.tv_sec - that->_timeLastTaskComplete.tv_sec) * 1000 +
-            (now.tv_usec - that->_timeLastTaskComplete.tv_usec) / 1000;
+          // Close the file pointer to the Neuranet definition file
+          if (fpnn != NULL)
+            fclose(fpnn);
+        }
+        
+        // If we could load all the NeuraNets, evaluate them all in
+        // one single pass on the samples
+        // The sample values must be ordered as follow
+        // <i0, i1, ..., in, o0, o1, ..., om> 
+        // If there are more ranges than samples, the range may be 
+        // empty, its sums of errors and numbers of samples are null
+        if (success == true && first >= last) {
+          for (long iNN = VecGetDim(nnids); iNN--;) {
+            VecSet(values, iNN, 0.0);
+            VecSet(nbEvals, iNN, 0);
+            VecSet(sumErrs, iNN, 0.0);
+          }
+        } else if (success == true) {
+          success = TheSquidEvalNeuraNets(
+            that->_samples, 
+            that->_nbSample, 
+            that->_dimSample, 
+            first, 
+            last, 
+            nns, 
+            VecGetDim(nnids), 
+            bestVal, 
+            SquidletGetNbThread(that), 
+            fastReject, 
+            values, 
+            nbEvals, 
+            sumErrs);
         }
 
-        if (SquidletStreamInfo(that)){
-          SquidletPrint(that, SquidletStreamInfo(that));
-          fprintf(SquidletStreamInfo(that), 
-            " : received task type %d\n", taskRequest._type);
+        // Free the NeuraNets, except the inlined ones which are kept
+        // in cache
+        if (propWorkingDir != NULL) {
+          for (long iNN = VecGetDim(nnids); iNN--;)
+            NeuraNetFree(nns + iNN);
         }
+        free(nns);
 
-      // Else, we couldn't receive the task type
-      } else {
+        if (success == true) {
 
-        // Refuse the task and ensure the task type is equal to
-        // SquidletTaskType_Null
-        taskRequest._type = SquidletTaskType_Null;
-        reply = THESQUID_TASKREFUSED;
+          // Update the time used to process the task
+          struct timeval now;
+          gettimeofday(&now, NULL);
+          that->_timeToProcessMs = 
+            (now.tv_sec - start.tv_sec) * 1000 +
+            (now.tv_usec - start.tv_usec) / 1000;
 
-        // Update the number of refused task
-        ++(that->_nbRefusedTask);
+          // Update the number of completed tasks
+          ++(that->_nbTaskComplete);
 
-        if (SquidletStreamInfo(that)){
-          SquidletPrint(that, SquidletStreamInfo(that));
-          fprintf(SquidletStreamInfo(that),
-            " : couldn't receive task type\n");
-        }
-      }
+          // Prepare the result data as JSON
+          JSONNode* jsonResult = JSONCreate();
+          float temperature = SquidletGetTemperature(that);
+          char temperatureStr[10] = {'\0'};
+          sprintf(temperatureStr, "%.2f", temperature);
+          JSONAddProp(jsonResult, "temperature", temperatureStr);
+          char successStr[2] = {'\0'};
+          sprintf(successStr, "%d", success);
+          JSONAddProp(jsonResult, "success", successStr);
+          JSONAddProp(jsonResult, "nnids", propIds);
 
-      // Send the reply to the task request
-      int flags = 0;
-      ret = (send(that->_sockReply, &reply, sizeof(reply), flags) != -1);
+          JSONNode* jsonValues = VecEncodeAsJSON(values);
+          JSONAddProp(jsonResult, "v", jsonValues);
 
-      // If we couldn't send the reply
-      if (ret == false) {
+          // In fast reject mode or for a sharded evaluation, add the
+          // number of samples on which the NeuraNets have been 
+          // evaluated and the total number of samples
+          if (fastReject == true || nbShard > 1) {
+            JSONNode* jsonNbEvals = VecEncodeAsJSON(nbEvals);
+            JSONAddProp(jsonResult, "nbSample", jsonNbEvals);
+            char sizeCatStr[20] = {'\0'};
+            sprintf(sizeCatStr, "%ld", that->_nbSample);
+            JSONAddProp(jsonResult, "sizeCat", sizeCatStr);
+          }
 
-        // If we couldn't send the reply, do not process the task
-        taskRequest._type = SquidletTaskType_Null;
+          // For a sharded evaluation, add the sum of errors to let 
+          // the Squad merge the ranges
+          if (nbShard > 1) {
+            JSONNode* jsonSumErrs = VecEncodeAsJSON(sumErrs);
+            JSONAddProp(jsonResult, "sumErr", jsonSumErrs);
+          }
 
-        if (SquidletStreamInfo(that)){
-          SquidletPrint(that, SquidletStreamInfo(that));
-          fprintf(SquidletStreamInfo(that),
-            " : couldn't sent reply to task request %d\n", reply);
+          // Convert the JSON to a string
+          bool compact = true;
+          ret = JSONSaveToStr(jsonResult, *bufferResult, 
+            THESQUID_MAXPAYLOADSIZE, compact);
+          if (ret == false) {
+            sprintf(*bufferResult, 
+              "{\"success\":\"0\",\"temperature\":\"0.0\","
+              "\"err\":\"JSONSaveToStr failed\"}");
+          }
+        
+        // Else, we couldn't load the neuranet
+        } else {
+
+          sprintf(*bufferResult, 
+            "{\"success\":\"0\",\"temperature\":\"0.0\","
+            "\"err\":\"%s\"}", errMsg);
         }
 
-      // Else, we could send the reply
-      } else {
+        // Free memory
+        VecFree(&values);
+        VecFree(&nbEvals);
+        VecFree(&sumErrs);
 
-        if (SquidletStreamInfo(that)){
-          SquidletPrint(that, SquidletStreamInfo(that));
-          fprintf(SquidletStreamInfo(that),
-            " : sent reply to task request %d\n", reply);
-        }
+      // Else, the dataset could not be loaded or was empty
+      } else {
+        
+        sprintf(*bufferResult, 
+          "{\"success\":\"0\",\"temperature\":\"0.0\","
+          "\"err\":\"Invalid dataset\"}");
       }
+      
+    // else the value is not present
+    } else {
+
+      sprintf(*bufferResult, 
+        "{\"success\":\"0\",\"temperature\":\"0.0\","
+        "\"err\":\"Invalid input\"}");
     }
+
+    // Free memory
+    VecFree(&nnids);
+
+  // Else, we couldn't decode the input
+  } else {
+
+    sprintf(*bufferResult, 
+      "{\"success\":\"0\",\"temperature\":\"0.0\","
+      "\"err\":\"JSONLoadFromStr failed\"}");
   }
 
-  // Return the received task request
-  return taskRequest;
+  // Free memory
+  JSONFree(&json);
 }
 
-// Process the task request 'request' with the Squidlet 'that'
-void SquidletProcessRequest(
-             Squidlet* const that, 
-  SquidletTaskRequest* const request) {
+// Process a batch task request with the relay Squidlet 'that' 
+// The tasks of the batch are encoded in 'buffer' and executed by the 
+// squidlets of the Squad of the relay, the results of the completed 
+// ones are encoded in 'bufferResult' which is allocated as necessary
+void SquidletProcessRequest_Batch(
+    Squidlet* const that, 
+  const char* const buffer, 
+             char** bufferResult) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (request == NULL) {
+  if (buffer == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'request' is null");
+    sprintf(TheSquidErr->_msg, "'buffer' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (bufferResult == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'bufferResult' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
 
-  // If the task is of type null
-  if (request->_type == SquidletTaskType_Null) {
+  // Start measuring the time used to process the task
+  that->_timeToProcessMs = 0;
+  struct timeval start;
+  gettimeofday(&start, NULL);
 
-    // Nothing to do
+  // If the squidlet is not a relay, it can't process the batch
+  Squad* relay = that->_relay;
+  if (relay == NULL) {
+    *bufferResult = PBErrMalloc(TheSquidErr, THESQUID_MAXPAYLOADSIZE);
+    sprintf(*bufferResult, 
+      "{\"success\":\"0\",\"temperature\":\"0.0\","
+      "\"err\":\"Not a relay\"}");
     return;
   }
 
-  if (SquidletStreamInfo(that)){
-    SquidletPrint(that, SquidletStreamInfo(that));
-    fprintf(SquidletStreamInfo(that), " : process task\n");
+  // Decode the header of the batch, preceding the data of the tasks 
+  // which are forwarded as is
+  const char* dataStart = strstr(buffer, ",\"data\":[");
+  JSONNode* json = JSONCreate();
+  bool ret = false;
+  if (dataStart != NULL) {
+    size_t lenHeader = dataStart - buffer;
+    char* header = PBErrMalloc(TheSquidErr, lenHeader + 2);
+    memcpy(header, buffer, lenHeader);
+    header[lenHeader] = '}';
+    header[lenHeader + 1] = '\0';
+    ret = JSONLoadFromStr(json, header);
+    free(header);
+  }
+  JSONNode* propTypes = (ret ? JSONProperty(json, "types") : NULL);
+  JSONNode* propIds = (ret ? JSONProperty(json, "ids") : NULL);
+  JSONNode* propSubIds = (ret ? JSONProperty(json, "subIds") : NULL);
+  JSONNode* propMaxWaits = (ret ? JSONProperty(json, "maxWaits") : NULL);
+  JSONNode* propLens = (ret ? JSONProperty(json, "lens") : NULL);
+  long nbTask = (propTypes != NULL ? JSONGetNbValue(propTypes) : 0);
+  if (nbTask == 0 || 
+    propIds == NULL || JSONGetNbValue(propIds) != nbTask || 
+    propSubIds == NULL || JSONGetNbValue(propSubIds) != nbTask || 
+    propMaxWaits == NULL || JSONGetNbValue(propMaxWaits) != nbTask || 
+    propLens == NULL || JSONGetNbValue(propLens) != nbTask) {
+    *bufferResult = PBErrMalloc(TheSquidErr, THESQUID_MAXPAYLOADSIZE);
+    sprintf(*bufferResult, 
+      "{\"success\":\"0\",\"temperature\":\"0.0\","
+      "\"err\":\"Invalid input\"}");
+    JSONFree(&json);
+    return;
   }
 
-  // Declare a variable to memorize the size in byte of the input data
-  unsigned long int sizeInputData = 0;
-
-  // Declare a buffer for the result data
-  char* bufferResult = NULL;
-
-  // Wait to receive the size of the input data with a time limit of
-  // THESQUID_WAITDATARECEPT_TIMEOUT seconds
-  bool ret = SocketRecv(&(that->_sockReply), sizeof(size_t), 
-    (char*)&sizeInputData, THESQUID_WAITDATARECEPT_TIMEOUT);
-  
-  // If we could receive the data size
-  if (ret == true) {
-
-    // Declare a buffer for the raw input data
-    char* buffer = NULL;
-
-    // If there are input data
-    if (sizeInputData > 0) {
-
-      if (SquidletStreamInfo(that)) {
-        SquidletPrint(that, SquidletStreamInfo(that));
-        fprintf(SquidletStreamInfo(that), 
-          " : received size task data %ld\n", sizeInputData);
-      }
-
-      // Allocate memory for the input data
-      buffer = PBErrMalloc(TheSquidErr, sizeInputData + 1);
-      memset(buffer, 0, sizeInputData + 1);
-      
-      // Wait to receive the input data with a time limit proportional
-      // to the size of input data
-      int timeLimit = THESQUID_WAITDATARECEPT_TIMEOUT + \
-        (int)round((float)sizeInputData / 100.0);
-      ret = SocketRecv(&(that->_sockReply), sizeInputData, buffer, 
-        timeLimit);
-      
-      // If we couldn't receive the data
-      if (ret == false) {
-
-        // Free memory
-        free(buffer);
-        buffer = NULL;
-        
-        // Update the number of failed reception of data
-        ++(that->_nbFailedReceptTaskData);
-
-        if (SquidletStreamInfo(that)){
-          SquidletPrint(that, SquidletStreamInfo(that));
-          fprintf(SquidletStreamInfo(that), 
-            " : couldn't receive task data\n");
-        }
-      
-      // Else, we could receive the data
-      } else {
-
-        if (SquidletStreamInfo(that)){
-          SquidletPrint(that, SquidletStreamInfo(that));
-          if (strlen(buffer) > 50) {
-            char tmp[4];
-            tmp[0] = buffer[47];
-            tmp[1] = buffer[48];
-            tmp[2] = buffer[49];
-            tmp[3] = buffer[50];
-            buffer[47] = ' ';
-            buffer[48] = '.';
-            buffer[49] = '.';
-            buffer[50] = '\0';
-            fprintf(SquidletStreamInfo(that), 
-              " : received task data %s\n", buffer);
-            buffer[47] = tmp[0];
-            buffer[48] = tmp[1];
-            buffer[49] = tmp[2];
-            buffer[50] = tmp[3];
-          } else {
-            fprintf(SquidletStreamInfo(that), 
-              " : received task data %s\n", buffer);
-          }
-        }
-      }
-    }
-
-    // If we could receive the expected data
-    if (sizeInputData > 0 && buffer != NULL) {
-
-      // Process the request according to the request type
-      // and store the result into bufferResult
-      switch (request->_type) {
-        case SquidletTaskType_Dummy:
-          SquidletProcessRequest_Dummy(that, buffer, &bufferResult);
-          break;
-        case SquidletTaskType_Benchmark:
-          SquidletProcessRequest_Benchmark(that, buffer, &bufferResult);
-          break;
-        case SquidletTaskType_PovRay:
-          SquidletProcessRequest_PovRay(that, buffer, &bufferResult);
-          break;
-        case SquidletTaskType_ResetStats:
-          SquidletProcessRequest_StatsReset(that);
-          break;
-        case SquidletTaskType_EvalNeuranet:
-          SquidletProcessRequest_EvalNeuranet(that, buffer, 
-            &bufferResult);
-          break;
-        default:
-          break;
-      }
-
-      // Free memory
-      free(buffer);
-    }
-
-  // Else we couldn't receive the data size
-  } else {
+  // Declare arrays to match the completed tasks with the tasks of the 
+  // batch and memorize their results
+  SquidletTaskType* types = 
+    PBErrMalloc(TheSquidErr, sizeof(SquidletTaskType) * nbTask);
+  unsigned long* ids = 
+    PBErrMalloc(TheSquidErr, sizeof(unsigned long) * nbTask);
+  unsigned long* subIds = 
+    PBErrMalloc(TheSquidErr, sizeof(unsigned long) * nbTask);
+  char** results = PBErrMalloc(TheSquidErr, sizeof(char*) * nbTask);
+  memset(results, 0, sizeof(char*) * nbTask);
+
+  // Add the tasks of the batch to the Squad of the relay
+  const char* ptrData = dataStart + strlen(",\"data\":[");
+  const char* dataEnd = buffer + strlen(buffer);
+  time_t maxWait = 0;
+  long nbCreated = 0;
+  for (long iTask = 0; iTask < nbTask; ++iTask) {
+    long len = atol(JSONLblVal(JSONValue(propLens, iTask)));
+    if (iTask > 0)
+      ++ptrData;
+    if (len <= 0 || ptrData + len > dataEnd)
+      break;
+    char* data = PBErrMalloc(TheSquidErr, len + 1);
+    memcpy(data, ptrData, len);
+    data[len] = '\0';
+    ptrData += len;
+    types[iTask] = atoi(JSONLblVal(JSONValue(propTypes, iTask)));
+    ids[iTask] = atol(JSONLblVal(JSONValue(propIds, iTask)));
+    subIds[iTask] = atol(JSONLblVal(JSONValue(propSubIds, iTask)));
+    time_t wait = atol(JSONLblVal(JSONValue(propMaxWaits, iTask)));
+    maxWait = MAX(maxWait, wait);
+    SquidletTaskRequest* task = SquidletTaskRequestCreate(types[iTask], 
+      ids[iTask], subIds[iTask], data, wait);
+    GSetAppend(&(relay->_tasks), task);
+    free(data);
+    ++nbCreated;
+  }
+  JSONFree(&json);
 
-    // Update the number of failed reception of data
-    ++(that->_nbFailedReceptTaskSize);
-    
-    if (SquidletStreamInfo(that)){
-      SquidletPrint(that, SquidletStreamInfo(that));
-      fprintf(SquidletStreamInfo(that), 
-        " : couldn't receive data size\n");
+  if (SquidletStreamInfo(that)) {
+    SquidletPrint(that, SquidletStreamInfo(that));
+    fprintf(SquidletStreamInfo(that), 
+      " : relay batch of %ld tasks\n", nbCreated);
+  }
+
+  // Step the Squad of the relay until all the tasks are completed or 
+  // the time limit of the batch is over
+  time_t deadline = time(NULL) + maxWait + SQUAD_REQUESTTIMEOUT;
+  long nbDone = 0;
+  while (nbDone < nbCreated && time(NULL) <= deadline && 
+    !Squidlet_CtrlC) {
+    GSetSquadRunningTask completedTasks = SquadStep(relay);
+    while (GSetNbElem(&completedTasks) > 0) {
+      SquadRunningTask* completedTask = GSetPop(&completedTasks);
+      SquidletTaskRequest* request = completedTask->_request;
+
+      // Search the task of the batch matching the completed one, the 
+      // ones from a previous batch are discarded
+      for (long iTask = 0; iTask < nbCreated; ++iTask) {
+        if (results[iTask] == NULL && 
+          types[iTask] == request->_type && 
+          ids[iTask] == request->_id && 
+          subIds[iTask] == request->_subId && 
+          request->_bufferResult != NULL) {
+          results[iTask] = request->_bufferResult;
+          request->_bufferResult = NULL;
+          ++nbDone;
+          break;
+        }
+      }
+      SquidletTaskRequestFree(&(completedTask->_request));
+      SquadRunningTaskFree(&completedTask);
     }
-
+    if (nbDone < nbCreated)
+      usleep(THESQUID_RELAY_STEPPERIOD * 1000);
   }
-  
-  // If bufferResult is not null here it means there is a result
-  // to be sent
-  if (bufferResult != NULL) {
 
-    // Send the result
-    SquidletSendResultData(that, bufferResult);
+  // Remove the tasks which couldn't be dispatched, the parent Squad 
+  // will try them again
+  while (GSetNbElem(&(relay->_tasks)) > 0) {
+    SquidletTaskRequest* task = GSetPop(&(relay->_tasks));
+    SquidletTaskRequestFree(&task);
+  }
 
-    // Free memory 
-    free(bufferResult);
+  // Update the time used to process the task
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  that->_timeToProcessMs = 
+    (now.tv_sec - start.tv_sec) * 1000 +
+    (now.tv_usec - start.tv_usec) / 1000;
 
+  // Update the number of completed tasks
+  that->_nbTaskComplete += nbDone;
+
+  // Encode the results, the lengths of the results of the tasks which 
+  // couldn't be completed are 0, and the capacity of the relay to let 
+  // the parent Squad adjust the size of the next batches
+  size_t lenResult = 0;
+  *bufferResult = NULL;
+  FILE* stream = open_memstream(bufferResult, &lenResult);
+  if (stream != NULL) {
+    fprintf(stream, 
+      "{\"success\":\"1\",\"temperature\":\"%.2f\",\"capacity\":\"%lu\"," 
+      "\"lens\":[", SquidletGetTemperature(that), 
+      SquadGetCapacity(relay));
+    for (long iTask = 0; iTask < nbTask; ++iTask) {
+      fprintf(stream, "%s\"%lu\"", (iTask > 0 ? "," : ""), 
+        (unsigned long)(results[iTask] != NULL ? 
+          strlen(results[iTask]) : 0));
+    }
+    fprintf(stream, "],\"results\":[");
+    bool first = true;
+    for (long iTask = 0; iTask < nbTask; ++iTask) {
+      if (results[iTask] != NULL) {
+        fprintf(stream, "%s%s", (first ? "" : ","), results[iTask]);
+        first = false;
+      }
+    }
+    fprintf(stream, "]}");
+    fclose(stream);
+  } else {
+    *bufferResult = PBErrMalloc(TheSquidErr, THESQUID_MAXPAYLOADSIZE);
+    sprintf(*bufferResult, 
+      "{\"success\":\"0\",\"temperature\":\"0.0\","
+      "\"err\":\"open_memstream failed\"}");
   }
 
-  // Update the time when we last processed a request to calculate
-  // later the time between two processing
-  gettimeofday(&(that->_timeLastTaskComplete), NULL);
-
+  // Free memory
+  for (long iTask = 0; iTask < nbTask; ++iTask)
+    if (results[iTask] != NULL)
+      free(results[iTask]);
+  free(results);
+  free(types);
+  free(ids);
+  free(subIds);
 }
 
-// Send the result 'bufferResult' of the processing of a task
-// by the Squidlet 'that' 
-void SquidletSendResultData(
-             Squidlet* const that, 
-           const char* const bufferResult) {
+// Process an exec task request with the Squidlet 'that' 
+// The command, its arguments and its standard input are stored in 
+// 'buffer' as encoded by SquadAddTask_Exec 
+// The result of the task, a line in JSON format followed by the 
+// standard output of the command, is stored in 'bufferResult' which is 
+// allocated as necessary
+void SquidletProcessRequest_Exec(
+    Squidlet* const that, 
+  const char* const buffer, 
+             char** bufferResult) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (bufferResult == NULL) {
+  if (buffer == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'bufferResult' is null");
+    sprintf(TheSquidErr->_msg, "'buffer' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
+  // Declare variables to memorize the result of the command
+  bool success = false;
+  int status = -1;
+  char* output = NULL;
+  size_t lenOutput = 0;
+  const char* err = NULL;
 
-  // Get the current time for statistics
+  // Start measuring the time used to process the task
+  that->_timeToProcessMs = 0;
   struct timeval start;
   gettimeofday(&start, NULL);
 
-  // Send the result data size
-  int flags = 0;
-  size_t len = strlen(bufferResult);
-  bool ret = (send(that->_sockReply, 
-    (char*)&len, sizeof(size_t), flags) != -1);
-
-  if (ret == true) {
+  // Decode the first line, in JSON format
+  const char* eol = strchr(buffer, '\n');
+  char* header = (eol != NULL ? strndup(buffer, eol - buffer) : NULL);
+  JSONNode* json = JSONCreate();
+  JSONNode* propCmd = NULL;
+  JSONNode* propNbArg = NULL;
+  if (header != NULL && JSONLoadFromStr(json, header) == true) {
+    propCmd = JSONProperty(json, "cmd");
+    propNbArg = JSONProperty(json, "nbArg");
+  }
 
-    // Update stats
-    struct timeval stop;
-    gettimeofday(&stop, NULL);
-    that->_timeTransferSquidSquadMs = 
-      (stop.tv_sec - start.tv_sec) * 1000 + 
-      (stop.tv_usec - start.tv_usec) / 1000;
-    that->_timeTransferSquidSquadMs /= (float)len;
+  if (SquidletStreamInfo(that)){
+    SquidletPrint(that, SquidletStreamInfo(that));
+    fprintf(SquidletStreamInfo(that), 
+      " : process exec task %s\n", (header != NULL ? header : ""));
+  }
 
-    if (SquidletStreamInfo(that)){
-      SquidletPrint(that, SquidletStreamInfo(that));
-      fprintf(SquidletStreamInfo(that), 
-        " : sent result size\n");
-      SquidletPrint(that, SquidletStreamInfo(that));
-      fprintf(SquidletStreamInfo(that), 
-        " : wait for acknowledgement from squad\n");
-    }
+  // If the input is invalid
+  int nbArg = (propNbArg != NULL ? atoi(JSONLblVal(propNbArg)) : -1);
+  if (propCmd == NULL || nbArg < 0) {
+    err = "Invalid input";
 
-    // Receive the acknowledgement
-    char ack = 0;
-    int waitDelayMaxSec = 60;
-    struct timeval start;
-    gettimeofday(&start, NULL);
-    ret = SocketRecv(&(that->_sockReply), sizeof(char), &ack, 
-      waitDelayMaxSec);
+  // Else, the input is valid
+  } else {
 
-    // If we could receive the acknowledgment
-    if (ret == true) {
+    // Get the binary of the command among the allowed ones
+    const char* path = NULL;
+    for (int iCmd = 0; iCmd < that->_nbExecCommand && path == NULL; 
+      ++iCmd) {
+      const char* name = strrchr(that->_execCommands[iCmd], '/');
+      name = (name != NULL ? name + 1 : that->_execCommands[iCmd]);
+      if (strcmp(name, JSONLblVal(propCmd)) == 0)
+        path = that->_execCommands[iCmd];
+    }
 
-      // Update the statistics
-      struct timeval now;
-      gettimeofday(&now, NULL);
-      that->_timeWaitedAckMs = 
-        (now.tv_sec - start.tv_sec) * 1000 +
-        (now.tv_usec - start.tv_usec) / 1000;
+    // If the command is not allowed
+    if (path == NULL) {
+      err = "Unknown command";
 
-      if (SquidletStreamInfo(that)){
-        SquidletPrint(that, SquidletStreamInfo(that));
-        fprintf(SquidletStreamInfo(that), 
-          " : received acknowledgement from squad\n");
-      }
+    // Else, the command is allowed
+    } else {
 
-      // Send the result
-      ret = (send(that->_sockReply, bufferResult, len, flags) != -1);
+      // Count the lines available for the arguments, up to the 
+      // requested number, before allocating memory for them
+      int nbLine = 0;
+      for (const char* ptr = strchr(eol + 1, '\n'); 
+        ptr != NULL && nbLine < nbArg; ptr = strchr(ptr + 1, '\n'))
+        ++nbLine;
 
-      // If we could send the result
-      if (ret == true) {
-        
-        // Update the number of successfully sent result
-        ++(that->_nbSentResult);
+      // If there are less lines than arguments
+      if (nbLine < nbArg) {
+        err = "Invalid arguments";
 
-        if (SquidletStreamInfo(that)){
-          SquidletPrint(that, SquidletStreamInfo(that));
-          fprintf(SquidletStreamInfo(that), 
-            " : sent result %s\n", bufferResult);
-        }
-      
-      // Else, we couldn't send the result
+      // Else, the arguments are available
       } else {
 
-        // Update the number of unsuccessfully sent result
-        ++(that->_nbFailedSendResult);
-
-        if (SquidletStreamInfo(that)){
-          SquidletPrint(that, SquidletStreamInfo(that));
-          fprintf(SquidletStreamInfo(that), 
-            " : couldn't send result %s\n", bufferResult);
+        // Get the arguments, one per line, the standard input follows
+        char** argv = 
+          PBErrMalloc(TheSquidErr, sizeof(char*) * (nbArg + 2));
+        argv[0] = (char*)path;
+        const char* ptr = eol + 1;
+        for (int iArg = 0; iArg < nbArg; ++iArg) {
+          const char* next = strchr(ptr, '\n');
+          argv[iArg + 1] = strndup(ptr, next - ptr);
+          ptr = next + 1;
         }
-      }
-    
-    // Else, we couldn't receive the acknowledgement
-    } else {
-
-      // Update the number of unsuccessfully received acknowledgment
-      ++(that->_nbFailedReceptAck);
+        argv[nbArg + 1] = NULL;
+
+        // Run the command, killed after the time limit of the task
+        JSONNode* propTimeout = JSONProperty(json, "timeout");
+        int timeout = 
+          (propTimeout != NULL ? atoi(JSONLblVal(propTimeout)) : 0);
+        status = TheSquidSpawn(path, argv, ptr, strlen(ptr), 
+          &output, &lenOutput, timeout);
+        success = (status == 0);
+        if (status == -1)
+          err = "Command failed";
 
-      if (SquidletStreamInfo(that)){
-        SquidletPrint(that, SquidletStreamInfo(that));
-        fprintf(SquidletStreamInfo(that), 
-          " : couldn't receive acknowledgement\n");
+        // Free memory
+        for (int iArg = 1; iArg <= nbArg; ++iArg)
+          free(argv[iArg]);
+        free(argv);
       }
     }
-
-  // Else, we couldn't send the result size
-  } else {
-
-
-    // Update the number of unsuccessfully sent result size
-    ++(that->_nbFailedSendResultSize);
-
-    if (SquidletStreamInfo(that)){
-      SquidletPrint(that, SquidletStreamInfo(that));
-      fprintf(SquidletStreamInfo(that), 
-        " : couldn't send data size\n");
-    }
-  }
-
-  if (SquidletStreamInfo(that)){
-    SquidletPrint(that, SquidletStreamInfo(that));
-    fprintf(SquidletStreamInfo(that), 
-      " : wait for acknowledgement from squad\n");
   }
 
-  // Receive the acknowledgment of reception of result
-  // Give up after THESQUID_PROC_TIMEOUT seconds
-  char ack = 0;
-  ret = SocketRecv(&(that->_sockReply), 1, &ack, 
-    THESQUID_PROC_TIMEOUT);
-
-  // If we could receive the acknowledgement
-  if (ret == true) {
+  // Free memory
+  free(header);
+  JSONFree(&json);
 
-    if (SquidletStreamInfo(that)){
-      SquidletPrint(that, SquidletStreamInfo(that));
-      fprintf(SquidletStreamInfo(that), 
-        " : received acknowledgement from squad\n");
-    }
+  // Update the time used to process the task and the number of 
+  // completed tasks
+  that->_timeToProcessMs = (unsigned long)TheSquidGetElapsedMs(&start);
+  if (success == true)
+    ++(that->_nbTaskComplete);
 
-  // Else, we couldn't receive the acknowledgement
+  // Prepare the result: a line in JSON format followed by the standard 
+  // output of the command as is
+  char* result = NULL;
+  size_t lenResult = 0;
+  FILE* stream = open_memstream(&result, &lenResult);
+  if (stream != NULL) {
+    fprintf(stream, 
+      "{\"success\":\"%d\",\"temperature\":\"%.2f\",\"status\":\"%d\","
+      "\"len\":\"%lu\"", success, SquidletGetTemperature(that), status, 
+      (unsigned long)lenOutput);
+    if (err != NULL)
+      fprintf(stream, ",\"err\":\"%s\"", err);
+    fprintf(stream, "}\n");
+    if (output != NULL)
+      fwrite(output, 1, lenOutput, stream);
+    fclose(stream);
+    *bufferResult = result;
   } else {
-
-    // Update the number of unsuccessfully received acknowledgement
-    ++(that->_nbFailedReceptAck);
-
-    if (SquidletStreamInfo(that)){
-      SquidletPrint(that, SquidletStreamInfo(that));
-      fprintf(SquidletStreamInfo(that), 
-        " : couldn't receive acknowledgement from squad\n");
-    }
-  }
-
-  if (SquidletStreamInfo(that)){
-    SquidletPrint(that, SquidletStreamInfo(that));
-    fprintf(SquidletStreamInfo(that), 
-      " : ready for next task\n");
+    *bufferResult = PBErrMalloc(TheSquidErr, THESQUID_MAXPAYLOADSIZE);
+    sprintf(*bufferResult, 
+      "{\"success\":\"0\",\"temperature\":\"0.0\","
+      "\"err\":\"open_memstream failed\"}");
   }
 
+  // Free memory
+  free(output);
 }
 
-// Process a dummy task request with the Squidlet 'that'
+// Process a task request of the plugin 'plugin' with the Squidlet 
+// 'that' 
 // The task request parameters are encoded in JSON and stored in the 
-// string 'buffer'
+// string 'buffer' 
 // The result of the task are encoded in JSON format and stored in 
 // 'bufferResult' which is allocated as necessary
-void SquidletProcessRequest_Dummy(
-    Squidlet* const that,
-  const char* const buffer, 
-             char** bufferResult) {
+void SquidletProcessRequest_Plugin(
+                   Squidlet* const that, 
+  const TheSquidTaskPlugin* const plugin, 
+                const char* const buffer, 
+                            char** bufferResult) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
+  if (plugin == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'plugin' is null");
+    PBErrCatch(TheSquidErr);
+  }
   if (buffer == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'buffer' is null");
@@ -3988,198 +11832,160 @@ void SquidletProcessRequest_Dummy(
   }
 #endif
 
-  // Declare a variable to memorize if the process has been successful
-  bool success = false;
-
-  // Declare a variable to memorize the result of processing
-  int result = 0; 
-
   // Allocate memory for the result
   *bufferResult = PBErrMalloc(TheSquidErr, THESQUID_MAXPAYLOADSIZE);
   memset(*bufferResult, 0, THESQUID_MAXPAYLOADSIZE);
 
-  // Start measuring the time used to process the task
-  that->_timeToProcessMs = 0;
-  struct timeval start;
-  gettimeofday(&start, NULL);
-
-  // Process the data
   if (SquidletStreamInfo(that)){
     SquidletPrint(that, SquidletStreamInfo(that));
     fprintf(SquidletStreamInfo(that), 
-      " : process dummy task %s\n", buffer);
+      " : process %s task %s\n", plugin->_name, buffer);
   }
 
-  // Decode the input from JSON
-  JSONNode* json = JSONCreate();
-  bool ret = JSONLoadFromStr(json, buffer);
-
-  // If we could decode the input
-  if (ret == true) {
-
-    // Get the value to process
-    JSONNode* prop = JSONProperty(json, "v");
-    
-    // If the value is present
-    if (prop != NULL) {
-      
-      // Convert the value from string to int
-      int v = atoi(JSONLblVal(prop));
-
-      // Process the value
-      result = v * -1;
-
-      // Sleep for v seconds
-      sleep(v);
-
-      // Set the flag for successfull process
-      success = true;
-
-      // Update the time used to process the task
-      struct timeval now;
-      gettimeofday(&now, NULL);
-      that->_timeToProcessMs = 
-        (now.tv_sec - start.tv_sec) * 1000 +
-        (now.tv_usec - start.tv_usec) / 1000;
+  // Start measuring the time used to process the task
+  that->_timeToProcessMs = 0;
+  struct timeval start;
+  gettimeofday(&start, NULL);
 
-      // Update the number of completed tasks
-      ++(that->_nbTaskComplete);
+  // Execute the task with the plugin, it writes its result as a JSON 
+  // object
+  char result[THESQUID_MAXPAYLOADSIZE];
+  memset(result, 0, THESQUID_MAXPAYLOADSIZE);
+  bool success = plugin->_execute(buffer, result, 
+    THESQUID_MAXPAYLOADSIZE - 1);
 
-      // Prepare the result data as JSON
-      JSONNode* jsonResult = JSONCreate();
-      float temperature = SquidletGetTemperature(that);
-      char temperatureStr[10] = {'\0'};
-      sprintf(temperatureStr, "%.2f", temperature);
-      JSONAddProp(jsonResult, "temperature", temperatureStr);
-      char successStr[2] = {'\0'};
-      sprintf(successStr, "%d", success);
-      JSONAddProp(jsonResult, "success", successStr);
-      char resultStr[10] = {'\0'};
-      sprintf(resultStr, "%d", result);
-      JSONAddProp(jsonResult, "v", resultStr);
+  // Update the time used to process the task
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  that->_timeToProcessMs = 
+    (now.tv_sec - start.tv_sec) * 1000 +
+    (now.tv_usec - start.tv_usec) / 1000;
 
-      // Append the statistics data
-      SquidletAddStatsToJSON(that, jsonResult);
+  // Decode the result of the plugin, an empty result is an empty object
+  JSONNode* jsonResult = JSONCreate();
+  bool ret = (result[0] == '\0' || JSONLoadFromStr(jsonResult, result));
 
-      // Convert the JSON to a string
-      bool compact = true;
-      ret = JSONSaveToStr(jsonResult, *bufferResult, 
-        THESQUID_MAXPAYLOADSIZE, compact);
-      if (ret == false) {
-        sprintf(*bufferResult, 
-          "{\"success\":\"0\",\"temperature\":\"0.0\","
-          "\"err\":\"JSONSaveToStr failed\"}");
-      }
+  // If we could decode the result
+  if (ret == true) {
 
-    // else the value is not present
-    } else {
+    // Update the number of completed tasks
+    if (success == true)
+      ++(that->_nbTaskComplete);
 
+    // Add the success flag and temperature to the result of the plugin
+    float temperature = SquidletGetTemperature(that);
+    char temperatureStr[10] = {'\0'};
+    sprintf(temperatureStr, "%.2f", temperature);
+    JSONAddProp(jsonResult, "temperature", temperatureStr);
+    char successStr[2] = {'\0'};
+    sprintf(successStr, "%d", success);
+    JSONAddProp(jsonResult, "success", successStr);
+
+    // Convert the JSON to a string
+    bool compact = true;
+    ret = JSONSaveToStr(jsonResult, *bufferResult, 
+      THESQUID_MAXPAYLOADSIZE, compact);
+    if (ret == false) {
       sprintf(*bufferResult, 
         "{\"success\":\"0\",\"temperature\":\"0.0\","
-        "\"err\":\"Invalid input\"}");
+        "\"err\":\"JSONSaveToStr failed\"}");
     }
 
-  // Else, we couldn't decode the input
+  // Else, we couldn't decode the result
   } else {
 
     sprintf(*bufferResult, 
       "{\"success\":\"0\",\"temperature\":\"0.0\","
-      "\"err\":\"JSONLoadFromStr failed\"}");
+      "\"err\":\"Invalid result of the plugin\"}");
   }
 
   // Free memory
-  JSONFree(&json);
-}  
+  JSONFree(&jsonResult);
+}
 
-// Append the statistical data about the squidlet 'that' to the JSON 
-// node 'json'
-void SquidletAddStatsToJSON(
-  const Squidlet* const that, 
-        JSONNode* const json) {
+// Return the NeuraNet whose hash is 'hash' from the cache of the 
+// Squidlet 'that'. If 'nns' is not null and contains the definition 
+// of the NeuraNet, it is decoded and added to the cache first, in 
+// place of the oldest NeuraNet whose hash is not in 'keep' (the 
+// hashes of the NeuraNets of the current task, may be null) 
+// Return null if the NeuraNet is not available
+NeuraNet* SquidletGetNeuraNet(
+        Squidlet* const that, 
+      const char* const hash, 
+  const JSONNode* const nns, 
+  const JSONNode* const keep) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (json == NULL) {
+  if (hash == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'json' is null");
+    sprintf(TheSquidErr->_msg, "'hash' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
-  // Declare a variable to convert numbers into string
-  // Hopefully numbers won't have more than 99 digits
-  const int bufferSize = 99;
-  char buffer[bufferSize];
-
-  // Convert numbers into string and add the JSON property for each one
-  sprintf(buffer, "%lu", that->_nbAcceptedConnection);
-  JSONAddProp(json, "nbAcceptedConnection", buffer);
-  memset(buffer, 0, bufferSize);
-
-  sprintf(buffer, "%lu", that->_nbAcceptedTask);
-  JSONAddProp(json, "nbAcceptedTask", buffer);
-  memset(buffer, 0, bufferSize);
-
-  sprintf(buffer, "%lu", that->_nbRefusedTask);
-  JSONAddProp(json, "nbRefusedTask", buffer);
-  memset(buffer, 0, bufferSize);
-
-  sprintf(buffer, "%lu", that->_nbFailedReceptTaskSize);
-  JSONAddProp(json, "nbFailedReceptTaskSize", buffer);
-  memset(buffer, 0, bufferSize);
-
-  sprintf(buffer, "%lu", that->_nbFailedReceptTaskData);
-  JSONAddProp(json, "nbFailedReceptTaskData", buffer);
-  memset(buffer, 0, bufferSize);
-
-  sprintf(buffer, "%lu", that->_nbSentResult);
-  JSONAddProp(json, "nbSentResult", buffer);
-  memset(buffer, 0, bufferSize);
-
-  sprintf(buffer, "%lu", that->_nbFailedSendResult);
-  JSONAddProp(json, "nbFailedSendResult", buffer);
-  memset(buffer, 0, bufferSize);
-
-  sprintf(buffer, "%lu", that->_nbFailedSendResultSize);
-  JSONAddProp(json, "nbFailedSendResultSize", buffer);
-  memset(buffer, 0, bufferSize);
-
-  sprintf(buffer, "%lu", that->_nbFailedReceptAck);
-  JSONAddProp(json, "nbFailedReceptAck", buffer);
-  memset(buffer, 0, bufferSize);
 
-  sprintf(buffer, "%lu", that->_nbTaskComplete);
-  JSONAddProp(json, "nbTaskComplete", buffer);
-  memset(buffer, 0, bufferSize);
+  // Get the definition of the NeuraNet, if given
+  const JSONNode* propNN = NULL;
+  if (nns != NULL)
+    propNN = JSONProperty(nns, hash);
+
+  // If the definition is given
+  if (propNN != NULL) {
+
+    // Replace the oldest NeuraNet in the cache which is not needed by 
+    // the current task, the Squad memorizes the sent NeuraNets in the 
+    // same way and so knows which ones are still available 
+    // There is always one, the tasks have at most THESQUID_NBNNCACHE 
+    // NeuraNets
+    int iNN = that->_nextNNCache;
+    bool needed = true;
+    for (int iTry = THESQUID_NBNNCACHE; iTry-- && needed;) {
+      needed = false;
+      for (long iHash = (keep != NULL ? JSONGetNbValue(keep) : 0); 
+        iHash-- && !needed;) {
+        needed = (strcmp(that->_nnCacheHashes[iNN], 
+          JSONLblVal(JSONValue(keep, iHash))) == 0);
+      }
+      if (needed == true)
+        iNN = (iNN + 1) % THESQUID_NBNNCACHE;
+    }
+    that->_nextNNCache = (iNN + 1) % THESQUID_NBNNCACHE;
+    NeuraNetFree(that->_nnCache + iNN);
+    that->_nnCacheHashes[iNN][0] = '\0';
 
-  sprintf(buffer, "%lu", that->_timeToProcessMs);
-  JSONAddProp(json, "timeToProcessMs", buffer);
-  memset(buffer, 0, bufferSize);
+    // Decode the NeuraNet
+    if (NNDecodeAsJSON(that->_nnCache + iNN, propNN) == false) {
+      NeuraNetFree(that->_nnCache + iNN);
+      return NULL;
+    }
+    strncpy(that->_nnCacheHashes[iNN], hash, THESQUID_NNHASHLENGTH);
+    that->_nnCacheHashes[iNN][THESQUID_NNHASHLENGTH] = '\0';
 
-  sprintf(buffer, "%lu", that->_timeWaitedTaskMs);
-  JSONAddProp(json, "timeWaitedTaskMs", buffer);
-  memset(buffer, 0, bufferSize);
+    // Return the NeuraNet
+    return that->_nnCache[iNN];
+  }
 
-  sprintf(buffer, "%lu", that->_timeWaitedAckMs);
-  JSONAddProp(json, "timeWaitedAckMs", buffer);
-  memset(buffer, 0, bufferSize);
+  // Search the NeuraNet in the cache
+  for (int iNN = THESQUID_NBNNCACHE; iNN--;) {
+    if (that->_nnCache[iNN] != NULL && 
+      strcmp(that->_nnCacheHashes[iNN], hash) == 0) {
+      return that->_nnCache[iNN];
+    }
+  }
 
-  sprintf(buffer, "%.3f", that->_timeTransferSquidSquadMs);
-  JSONAddProp(json, "timeTransferSquidSquadMs", buffer);
-  memset(buffer, 0, bufferSize);
+  // The NeuraNet is not available
+  return NULL;
 }
 
-// Process a benchmark task request with the Squidlet 'that'
-// The task request parameters are encoded in JSON and stored in the 
-// string 'buffer'
-// The result of the task are encoded in JSON format and stored in 
-// 'bufferResult' which is allocated as necessary
-void SquidletProcessRequest_Benchmark(
-    Squidlet* const that,
-  const char* const buffer, 
-             char** bufferResult) {
+// Copy the samples of the category 'cat' of the GDataSet of the 
+// Squidlet 'that' into one contiguous buffer, if they are not already
+// Return true if the samples are available, false else
+bool SquidletCacheSamples(
+  Squidlet* const that, 
+   const long cat) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
@@ -4188,139 +11994,236 @@ void SquidletProcessRequest_Benchmark(
   }
 #endif
 
-  // Start measuring the time used to process the task
-  that->_timeToProcessMs = 0;
-  struct timeval start;
-  gettimeofday(&start, NULL);
-
-  // Declare a variable to memorize if the process has been successful
-  bool success = false;
-
-  // Variable to memorize the result of the benchmark function
-  int result = 0;
-
-  // Declare a variable to store the error message if any
-  char errMsg[THESQUID_MAXPAYLOADSIZE] = {'\0'};
-
-  // Decode the input from JSON
-  JSONNode* json = JSONCreate();
-  bool ret = JSONLoadFromStr(json, buffer);
+  // If the samples of this category are already cached, there is 
+  // nothing to do
+  if (that->_samples != NULL && that->_samplesCat == cat)
+    return true;
 
-  // If we could decode the JSON
-  if (ret == true) {
+  // Free the currently cached samples
+  if (that->_samples != NULL)
+    free(that->_samples);
+  that->_samples = NULL;
+  that->_samplesCat = -1;
+  that->_nbSample = 0;
+  that->_dimSample = 0;
 
-    // Get the values to process
-    JSONNode* propNb = JSONProperty(json, "nb");
-    JSONNode* propPayloadSize = JSONProperty(json, "payloadSize");
-    
-    // If the value were in the JSON
-    if (propNb != NULL && propPayloadSize != NULL) {
+  // Get the number of samples in the category
+  long nbSample = GDSGetSizeCat(&(that->_dataset), cat);
 
-      // Convert the value from string to int 
-      int nb = atoi(JSONLblVal(propNb));
+  // If the category is empty
+  if (nbSample <= 0)
+    return false;
 
-      if (SquidletStreamInfo(that)){
-        SquidletPrint(that, SquidletStreamInfo(that));
-        fprintf(SquidletStreamInfo(that), 
-          " : run benchmark\n");
-      }
+  // Loop on the samples of the category
+  GDSReset(&(that->_dataset), cat);
+  long iSample = 0;
+  do {
 
-      // Run the benchmark function
-      result = TheSquidBenchmark(nb, 
-        JSONLblVal(propPayloadSize));
+    // Get the current sample
+    VecFloat* sample = GDSGetSample(&(that->_dataset), cat);
 
-      if (SquidletStreamInfo(that)){
-        SquidletPrint(that, SquidletStreamInfo(that));
-        fprintf(SquidletStreamInfo(that), 
-          " : benchmark complete\n");
-      }
+    // If it's the first sample, allocate memory for the cache now 
+    // that we know the dimension of samples
+    if (that->_samples == NULL) {
+      that->_dimSample = VecGetDim(sample);
+      that->_samples = PBErrMalloc(TheSquidErr, 
+        sizeof(float) * nbSample * that->_dimSample);
+    }
 
-      // Set the flag for successfull process
-      success = true;
+    // Copy the values of the sample into the cache
+    float* cache = that->_samples + iSample * that->_dimSample;
+    for (long iVal = that->_dimSample; iVal--;)
+      cache[iVal] = VecGet(sample, iVal);
 
-    // Else, at least one value was missing
-    } else {
+    // Free memory
+    VecFree(&sample);
 
-      // Update the error message
-      sprintf(errMsg, "missing data (nb or v)");
+    ++iSample;
 
-      if (SquidletStreamInfo(that)){
-        SquidletPrint(that, SquidletStreamInfo(that));
-        fprintf(SquidletStreamInfo(that), " : missing data (nb or v)\n");
-      }
-    }
+  } while (iSample < nbSample && 
+    GDSStepSample(&(that->_dataset), cat));
 
-  // Else, we couldn't decode the JSON
-  } else {
+  // Memorize the category and number of cached samples
+  that->_samplesCat = cat;
+  that->_nbSample = iSample;
 
-    // Update the error message
-    sprintf(errMsg, "couldn't load json (%s)", JSONErr->_msg);
+  // Return the success code
+  return true;
+}
 
-    if (SquidletStreamInfo(that)){
-      SquidletPrint(that, SquidletStreamInfo(that));
-      fprintf(SquidletStreamInfo(that), 
-        " : couldn't load json %s\n", buffer);
-    }
+// Return the temperature of the squidlet 'that' as a float. 
+// The result is the last value sampled in background by its 
+// TheSquidThermal, whose source depends on the architecture on which 
+// the squidlet is running. It is '0.0' if the temperature is not 
+// available
+float SquidletGetTemperature(
+  const Squidlet* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
   }
+#endif
+  if (that->_thermal == NULL)
+    return 0.0;
+  return TheSquidThermalGetTemperature(that->_thermal);
+}
 
-  // Free memory
-  JSONFree(&json);
-
-  // Update the time used to process the task
-  struct timeval now;
-  gettimeofday(&now, NULL);
-  that->_timeToProcessMs = 
-    (now.tv_sec - start.tv_sec) * 1000 +
-    (now.tv_usec - start.tv_usec) / 1000;
-
-  // Update the number of completed tasks if it was successfull
-  if (success == true) {
-    ++(that->_nbTaskComplete);
+// Replace the source of the temperature of the Squidlet 'that' with 
+// 'source' and its user 'data', sampled every 'periodMs' milliseconds 
+// Return true if the sampler could be created, else false and the 
+// temperature is not available anymore
+bool SquidletSetThermalSource(
+                   Squidlet* const that, 
+  const TheSquidThermalSource source, 
+                   void* const data, 
+            const unsigned int periodMs) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (source == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'source' is null");
+    PBErrCatch(TheSquidErr);
   }
+#endif
+  TheSquidThermalFree(&(that->_thermal));
+  that->_thermal = TheSquidThermalCreate(source, data, periodMs);
+  return (that->_thermal != NULL);
+}
 
-  // Prepare the result data as JSON
-  JSONNode* jsonResult = JSONCreate();
-  float temperature = SquidletGetTemperature(that);
-  // This software is not guaranteed to run under temperature having
-  // more than 7 digits, you've be warned !
-  char temperatureStr[10] = {'\0'};
-  sprintf(temperatureStr, "%.2f", temperature);
-  JSONAddProp(jsonResult, "temperature", temperatureStr);
-  char successStr[2] = {'\0'};
-  sprintf(successStr, "%d", success);
-  JSONAddProp(jsonResult, "success", successStr);
-  // Result is an int, 10 digits will be fine
-  char resultStr[10] = {'\0'};
-  sprintf(resultStr, "%d", result);
-  JSONAddProp(jsonResult, "v", resultStr);
-  JSONAddProp(jsonResult, "err", errMsg);
+// Return the throttled state of the squidlet 'that', the last value 
+// sampled in background by its TheSquidThermal. It is false if the 
+// state is not available
+bool SquidletIsThrottled(
+  const Squidlet* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  if (that->_thermal == NULL)
+    return false;
+  return TheSquidThermalIsThrottled(that->_thermal);
+}
 
-  // Append the statistics data
-  SquidletAddStatsToJSON(that, jsonResult);
+// Print the statistics of the Squidlet 'that' on the 'stream' in the 
+// Prometheus text format
+void SquidletPrintMetrics(
+  const Squidlet* const that, 
+           FILE* const stream) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (stream == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'stream' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Print the counters
+  TheSquidPrintMetricHeader(stream, 
+    "thesquid_squidlet_connections_accepted_total", "counter", 
+    "Number of connections accepted by the squidlet");
+  fprintf(stream, "thesquid_squidlet_connections_accepted_total %lu\n",
+    that->_nbAcceptedConnection);
+  TheSquidPrintMetricHeader(stream, 
+    "thesquid_squidlet_tasks_accepted_total", "counter", 
+    "Number of tasks accepted by the squidlet");
+  fprintf(stream, "thesquid_squidlet_tasks_accepted_total %lu\n",
+    that->_nbAcceptedTask);
+  TheSquidPrintMetricHeader(stream, 
+    "thesquid_squidlet_tasks_completed_total", "counter", 
+    "Number of tasks completed by the squidlet");
+  fprintf(stream, "thesquid_squidlet_tasks_completed_total %lu\n",
+    that->_nbTaskComplete);
+  TheSquidPrintMetricHeader(stream, 
+    "thesquid_squidlet_failures_total", "counter", 
+    "Number of failures of the protocol by cause");
+  const char* format = "thesquid_squidlet_failures_total{cause=\"%s\"} %lu\n";
+  fprintf(stream, format, "refused_task", that->_nbRefusedTask);
+  fprintf(stream, format, "recv_task_size", 
+    that->_nbFailedReceptTaskSize);
+  fprintf(stream, format, "recv_task_data", 
+    that->_nbFailedReceptTaskData);
+  fprintf(stream, format, "send_result_size", 
+    that->_nbFailedSendResultSize);
+  fprintf(stream, format, "send_result", that->_nbFailedSendResult);
+  fprintf(stream, format, "recv_ack", that->_nbFailedReceptAck);
+  TheSquidPrintMetricHeader(stream, 
+    "thesquid_squidlet_task_bytes_total", "counter", 
+    "Number of bytes of task data received by the squidlet");
+  fprintf(stream, "thesquid_squidlet_task_bytes_total %lu\n",
+    that->_nbByteReceived);
+  TheSquidPrintMetricHeader(stream, 
+    "thesquid_squidlet_result_bytes_total", "counter", 
+    "Number of bytes of result sent by the squidlet");
+  fprintf(stream, "thesquid_squidlet_result_bytes_total %lu\n",
+    that->_nbByteSent);
+
+  // Print the gauges
+  TheSquidPrintMetricHeader(stream, 
+    "thesquid_squidlet_temperature_celsius", "gauge", 
+    "Current temperature of the squidlet");
+  fprintf(stream, "thesquid_squidlet_temperature_celsius %.1f\n",
+    SquidletGetTemperature(that));
+  TheSquidPrintMetricHeader(stream, 
+    "thesquid_squidlet_threads", "gauge", 
+    "Number of threads used to process the tasks");
+  fprintf(stream, "thesquid_squidlet_threads %d\n",
+    SquidletGetNbThread(that));
+
+  // Print the histograms
+  TheSquidPrintMetricHeader(stream, 
+    "thesquid_squidlet_process_time_ms", "histogram", 
+    "Time to process a task, per type of task");
+  for (int iType = 0; iType < SquidletTaskType_Nb; ++iType) {
+    if (that->_histoTimeToProcessMs[iType]._nb > 0) {
+      char label[100];
+      sprintf(label, "type=\"%s\"", squidletTaskTypeStr[iType]);
+      TheSquidHistoPrintPrometheus(that->_histoTimeToProcessMs + iType,
+        "thesquid_squidlet_process_time_ms", label, stream);
+    }
+  }
+}
 
-  // Convert the JSON to a string and store it in the result buffer
-  *bufferResult = PBErrMalloc(TheSquidErr, THESQUID_MAXPAYLOADSIZE);
-  memset(*bufferResult, 0, THESQUID_MAXPAYLOADSIZE);
-  bool compact = true;
-  ret = JSONSaveToStr(jsonResult, 
-    *bufferResult, THESQUID_MAXPAYLOADSIZE, compact);
-  if (ret == false) {
-    sprintf(*bufferResult, 
-      "{\"success\":\"0\",\"temperature\":\"0.0\","
-      "\"err\":\"JSONSaveToStr failed\"}");
+// Open the endpoint serving the metrics of the Squidlet 'that' over 
+// HTTP on the port 'port'. The scrapes are served while waiting for 
+// requests in SquidletWaitRequest
+// Return true if the endpoint could be opened, false else
+bool SquidletSetMetricsPort(
+  Squidlet* const that, 
+   const int port) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
   }
+#endif
+  // Close the current endpoint if any and open the new one
+  TheSquidMetricsFree(&(that->_metrics));
+  that->_metrics = TheSquidMetricsCreate(port);
 
-}  
+  // Return the success code
+  return (that->_metrics != NULL);
+}
 
-// Process a Pov-Ray task request with the Squidlet 'that'
-// The task request parameters are encoded in JSON and stored in the 
-// string 'buffer'
-// The result of the task are encoded in JSON format and stored in 
-// 'bufferResult' which is allocated as necessary
-void SquidletProcessRequest_PovRay(
-    Squidlet* const that,
-  const char* const buffer, 
-             char** bufferResult) {
+// Open the binary log of the events of the Squidlet 'that' in the 
+// file at 'path', or close it if 'path' is null 
+// Return true if the log could be opened, false else
+bool SquidletSetEventLog(
+     Squidlet* const that, 
+  const char* const path) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
@@ -4328,95 +12231,128 @@ void SquidletProcessRequest_PovRay(
     PBErrCatch(TheSquidErr);
   }
 #endif
-  // Declare a variable to memorize if the process has been successful
-  bool success = false;
+  // Close the current log if any
+  TheSquidEventLogFree(&(that->_eventLog));
 
-  // Display info
-  if (SquidletStreamInfo(that)) {
-    SquidletPrint(that, SquidletStreamInfo(that));
-    fprintf(SquidletStreamInfo(that), 
-      " : process Pov-Ray task %s\n", buffer);
-    fflush(SquidletStreamInfo(that));
-  }
+  // If there is no new log, nothing else to do
+  if (path == NULL)
+    return true;
 
-  // Decode the input from JSON
-  JSONNode* json = JSONCreate();
-  bool ret = JSONLoadFromStr(json, buffer);
+  // Open the new log, named after the squidlet
+  char name[THESQUID_EVENTLOG_LENGTHNAME];
+  snprintf(name, THESQUID_EVENTLOG_LENGTHNAME, "squidlet %s:%d", 
+    that->_hostname, that->_port);
+  that->_eventLog = TheSquidEventLogCreate(path, name);
 
-  // If we could decode the JSON
-  if (ret == true) {
+  // Return the success code
+  return (that->_eventLog != NULL);
+}
 
-    // Get the arguments
-    JSONNode* propIni = JSONProperty(json, "ini");
-    JSONNode* propTga = JSONProperty(json, "tga");
-    JSONNode* propTop = JSONProperty(json, "top");
-    JSONNode* propLeft = JSONProperty(json, "left");
-    JSONNode* propBottom = JSONProperty(json, "bottom");
-    JSONNode* propRight = JSONProperty(json, "right");
+// Push the event of type 'type' with the value 'value' for the task 
+// currently processed by the Squidlet 'that' in its event log, if any
+void SquidletLogEvent(
+          Squidlet* const that, 
+  const TheSquidEventType type, 
+      const unsigned long value) {
+  if (that->_eventLog != NULL) {
+    TheSquidEventLogPush(that->_eventLog, type, that->_taskType, 
+      that->_taskId, that->_taskSubId, (uint16_t)(that->_port), value);
+  }
+}
 
-    // If all the arguments are presents
-    if (propIni != NULL && propTga != NULL && propTop != NULL && 
-      propLeft != NULL && propBottom != NULL && propRight != NULL) {
-
-      // Create the Pov-Ray command
-      // povray +SC<left> +SR<top> +EC<right> +ER<bottom> +O<tga>
-      //   +FT -D <ini>
-      char cmd[500];
-      sprintf(cmd, 
-        "povray %s +SC%s +SR%s +EC%s +ER%s +O%s +FT -D", 
-        JSONLblVal(propIni),
-        JSONLblVal(propLeft), 
-        JSONLblVal(propTop), 
-        JSONLblVal(propRight), 
-        JSONLblVal(propBottom), 
-        JSONLblVal(propTga));
-
-      // Execute the Pov-Ray command
-      int ret = system(cmd);
-      
-      if (ret == 0) {
-        // Set the flag for successfull process
-        success = true;
-      }
-    }
+// Memorize in the Squidlet 'that' the id and sub id of the task 
+// currently processed, decoded from its data 'buffer', for the event log 
+// They are left to 0 if the data doesn't start with them
+void SquidletSetTaskId(
+   Squidlet* const that, 
+  const char* const buffer) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (buffer == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'buffer' is null");
+    PBErrCatch(TheSquidErr);
   }
+#endif
 
-  // Update the number of completed tasks if it was successfull
-  if (success == true) {
-    ++(that->_nbTaskComplete);
+  // Only the head of the data is scanned, the id and sub id are the 
+  // first properties of the tasks having them, and the data of the 
+  // other tasks (command, standard input, ...) must not be mistaken 
+  // for them
+  unsigned long id = 0;
+  unsigned long subId = 0;
+  sscanf(buffer, "{\"id\":\"%lu\",\"subid\":\"%lu\"", &id, &subId);
+  that->_taskId = id;
+  that->_taskSubId = subId;
+}
+
+// Announce the Squidlet 'that' every THESQUID_ANNOUNCE_PERIOD seconds 
+// to the squads discovering squidlets on the address 'ip':'port', 
+// which may be a broadcast address or the one of a squad. Announce it 
+// immediately, then while waiting for requests in SquidletWaitRequest 
+// Stop the announces if 'ip' is null 
+// Return true if the announce could be setup, false else
+bool SquidletSetAnnounce(
+     Squidlet* const that, 
+  const char* const ip, 
+          const int port) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'that' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Close the current socket if any
+  if (that->_fdAnnounce != -1) {
+    close(that->_fdAnnounce);
+    that->_fdAnnounce = -1;
   }
 
-  // Prepare the result data as JSON
-  *bufferResult = PBErrMalloc(TheSquidErr, THESQUID_MAXPAYLOADSIZE);
-  memset(*bufferResult, 0, THESQUID_MAXPAYLOADSIZE);
-  char successStr[2] = {'\0'};
-  sprintf(successStr, "%d", success);
-  JSONAddProp(json, "success", successStr);
-  float temperature = SquidletGetTemperature(that);
-  // This software is not guaranteed to run under temperature having
-  // more than 7 digits, you've be warned !
-  char temperatureStr[10] = {'\0'};
-  sprintf(temperatureStr, "%.2f", temperature);
-  JSONAddProp(json, "temperature", temperatureStr);
+  // If the announces are stopped, nothing else to do
+  if (ip == NULL)
+    return true;
 
-  // Append the statistics data
-  SquidletAddStatsToJSON(that, json);
-  ret = JSONSaveToStr(json, 
-    *bufferResult, THESQUID_MAXPAYLOADSIZE, true);
-  if (ret == false) {
-    sprintf(*bufferResult, 
-      "{\"success\":\"0\",\"temperature\":\"0.0\","
-      "\"err\":\"JSONSaveToStr failed\"}");
+  // Decode the address of the announces
+  memset(&(that->_addrAnnounce), 0, sizeof(struct sockaddr_in));
+  that->_addrAnnounce.sin_family = AF_INET;
+  that->_addrAnnounce.sin_port = htons(port);
+  if (inet_pton(AF_INET, ip, &(that->_addrAnnounce.sin_addr)) != 1) {
+    TheSquidErr->_type = PBErrTypeInvalidArg;
+    sprintf(TheSquidErr->_msg, "invalid address %s", ip);
+    return false;
   }
 
-  // Free memory
-  JSONFree(&json);
+  // Open the socket, allowed to broadcast
+  that->_fdAnnounce = socket(AF_INET, SOCK_DGRAM, 0);
+  int broadcast = 1;
+  if (that->_fdAnnounce == -1 || setsockopt(that->_fdAnnounce, 
+    SOL_SOCKET, SO_BROADCAST, &broadcast, sizeof(int)) == -1) {
+    if (that->_fdAnnounce != -1)
+      close(that->_fdAnnounce);
+    that->_fdAnnounce = -1;
+    sprintf(TheSquidErr->_msg, "couldn't open the announce socket");
+    return false;
+  }
 
-}  
+  // Announce the squidlet immediately
+  SquidletAnnounce(that, "hello");
 
-// Process a stats reset task request with the Squidlet 'that'
-void SquidletProcessRequest_StatsReset(
-    Squidlet* const that) {
+  // Return the success code
+  return true;
+}
+
+// Make the Squidlet 'that' a relay to the squidlets of the Squad 
+// 'squad': the batch tasks it receives from its parent Squad are 
+// executed by the squidlets of 'squad'. 'squad' is freed with the 
+// Squidlet, the previous one is freed, null stops the relay
+void SquidletSetRelay(
+  Squidlet* const that, 
+     Squad* const squad) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
@@ -4425,380 +12361,811 @@ void SquidletProcessRequest_StatsReset(
   }
 #endif
 
-  // Reset the stats
-  SquidletResetStats(that);
-}  
+  // Free the current relay if any
+  SquadFree(&(that->_relay));
 
-// Process a neuranet evaluation task request with the Squidlet 'that'
-// The task request parameters are encoded in JSON and stored in the 
-// string 'buffer'
-// The result of the task are encoded in JSON format and stored in 
-// 'bufferResult' which is allocated as necessary
-void SquidletProcessRequest_EvalNeuranet(
-    Squidlet* const that,
-  const char* const buffer, 
-             char** bufferResult) {
+  // The Squad of the relay forwards the results of the tasks to the 
+  // parent Squad which post processes them
+  if (squad != NULL)
+    squad->_flagRelay = true;
+
+  // Set the relay
+  that->_relay = squad;
+}
+
+// Allow the Squidlet 'that' to run the binary at 'path' for the Exec 
+// tasks, which refer to it by its file name 
+// Return false if the binary is not executable or there are already 
+// THESQUID_EXEC_MAXCOMMAND binaries, else true
+bool SquidletAddExecCommand(
+    Squidlet* const that, 
+  const char* const path) {
 #if BUILDMODE == 0
   if (that == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
     sprintf(TheSquidErr->_msg, "'that' is null");
     PBErrCatch(TheSquidErr);
   }
-  if (buffer == NULL) {
+  if (path == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'buffer' is null");
+    sprintf(TheSquidErr->_msg, "'path' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
+  // If there is no more room for the binary
+  if (that->_nbExecCommand >= THESQUID_EXEC_MAXCOMMAND) {
+    TheSquidErr->_type = PBErrTypeInvalidArg;
+    sprintf(TheSquidErr->_msg, "too many exec commands");
+    return false;
+  }
 
-  // Declare a variable to memorize if the process has been successful
-  bool success = false;
-
-  // Allocate memory for the result
-  *bufferResult = PBErrMalloc(TheSquidErr, THESQUID_MAXPAYLOADSIZE);
-  memset(*bufferResult, 0, THESQUID_MAXPAYLOADSIZE);
+  // If the binary is not executable
+  if (access(path, X_OK) != 0) {
+    TheSquidErr->_type = PBErrTypeInvalidArg;
+    sprintf(TheSquidErr->_msg, "%.100s is not executable (%s)", path, 
+      strerror(errno));
+    return false;
+  }
 
-  // Start measuring the time used to process the task
-  that->_timeToProcessMs = 0;
-  struct timeval start;
-  gettimeofday(&start, NULL);
+  // Add the binary
+  that->_execCommands[that->_nbExecCommand] = strdup(path);
+  ++(that->_nbExecCommand);
 
-  // Process the data
-  if (SquidletStreamInfo(that)){
-    SquidletPrint(that, SquidletStreamInfo(that));
-    fprintf(SquidletStreamInfo(that), 
-      " : process neuranet evaluation task %s\n", buffer);
-  }
+  // Return the success code
+  return true;
+}
 
-  // Decode the input from JSON
-  JSONNode* json = JSONCreate();
-  bool ret = JSONLoadFromStr(json, buffer);
+// Send the announce 'cmd' (hello or bye) of the Squidlet 'that'
+void SquidletAnnounce(
+     Squidlet* const that, 
+  const char* const cmd) {
+  // Send the announce, without blocking, it will be sent again at the 
+  // next period if it fails
+  char buffer[THESQUID_ANNOUNCE_LENGTH];
+  int len = snprintf(buffer, THESQUID_ANNOUNCE_LENGTH, "%s %s %d %s", 
+    THESQUID_ANNOUNCE_MAGIC, cmd, that->_port, that->_hostname);
+  (void)sendto(that->_fdAnnounce, buffer, 
+    MIN(len, THESQUID_ANNOUNCE_LENGTH - 1), MSG_DONTWAIT, 
+    (struct sockaddr*)&(that->_addrAnnounce), sizeof(struct sockaddr_in));
+  that->_timeLastAnnounce = time(NULL);
+}
 
-  // If we could decode the input
-  if (ret == true) {
+// Print the metrics of the Squidlet 'that' on the 'stream', 
+// TheSquidMetricsPrinter wrapper of SquidletPrintMetrics
+void SquidletPrintMetricsCallback(
+  const void* const that, 
+        FILE* const stream) {
+  SquidletPrintMetrics((const Squidlet*)that, stream);
+}
 
-    // Get the dataset path
-    JSONNode* propDataset = JSONProperty(json, "dataset");
-    
-    // Get the working dir path
-    JSONNode* propWorkingDir = JSONProperty(json, "workingDir");
-    
-    // Get the entity ids
-    JSONNode* propIds = JSONProperty(json, "nnids");
-    VecLong* nnids = NULL;
-    VecDecodeAsJSON(&nnids, propIds);
-    
-    // Get the best value
-    JSONNode* propBest = JSONProperty(json, "best");
-    
-    // Get the category in dataset
-    JSONNode* propCat = JSONProperty(json, "cat");
-    
-    // If all the values are present
-    if (propDataset != NULL && 
-      propWorkingDir != NULL && 
-      propIds != NULL && 
-      propBest != NULL &&
-      propCat != NULL) {
-      
-      // Convert the ids, cat and best value from string
-      long cat = atol(JSONLblVal(propCat));
-      float bestVal = atof(JSONLblVal(propBest));
+// -------------- TheSquid 
 
-      // If the dataset in argument is different from the last one used
-      if (that->_datasetPath == NULL ||
-        strcmp(that->_datasetPath, JSONLblVal(propDataset)) != 0) {
+// ================ Functions implementation ====================
 
-        // Free the current dataset
-        GDataSetVecFloatFreeStatic(&(that->_dataset));
+// Function for benchmark purpose
+// Create a set of null element of size equals to the size of the
+// buffer in the task data, and sort it 10 times the 'nbLoop' in the
+// task data, using each time diferrent sorting values for each element 
+int TheSquidBenchmark(
+                int nbLoop, 
+  const char* const buffer) {
 
-        // Load the requested dataset
-        that->_dataset = GDataSetVecFloatCreateStaticFromFile(
-          JSONLblVal(propDataset));
+  // Variable to memorize the dummy result
+  int res = 0;
 
-        // Memorize the path
-        if (that->_datasetPath != NULL)
-          free(that->_datasetPath);
-        that->_datasetPath = strdup(JSONLblVal(propDataset));
-        
+  // Loop on sample code
+  for (int iLoop = 0; iLoop < nbLoop; ++iLoop) {
+    for (unsigned int scaling = 10; scaling--;) {
+      GSet set = GSetCreateStatic();
+      for(unsigned long i = strlen(buffer); i--;) {
+        GSetPush(&set, NULL);
+        set._head->_sortVal = (float)(i + scaling + iLoop);
       }
+      GSetSort(&set);
+      res = (int)round(set._head->_sortVal);
+      GSetFlush(&set);
+    }
+  }
 
-      // If we could load the dataset
-      if (GDSGetSizeCat(&(that->_dataset), cat) > 0) {
-
-        // Declare a variable to memorize the values
-        VecFloat* values = VecFloatCreate(VecGetDim(nnids));
-        
-        // Set the flag for successfull process by default
-        success = true;
+  // Return the dummy result
+  return res;
+}
 
-        // Loop on the NeuraNet to evaluate
-        for (int iNN = 0; iNN < VecGetDim(nnids); ++iNN) {
+// Create a pipe in 'fds' whose ends are closed on exec 
+// Return true if it could be created, else false
+bool TheSquidPipe(
+  int* const fds) {
+#if BUILDMODE == 0
+  if (fds == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'fds' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  if (pipe(fds) != 0)
+    return false;
+  fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+  fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+  return true;
+}
 
-          // Load the Neuranet
-          NeuraNet* nn = NULL;
-          char nnFilename[100];
-          sprintf(nnFilename, "nn%ld.json", VecGet(nnids, iNN));
-          char* pathNN = PBFSJoinPath(
-            JSONLblVal(propWorkingDir), 
-            nnFilename);
-          FILE* fpnn = fopen(pathNN, "r");
-          free(pathNN);
-          if (fpnn != NULL && NNLoad(&nn, fpnn)) {
-            
-            // Close the file pointer to the Neuranet definition
-            // file
-            fclose(fpnn);
-        
-            // Create the inputs and outputs vector from the
-            // dimension of the NeuraNet
-            // The sample values must be ordered as follow
-            // <i0, i1, ..., in, o0, o1, ..., om>
-            VecShort* inputs = VecShortCreate(NNGetNbInput(nn));
-            for (unsigned int i = VecGetDim(inputs); i--;)
-              VecSet(inputs, i, i);
-            VecShort* outputs = VecShortCreate(NNGetNbOutput(nn));
-            for (unsigned int i = VecGetDim(outputs); i--;)
-              VecSet(outputs, i, VecGetDim(inputs) + i);
-
-            // Run the evaluation of the neuranet on the dataset
-            float eval = GDSEvaluateNN(
-              &(that->_dataset), 
-              nn,
-              cat,
-              inputs,
-              outputs,
-              bestVal);
-            VecSet(
-              values, 
-              iNN, 
-              eval);
-
-            // Free memory
-            VecFree(&inputs);
-            VecFree(&outputs);
-            NeuraNetFree(&nn);
-
-          // Else, we couldn't load the Neuranet
-          } else {
+// Run the binary 'path' (searched in the PATH if it contains no 
+// slash) with the arguments 'argv' (null terminated, 'argv[0]' being 
+// the name of the binary) in a new process, without shell 
+// If 'input' is not null, its 'lenInput' bytes are written on the 
+// standard input of the process, else the process inherits it 
+// If 'output' is not null, the standard output of the process is 
+// stored in '*output' (allocated, null terminated) and its length in 
+// '*lenOutput', else the process inherits it. The process is killed 
+// if its output exceeds THESQUID_EXEC_MAXOUTPUT bytes 
+// If 'timeout' is greater than 0, the process is killed after 
+// 'timeout' seconds 
+// Return the exit status of the process, or -1 if it couldn't be run 
+// or has been killed
+int TheSquidSpawn(
+     const char* const path, 
+            char* const* argv, 
+     const char* const input, 
+          const size_t lenInput, 
+                  char** output, 
+          size_t* const lenOutput, 
+             const int timeout) {
+#if BUILDMODE == 0
+  if (path == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'path' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (argv == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'argv' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (output != NULL && lenOutput == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'lenOutput' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Create the pipes to the standard input and output of the process
+  int fdIn[2] = {-1, -1};
+  int fdOut[2] = {-1, -1};
+  bool ret = true;
+  if (input != NULL)
+    ret = TheSquidPipe(fdIn);
+  if (ret == true && output != NULL)
+    ret = TheSquidPipe(fdOut);
+  if (ret == false) {
+    TheSquidErr->_type = PBErrTypeIOError;
+    sprintf(TheSquidErr->_msg, "pipe failed (%s)", strerror(errno));
+    for (int iFd = 2; iFd--;) {
+      if (fdIn[iFd] != -1)
+        close(fdIn[iFd]);
+      if (fdOut[iFd] != -1)
+        close(fdOut[iFd]);
+    }
+    return -1;
+  }
+
+  // Start the process with its standard input and output redirected to 
+  // the pipes, the other ends of the pipes are closed on exec
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  if (input != NULL)
+    posix_spawn_file_actions_adddup2(&actions, fdIn[0], STDIN_FILENO);
+  if (output != NULL)
+    posix_spawn_file_actions_adddup2(&actions, fdOut[1], STDOUT_FILENO);
+  pid_t pid = 0;
+  int retSpawn = posix_spawnp(&pid, path, &actions, NULL, argv, environ);
+  posix_spawn_file_actions_destroy(&actions);
+
+  // Close the ends of the pipes used by the process
+  if (fdIn[0] != -1)
+    close(fdIn[0]);
+  if (fdOut[1] != -1)
+    close(fdOut[1]);
+  int fdWrite = fdIn[1];
+  int fdRead = fdOut[0];
+
+  // If we couldn't start the process
+  if (retSpawn != 0) {
+    TheSquidErr->_type = PBErrTypeIOError;
+    sprintf(TheSquidErr->_msg, "posix_spawnp failed (%s)", 
+      strerror(retSpawn));
+    if (fdWrite != -1)
+      close(fdWrite);
+    if (fdRead != -1)
+      close(fdRead);
+    return -1;
+  }
+
+  // Stream the input to the process and its output back by chunks of 
+  // THESQUID_EXEC_PIPEBUFFER bytes, without blocking on one pipe while 
+  // the process is waiting on the other one
+  struct timeval start;
+  gettimeofday(&start, NULL);
+  bool killed = false;
+  size_t nbWritten = 0;
+  size_t sizeOutput = 0;
+  if (output != NULL) {
+    *output = NULL;
+    *lenOutput = 0;
+  }
+  if (fdWrite != -1) {
+    fcntl(fdWrite, F_SETFL, O_NONBLOCK);
+    if (lenInput == 0) {
+      close(fdWrite);
+      fdWrite = -1;
+    }
+  }
+  if (fdRead != -1)
+    fcntl(fdRead, F_SETFL, O_NONBLOCK);
+  while (killed == false && (fdWrite != -1 || fdRead != -1)) {
+
+    // Wait for the pipes, up to the deadline
+    struct pollfd fds[2];
+    int nbFd = 0;
+    if (fdWrite != -1) {
+      fds[nbFd].fd = fdWrite;
+      fds[nbFd].events = POLLOUT;
+      ++nbFd;
+    }
+    if (fdRead != -1) {
+      fds[nbFd].fd = fdRead;
+      fds[nbFd].events = POLLIN;
+      ++nbFd;
+    }
+    int wait = -1;
+    if (timeout > 0)
+      wait = MAX(0, 1000 * timeout - (int)TheSquidGetElapsedMs(&start));
+    int nbReady = poll(fds, nbFd, wait);
+    if (nbReady == -1 && errno == EINTR)
+      continue;
+    if (nbReady <= 0) {
+      TheSquidErr->_type = PBErrTypeRuntimeError;
+      sprintf(TheSquidErr->_msg, "%s timed out", path);
+      killed = true;
+      break;
+    }
 
-            // Set the successfull flag to false
-            success = false;
+    // Loop on the ready pipes
+    for (int iFd = 0; iFd < nbFd && killed == false; ++iFd) {
+      if (fds[iFd].revents == 0)
+        continue;
+
+      // Write the next chunk of the input, stop when it's complete or 
+      // the process doesn't read it anymore
+      if (fds[iFd].fd == fdWrite) {
+        size_t nb = MIN(THESQUID_EXEC_PIPEBUFFER, lenInput - nbWritten);
+        ssize_t nbSent = write(fdWrite, input + nbWritten, nb);
+        if (nbSent > 0)
+          nbWritten += nbSent;
+        if (nbWritten == lenInput || 
+          (nbSent == -1 && errno != EAGAIN && errno != EINTR)) {
+          close(fdWrite);
+          fdWrite = -1;
+        }
 
+      // Read the next chunk of the output, stop at the end of file
+      } else {
+        while (sizeOutput < *lenOutput + THESQUID_EXEC_PIPEBUFFER + 1)
+          sizeOutput = 
+            (sizeOutput == 0 ? THESQUID_EXEC_PIPEBUFFER + 1 : 
+            2 * sizeOutput);
+        char* buffer = realloc(*output, sizeOutput);
+        if (buffer == NULL) {
+          TheSquidErr->_type = PBErrTypeMallocFailed;
+          sprintf(TheSquidErr->_msg, "realloc failed");
+          killed = true;
+          break;
+        }
+        *output = buffer;
+        ssize_t nbRecv = read(fdRead, *output + *lenOutput, 
+          THESQUID_EXEC_PIPEBUFFER);
+        if (nbRecv > 0) {
+          *lenOutput += nbRecv;
+          if (*lenOutput > THESQUID_EXEC_MAXOUTPUT) {
+            TheSquidErr->_type = PBErrTypeRuntimeError;
+            sprintf(TheSquidErr->_msg, "output of %s too large", path);
+            *lenOutput = THESQUID_EXEC_MAXOUTPUT;
+            killed = true;
           }
+        } else if (nbRecv == 0 || (errno != EAGAIN && errno != EINTR)) {
+          close(fdRead);
+          fdRead = -1;
         }
-        
-        if (success == true) {
-
-          // Update the time used to process the task
-          struct timeval now;
-          gettimeofday(&now, NULL);
-          that->_timeToProcessMs = 
-            (now.tv_sec - start.tv_sec) * 1000 +
-            (now.tv_usec - start.tv_usec) / 1000;
-
-          // Update the number of completed tasks
-          ++(that->_nbTaskComplete);
-
-          // Prepare the result data as JSON
-          JSONNode* jsonResult = JSONCreate();
-          float temperature = SquidletGetTemperature(that);
-          char temperatureStr[10] = {'\0'};
-          sprintf(temperatureStr, "%.2f", temperature);
-          JSONAddProp(jsonResult, "temperature", temperatureStr);
-          char successStr[2] = {'\0'};
-          sprintf(successStr, "%d", success);
-          JSONAddProp(jsonResult, "success", successStr);
-          JSONAddProp(jsonResult, "nnids", propIds);
+      }
+    }
+  }
+  if (fdWrite != -1)
+    close(fdWrite);
+  if (fdRead != -1)
+    close(fdRead);
+
+  // Null terminate the output
+  if (output != NULL) {
+    if (*output == NULL)
+      *output = PBErrMalloc(TheSquidErr, 1);
+    (*output)[*lenOutput] = '\0';
+  }
+
+  // Wait for the end of the process, kill it if it's still running 
+  // at the deadline
+  int status = 0;
+  pid_t retWait = 0;
+  if (killed == false && timeout > 0) {
+    while ((retWait = waitpid(pid, &status, WNOHANG)) == 0 && 
+      TheSquidGetElapsedMs(&start) < 1000.0 * (float)timeout)
+      usleep(10000);
+    if (retWait == 0) {
+      TheSquidErr->_type = PBErrTypeRuntimeError;
+      sprintf(TheSquidErr->_msg, "%s timed out", path);
+      killed = true;
+    }
+  }
+  if (killed == true)
+    kill(pid, SIGKILL);
+  if (retWait == 0)
+    while ((retWait = waitpid(pid, &status, 0)) == -1 && errno == EINTR);
 
-          JSONNode* jsonValues = VecEncodeAsJSON(values);
-          JSONAddProp(jsonResult, "v", jsonValues);
+  // Return the exit status of the process
+  if (killed == true || retWait == -1 || WIFEXITED(status) == 0)
+    return -1;
+  return WEXITSTATUS(status);
+}
 
-          // Append the statistics data
-          SquidletAddStatsToJSON(that, jsonResult);
+// Receive 'size' bytes from the socket 'sock' and write them in the 
+// file at 'path', moving them directly from the socket to the file 
+// with splice(), by chunks of THESQUID_SPLICE_CHUNK bytes 
+// Give up after 'timeout' seconds, in which case the file is deleted 
+// Return true if all the bytes could be received, else false
+bool TheSquidSpliceToFile(
+               const int sock, 
+       const char* const path, 
+            const size_t size, 
+               const int timeout) {
+#if BUILDMODE == 0
+  if (path == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'path' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+  // Open the file
+  int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    TheSquidErr->_type = PBErrTypeIOError;
+    sprintf(TheSquidErr->_msg, "can't open %s (%s)", path, 
+      strerror(errno));
+    return false;
+  }
 
-          // Convert the JSON to a string
-          bool compact = true;
-          ret = JSONSaveToStr(jsonResult, *bufferResult, 
-            THESQUID_MAXPAYLOADSIZE, compact);
-          if (ret == false) {
-            sprintf(*bufferResult, 
-              "{\"success\":\"0\",\"temperature\":\"0.0\","
-              "\"err\":\"JSONSaveToStr failed\"}");
-          }
-        
-        // Else, we couldn't load the neuranet
-        } else {
+  // Create the pipe through which the bytes are moved, splice() needs 
+  // a pipe at one of its ends
+  int fdPipe[2] = {-1, -1};
+  if (TheSquidPipe(fdPipe) == false) {
+    TheSquidErr->_type = PBErrTypeIOError;
+    sprintf(TheSquidErr->_msg, "pipe failed (%s)", strerror(errno));
+    close(fd);
+    unlink(path);
+    return false;
+  }
 
-          sprintf(*bufferResult, 
-            "{\"success\":\"0\",\"temperature\":\"0.0\","
-            "\"err\":\"Invalid neuranet\"}");
-        }
+  // Move the bytes by chunks from the socket to the pipe, then from the 
+  // pipe to the file
+  struct timeval start;
+  gettimeofday(&start, NULL);
+  size_t nbMoved = 0;
+  bool ret = true;
+  while (ret == true && nbMoved < size) {
+
+    // Wait for the bytes on the socket, up to the deadline
+    struct pollfd fdSock;
+    fdSock.fd = sock;
+    fdSock.events = POLLIN;
+    int wait = MAX(0, 1000 * timeout - (int)TheSquidGetElapsedMs(&start));
+    int nbReady = poll(&fdSock, 1, wait);
+    if (nbReady == -1 && errno == EINTR)
+      continue;
+    if (nbReady <= 0) {
+      TheSquidErr->_type = PBErrTypeRuntimeError;
+      sprintf(TheSquidErr->_msg, "reception of %s timed out", path);
+      ret = false;
+      break;
+    }
 
-        // Free memory
-        VecFree(&values);
+    // Move the available bytes from the socket into the pipe
+    size_t nb = MIN(THESQUID_SPLICE_CHUNK, size - nbMoved);
+    ssize_t nbIn = splice(sock, NULL, fdPipe[1], NULL, nb, 
+      SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    if (nbIn == -1 && (errno == EAGAIN || errno == EINTR))
+      continue;
+    if (nbIn <= 0) {
+      TheSquidErr->_type = PBErrTypeIOError;
+      sprintf(TheSquidErr->_msg, "splice from socket failed (%s)", 
+        (nbIn == 0 ? "connection closed" : strerror(errno)));
+      ret = false;
+      break;
+    }
 
-      // Else, the dataset could not be loaded or was empty
-      } else {
-        
-        sprintf(*bufferResult, 
-          "{\"success\":\"0\",\"temperature\":\"0.0\","
-          "\"err\":\"Invalid dataset\"}");
+    // Flush the pipe into the file
+    ssize_t nbOut = 0;
+    while (ret == true && nbOut < nbIn) {
+      ssize_t nbFlushed = 
+        splice(fdPipe[0], NULL, fd, NULL, nbIn - nbOut, SPLICE_F_MOVE);
+      if (nbFlushed > 0) {
+        nbOut += nbFlushed;
+      } else if (nbFlushed == 0 || errno != EINTR) {
+        TheSquidErr->_type = PBErrTypeIOError;
+        sprintf(TheSquidErr->_msg, "splice to %s failed (%s)", path, 
+          strerror(errno));
+        ret = false;
       }
-      
-    // else the value is not present
-    } else {
-
-      sprintf(*bufferResult, 
-        "{\"success\":\"0\",\"temperature\":\"0.0\","
-        "\"err\":\"Invalid input\"}");
     }
+    nbMoved += nbIn;
+  }
+  close(fdPipe[0]);
+  close(fdPipe[1]);
+  if (close(fd) != 0)
+    ret = false;
 
-    // Free memory
-    VecFree(&nnids);
+  // Don't leave a partial file
+  if (ret == false)
+    unlink(path);
 
-  // Else, we couldn't decode the input
-  } else {
+  // Return the flag memorizing if we could receive the file
+  return ret;
+}
 
-    sprintf(*bufferResult, 
-      "{\"success\":\"0\",\"temperature\":\"0.0\","
-      "\"err\":\"JSONLoadFromStr failed\"}");
+// Return the time elapsed since 'start', in milliseconds
+float TheSquidGetElapsedMs(
+  const struct timeval* const start) {
+#if BUILDMODE == 0
+  if (start == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'start' is null");
+    PBErrCatch(TheSquidErr);
   }
-
-  // Free memory
-  JSONFree(&json);
+#endif
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return (float)(now.tv_sec - start->tv_sec) * 1000.0 + 
+    (float)(now.tv_usec - start->tv_usec) / 1000.0;
 }
 
-// Return the temperature of the squidlet 'that' as a float.
-// The result depends on the architecture on which the squidlet is 
-// running. It is '0.0' if the temperature is not available
-float SquidletGetTemperature(
-  const Squidlet* const that) {
+// Calculate the hash of the string 'str' (64 bits FNV-1a) and store it
+// in 'hash' as a null terminated string of THESQUID_NNHASHLENGTH 
+// hexadecimal characters
+void TheSquidHash(
+  const char* const str, 
+        char* const hash) {
 #if BUILDMODE == 0
-  if (that == NULL) {
+  if (str == NULL) {
     TheSquidErr->_type = PBErrTypeNullPointer;
-    sprintf(TheSquidErr->_msg, "'that' is null");
+    sprintf(TheSquidErr->_msg, "'str' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (hash == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'hash' is null");
     PBErrCatch(TheSquidErr);
   }
 #endif
 
-  // The Squidlet's info are not used
-  (void)that;
+  // Calculate the hash
+  unsigned long long h = 14695981039346656037ULL;
+  for (const unsigned char* ptr = (const unsigned char*)str; 
+    *ptr != '\0'; ++ptr) {
+    h ^= (unsigned long long)(*ptr);
+    h *= 1099511628211ULL;
+  }
 
-#if BUILDARCH == 0
-  return 0.0;
+  // Convert the hash to a string
+  sprintf(hash, "%016llx", h);
+}
+
+// Evaluate the 'nbNN' NeuraNet 'nns' on the samples [first, last[ 
+// among the 'nbSample' samples stored contiguously in 'samples', each
+// sample being made of 'dimSample' values ordered as follow: 
+// <i0, i1, ..., in, o0, o1, ..., om>
+// The samples are read in one single pass, each sample being 
+// evaluated by all the NeuraNet whose evaluation is still running
+// The samples are split into ranges evaluated in parallel by up to 
+// 'nbThread' threads
+// The evaluation of a NeuraNet stops as soon as its value gets lower 
+// than 'threshold'
+// The value of each NeuraNet is stored in 'values' and is, as in 
+// GDSEvaluateNN, the opposite of the average norm of the error on 
+// outputs over the evaluated samples. The errors are summed in the 
+// order of samples whatever the number of threads, so the values 
+// don't depend on 'nbThread'
+// If 'flagBound' is true, the value of a NeuraNet whose evaluation 
+// has been stopped is instead the sum of errors on the evaluated 
+// samples divided by 'nbSample', i.e. an upper bound of its value
+// If 'nbEvals' is not null, the number of evaluated samples for each
+// NeuraNet is stored in it
+// If 'sumErrs' is not null, the sum of errors over the evaluated 
+// samples for each NeuraNet is stored in it
+// The threshold always applies to the sum of errors divided by 
+// 'nbSample', hence the evaluation on a subset of samples stops only 
+// if the NeuraNet can't beat the threshold on the whole samples
+// Return false if the dimensions of the NeuraNet and samples don't 
+// match, true else
+bool TheSquidEvalNeuraNets(
+       const float* const samples, 
+               const long nbSample, 
+               const long dimSample, 
+               const long first, 
+               const long last, 
+       NeuraNet** const nns, 
+               const long nbNN, 
+              const float threshold, 
+                const int nbThread, 
+               const bool flagBound, 
+          VecFloat* const values, 
+           VecLong* const nbEvals, 
+          VecFloat* const sumErrs) {
+#if BUILDMODE == 0
+  if (samples == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'samples' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (nns == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'nns' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (values == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'values' is null");
+    PBErrCatch(TheSquidErr);
+  }
+  if (VecGetDim(values) < nbNN) {
+    TheSquidErr->_type = PBErrTypeInvalidArg;
+    sprintf(TheSquidErr->_msg, "'values' is too small (%ld<%ld)", 
+      VecGetDim(values), nbNN);
+    PBErrCatch(TheSquidErr);
+  }
+  if (nbEvals != NULL && VecGetDim(nbEvals) < nbNN) {
+    TheSquidErr->_type = PBErrTypeInvalidArg;
+    sprintf(TheSquidErr->_msg, "'nbEvals' is too small (%ld<%ld)", 
+      VecGetDim(nbEvals), nbNN);
+    PBErrCatch(TheSquidErr);
+  }
+  if (sumErrs != NULL && VecGetDim(sumErrs) < nbNN) {
+    TheSquidErr->_type = PBErrTypeInvalidArg;
+    sprintf(TheSquidErr->_msg, "'sumErrs' is too small (%ld<%ld)", 
+      VecGetDim(sumErrs), nbNN);
+    PBErrCatch(TheSquidErr);
+  }
 #endif
 
-#if BUILDARCH == 1
-  // Declare a variable to pipe the shell command
-  FILE* fp = NULL;
+  // If there is nothing to evaluate
+  if (nbNN <= 0 || first < 0 || last > nbSample || first >= last)
+    return false;
 
-  // Run the command and pipe its output
-  fp = popen("vcgencmd measure_temp", "r");
-  
-  // If we could execute the command
-  if (fp != NULL) {
+  // Get the number of inputs and outputs, they must be the same for 
+  // all the NeuraNet and fit in the samples
+  long nbInput = NNGetNbInput(nns[0]);
+  long nbOutput = NNGetNbOutput(nns[0]);
+  if (nbInput + nbOutput > dimSample)
+    return false;
+  for (long iNN = 1; iNN < nbNN; ++iNN) {
+    if (NNGetNbInput(nns[iNN]) != nbInput ||
+      NNGetNbOutput(nns[iNN]) != nbOutput)
+      return false;
+  }
+
+  // Get the number of threads, such as each thread has enough samples
+  // to be worth its creation
+  long nbUsedThread = MIN((long)nbThread, 
+    (last - first) / THESQUID_EVALNN_MINSAMPLETHREAD);
+  nbUsedThread = MAX(1, nbUsedThread);
+
+  // Declare a variable to memorize the norm of errors per NeuraNet 
+  // and sample. Samples not evaluated are flagged with a negative 
+  // value
+  float* errs = 
+    PBErrMalloc(TheSquidErr, sizeof(float) * nbNN * nbSample);
+  for (long iErr = nbNN * nbSample; iErr--;)
+    errs[iErr] = -1.0;
+
+  // Declare the arguments of the threads
+  TheSquidEvalNeuraNetsThread* threads = PBErrMalloc(TheSquidErr, 
+    sizeof(TheSquidEvalNeuraNetsThread) * nbUsedThread);
+
+  // Loop on the threads
+  for (long iThread = 0; iThread < nbUsedThread; ++iThread) {
+
+    // Set the arguments of the thread
+    TheSquidEvalNeuraNetsThread* thread = threads + iThread;
+    thread->_samples = samples;
+    thread->_nbSample = nbSample;
+    thread->_dimSample = dimSample;
+    thread->_first = first + (last - first) * iThread / nbUsedThread;
+    thread->_last = 
+      first + (last - first) * (iThread + 1) / nbUsedThread;
+    thread->_nbNN = nbNN;
+    thread->_nbInput = nbInput;
+    thread->_nbOutput = nbOutput;
+    thread->_threshold = threshold;
+    thread->_errs = errs;
+
+    // The NeuraNets keep their internal state during evaluation, so
+    // each additional thread works on its own copy of the NeuraNets
+    if (iThread == 0) {
+      thread->_nns = nns;
+    } else {
+      thread->_nns = 
+        PBErrMalloc(TheSquidErr, sizeof(NeuraNet*) * nbNN);
+      for (long iNN = nbNN; iNN--;) {
+        JSONNode* json = NNEncodeAsJSON(nns[iNN]);
+        thread->_nns[iNN] = NULL;
+        NNDecodeAsJSON(thread->_nns + iNN, json);
+        JSONFree(&json);
+      }
 
-    // Declare a variable to store the output
-    char output[100] = {0};
+      // Start the thread, if it fails the range will be evaluated 
+      // by the current thread instead
+      if (pthread_create(&(thread->_thread), NULL, 
+        TheSquidEvalNeuraNetsRange, thread) != 0) {
+        for (long iNN = nbNN; iNN--;)
+          NeuraNetFree(thread->_nns + iNN);
+        free(thread->_nns);
+        thread->_nns = NULL;
+      }
+    }
+  }
 
-    // Read the output, expected to be as:
-    // temp=42.8'C
-    while (fgets(output, sizeof(output), fp) != NULL);
+  // Evaluate the first range of samples in the current thread
+  TheSquidEvalNeuraNetsRange(threads);
 
-    // Close the pipe
-    pclose(fp);
+  // Loop on the other threads
+  for (long iThread = 1; iThread < nbUsedThread; ++iThread) {
+    TheSquidEvalNeuraNetsThread* thread = threads + iThread;
 
-    // Remove the line return and two last characters
-    if (strlen(output) > 0)
-      output[strlen(output) - 3] = '\0';
+    // If the thread couldn't be created
+    if (thread->_nns == NULL) {
 
-    // Convert the output to a float
-    float t = 0.0;
-    sscanf(output + 5, "%f", &t);
+      // Evaluate its range in the current thread
+      thread->_nns = nns;
+      TheSquidEvalNeuraNetsRange(thread);
 
-    // Return the result
-    return t;
+    // Else, the thread has been created
+    } else {
 
-  // Else, the command failed
-  } else {
+      // Wait for the thread to end
+      pthread_join(thread->_thread, NULL);
 
-    // Return the default result
-    return 0.0;
+      // Free the copy of the NeuraNets
+      for (long iNN = nbNN; iNN--;)
+        NeuraNetFree(thread->_nns + iNN);
+      free(thread->_nns);
+    }
   }
-#endif
-
-#if BUILDARCH == 2
-  // Declare a variable to pipe the shell command
-  FILE* fp = NULL;
 
-  // Run the command and pipe its output
-  fp = popen("vcgencmd measure_temp", "r");
-  
-  // If we could execute the command
-  if (fp != NULL) {
+  // Loop on the NeuraNet
+  for (long iNN = 0; iNN < nbNN; ++iNN) {
+
+    // Sum the errors in the order of samples until the NeuraNet can't
+    // do better than the threshold anymore, as the serial evaluation
+    // would do. A range whose evaluation has stopped early had 
+    // already, by itself, a sum of errors reaching the threshold, so 
+    // the samples it has skipped are after the stop point
+    float sumErr = 0.0;
+    long nbEval = 0;
+    const float* err = errs + iNN * nbSample;
+    for (long iSample = first; 
+      iSample < last && err[iSample] >= 0.0; ++iSample) {
+      sumErr += err[iSample];
+      ++nbEval;
+      if (-1.0 * sumErr / (float)nbSample <= threshold)
+        break;
+    }
 
-    // Declare a variable to store the output
-    char output[100] = {0};
+    // Set the value of the NeuraNet, or its upper bound if requested
+    // and its evaluation has been stopped
+    if (flagBound == true && nbEval < last - first)
+      VecSet(values, iNN, -1.0 * sumErr / (float)nbSample);
+    else
+      VecSet(values, iNN, -1.0 * sumErr / (float)nbEval);
 
-    // Read the output, expected to be as:
-    // temp=42.8'C
-    while (fgets(output, sizeof(output), fp) != NULL);
+    // Set the number of evaluated samples and sum of errors if 
+    // requested
+    if (nbEvals != NULL)
+      VecSet(nbEvals, iNN, nbEval);
+    if (sumErrs != NULL)
+      VecSet(sumErrs, iNN, sumErr);
+  }
 
-    // Close the pipe
-    pclose(fp);
+  // Free memory
+  free(errs);
+  free(threads);
 
-    // Remove the line return and two last characters
-    if (strlen(output) > 0)
-      output[strlen(output) - 3] = '\0';
+  // Return the success code
+  return true;
+}
 
-    // Convert the output to a float
-    float t = 0.0;
-    sscanf(output + 5, "%f", &t);
+// Evaluate the NeuraNets on the range of samples described by 'arg',
+// a TheSquidEvalNeuraNetsThread, and store the norm of errors in it
+void* TheSquidEvalNeuraNetsRange(
+  void* arg) {
+#if BUILDMODE == 0
+  if (arg == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'arg' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
 
-    // Return the result
-    return t;
+  // Get the arguments
+  TheSquidEvalNeuraNetsThread* that = arg;
 
-  // Else, the command failed
-  } else {
+  // Declare the input and output vectors, shared by all the NeuraNet
+  VecFloat* input = VecFloatCreate(that->_nbInput);
+  VecFloat* output = VecFloatCreate(that->_nbOutput);
 
-    // Return the default result
-    return 0.0;
+  // Declare variables to memorize for each NeuraNet the sum of errors
+  // on the range and if its evaluation is running
+  float* sumErr = PBErrMalloc(TheSquidErr, sizeof(float) * that->_nbNN);
+  bool* running = PBErrMalloc(TheSquidErr, sizeof(bool) * that->_nbNN);
+  for (long iNN = that->_nbNN; iNN--;) {
+    sumErr[iNN] = 0.0;
+    running[iNN] = true;
   }
-#endif
-}
+  long nbRunning = that->_nbNN;
 
-// -------------- TheSquid 
+  // Loop on the samples until there is no more running evaluation
+  for (long iSample = that->_first; 
+    iSample < that->_last && nbRunning > 0; ++iSample) {
 
-// ================ Functions implementation ====================
+    // Get the sample and its expected outputs
+    const float* sample = that->_samples + iSample * that->_dimSample;
+    const float* expected = sample + that->_nbInput;
 
-// Function for benchmark purpose
-// Create a set of null element of size equals to the size of the
-// buffer in the task data, and sort it 10 times the 'nbLoop' in the
-// task data, using each time diferrent sorting values for each element 
-int TheSquidBenchmark(
-                int nbLoop, 
-  const char* const buffer) {
+    // Set the inputs, which are the same for all the NeuraNet
+    for (long iInput = that->_nbInput; iInput--;)
+      VecSet(input, iInput, sample[iInput]);
 
-  // Variable to memorize the dummy result
-  int res = 0;
+    // Loop on the NeuraNet
+    for (long iNN = 0; iNN < that->_nbNN; ++iNN) {
 
-  // Loop on sample code
-  for (int iLoop = 0; iLoop < nbLoop; ++iLoop) {
-    for (unsigned int scaling = 10; scaling--;) {
-      GSet set = GSetCreateStatic();
-      for(unsigned long i = strlen(buffer); i--;) {
-        GSetPush(&set, NULL);
-        set._head->_sortVal = (float)(i + scaling + iLoop);
+      // If the evaluation of this NeuraNet is over, skip it
+      if (running[iNN] == false)
+        continue;
+
+      // Evaluate the NeuraNet on the sample
+      NNEval(that->_nns[iNN], input, output);
+
+      // Calculate the norm of the error on outputs
+      float err = 0.0;
+      for (long iOutput = 0; iOutput < that->_nbOutput; ++iOutput) {
+        float diff = expected[iOutput] - VecGet(output, iOutput);
+        err += diff * diff;
+      }
+      err = sqrt(err);
+      that->_errs[iNN * that->_nbSample + iSample] = err;
+      sumErr[iNN] += err;
+
+      // If the NeuraNet can't do better than the threshold anymore,
+      // even with no error on the other ranges, stop its evaluation
+      if (-1.0 * sumErr[iNN] / (float)(that->_nbSample) <= 
+        that->_threshold) {
+        running[iNN] = false;
+        --nbRunning;
       }
-      GSetSort(&set);
-      res = (int)round(set._head->_sortVal);
-      GSetFlush(&set);
     }
   }
 
-  // Return the dummy result
-  return res;
+  // Free memory
+  VecFree(&input);
+  VecFree(&output);
+  free(sumErr);
+  free(running);
+
+  // Nothing to return
+  return NULL;
 }
 
 // Function to receive in blocking mode 'nb' bytes of data from
@@ -4867,3 +13234,99 @@ bool SocketRecv(short* sock, unsigned long nb, char* buffer,
 
 } 
 
+// Function to check without blocking if the connection through the 
+// socket 'sock' has been lost, i.e. it has been closed by the peer or 
+// the keepalive probes have failed
+// Return true if the connection is lost, false if it's still alive 
+// (with or without pending data)
+bool SocketIsLost(
+  const short sock) {
+  // An invalid socket is lost
+  if (sock < 0)
+    return true;
+
+  // Check if there is an event on the socket
+  struct pollfd fds;
+  fds.fd = sock;
+  fds.events = POLLIN;
+  fds.revents = 0;
+  int ret = poll(&fds, 1, 0);
+
+  // If there is no event, the connection is alive and idle
+  if (ret == 0)
+    return false;
+
+  // If there is something to read, peek at it without consuming it: 
+  // pending data means the connection is alive, even if the peer has 
+  // closed it since, no byte means the peer has closed the 
+  // connection, an error other than no data available means the 
+  // keepalive probes have failed or the connection has been reset
+  if (ret > 0 && (fds.revents & POLLIN) != 0) {
+    char c = 0;
+    ssize_t nb = recv(sock, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (nb > 0)
+      return false;
+    if (nb == 0)
+      return true;
+    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+      return true;
+  }
+
+  // If there is an error on the socket, the connection is lost
+  if ((ret < 0 && errno != EINTR) || 
+    (fds.revents & (POLLERR | POLLHUP | POLLNVAL)) != 0)
+    return true;
+
+  // The connection is alive
+  return false;
+}
+
+// Function to send in blocking mode 'nb' bytes of data from 'buffer'
+// through the socket 'sock'. Give up after 'maxWait' seconds.
+// Return true if we could send all the bytes, false else
+bool SocketSend(
+         const short sock, 
+  const unsigned long nb, 
+    const char* const buffer, 
+         const time_t maxWait) {
+#if BUILDMODE == 0
+  if (buffer == NULL) {
+    TheSquidErr->_type = PBErrTypeNullPointer;
+    sprintf(TheSquidErr->_msg, "'buffer' is null");
+    PBErrCatch(TheSquidErr);
+  }
+#endif
+
+  // Declare a variable to memorize the number of bytes already sent
+  unsigned long nbSent = 0;
+
+  // Declare variables to memorize the start time and elapsed time
+  time_t startTime = time(NULL);
+  time_t elapsedTime = 0;
+
+  // While we haven't sent all the bytes and the time limit is not 
+  // reached
+  // The socket may accept only part of the data at each call, 
+  // or none of it if its send buffer is full
+  do {
+
+    // Try to send the remaining bytes
+    int flags = 0;
+    ssize_t nbSentByte = 
+      send(sock, buffer + nbSent, nb - nbSent, flags);
+    if (nbSentByte > 0) {
+      nbSent += nbSentByte;
+    } else if (nbSentByte == -1 && errno != EAGAIN && 
+      errno != EWOULDBLOCK && errno != EINTR) {
+      return false;
+    }
+
+    // Update the elapsed time
+    elapsedTime = time(NULL) - startTime;
+
+  } while (nbSent < nb && elapsedTime <= maxWait && !Squidlet_CtrlC);
+
+  // Return the success/failure code
+  return (nbSent == nb);
+}
+
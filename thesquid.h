@@ -10,12 +10,24 @@
 #include <math.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <sys/socket.h>
+#include <netinet/tcp.h>
+#include <poll.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <netdb.h>
 #include <time.h>
 #include <sys/time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <dlfcn.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+#include <sys/sendfile.h>
 #include "pberr.h"
 #include "pbmath.h"
 #include "gset.h"
@@ -37,6 +49,36 @@
 #define THESQUID_PROC_TIMEOUT           60   // in seconds
 #define THESQUID_MAXPAYLOADSIZE         1024 // bytes
 #define THESQUID_WAITDATARECEPT_TIMEOUT 5    // in seconds
+#define THESQUID_EVALNN_MINSAMPLETHREAD 256  // samples per thread
+#define THESQUID_NBNNCACHE              64   // NeuraNets per squidlet
+#define THESQUID_NNHASHLENGTH           16   // hexadecimal characters
+#define THESQUID_ERRUNKNOWNNN           "Unknown neuranet"
+// Announce of the squidlets to the squads discovering them, sent over 
+// UDP as "<magic> <hello | bye> <port> <name>"
+#define THESQUID_DISCOVERY_PORT         8999 // UDP port
+#define THESQUID_ANNOUNCE_PERIOD        5    // in seconds
+#define THESQUID_ANNOUNCE_MAGIC         "TheSquid"
+#define THESQUID_ANNOUNCE_LENGTH        300  // bytes
+// TCP keepalive of the connections of the squad to the squidlets 
+// running a task, used as heartbeat: a dead squidlet or an 
+// unreachable device is detected after at most 
+// IDLE + INTVL * CNT seconds
+#define THESQUID_KEEPALIVE_IDLE         5    // in seconds
+#define THESQUID_KEEPALIVE_INTVL        2    // in seconds
+#define THESQUID_KEEPALIVE_CNT          3
+// Delay between two steps of the Squad of a relay squidlet executing 
+// a batch task
+#define THESQUID_RELAY_STEPPERIOD       10   // in milliseconds
+// Processes run by TheSquidSpawn: size of the chunks written to their 
+// standard input and read from their standard output, max size of 
+// their output, and max number of binaries a squidlet can run for the 
+// Exec tasks
+#define THESQUID_EXEC_PIPEBUFFER        4096 // bytes
+#define THESQUID_EXEC_MAXOUTPUT         1048576 // bytes
+#define THESQUID_EXEC_MAXCOMMAND        16
+// Size of the chunks moved from the socket to the file by splice() 
+// when receiving a file attached to a result, cf TheSquidSpliceToFile
+#define THESQUID_SPLICE_CHUNK           65536 // bytes
 
 #define SQUAD_TXTOMETER_LINE1             \
   "NbRunning xxxxx NbQueued xxxxx NbSquidletAvail xxxxx\n"
@@ -50,14 +92,277 @@
 #define SQUAD_TXTOMETER_NBLINEHISTORY     20
 #define SQUAD_TXTOMETER_LENGTHLINEHISTORY 100
 #define SQUAD_TXTOMETER_NBTASKDISPLAYED   32
+#define SQUAD_TXTOMETER_NBHISTORYEVENT    64 // power of 2
+#define SQUAD_TXTOMETER_NBREFRESHPERSEC   4
+#define SQUAD_TXTOMETER_LENGTHNAME        32
 
-// Range for the sliding average when computing stats
-#define SQUID_RANGEAVGSTAT 100
+// -------------- TheSquidHisto
+
+// ================= Define ===================
+
+// The histograms have THESQUID_HISTO_NBBUCKETPEROCTAVE buckets per 
+// power of 2, the bucket i contains the values v such as 
+// i <= THESQUID_HISTO_NBBUCKETPEROCTAVE * log2(1 + v) < i + 1 
+#define THESQUID_HISTO_NBBUCKET          256
+#define THESQUID_HISTO_NBBUCKETPEROCTAVE 8
+
+// ================= Data structure ===================
+
+typedef struct TheSquidHisto {
+  // Number of values in each bucket
+  unsigned long _counts[THESQUID_HISTO_NBBUCKET];
+  // Total number of values
+  unsigned long _nb;
+  // Sum of the values
+  double _sum;
+  // Min and max values
+  float _min;
+  float _max;
+} TheSquidHisto;
+
+// ================ Functions declaration ====================
+
+// Return a new empty TheSquidHisto
+TheSquidHisto TheSquidHistoCreateStatic(void);
+
+// Empty the TheSquidHisto 'that'
+void TheSquidHistoReset(
+  TheSquidHisto* const that);
+
+// Add the value 'val' (positive or null) to the TheSquidHisto 'that'
+void TheSquidHistoAdd(
+  TheSquidHisto* const that, 
+             const float val);
+
+// Return the quantile 'q' (in [0.0, 1.0]) of the values of the 
+// TheSquidHisto 'that', estimated from the bounds of its bucket
+// Return 0.0 if the TheSquidHisto is empty
+float TheSquidHistoGetQuantile(
+  const TheSquidHisto* const that, 
+                 const float q);
+
+// Return the average of the values of the TheSquidHisto 'that'
+// Return 0.0 if the TheSquidHisto is empty
+float TheSquidHistoGetMean(
+  const TheSquidHisto* const that);
+
+// Add the values of the TheSquidHisto 'histo' to the TheSquidHisto 
+// 'that'
+void TheSquidHistoMerge(
+        TheSquidHisto* const that, 
+  const TheSquidHisto* const histo);
+
+// Print the number of values, the average, the 50th, 90th, 99th, 
+// 99.9th percentiles and the max of the TheSquidHisto 'that' on the 
+// file 'stream'
+void TheSquidHistoPrint(
+  const TheSquidHisto* const that, 
+                FILE* const stream);
+
+// Return a new string encoding the TheSquidHisto 'that' as 
+// '<nb> <sum> <min> <max>;<bucket>:<count>,...' where only the non 
+// empty buckets are listed
+char* TheSquidHistoToStr(
+  const TheSquidHisto* const that);
+
+// Decode the string 'str' created by TheSquidHistoToStr into the 
+// TheSquidHisto 'that'
+// Return true if the string could be decoded, else false and 'that' 
+// is empty
+bool TheSquidHistoFromStr(
+  TheSquidHisto* const that, 
+     const char* const str);
+
+// Print the TheSquidHisto 'that' on the file 'stream' as the samples 
+// of the Prometheus histogram 'name' with the labels 'labels' (as 
+// 'a="x",b="y"', may be empty). Only the non empty buckets are printed
+void TheSquidHistoPrintPrometheus(
+  const TheSquidHisto* const that, 
+           const char* const name, 
+           const char* const labels, 
+                 FILE* const stream);
+
+// -------------- TheSquidMetrics
+
+// ================= Define ===================
+
+// Maximum number of scrapes served per call to TheSquidMetricsServe
+#define THESQUID_METRICS_NBMAXSCRAPE 4
+// Time to receive the HTTP request of a scrape, in milliseconds
+#define THESQUID_METRICS_TIMEOUTMS   100
+
+// ================= Data structure ===================
+
+// Function printing the metrics of 'data' in the Prometheus text 
+// format on the file 'stream'
+typedef void (*TheSquidMetricsPrinter)(
+  const void* const data, 
+        FILE* const stream);
+
+typedef struct TheSquidMetrics {
+  // File descriptor of the non blocking socket listening for scrapes
+  int _fd;
+  // Port of the socket
+  int _port;
+  // Number of served scrapes
+  unsigned long _nbScrape;
+} TheSquidMetrics;
+
+// ================ Functions declaration ====================
+
+// Return a new TheSquidMetrics listening on the port 'port' of all
+// the interfaces of the device
+// Return null if the socket couldn't be opened
+TheSquidMetrics* TheSquidMetricsCreate(
+  const int port);
+
+// Free the memory used by the TheSquidMetrics 'that'
+void TheSquidMetricsFree(
+  TheSquidMetrics** that);
+
+// Reply to the pending scrapes of the TheSquidMetrics 'that' with the 
+// metrics printed by 'printer' for 'data', whatever the requested 
+// path. Return immediately if there is no pending scrape, serve at 
+// most THESQUID_METRICS_NBMAXSCRAPE scrapes
+// Return the number of served scrapes
+int TheSquidMetricsServe(
+         TheSquidMetrics* const that, 
+  const TheSquidMetricsPrinter printer, 
+              const void* const data);
+
+// -------------- TheSquidThermal
+
+// ================= Define ===================
+
+// Default delay between two samples of the thermal sensor
+#define THESQUID_THERMAL_PERIODMS        1000 // in milliseconds
+// Files read by TheSquidThermalSourceSysfs: the temperature in 
+// millidegree Celsius, and the throttled state of the Raspberry Pi 
+// firmware as a bit mask in hexadecimal
+#define THESQUID_THERMAL_PATHTEMP        \
+  "/sys/class/thermal/thermal_zone0/temp"
+#define THESQUID_THERMAL_PATHTHROTTLED   \
+  "/sys/devices/platform/soc/soc:firmware/get_throttled"
+// Bits of the throttled state meaning the device is currently capped,
+// throttled or at the soft temperature limit
+#define THESQUID_THERMAL_MASKTHROTTLED   0xE
+
+// ================= Data structure ===================
+
+// Function reading the current temperature of the device (in 
+// Celsius) into 'temperature' and its throttled state into 
+// 'throttled', 'data' is the user data given to 
+// TheSquidThermalCreate
+// Return true if the values could be read, else false
+typedef bool (*TheSquidThermalSource)(
+    void* const data, 
+   float* const temperature, 
+    bool* const throttled);
+
+typedef struct TheSquidThermal {
+  // Thread sampling the source
+  pthread_t _thread;
+  // Mutex and condition protecting the sampled values and used to 
+  // stop the thread
+  pthread_mutex_t _mutex;
+  pthread_cond_t _cond;
+  // Source of the samples and its user data
+  TheSquidThermalSource _source;
+  void* _data;
+  // Delay between two samples, in milliseconds
+  unsigned int _periodMs;
+  // Last sampled values, 0.0 and false if not available
+  float _temperature;
+  bool _throttled;
+  // Flag to stop the thread
+  bool _stop;
+} TheSquidThermal;
+
+// ================ Functions declaration ====================
+
+// Return a new TheSquidThermal sampling the 'source' with the user 
+// 'data' every 'periodMs' milliseconds in a background thread
+// The source is sampled once before returning
+// Return null if the thread couldn't be created
+TheSquidThermal* TheSquidThermalCreate(
+  const TheSquidThermalSource source, 
+                   void* const data, 
+            const unsigned int periodMs);
+
+// Stop the thread and free the memory used by the TheSquidThermal 
+// 'that'
+void TheSquidThermalFree(
+  TheSquidThermal** that);
+
+// Return the last sampled temperature of the TheSquidThermal 'that'
+// Never blocks on the source
+float TheSquidThermalGetTemperature(
+  const TheSquidThermal* const that);
+
+// Return the last sampled throttled state of the TheSquidThermal 
+// 'that'
+// Never blocks on the source
+bool TheSquidThermalIsThrottled(
+  const TheSquidThermal* const that);
+
+// TheSquidThermalSource reading THESQUID_THERMAL_PATHTEMP and 
+// THESQUID_THERMAL_PATHTHROTTLED, 'data' is not used
+// The throttled state is false if its file is not available
+bool TheSquidThermalSourceSysfs(
+    void* const data, 
+   float* const temperature, 
+    bool* const throttled);
+
+// TheSquidThermalSource returning the temperature pointed to by 
+// 'data' (a float*, 0.0 if null) and never throttled, used on the 
+// architectures without sensor and for tests 
+// The temperature is read atomically, it must be updated with 
+// __atomic_store while the sampler thread is running
+bool TheSquidThermalSourceStub(
+    void* const data, 
+   float* const temperature, 
+    bool* const throttled);
 
 // -------------- SquidletInfo
 
 // ================= Data structure ===================
 
+typedef enum SquidletTaskType {
+  SquidletTaskType_Null, 
+  SquidletTaskType_Dummy, 
+  SquidletTaskType_Benchmark, 
+  SquidletTaskType_PovRay,
+  SquidletTaskType_ResetStats,
+  SquidletTaskType_EvalNeuranet,
+  SquidletTaskType_Stats, 
+  SquidletTaskType_Batch, 
+  SquidletTaskType_Exec, 
+  SquidletTaskType_Nb} SquidletTaskType;
+
+// Thermal state of a squidlet as seen by the Squad, cf 
+// SquadGetSquidletThermalState
+typedef enum SquidletThermalState {
+  // Receive tasks normally
+  SquidletThermalState_Cool, 
+  // Receive tasks only if there is no cool squidlet available
+  SquidletThermalState_Warm, 
+  // Receive no task until cooled down
+  SquidletThermalState_Hot, 
+  SquidletThermalState_Nb} SquidletThermalState;
+
+// Health of a squidlet as seen by the Squad, i.e. state of its 
+// circuit breaker, cf SquidletInfoGetHealth
+typedef enum SquidletHealth {
+  // Receive tasks normally
+  SquidletHealth_Closed, 
+  // Failing, receive no task until the end of its quarantine
+  SquidletHealth_Open, 
+  // End of quarantine, receive one task as a probe: the circuit is 
+  // closed if it's accepted, opened again with a longer quarantine 
+  // else
+  SquidletHealth_HalfOpen, 
+  SquidletHealth_Nb} SquidletHealth;
+
 typedef struct SquidletInfoStats {
   unsigned long _nbAcceptedConnection;
   unsigned long _nbAcceptedTask;
@@ -69,12 +374,25 @@ typedef struct SquidletInfoStats {
   unsigned long _nbFailedSendResultSize;
   unsigned long _nbFailedReceptAck;
   unsigned long _nbTaskComplete;
-  float _timeToProcessMs[3];
-  float _timeWaitedTaskMs[3];
-  float _timeWaitedAckMs[3];
-  float _temperature[3];
-  float _timeTransferSquadSquidMs[3];
-  float _timeTransferSquidSquadMs[3];
+  // Distribution of the time in millisecond to process the tasks, 
+  // over all the tasks and per type of task
+  TheSquidHisto _timeToProcessMs;
+  TheSquidHisto _timeToProcessMsPerType[SquidletTaskType_Nb];
+  // Distribution of the time in millisecond waited by the squidlet
+  // between two tasks, and for the acknowledgement from the Squad
+  TheSquidHisto _timeWaitedTaskMs;
+  TheSquidHisto _timeWaitedAckMs;
+  // Distribution of the temperature of the squidlet
+  TheSquidHisto _temperature;
+  // Distribution of the time in microsecond to transfer one kilobyte
+  // of data from the Squad to the squidlet, and from the squidlet to 
+  // the Squad
+  TheSquidHisto _timeTransferSquadSquidUsPerKB;
+  TheSquidHisto _timeTransferSquidSquadUsPerKB;
+  // Number of bytes of task data sent by the Squad to the squidlet, 
+  // and of result received from it
+  unsigned long _nbByteSent;
+  unsigned long _nbByteReceived;
   float _timePerTask;
   float _nbTaskExpected;
 } SquidletInfoStats;
@@ -90,6 +408,46 @@ typedef struct SquidletInfo {
   short _sock;
   // Statistics
   SquidletInfoStats _stats;
+  // Hashes of the inlined NeuraNets the squidlet is supposed to have
+  // in its cache, in the same order as the squidlet's cache
+  char _nnHashes[THESQUID_NBNNCACHE][THESQUID_NNHASHLENGTH + 1];
+  // Index in '_nnHashes' of the next hash to be added
+  int _nextNNHash;
+  // Time at which the statistics of the squidlet have been requested 
+  // for the last time
+  time_t _timeLastStats;
+  // Last temperature reported by the squidlet
+  float _temperature;
+  // Trend of the temperature, in Celsius per second, and temperature 
+  // and time of the sample used as reference to compute it
+  float _temperatureTrend;
+  float _temperatureRef;
+  time_t _timeTemperatureRef;
+  // Last throttled state reported by the squidlet
+  bool _throttled;
+  // Flag to memorize if the squidlet is cooling down, i.e. it has 
+  // reached the hard threshold and has not yet come back under the 
+  // soft threshold
+  bool _cooling;
+  // Time of the last announce received from the squidlet, 0 if it 
+  // has never announced itself (loaded from the configuration), in 
+  // which case it's never removed, 1 if it has said goodbye
+  time_t _timeLastAnnounce;
+  // Time until which the squidlet is in quarantine after losing the 
+  // connection with it, and delay of the last quarantine (0 if the 
+  // squidlet has completed a task since), in seconds
+  time_t _timeQuarantineEnd;
+  time_t _quarantineDelay;
+  // State of the circuit breaker, it's half open if it's open and the 
+  // quarantine has ended
+  SquidletHealth _health;
+  // Number of consecutive failures to connect to the squidlet or to 
+  // have a task accepted by it
+  unsigned int _nbFailure;
+  // Number of tasks the squidlet can execute at once, greater than 1 
+  // if it's a relay to the squidlets of another Squad, in which case 
+  // it receives the tasks in batch
+  unsigned long _capacity;
 } SquidletInfo;
 
 // ================ Functions declaration ====================
@@ -105,6 +463,35 @@ SquidletInfo* SquidletInfoCreate(
 void SquidletInfoFree(
   SquidletInfo** that);
 
+// Put the SquidletInfo 'that' in quarantine (open its circuit 
+// breaker), for SQUAD_QUARANTINEMIN seconds the first time, then for 
+// twice the previous delay up to SQUAD_QUARANTINEMAX seconds until it 
+// completes a task
+void SquidletInfoQuarantine(
+  SquidletInfo* const that);
+
+// Return true if the SquidletInfo 'that' is in quarantine (its circuit 
+// breaker is open), false else
+bool SquidletInfoIsQuarantined(
+  const SquidletInfo* const that);
+
+// Return the health (state of the circuit breaker) of the 
+// SquidletInfo 'that'
+SquidletHealth SquidletInfoGetHealth(
+  const SquidletInfo* const that);
+
+// Update the circuit breaker of the SquidletInfo 'that' after a 
+// failure to connect to it or to have a task accepted by it: the 
+// circuit is opened after SQUAD_BREAKERNBFAILURE consecutive failures, 
+// or after the failure of the probe if it's half open
+void SquidletInfoReportFailure(
+  SquidletInfo* const that);
+
+// Update the circuit breaker of the SquidletInfo 'that' after it has 
+// accepted a task: the circuit is closed
+void SquidletInfoReportSuccess(
+  SquidletInfo* const that);
+
 // Print the SquidletInfo 'that' on the file 'stream'
 void SquidletInfoPrint(
   const SquidletInfo* const that, 
@@ -119,6 +506,12 @@ void SquidletInfoStatsPrintln(
 void SquidletInfoStatsInit(
   SquidletInfoStats* const that);
 
+// Add the stats of the SquidletInfoStats 'stats' to the 
+// SquidletInfoStats 'that', to get the stats over several squidlets
+void SquidletInfoStatsMerge(
+        SquidletInfoStats* const that, 
+  const SquidletInfoStats* const stats);
+
 // Return the stats of the SquidletInfo 'that'
 #if BUILDMODE != 0 
 static inline 
@@ -126,25 +519,48 @@ static inline
 const SquidletInfoStats* SquidletInfoStatistics(
   const SquidletInfo* const that);
 
-// Update the statistics about the transfer time of the SquidletInfoStats
-// 'that' given that it took 'deltams' millisecond to send 'len' bytes
-// of data
+// Update the statistics about the transfer time from the Squad to the
+// squidlet of the SquidletInfoStats 'that' given that it took 'deltams'
+// millisecond to send 'len' bytes of data
 void SquidletInfoStatsUpdateTimeTransfer(
   SquidletInfoStats* const that,
                const float deltams,
               const size_t len);
 
+// Forget the inlined NeuraNets the SquidletInfo 'that' is supposed to
+// know, they will be sent again with the next tasks
+void SquidletInfoForgetNeuraNets(
+  SquidletInfo* const that);
+
+// Memorize that the squidlet of the SquidletInfo 'that' has added 
+// the NeuraNet whose hash is 'hash' to its cache, in place of the 
+// oldest one whose hash is not in 'keep' (the hashes of the NeuraNets 
+// of the current task), as the squidlet does
+void SquidletInfoAddNeuraNet(
+  SquidletInfo* const that, 
+    const char* const hash, 
+     const GSet* const keep);
+
 // -------------- SquidletTaskRequest
 
 // ================= Data structure ===================
 
-typedef enum SquidletTaskType {
-  SquidletTaskType_Null, 
-  SquidletTaskType_Dummy, 
-  SquidletTaskType_Benchmark, 
-  SquidletTaskType_PovRay,
-  SquidletTaskType_ResetStats,
-  SquidletTaskType_EvalNeuranet} SquidletTaskType;
+// Steps of the protocol between the Squad and the Squidlet for one 
+// task
+typedef enum SquidletTaskPhase {
+  // The Squad starts connecting to the Squidlet
+  SquidletTaskPhase_Connect,
+  // The Squad is connected to the Squidlet
+  SquidletTaskPhase_Connected,
+  // The Squidlet has accepted the task
+  SquidletTaskPhase_Accepted,
+  // The Squad has sent the data of the task
+  SquidletTaskPhase_DataSent,
+  // The Squad has received the size of the result
+  SquidletTaskPhase_ResultSize,
+  // The Squad has received the result
+  SquidletTaskPhase_Completed,
+  SquidletTaskPhase_Nb} SquidletTaskPhase;
 
 typedef struct SquidletTaskRequest {
   // Task type
@@ -161,6 +577,12 @@ typedef struct SquidletTaskRequest {
   // Time in second after which the Squad give up waiting for the
   // completion of this task
   time_t _maxWaitTime;
+  // Time at which the task has been added (or added back) to the set 
+  // of tasks to execute
+  struct timeval _timeQueued;
+  // Time at which each phase of the protocol has been reached during
+  // the last execution of the task (null if not reached)
+  struct timeval _timePhases[SquidletTaskPhase_Nb];
 } SquidletTaskRequest;
 
 // ================ Functions declaration ====================
@@ -199,6 +621,17 @@ bool SquidletTaskHasSucceeded(
 const char* SquidletTaskTypeAsStr(
   const SquidletTaskRequest* const that);
 
+// Return the name of the task type 'type', the name of the plugin for 
+// the types registered with TheSquidRegisterTaskPlugin, "Null" if the 
+// type is invalid
+const char* SquidletTaskTypeName(
+  const SquidletTaskType type);
+
+// Return true if 'type' is a built-in task type or the type of a 
+// registered plugin, else false
+bool SquidletTaskTypeIsValid(
+  const SquidletTaskType type);
+
 // Return the type of the task 'that'
 #if BUILDMODE != 0 
 static inline 
@@ -241,23 +674,281 @@ static inline
 time_t SquidletTaskGetMaxWaitTime(
   const SquidletTaskRequest* const that);
 
+// -------------- TheSquidTaskPlugin
+
+// ================= Define ===================
+
+// The task types of the plugins are in 
+// [THESQUID_PLUGIN_FIRSTTYPE, 
+//  THESQUID_PLUGIN_FIRSTTYPE + THESQUID_PLUGIN_MAXNB[, the event log 
+// stores the task type on one byte so they must stay below 256
+#define THESQUID_PLUGIN_FIRSTTYPE        64
+#define THESQUID_PLUGIN_MAXNB            32
+// Length of the name of a plugin, including the terminating null 
+// character
+#define THESQUID_PLUGIN_LENGTHNAME       32
+// Name of the function exported by the shared objects of plugins, cf 
+// TheSquidPluginRegisterFun
+#define THESQUID_PLUGIN_REGISTERFUN      "TheSquidPluginRegister"
+
+// ================= Data structure ===================
+
+// Hints about the cost of the tasks of a plugin for the scheduler of 
+// the Squad
+typedef struct TheSquidTaskCost {
+  // Expected time to execute one task, in milliseconds, used as the 
+  // time limit of the tasks added without one
+  unsigned long _timeMs;
+  // Flag to avoid sending the tasks to the squidlets already warm
+  bool _heavy;
+  // Flag to allow several tasks to be sent together to a relay
+  bool _batchable;
+} TheSquidTaskCost;
+
+// User defined task type
+typedef struct TheSquidTaskPlugin {
+  // Name of the task type
+  char _name[THESQUID_PLUGIN_LENGTHNAME];
+  // Task type, in [THESQUID_PLUGIN_FIRSTTYPE, 
+  // THESQUID_PLUGIN_FIRSTTYPE + THESQUID_PLUGIN_MAXNB[
+  SquidletTaskType _type;
+  // Cost hints for the scheduler
+  TheSquidTaskCost _cost;
+  // Squad side: encode the description of a task in the tasks file 
+  // (cf SquadLoadTasks) into the data sent to the squidlet, returned 
+  // as a string in JSON format allocated with malloc, or null if the 
+  // description is invalid 
+  // If null, the description is sent as is
+  char* (*_encode)(const JSONNode* task);
+  // Squidlet side: execute the task with the 'data' sent by the Squad 
+  // and write its result as a JSON object in 'result' of 'size' bytes 
+  // Return true if the task succeeded, else false
+  bool (*_execute)(const char* data, char* result, size_t size);
+  // Squad side: post process the completed task with the 'data' sent 
+  // to the squidlet and its 'result' 
+  // Return true if the task must be returned by SquadStep, false if 
+  // it has been consumed. If null, the task is returned as is
+  bool (*_postProcess)(const char* data, const char* result);
+} TheSquidTaskPlugin;
+
+// Function exported under the name THESQUID_PLUGIN_REGISTERFUN by the 
+// shared objects of plugins, it fills up to 'nb' plugins in 'plugins' 
+// and returns the number of filled ones
+typedef int (*TheSquidPluginRegisterFun)(
+  TheSquidTaskPlugin* plugins, 
+                  int nb);
+
+// ================ Functions declaration ====================
+
+// Register a copy of the 'plugin' for its task type, the Squad and 
+// the squidlets of the process can then execute the tasks of this type 
+// The plugins must be registered before starting the squidlets and 
+// the threads of the Squad, and both the squad and squidlets must 
+// register the same plugins 
+// Return false if the type is out of range or already registered or 
+// the plugin has no execute function, else true
+bool TheSquidRegisterTaskPlugin(
+  const TheSquidTaskPlugin* const plugin);
+
+// Load the shared object at 'path' and register the plugins it exports 
+// through its THESQUID_PLUGIN_REGISTERFUN function 
+// The shared object stays loaded until the end of the process 
+// Return true if at least one plugin could be registered and all of 
+// them were valid, else false
+bool TheSquidLoadTaskPlugin(
+  const char* const path);
+
+// Return the plugin registered for the task type 'type', or null if 
+// there is none
+const TheSquidTaskPlugin* TheSquidGetTaskPlugin(
+  const SquidletTaskType type);
+
+// -------------- TheSquidEventLog
+
+// ================= Define ===================
+
+// Number of records in the ring buffer of a TheSquidEventLog, events 
+// pushed while the ring buffer is full are dropped
+#define THESQUID_EVENTLOG_NBRECORD       4096
+// Delay between two flushes of the ring buffer by the writer thread
+#define THESQUID_EVENTLOG_PERIODMS       100 // in milliseconds
+// Magic string at the head of the event log files, its last 
+// character is the version of the format
+#define THESQUID_EVENTLOG_MAGIC          "TSQEVTL1"
+// Length of the name of the process in the header of the event log 
+// files, including the terminating null character
+#define THESQUID_EVENTLOG_LENGTHNAME     48
+
+// ================= Data structure ===================
+
+// Types of the events of a TheSquidEventLog, the comment gives the 
+// meaning of the value of the record if any
+typedef enum TheSquidEventType {
+  // Events of the squidlet
+  TheSquidEventType_AcceptConnection, 
+  TheSquidEventType_SetSockOptFailed, 
+  TheSquidEventType_RecvTaskType,         // task type
+  TheSquidEventType_RecvTaskTypeFailed, 
+  TheSquidEventType_SendReply,            // reply
+  TheSquidEventType_SendReplyFailed,      // reply
+  TheSquidEventType_ProcessTask, 
+  TheSquidEventType_RecvDataSize,         // size in bytes
+  TheSquidEventType_RecvDataSizeFailed, 
+  TheSquidEventType_RecvData,             // size in bytes
+  TheSquidEventType_RecvDataFailed,       // size in bytes
+  TheSquidEventType_SendResultSize,       // size in bytes
+  TheSquidEventType_SendResultSizeFailed, // size in bytes
+  TheSquidEventType_RecvAck, 
+  TheSquidEventType_RecvAckFailed, 
+  TheSquidEventType_SendResult,           // size in bytes
+  TheSquidEventType_SendResultFailed,     // size in bytes
+  TheSquidEventType_Ready, 
+  // Events of the squad
+  TheSquidEventType_SendTask,             // size of the data in bytes
+  TheSquidEventType_TaskRefused, 
+  TheSquidEventType_SendDataFailed, 
+  TheSquidEventType_TaskCompleted,        // size of the result in bytes
+  TheSquidEventType_TaskGaveUp, 
+  TheSquidEventType_TaskLost, 
+  // Number of events dropped because the ring buffer was full, 
+  // written when the log is closed
+  TheSquidEventType_Dropped,              // number of dropped events
+  TheSquidEventType_Nb} TheSquidEventType;
+
+// Record of one event, fixed size and written as is in the event log 
+// files
+typedef struct TheSquidEventRecord {
+  // Time of the event, in microseconds since the Epoch
+  uint64_t _timeUs;
+  // ID of the task, 0 if unknown
+  uint64_t _id;
+  // Value associated to the event, cf TheSquidEventType
+  uint64_t _value;
+  // Sub ID of the task, 0 if unknown
+  uint32_t _subId;
+  // Port of the squidlet
+  uint16_t _port;
+  // Type of the event (TheSquidEventType)
+  uint8_t _type;
+  // Type of the task (SquidletTaskType), SquidletTaskType_Null if 
+  // unknown
+  uint8_t _taskType;
+} TheSquidEventRecord;
+
+// Header of the event log files
+typedef struct TheSquidEventLogHeader {
+  // THESQUID_EVENTLOG_MAGIC without the terminating null character
+  char _magic[8];
+  // PID of the process which wrote the log
+  uint32_t _pid;
+  // Size in bytes of one record, to detect incompatible files
+  uint32_t _sizeRecord;
+  // Name of the process which wrote the log
+  char _name[THESQUID_EVENTLOG_LENGTHNAME];
+} TheSquidEventLogHeader;
+
+typedef struct TheSquidEventLog {
+  // Stream of the log file
+  FILE* _stream;
+  // Thread writing the records to the stream
+  pthread_t _thread;
+  // Mutex and condition used to stop the thread
+  pthread_mutex_t _mutex;
+  pthread_cond_t _cond;
+  // Flag to stop the thread
+  bool _stop;
+  // Ring buffer of records waiting to be written, filled by one single 
+  // producer and emptied by the writer thread without lock
+  TheSquidEventRecord _records[THESQUID_EVENTLOG_NBRECORD];
+  // Total number of records pushed in and written from the ring buffer
+  unsigned long _nbPushed;
+  unsigned long _nbWritten;
+  // Number of events dropped because the ring buffer was full
+  unsigned long _nbDropped;
+} TheSquidEventLog;
+
+// ================ Functions declaration ====================
+
+// Return a new TheSquidEventLog writing its records in the file at 
+// 'path', whose header gets the 'name' of the process, in a 
+// background thread 
+// Return null if the file couldn't be opened or the thread couldn't 
+// be created
+TheSquidEventLog* TheSquidEventLogCreate(
+  const char* const path, 
+  const char* const name);
+
+// Write the pending records, stop the thread, close the file and free 
+// the memory used by the TheSquidEventLog 'that'
+void TheSquidEventLogFree(
+  TheSquidEventLog** that);
+
+// Push the event of type 'type' for the task 'taskType' 'id'/'subId' 
+// on the squidlet listening on 'port' with the value 'value' in the 
+// TheSquidEventLog 'that' 
+// Never blocks and never does I/O, must be called from one single 
+// thread. If the ring buffer is full the event is dropped 
+// Return true if the event could be pushed, false else
+bool TheSquidEventLogPush(
+      TheSquidEventLog* const that, 
+  const TheSquidEventType type, 
+   const SquidletTaskType taskType, 
+     const unsigned long id, 
+     const unsigned long subId, 
+          const uint16_t port, 
+     const unsigned long value);
+
+// Decode the event log in the 'stream' and print it on the stream 
+// 'out', in text, one event per line, or in the Chrome trace event 
+// format (JSON) if 'json' is true 
+// Return true if the log could be decoded, false else
+bool TheSquidEventLogDecode(
+  FILE* const stream, 
+     FILE* const out, 
+     const bool json);
+
 // -------------- SquadRunningTask
 
+// ================= Define ===================
+
+#define SQUADRUNNINGTASK_LENGTHADDR 32 // characters
+
 // ================= Data structure ===================
 
+// State of the request of a task to a squidlet
+typedef enum SquadRunningTaskState {
+  // Waiting for the non blocking connection to the squidlet
+  SquadRunningTaskState_Connecting, 
+  // Waiting for the squidlet to accept or refuse the task
+  SquadRunningTaskState_Requested, 
+  // The task has been accepted and is executed by the squidlet
+  SquadRunningTaskState_Running, 
+  SquadRunningTaskState_Nb} SquadRunningTaskState;
+
 typedef struct SquadRunningTask {
   // The task
   SquidletTaskRequest* _request;
   // The squidlet
   SquidletInfo* _squidlet;
-  // Time when the SquadRunningTask is created
+  // Time when the SquadRunningTask is created, or when it has entered 
+  // its current state
   time_t _startTime;
+  // State of the request
+  SquadRunningTaskState _state;
+  // Address (ip:port) of the squidlet, kept for the trace of the task 
+  // once the squidlet is not available anymore
+  char _squidletAddr[SQUADRUNNINGTASK_LENGTHADDR];
+  // Time at which the post processing of the task in background has 
+  // ended, null if it's not post processed in background
+  struct timeval _timePostProcessed;
 } SquadRunningTask;
 
 // ================ Functions declaration ====================
 
 // Return a new SquadRunningTask for the SquidletTaskRequest 'request' 
-// running on the SquidletInfo 'squidlet'
+// running on the SquidletInfo 'squidlet' (may be null if the squidlet 
+// is not available anymore) 
+// The task is created in the running state
 SquadRunningTask* SquadRunningTaskCreate(
   SquidletTaskRequest* const request, 
          SquidletInfo* const squidlet);
@@ -271,10 +962,149 @@ void SquadRunningTaskPrint(
   const SquadRunningTask* const that, 
                     FILE* const stream);
 
+// -------------- SquadBenchmarkConfig
+
+// ================= Define ===================
+
+#define SQUAD_BENCHMARK_MINNBSAMPLE 5 // samples per measured point
+
+// ================= Data structure ===================
+
+typedef enum SquadBenchmarkFormat {
+  SquadBenchmarkFormat_Text,
+  SquadBenchmarkFormat_JSON,
+  SquadBenchmarkFormat_CSV
+} SquadBenchmarkFormat;
+
+typedef struct SquadBenchmarkConfig {
+  // Sizes in bytes of the payload of the benchmark tasks
+  VecLong* _payloadSizes;
+  // Numbers of sorts per benchmark task
+  VecLong* _nbLoops;
+  // Duration of the warm-up phase before measuring each point, in ms
+  float _warmUpMs;
+  // Duration of one sample of the task throughput, in ms
+  float _sampleMs;
+  // Min and max duration of the measurement of each point, in ms
+  float _minLengthMs;
+  float _maxLengthMs;
+  // Target half-width of the 95% confidence interval of the task 
+  // throughput, relative to the throughput
+  float _targetCI;
+  // Format of the results
+  SquadBenchmarkFormat _format;
+} SquadBenchmarkConfig;
+
+// ================ Functions declaration ====================
+
+// Return a SquadBenchmarkConfig with the default values: payloads of 
+// 9, 90 and 900 bytes, 1 to 1024 sorts per task, 1s of warm-up, 1s 
+// samples, 5s to 240s per point, 2% confidence interval, text output
+SquadBenchmarkConfig SquadBenchmarkConfigCreateStatic(void);
+
+// Free the memory used by the SquadBenchmarkConfig 'that'
+void SquadBenchmarkConfigFreeStatic(
+  SquadBenchmarkConfig* const that);
+
+// Load the SquadBenchmarkConfig 'that' from the file 'stream'
+// All the properties are optional, the missing ones keep their 
+// current value
+// Return true if the config could be loaded, false else
+// Example:
+// {"payloadSizes":["9","90"],"nbLoops":["1","16","256"],
+// "warmUpMs":"500","sampleMs":"500","minLengthMs":"2000",
+// "maxLengthMs":"60000","targetCI":"0.05","format":"json"}
+// where format is one of "text", "json", "csv"
+bool SquadBenchmarkConfigLoad(
+  SquadBenchmarkConfig* const that, 
+                  FILE* const stream);
+
+// Decode the SquadBenchmarkConfig 'that' from the JSON node 'json'
+// Return true if the config could be decoded, false else
+bool SquadBenchmarkConfigDecodeAsJSON(
+  SquadBenchmarkConfig* const that, 
+        const JSONNode* const json);
+
 // -------------- Squad
 
+// ================= Define ===================
+
+#define SQUAD_NBTRACE         1024 // traces memorized by the Squad
+#define SQUAD_TRACELENGTHADDR 32   // characters
+#define SQUAD_STATSPERIOD     10   // in seconds
+// Delay to connect to a squidlet, and to get its reply to a request
+#define SQUAD_REQUESTTIMEOUT     5   // in seconds
+// Maximum delay a step of the Squad waits for the replies to the 
+// requests it has sent
+#define SQUAD_DISPATCHWAIT       100 // in milliseconds
+// Delay after which a discovered squidlet which hasn't announced 
+// itself anymore is removed
+#define SQUAD_DISCOVERY_TIMEOUT  (4 * THESQUID_ANNOUNCE_PERIOD) // in s
+// Minimum and maximum delay of quarantine of a squidlet whose 
+// connection has been lost
+#define SQUAD_QUARANTINEMIN      5   // in seconds
+#define SQUAD_QUARANTINEMAX      300 // in seconds
+// Number of consecutive failures to send a task to a squidlet after 
+// which its circuit breaker is opened
+#define SQUAD_BREAKERNBFAILURE   3
+// Default thresholds of the predicted temperature of a squidlet above 
+// which it is warm or hot, and delay used to predict the temperature
+#define SQUAD_THERMALSOFT        70.0 // in Celsius
+#define SQUAD_THERMALHARD        80.0 // in Celsius
+#define SQUAD_THERMALHORIZON     30   // in seconds
+// Delay between two requests of the statistics of a squidlet cooling 
+// down, whatever the stats period, to know when it has cooled down
+#define SQUAD_THERMALCOOLPERIOD  5    // in seconds
+// Weight of the last sample in the moving average of the trend of 
+// the temperature
+#define SQUAD_THERMALTRENDWEIGHT 0.5
+// Period of the steps of the threads of a multithreaded Squad while 
+// they have no new task
+#define SQUAD_THREADSTEPPERIOD   10  // in milliseconds
+
 // ================= Data structure ===================
 
+typedef struct SquadTaskTrace {
+  // Type and ids of the task
+  SquidletTaskType _type;
+  unsigned long _id;
+  unsigned long _subId;
+  // Address (ip:port) of the squidlet which executed the task
+  char _squidlet[SQUAD_TRACELENGTHADDR];
+  // Time at which the task has been queued
+  struct timeval _timeQueued;
+  // Time at which each phase of the protocol has been reached
+  struct timeval _timePhases[SquidletTaskPhase_Nb];
+  // Time at which the post processing of the result has ended
+  struct timeval _timePostProcessed;
+  // Flag to memorize if the task has been completed (else the Squad 
+  // gave up waiting for it)
+  bool _completed;
+} SquadTaskTrace;
+
+// Event of the history displayed in the TextOMeter of the Squad, the 
+// task and squidlet it refers to are copied and formatted only when 
+// the TextOMeter is refreshed
+typedef struct SquadHistoryEvent {
+  // Sequence number of the event plus one, 0 while the event is being 
+  // written
+  unsigned long _seq;
+  // Message
+  char _msg[SQUAD_TXTOMETER_LENGTHLINEHISTORY];
+  // Flag to memorize if the event refers to a task, and the type and 
+  // ids of this task
+  bool _hasTask;
+  SquidletTaskType _type;
+  unsigned long _id;
+  unsigned long _subId;
+  // Flag to memorize if the event refers to a squidlet, and the name 
+  // and address of this squidlet
+  bool _hasSquidlet;
+  char _name[SQUAD_TXTOMETER_LENGTHNAME];
+  char _ip[INET_ADDRSTRLEN];
+  int _port;
+} SquadHistoryEvent;
+
 typedef struct Squad {
   // File descriptor of the socket
   short _fd;
@@ -288,11 +1118,68 @@ typedef struct Squad {
   bool _flagTextOMeter;
   // TextOMeter to display info 
   TextOMeter* _textOMeter;
-  // Buffer used to display info in the TextOMeter
-  char _history[SQUAD_TXTOMETER_NBLINEHISTORY] \
-    [SQUAD_TXTOMETER_LENGTHLINEHISTORY];
-  // Counter used to display info in the TextOMeter
-  unsigned int _countLineHistory;
+  // Ring buffer of the events of the history displayed in the 
+  // TextOMeter, written without lock, and total number of events 
+  // pushed in it
+  SquadHistoryEvent _history[SQUAD_TXTOMETER_NBHISTORYEVENT];
+  unsigned long _nbHistoryEvent;
+  // Time of the last refresh of the TextOMeter, and flag memorizing if 
+  // a refresh has been skipped since then
+  struct timeval _timeLastRefresh;
+  bool _flagTextOMeterDirty;
+  // Partial results of the sharded neuranet evaluation tasks 
+  // currently running, and key of the next one
+  GSet _evalNNShards;
+  unsigned long _nextEvalNNShardsKey;
+  // Ring buffer of the traces of the last SQUAD_NBTRACE executed tasks
+  SquadTaskTrace _traces[SQUAD_NBTRACE];
+  // Total number of traces added to the ring buffer
+  unsigned long _nbTrace;
+  // Endpoint for the metrics, null if not used
+  TheSquidMetrics* _metrics;
+  // Delay in seconds between two requests of the statistics of a 
+  // squidlet, 0 if the statistics are requested only on demand
+  time_t _statsPeriod;
+  // Thresholds of the predicted temperature of the squidlets, in 
+  // Celsius, and delay to predict it, in seconds
+  float _thermalSoft;
+  float _thermalHard;
+  time_t _thermalHorizon;
+  // Binary log of the events, null if not used
+  TheSquidEventLog* _eventLog;
+  // File descriptor of the non blocking UDP socket receiving the 
+  // announces of the squidlets, -1 if the discovery is not used
+  int _fdDiscovery;
+  // Tasks sent in batch to the relay squidlets, and id of the next 
+  // batch
+  GSet _batches;
+  unsigned long _nextBatchId;
+  // Flag to memorize if the Squad is the one of a relay squidlet, in 
+  // which case the results are returned as is, they are post 
+  // processed by the Squad of the relay
+  bool _flagRelay;
+  // Flag to memorize if the squidlets send the output files of the 
+  // tasks (POV-Ray fragments) over the socket after their result, 
+  // instead of writing them on a storage shared with the Squad
+  bool _flagSendFile;
+  // Shards of the squidlets, each stepped by its own thread, null if 
+  // the Squad is not multithreaded, and their number
+  struct SquadShard** _shards;
+  unsigned int _nbThread;
+  // Lock free queue of the tasks completed by the shards, pushed at 
+  // the tail by the threads of the shards and popped at the head, a 
+  // stub node, by the thread calling SquadStep
+  struct SquadCompletedNode* _completedHead;
+  struct SquadCompletedNode* _completedTail;
+  // Number of tasks handed to the shards and not yet returned
+  unsigned long _nbShardedTask;
+  // Threads post processing the completed tasks in background, null 
+  // if they are post processed by SquadStep, and their number
+  struct SquadPostProcessWorker** _postProcessWorkers;
+  unsigned int _nbPostProcessThread;
+  // Number of tasks handed to the post processing threads and not yet 
+  // returned
+  unsigned long _nbPostProcessTask;
 } Squad;
 
 // ================ Functions declaration ====================
@@ -342,7 +1229,9 @@ static inline
 const GSetSquadRunningTask* SquadRunningTasks(
   const Squad* const that);
 
-// Load the Squidlet info from the file 'stream' into the Squad 'that'
+// Load the Squidlet info from the file 'stream' into the Squad 'that' 
+// Each squidlet has a "_name", an "_ip", a "_port", and optionally a 
+// "_capacity" (number of tasks it can execute at once if it's a relay) 
 // Return true if it could load the info, else false
 bool SquadLoadSquidlets(
   Squad* const that, 
@@ -361,9 +1250,9 @@ bool SquadLoadSquidletsFromStr(
 // Return true if the request has been accepted by the squidlet, 
 // false else
 bool SquadSendTaskRequest(
-                      Squad* const that, 
-  const SquidletTaskRequest* const request, 
-               SquidletInfo* const squidlet);
+                Squad* const that, 
+  SquidletTaskRequest* const request, 
+         SquidletInfo* const squidlet);
 
 // Send the data associated to the task request 'task' from the Squad 
 // 'that' to the Squidlet 'squidlet'
@@ -375,6 +1264,19 @@ bool SquadSendTaskData(
          SquidletInfo* const squidlet, 
   SquidletTaskRequest* const task);
 
+// Return the data of the task 'task' to be sent to the squidlet 
+// 'squidlet', i.e. the task data without the inlined NeuraNets the 
+// squidlet already knows. The hashes of the NeuraNets kept in the 
+// data are added to 'sentHashes', and the ones of all the NeuraNets 
+// of the task to 'taskHashes' 
+// Return null if the data of the task doesn't contain inlined 
+// NeuraNets, in which case they are sent as is
+char* SquadGetTaskDataForSquidlet(
+  const SquidletTaskRequest* const task, 
+         const SquidletInfo* const squidlet, 
+                        GSet* const sentHashes, 
+                        GSet* const taskHashes);
+
 // Try to receive the result from the running task 'runningTask'
 // If the result is ready it is stored in the _bufferResult of the 
 // SquidletTaskRequest of the 'runningTask'
@@ -398,8 +1300,43 @@ bool SquadReceiveTaskResult(
 // as failed
 void SquadAddTask_Dummy(
          Squad* const that, 
-  const unsigned long id,
+  const unsigned long id, 
          const time_t maxWait);
+
+// Add an exec task uniquely identified by its 'id' to the list of 
+// task to execute by the squad 'that' 
+// The squidlet runs the binary named 'cmd' (one of those allowed with 
+// SquidletAddExecCommand) with the 'nbArg' arguments 'args', without 
+// shell, writes 'input' (may be null) on its standard input and 
+// returns its standard output 
+// The task will have a maximum of 'maxWait' seconds to complete from 
+// the time it's accepted by the squidlet or it will be considered 
+// as failed, the squidlet kills the command after 'maxWait' seconds 
+// Return false if the name of the command contains a line break, a 
+// quote, a backslash or a slash, or the arguments contain a line 
+// break, else true
+bool SquadAddTask_Exec(
+               Squad* const that, 
+        const unsigned long id, 
+               const time_t maxWait, 
+          const char* const cmd, 
+                  const int nbArg, 
+  const char* const* const args, 
+          const char* const input);
+
+// Add a task of the plugin type 'type' uniquely identified by its 'id'  
+// to the list of task to execute by the squad 'that', with the 'data' 
+// (string in JSON format) sent as is to the squidlet 
+// The task will have a maximum of 'maxWait' seconds to complete from 
+// the time it's accepted by the squidlet or it will be considered 
+// as failed, if 'maxWait' is 0 twice the expected time of the plugin 
+// is used instead
+void SquadAddTask_Plugin(
+                Squad* const that, 
+      const SquidletTaskType type, 
+         const unsigned long id, 
+                const time_t maxWait, 
+           const char* const data);
   
 // Add a benchmark task uniquely identified by its 'id' to the list of 
 // task to execute by the squad 'that'
@@ -448,11 +1385,28 @@ void SquadAddTask_PovRay(
    const unsigned int sizeMinFragment,
    const unsigned int sizeMaxFragment);
   
-// Add a dummy task uniquely identified by its 'id' to the list of 
-// task to execute by the squad 'that'
+// Add a neuranet evaluation task uniquely identified by its 'id' to
+// the list of task to execute by the squad 'that'
 // The task will have a maximum of 'maxWait' seconds to complete from 
 // the time it's accepted by the squidlet or it will be considered
 // as failed
+// The evaluation of a NeuraNet stops as soon as it can't beat 
+// 'curBest'. If 'fastReject' is true, the result of the task contains
+// for each NeuraNet the number of samples it has been evaluated on 
+// ("nbSample") and for those whose evaluation has been stopped, an
+// upper bound of their value instead of their value on the evaluated
+// samples
+// If 'nbShard' is greater than 1, the samples of the category are 
+// split into 'nbShard' ranges evaluated as separate tasks (with 
+// subid from 0 to nbShard-1) on different squidlets. The Squad sums 
+// the partial errors of the completed ranges and only the range 
+// completing last is returned by SquadStep, with the result of the 
+// evaluation on the whole category. A NeuraNet whose evaluation has 
+// been stopped in one of the ranges gets the upper bound of its value, 
+// whatever 'fastReject', and the result then contains "nbSample". A 
+// failed range is returned by SquadStep, the evaluation is abandoned 
+// if it's not tried again with SquadTryAgainTask within 'maxWait' 
+// seconds
 void SquadAddTask_EvalNeuraNet(
          Squad* const that, 
   const unsigned long id,
@@ -461,7 +1415,29 @@ void SquadAddTask_EvalNeuraNet(
     const char* const workingDirPath,
  const VecLong* const nnids,
           const float curBest,
-           const long cat);
+           const long cat,
+           const bool fastReject,
+   const unsigned int nbShard);
+
+// Add a neuranet evaluation task uniquely identified by its 'id' to
+// the list of task to execute by the squad 'that'
+// Same as SquadAddTask_EvalNeuraNet except that the NeuraNets are
+// not read by the squidlets from a working directory but sent inside
+// the task data. The 'nns' are the NeuraNets whose ids are 'nnids'
+// Each NeuraNet is identified by the hash of its definition and only
+// sent to the squidlets which haven't received it yet (up to the last
+// THESQUID_NBNNCACHE NeuraNets)
+void SquadAddTask_EvalNeuraNetInline(
+         Squad* const that, 
+  const unsigned long id,
+         const time_t maxWait,
+    const char* const datasetPath,
+       NeuraNet** const nns,
+ const VecLong* const nnids,
+          const float curBest,
+           const long cat,
+           const bool fastReject,
+   const unsigned int nbShard);
   
 // Send a request from the Squad 'that' to reset the stats of the
 // Squidlet 'squid'
@@ -515,7 +1491,10 @@ GSetSquadRunningTask SquadStep(
 
 // Process the completed 'task' with the Squad 'that' after its 
 // reception in SquadStep()
-void SquadProcessCompletedTask(
+// Return true if the task must be returned by SquadStep, false if 
+// it has been consumed by the Squad (partial result of a sharded 
+// task)
+bool SquadProcessCompletedTask(
              Squad* const that, 
   SquadRunningTask* const task);
 
@@ -523,6 +1502,25 @@ void SquadProcessCompletedTask(
 void SquadProcessCompletedTask_PovRay(
                 Squad* const that, 
   SquidletTaskRequest* const task);
+
+// Process the completed neuranet evaluation 'task' with the Squad 
+// 'that'
+// If the task is one range of a sharded evaluation, its partial 
+// result is merged with the other ranges. When all the ranges have
+// completed, the result of the last one is replaced with the result
+// of the evaluation on the whole category
+// Return true if the task must be returned by SquadStep, false if 
+// it has been merged and the evaluation is not complete yet
+bool SquadProcessCompletedTask_EvalNeuranet(
+                Squad* const that, 
+  SquidletTaskRequest* const task);
+
+// Abandon the sharded neuranet evaluations of the Squad 'that' having 
+// a failed range which hasn't been tried again with SquadTryAgainTask 
+// within its 'maxWait' seconds, the ranges completing later are 
+// ignored
+void SquadPurgeEvalNNShards(
+  Squad* const that);
   
 // Set the flag memorizing if the TextOMeter is displayed for
 // the Squad 'that' to 'flag'
@@ -537,6 +1535,114 @@ static inline
 bool SquadGetFlagTextOMeter(
   const Squad* const that);
 
+// Return the delay in seconds between two requests of the statistics 
+// of a squidlet by the Squad 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+time_t SquadGetStatsPeriod(
+  const Squad* const that);
+
+// Set the delay in seconds between two requests of the statistics 
+// of a squidlet by the Squad 'that' to 'period'
+// If 'period' is 0 the statistics are requested only on demand, 
+// except for the squidlets cooling down which are requested every 
+// SQUAD_THERMALCOOLPERIOD seconds
+#if BUILDMODE != 0
+static inline
+#endif
+void SquadSetStatsPeriod(
+   Squad* const that, 
+  const time_t period);
+
+// Return the flag memorizing if the squidlets of the Squad 'that' send 
+// the output files of the tasks after their result
+#if BUILDMODE != 0
+static inline
+#endif
+bool SquadGetFlagSendFile(
+  const Squad* const that);
+
+// Set the flag memorizing if the squidlets of the Squad 'that' send 
+// the output files of the tasks after their result to 'flag' 
+// It applies to the tasks added after the call
+#if BUILDMODE != 0
+static inline
+#endif
+void SquadSetFlagSendFile(
+  Squad* const that, 
+  const bool flag);
+
+// Request the statistics of all the squidlets of the Squad 'that' 
+// The requests are sent during the following SquadStep, as soon as 
+// the squidlets are available
+void SquadRequestStats(
+  Squad* const that);
+
+// Return the soft threshold (in Celsius) of the predicted temperature 
+// above which the squidlets of the Squad 'that' are warm
+#if BUILDMODE != 0
+static inline
+#endif
+float SquadGetThermalSoft(
+  const Squad* const that);
+
+// Return the hard threshold (in Celsius) of the predicted temperature 
+// above which the squidlets of the Squad 'that' are hot
+#if BUILDMODE != 0
+static inline
+#endif
+float SquadGetThermalHard(
+  const Squad* const that);
+
+// Return the delay (in seconds) used by the Squad 'that' to predict 
+// the temperature of its squidlets from their trend
+#if BUILDMODE != 0
+static inline
+#endif
+time_t SquadGetThermalHorizon(
+  const Squad* const that);
+
+// Set the soft and hard thresholds (in Celsius) of the predicted 
+// temperature of the squidlets of the Squad 'that' to 'soft' and 
+// 'hard'. 'soft' must be lower or equal to 'hard'
+#if BUILDMODE != 0
+static inline
+#endif
+void SquadSetThermalThresholds(
+  Squad* const that, 
+   const float soft, 
+   const float hard);
+
+// Set the delay (in seconds) used by the Squad 'that' to predict the 
+// temperature of its squidlets from their trend to 'horizon' 
+// If 'horizon' is 0 the current temperature is used
+#if BUILDMODE != 0
+static inline
+#endif
+void SquadSetThermalHorizon(
+   Squad* const that, 
+  const time_t horizon);
+
+// Update the thermal state of the 'squidlet' of the Squad 'that' with 
+// the temperature and throttled state in the result 'bufferResult' 
+// of a task it has completed 
+// The squidlet starts cooling down if it is throttled or its predicted 
+// temperature is above the hard threshold, and stops when it's not 
+// throttled anymore and its temperature is below the soft threshold
+void SquadUpdateSquidletThermal(
+         Squad* const that, 
+  SquidletInfo* const squidlet, 
+    const char* const bufferResult);
+
+// Return the thermal state of the 'squidlet' of the Squad 'that' 
+// The squidlet is hot if it is cooling down, else warm if its 
+// temperature predicted from its trend is above the soft threshold, 
+// else cool
+SquidletThermalState SquadGetSquidletThermalState(
+         const Squad* const that, 
+  const SquidletInfo* const squidlet);
+
 // Put back the 'task' into the set of task to complete of the Squad 
 // 'that'
 // Failed tasks (by timeout due to there 'maxWait' in 
@@ -547,6 +1653,20 @@ void SquadTryAgainTask(
                 Squad* const that, 
   SquidletTaskRequest* const task);
 
+// Return true if the task 'task' can be grouped in a batch sent to a 
+// relay, else false
+bool SquadIsBatchable(
+  const SquidletTaskRequest* const task);
+
+// Pop the first task of the Squad 'that' which can be sent to a 
+// squidlet in the thermal state 'thermalState', or return null if 
+// there is none. The heavy tasks of plugins are not sent to the warm 
+// squidlets, they are left in place for a cool one while the following 
+// tasks are dispatched
+SquidletTaskRequest* SquadPopTaskForThermalState(
+                 Squad* const that, 
+  const SquidletThermalState thermalState);
+
 // Check all the squidlets of the Squad 'that' by processing a dummy 
 // task and display information about each one on the file 'stream'
 // Return true if all the tasks could be performed, false else
@@ -563,12 +1683,126 @@ void SquadBenchmark(
   Squad* const that, 
    FILE* const stream);
 
+// Run the benchmark with the squad 'that' and the configuration 
+// 'config', and output the result on the file 'stream' in the format
+// of the configuration
+// For each pair of payload size and number of sorts, benchmark tasks
+// are executed during a warm-up phase, then the number of tasks 
+// completed per second is sampled until the confidence interval of 
+// its average reaches the target or the maximum duration is reached
+// If the squad has no squidlet the tasks are executed locally
+void SquadBenchmarkWithConfig(
+                        Squad* const that, 
+  const SquadBenchmarkConfig* const config, 
+                         FILE* const stream);
+
+// Run the benchmark of the protocol between the squad 'that' and its 
+// squidlets with the configuration 'config', and output the result on 
+// the file 'stream' in the format of the configuration
+// The squidlets execute dummy tasks without processing, first on one
+// squidlet, then two, up to all the squidlets of the squad, to 
+// measure the maximum number of tasks per second and the latency of 
+// each phase of the protocol
+// The grids of parameters of the configuration are ignored
+void SquadBenchmarkProtocol(
+                        Squad* const that, 
+  const SquadBenchmarkConfig* const config, 
+                         FILE* const stream);
+
+// Export the traces of the last SQUAD_NBTRACE tasks executed by the 
+// Squad 'that' on the file 'stream' in the Chrome trace event format
+// (JSON, viewable in chrome://tracing or Perfetto)
+// Each squidlet is displayed as a thread, on which each task is a 
+// span subdivided into the phases of its lifecycle
+// Return true if the traces could be exported, false else
+bool SquadExportTrace(
+  const Squad* const that, 
+   FILE* const stream);
+
 // Print the statistics about the currently available Squidlets of 
 // the Squad 'that' on the 'stream'
 void SquadPrintStatsSquidlets(
   const Squad* const that, 
          FILE* const stream);
 
+// Print the metrics of the Squad 'that' and the statistics of its 
+// squidlets (available or running a task) on the 'stream' in the 
+// Prometheus text format
+void SquadPrintMetrics(
+  const Squad* const that, 
+         FILE* const stream);
+
+// Open the endpoint serving the metrics of the Squad 'that' over HTTP 
+// on the port 'port'. The scrapes are served during SquadStep
+// Return true if the endpoint could be opened, false else
+bool SquadSetMetricsPort(
+  Squad* const that, 
+   const int port);
+
+// Open the binary log of the events of the Squad 'that' in the file 
+// at 'path', or close it if 'path' is null 
+// Return true if the log could be opened, false else
+bool SquadSetEventLog(
+        Squad* const that, 
+  const char* const path);
+
+// Receive the announces of the squidlets on the UDP port 'port' and 
+// add or remove them from the Squad 'that' at runtime, during 
+// SquadStep. Stop the discovery if 'port' is negative 
+// Return true if the port could be opened, false else
+bool SquadSetDiscoveryPort(
+  Squad* const that, 
+   const int port);
+
+// Split the squidlets of the Squad 'that' into 'nbThread' shards, each 
+// stepped by its own thread which does the I/O with its squidlets, 
+// receives their results and updates their statistics. SquadStep 
+// hands the tasks to the shards and returns the tasks they have 
+// completed, after post processing them. 'nbThread' lower than 2 
+// stops the threads and gives back the squidlets to 'that' 
+// The squidlets of the shards are not available to the other 
+// functions of the Squad until the threads are stopped, and the 
+// shards get the stats period, thermal thresholds and send file flag 
+// of 'that' when they are created. The tasks returned by SquadStep 
+// have no squidlet, and the traces of the tasks the shards gave up 
+// are not recorded by 'that'. The metrics and the event log 
+// would miss the squidlets and tasks of the shards, they can't be 
+// used at the same time 
+// Return true if the threads could be created, false else or if 
+// there are tasks running, or the metrics or event log are used
+bool SquadSetNbThread(
+                Squad* const that, 
+  const unsigned int nbThread);
+
+// Return the number of threads stepping the shards of the squidlets of 
+// the Squad 'that', 0 if it's not multithreaded
+#if BUILDMODE != 0
+static inline
+#endif
+unsigned int SquadGetNbThread(
+  const Squad* const that);
+
+// Post process the completed tasks of the Squad 'that' in 'nbThread' 
+// background threads instead of SquadStep, which then never waits for 
+// the composition of the POV-Ray images. The tasks with the same id 
+// are post processed by the same thread in the order of their 
+// completion, and returned without squidlet by the SquadStep 
+// following the end of their post processing. 'nbThread' equal to 0 
+// stops the threads, after they have post processed their pending 
+// tasks 
+// Return true if the threads could be created, false else
+bool SquadSetNbPostProcessThread(
+                Squad* const that, 
+  const unsigned int nbThread);
+
+// Return the number of threads post processing the completed tasks of 
+// the Squad 'that', 0 if they are post processed by SquadStep
+#if BUILDMODE != 0
+static inline
+#endif
+unsigned int SquadGetNbPostProcessThread(
+  const Squad* const that);
+
 // -------------- Squidlet
 
 // ================= Global variable ==================
@@ -614,10 +1848,63 @@ typedef struct Squidlet {
   struct timeval _timeLastTaskComplete;
   unsigned long _timeWaitedAckMs;
   float _timeTransferSquidSquadMs;
+  unsigned long _nbByteReceived;
+  unsigned long _nbByteSent;
+  TheSquidHisto _histoTimeToProcessMs[SquidletTaskType_Nb];
+  TheSquidHisto _histoTimeWaitedTaskMs;
+  TheSquidHisto _histoTimeWaitedAckMs;
+  TheSquidHisto _histoTimeTransferSquidSquadUsPerKB;
   // Path of the last used GDataSet
   char* _datasetPath;
   // Last used GDataSet
   GDataSetVecFloat _dataset;
+  // Index of the category of '_dataset' whose samples are currently
+  // in '_samples', -1 if there is none
+  long _samplesCat;
+  // Number of samples in '_samples'
+  long _nbSample;
+  // Dimension of one sample in '_samples'
+  long _dimSample;
+  // Values of the samples of the category '_samplesCat' of '_dataset'
+  // stored contiguously, sample after sample
+  float* _samples;
+  // Number of threads used to process the tasks
+  int _nbThread;
+  // Cache of the NeuraNets received inline in task data, and their 
+  // hash
+  NeuraNet* _nnCache[THESQUID_NBNNCACHE];
+  char _nnCacheHashes[THESQUID_NBNNCACHE][THESQUID_NNHASHLENGTH + 1];
+  // Index in the cache of the next NeuraNet to be added
+  int _nextNNCache;
+  // Endpoint for the metrics, null if not used
+  TheSquidMetrics* _metrics;
+  // Sampler of the temperature, null if not available
+  TheSquidThermal* _thermal;
+  // Binary log of the events, null if not used
+  TheSquidEventLog* _eventLog;
+  // Type, id and sub id of the task currently processed, for the event 
+  // log, the id and sub id are 0 until the data of the task is decoded
+  SquidletTaskType _taskType;
+  unsigned long _taskId;
+  unsigned long _taskSubId;
+  // File descriptor of the UDP socket used to announce the squidlet, 
+  // -1 if the squidlet doesn't announce itself, address to which the 
+  // announces are sent and time of the last one
+  int _fdAnnounce;
+  struct sockaddr_in _addrAnnounce;
+  time_t _timeLastAnnounce;
+  // Squad executing the batch tasks received by the squidlet, null if 
+  // the squidlet is not a relay
+  Squad* _relay;
+  // Paths of the binaries the squidlet accepts to run for the Exec 
+  // tasks, and their number
+  char* _execCommands[THESQUID_EXEC_MAXCOMMAND];
+  int _nbExecCommand;
+  // Path and size of the file attached to the result of the current 
+  // task, sent after the result with sendfile() then deleted, null if 
+  // there is none
+  char* _resultFilePath;
+  size_t _resultFileSize;
 } Squidlet;
 
 // ================ Functions declaration ====================
@@ -702,16 +1989,55 @@ void SquidletProcessRequest_PovRay(
 // Process a stats reset task request with the Squidlet 'that'
 void SquidletProcessRequest_StatsReset(
     Squidlet* const that);
+
+// Process a stats task request with the Squidlet 'that'
+// The statistics of the squidlet are encoded in JSON format and 
+// stored in 'bufferResult' which is allocated as necessary
+void SquidletProcessRequest_Stats(
+    Squidlet* const that,
+             char** bufferResult);
   
-// Process a neuranet evaluation task request with the Squidlet 'that'
+// Process a neuranet evaluation task request with the Squidlet 'that' 
 // The task request parameters are encoded in JSON and stored in the 
-// string 'buffer'
+// string 'buffer' 
 // The result of the task are encoded in JSON format and stored in 
 // 'bufferResult' which is allocated as necessary
 void SquidletProcessRequest_EvalNeuranet(
-    Squidlet* const that,
+    Squidlet* const that, 
   const char* const buffer, 
              char** bufferResult);
+
+// Process a batch task request with the relay Squidlet 'that' 
+// The tasks of the batch are encoded in 'buffer' and executed by the 
+// squidlets of the Squad of the relay, the results of the completed 
+// ones are encoded in 'bufferResult' which is allocated as necessary
+void SquidletProcessRequest_Batch(
+    Squidlet* const that, 
+  const char* const buffer, 
+             char** bufferResult);
+
+// Process an exec task request with the Squidlet 'that' 
+// The command, its arguments and its standard input are stored in 
+// 'buffer' as encoded by SquadAddTask_Exec 
+// The result of the task, a line in JSON format followed by the 
+// standard output of the command, is stored in 'bufferResult' which is 
+// allocated as necessary
+void SquidletProcessRequest_Exec(
+    Squidlet* const that, 
+  const char* const buffer, 
+             char** bufferResult);
+
+// Process a task request of the plugin 'plugin' with the Squidlet 
+// 'that' 
+// The task request parameters are encoded in JSON and stored in the 
+// string 'buffer' 
+// The result of the task are encoded in JSON format and stored in 
+// 'bufferResult' which is allocated as necessary
+void SquidletProcessRequest_Plugin(
+                   Squidlet* const that, 
+  const TheSquidTaskPlugin* const plugin, 
+                const char* const buffer, 
+                            char** bufferResult);
   
 // Get the PID of the Squidlet 'that'
 #if BUILDMODE != 0 
@@ -757,12 +2083,96 @@ void SquidletSetStreamInfo(
   Squidlet* const that, 
       FILE* const stream);
 
+// Get the number of threads used by the Squidlet 'that' to process 
+// the tasks
+#if BUILDMODE != 0 
+static inline 
+#endif 
+int SquidletGetNbThread(
+  const Squidlet* const that);
+
+// Set the number of threads used by the Squidlet 'that' to process 
+// the tasks to 'nbThread'
+// If 'nbThread' is less than 1, it is set to 1
+#if BUILDMODE != 0 
+static inline 
+#endif 
+void SquidletSetNbThread(
+  Squidlet* const that, 
+  const int nbThread);
+
 // Return the temperature of the squidlet 'that' as a float.
-// The result depends on the architecture on which the squidlet is 
-// running. It is '0.0' if the temperature is not available
+// The result is the last value sampled in background by its 
+// TheSquidThermal, whose source depends on the architecture on which 
+// the squidlet is running. It is '0.0' if the temperature is not 
+// available
 float SquidletGetTemperature(
   const Squidlet* const that);
 
+// Replace the source of the temperature of the Squidlet 'that' with
+// 'source' and its user 'data', sampled every 'periodMs' milliseconds
+// Return true if the sampler could be created, else false and the 
+// temperature is not available anymore
+bool SquidletSetThermalSource(
+                   Squidlet* const that, 
+  const TheSquidThermalSource source, 
+                   void* const data, 
+            const unsigned int periodMs);
+
+// Return the throttled state of the squidlet 'that', the last value 
+// sampled in background by its TheSquidThermal. It is false if the 
+// state is not available
+bool SquidletIsThrottled(
+  const Squidlet* const that);
+
+// Print the statistics of the Squidlet 'that' on the 'stream' in the 
+// Prometheus text format
+void SquidletPrintMetrics(
+  const Squidlet* const that, 
+           FILE* const stream);
+
+// Open the endpoint serving the metrics of the Squidlet 'that' over 
+// HTTP on the port 'port'. The scrapes are served while waiting for 
+// requests in SquidletWaitRequest
+// Return true if the endpoint could be opened, false else
+bool SquidletSetMetricsPort(
+  Squidlet* const that, 
+   const int port);
+
+// Open the binary log of the events of the Squidlet 'that' in the 
+// file at 'path', or close it if 'path' is null 
+// Return true if the log could be opened, false else
+bool SquidletSetEventLog(
+     Squidlet* const that, 
+  const char* const path);
+
+// Announce the Squidlet 'that' every THESQUID_ANNOUNCE_PERIOD seconds 
+// to the squads discovering squidlets on the address 'ip':'port', 
+// which may be a broadcast address or the one of a squad. Announce it 
+// immediately, then while waiting for requests in SquidletWaitRequest 
+// Stop the announces if 'ip' is null 
+// Return true if the announce could be setup, false else
+bool SquidletSetAnnounce(
+     Squidlet* const that, 
+  const char* const ip, 
+          const int port);
+
+// Make the Squidlet 'that' a relay to the squidlets of the Squad 
+// 'squad': the batch tasks it receives from its parent Squad are 
+// executed by the squidlets of 'squad'. 'squad' is freed with the 
+// Squidlet, the previous one is freed, null stops the relay
+void SquidletSetRelay(
+  Squidlet* const that, 
+     Squad* const squad);
+
+// Allow the Squidlet 'that' to run the binary at 'path' for the Exec 
+// tasks, which refer to it by its file name 
+// Return false if the binary is not executable or there are already 
+// THESQUID_EXEC_MAXCOMMAND binaries, else true
+bool SquidletAddExecCommand(
+    Squidlet* const that, 
+  const char* const path);
+
 // -------------- TheSquid 
 
 // ================ Functions declaration ====================
@@ -772,6 +2182,92 @@ int TheSquidBenchmark(
                 int nbLoop, 
   const char* const buffer);
 
+// Run the binary 'path' (searched in the PATH if it contains no 
+// slash) with the arguments 'argv' (null terminated, 'argv[0]' being 
+// the name of the binary) in a new process, without shell 
+// If 'input' is not null, its 'lenInput' bytes are written on the 
+// standard input of the process, else the process inherits it 
+// If 'output' is not null, the standard output of the process is 
+// stored in '*output' (allocated, null terminated) and its length in 
+// '*lenOutput', else the process inherits it. The process is killed 
+// if its output exceeds THESQUID_EXEC_MAXOUTPUT bytes 
+// If 'timeout' is greater than 0, the process is killed after 
+// 'timeout' seconds 
+// Return the exit status of the process, or -1 if it couldn't be run 
+// or has been killed
+int TheSquidSpawn(
+     const char* const path, 
+            char* const* argv, 
+     const char* const input, 
+          const size_t lenInput, 
+                  char** output, 
+          size_t* const lenOutput, 
+             const int timeout);
+
+// Receive 'size' bytes from the socket 'sock' and write them in the 
+// file at 'path', moving them directly from the socket to the file 
+// with splice(), by chunks of THESQUID_SPLICE_CHUNK bytes 
+// Give up after 'timeout' seconds, in which case the file is deleted 
+// Return true if all the bytes could be received, else false
+bool TheSquidSpliceToFile(
+               const int sock, 
+       const char* const path, 
+            const size_t size, 
+               const int timeout);
+
+// Return the time elapsed since 'start', in milliseconds
+float TheSquidGetElapsedMs(
+  const struct timeval* const start);
+
+// Calculate the hash of the string 'str' (64 bits FNV-1a) and store it
+// in 'hash' as a null terminated string of THESQUID_NNHASHLENGTH 
+// hexadecimal characters
+void TheSquidHash(
+  const char* const str, 
+        char* const hash);
+
+// Evaluate the 'nbNN' NeuraNet 'nns' on the samples [first, last[ 
+// among the 'nbSample' samples stored contiguously in 'samples', each
+// sample being made of 'dimSample' values ordered as follow: 
+// <i0, i1, ..., in, o0, o1, ..., om>
+// The samples are read in one single pass, each sample being 
+// evaluated by all the NeuraNet whose evaluation is still running
+// The samples are split into ranges evaluated in parallel by up to 
+// 'nbThread' threads
+// The evaluation of a NeuraNet stops as soon as its value gets lower 
+// than 'threshold'
+// The value of each NeuraNet is stored in 'values' and is, as in 
+// GDSEvaluateNN, the opposite of the average norm of the error on 
+// outputs over the evaluated samples. The errors are summed in the 
+// order of samples whatever the number of threads, so the values 
+// don't depend on 'nbThread'
+// If 'flagBound' is true, the value of a NeuraNet whose evaluation 
+// has been stopped is instead the sum of errors on the evaluated 
+// samples divided by 'nbSample', i.e. an upper bound of its value
+// If 'nbEvals' is not null, the number of evaluated samples for each
+// NeuraNet is stored in it
+// If 'sumErrs' is not null, the sum of errors over the evaluated 
+// samples for each NeuraNet is stored in it
+// The threshold always applies to the sum of errors divided by 
+// 'nbSample', hence the evaluation on a subset of samples stops only 
+// if the NeuraNet can't beat the threshold on the whole samples
+// Return false if the dimensions of the NeuraNet and samples don't 
+// match, true else
+bool TheSquidEvalNeuraNets(
+       const float* const samples, 
+               const long nbSample, 
+               const long dimSample, 
+               const long first, 
+               const long last, 
+       NeuraNet** const nns, 
+               const long nbNN, 
+              const float threshold, 
+                const int nbThread, 
+               const bool flagBound, 
+          VecFloat* const values, 
+           VecLong* const nbEvals, 
+          VecFloat* const sumErrs);
+
 // ================ Inliner ====================
 
 #if BUILDMODE != 0
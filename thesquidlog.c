@@ -0,0 +1,86 @@
+// -------------- thesquidlog.c ---------------
+
+// Include third party libraries
+#include <stdlib.h>
+#include <stdio.h>
+
+// Include own libraries
+#include "thesquid.h"
+
+// Main function for the decoder of the event logs
+int main(int argc, char** argv) {
+
+  // Declare and initialise variables to process arguments
+  char* logFilePath = NULL;
+  char* outputFilePath = NULL;
+  bool json = false;
+
+  // Loop on the arguments
+  for (int iArg = 1; iArg < argc; ++iArg) {
+
+    // -json
+    if (strcmp(argv[iArg], "-json") == 0) {
+
+      // Output in the Chrome trace event format
+      json = true;
+
+    // -out <path to output file>
+    } else if (strcmp(argv[iArg], "-out") == 0 && iArg < argc - 1) {
+
+      // Decode the path of the output file
+      ++iArg;
+      outputFilePath = argv[iArg];
+
+    // -help
+    } else if (strcmp(argv[iArg], "-help") == 0) {
+
+      // Display the help message and quit
+      printf("thesquidlog [-json] [-out <path to output file>] ");
+      printf("<path to event log file> [-help]\n");
+      return 0;
+
+    // Else, it's the path to the event log
+    } else {
+      logFilePath = argv[iArg];
+    }
+  }
+
+  // If the user hasn't provided the event log
+  if (logFilePath == NULL) {
+    fprintf(stderr, "No event log file, use -help for help\n");
+    return 1;
+  }
+
+  // Open the event log
+  FILE* stream = fopen(logFilePath, "rb");
+  if (stream == NULL) {
+    fprintf(stderr, "Failed to open the file %s\n", logFilePath);
+    return 2;
+  }
+
+  // Open the output file, the standard output by default
+  FILE* out = stdout;
+  if (outputFilePath != NULL) {
+    out = fopen(outputFilePath, "w");
+    if (out == NULL) {
+      fprintf(stderr, "Failed to open the file %s\n", outputFilePath);
+      fclose(stream);
+      return 3;
+    }
+  }
+
+  // Decode the event log
+  bool ret = TheSquidEventLogDecode(stream, out, json);
+  if (ret == false) {
+    fprintf(stderr, "Failed to decode the event log\n");
+    fprintf(stderr, "TheSquidErr: %s\n", TheSquidErr->_msg);
+  }
+
+  // Close the files
+  fclose(stream);
+  if (out != stdout)
+    fclose(out);
+
+  // Return the success code
+  return (ret ? 0 : 4);
+}